@@ -0,0 +1,4 @@
+<?xml version="1.0" encoding="UTF-8"?>
+<tileset name="testtsx" tilewidth="16" tileheight="16">
+ <image source="dye.png" width="32" height="32"/>
+</tileset>
@@ -45,8 +45,6 @@
 
 #include "const/utils/timer.h"
 
-#include "const/resources/spriteaction.h"
-
 #include "enums/being/beingdirection.h"
 
 #include "enums/resources/map/blockmask.h"
@@ -108,6 +106,7 @@
 #include "resources/skill/skillinfo.h"
 
 #include "resources/sprite/animatedsprite.h"
+#include "resources/sprite/spriteactionid.h"
 
 #include "gui/widgets/createwidget.h"
 
@@ -167,7 +166,6 @@ Being::Being(const BeingId id,
     mAnimationEffect(nullptr),
     mCastingEffect(nullptr),
     mBadges(),
-    mSpriteAction(SpriteAction::STAND),
     mName(),
     mExtName(),
     mRaceName(),
@@ -187,6 +185,7 @@ Being::Being(const BeingId id,
     mGuilds(),
     mParty(nullptr),
     mActionTime(0),
+    mSpriteAction(SpriteActionId::STAND),
     mEmotionTime(0),
     mSpeechTime(0),
     mAttackSpeed(350),
@@ -1415,110 +1414,110 @@ void Being::fireMissile(Being *restrict const victim,
     BLOCK_END("Being::fireMissile")
 }
 
-std::string Being::getSitAction() const restrict2
+int Being::getSitAction() const restrict2
 {
     if (mHorseId != 0)
-        return SpriteAction::SITRIDE;
+        return SpriteActionId::SITRIDE;
     if (mMap != nullptr)
     {
         const unsigned char mask = mMap->getBlockMask(mX, mY);
         if ((mask & BlockMask::GROUNDTOP) != 0)
-            return SpriteAction::SITTOP;
+            return SpriteActionId::SITTOP;
         else if ((mask & BlockMask::AIR) != 0)
-            return SpriteAction::SITSKY;
+            return SpriteActionId::SITSKY;
         else if ((mask & BlockMask::WATER) != 0)
-            return SpriteAction::SITWATER;
+            return SpriteActionId::SITWATER;
     }
-    return SpriteAction::SIT;
+    return SpriteActionId::SIT;
 }
 
 
-std::string Being::getMoveAction() const restrict2
+int Being::getMoveAction() const restrict2
 {
     if (mHorseId != 0)
-        return SpriteAction::RIDE;
+        return SpriteActionId::RIDE;
     if (mMap != nullptr)
     {
         const unsigned char mask = mMap->getBlockMask(mX, mY);
         if ((mask & BlockMask::AIR) != 0)
-            return SpriteAction::FLY;
+            return SpriteActionId::FLY;
         else if ((mask & BlockMask::WATER) != 0)
-            return SpriteAction::SWIM;
+            return SpriteActionId::SWIM;
     }
-    return SpriteAction::MOVE;
+    return SpriteActionId::MOVE;
 }
 
-std::string Being::getWeaponAttackAction(const ItemInfo *restrict const weapon)
-                                         const restrict2
+int Being::getWeaponAttackAction(const ItemInfo *restrict const weapon)
+                                 const restrict2
 {
     if (weapon == nullptr)
         return getAttackAction();
 
     if (mHorseId != 0)
-        return weapon->getRideAttackAction();
+        return SpriteActionId::get(weapon->getRideAttackAction());
     if (mMap != nullptr)
     {
         const unsigned char mask = mMap->getBlockMask(mX, mY);
         if ((mask & BlockMask::AIR) != 0)
-            return weapon->getSkyAttackAction();
+            return SpriteActionId::get(weapon->getSkyAttackAction());
         else if ((mask & BlockMask::WATER) != 0)
-            return weapon->getWaterAttackAction();
+            return SpriteActionId::get(weapon->getWaterAttackAction());
     }
-    return weapon->getAttackAction();
+    return SpriteActionId::get(weapon->getAttackAction());
 }
 
-std::string Being::getAttackAction(const Attack *restrict const attack1) const
-                                   restrict2
+int Being::getAttackAction(const Attack *restrict const attack1) const
+                           restrict2
 {
     if (attack1 == nullptr)
         return getAttackAction();
 
     if (mHorseId != 0)
-        return attack1->mRideAction;
+        return SpriteActionId::get(attack1->mRideAction);
     if (mMap != nullptr)
     {
         const unsigned char mask = mMap->getBlockMask(mX, mY);
         if ((mask & BlockMask::AIR) != 0)
-            return attack1->mSkyAction;
+            return SpriteActionId::get(attack1->mSkyAction);
         else if ((mask & BlockMask::WATER) != 0)
-            return attack1->mWaterAction;
+            return SpriteActionId::get(attack1->mWaterAction);
     }
-    return attack1->mAction;
+    return SpriteActionId::get(attack1->mAction);
 }
 
-std::string Being::getCastAction(const SkillInfo *restrict const skill) const
-                                 restrict2
+int Being::getCastAction(const SkillInfo *restrict const skill) const
+                         restrict2
 {
     if (skill == nullptr)
         return getCastAction();
 
     if (mHorseId != 0)
-        return skill->castingRideAction;
+        return SpriteActionId::get(skill->castingRideAction);
     if (mMap != nullptr)
     {
         const unsigned char mask = mMap->getBlockMask(mX, mY);
         if ((mask & BlockMask::AIR) != 0)
-            return skill->castingSkyAction;
+            return SpriteActionId::get(skill->castingSkyAction);
         else if ((mask & BlockMask::WATER) != 0)
-            return skill->castingWaterAction;
+            return SpriteActionId::get(skill->castingWaterAction);
     }
-    return skill->castingAction;
+    return SpriteActionId::get(skill->castingAction);
 }
 
 #define getSpriteAction(func, action) \
-    std::string Being::get##func##Action() const restrict2\
+    int Being::get##func##Action() const restrict2\
 { \
     if (mHorseId != 0) \
-        return SpriteAction::action##RIDE; \
+        return SpriteActionId::action##RIDE; \
     if (mMap) \
     { \
         const unsigned char mask = mMap->getBlockMask(mX, mY); \
         if (mask & BlockMask::AIR) \
-            return SpriteAction::action##SKY; \
+            return SpriteActionId::action##SKY; \
         else if (mask & BlockMask::WATER) \
-            return SpriteAction::action##WATER; \
+            return SpriteActionId::action##WATER; \
     } \
-    return SpriteAction::action; \
+    return SpriteActionId::action; \
 }
 
 getSpriteAction(Attack, ATTACK)
@@ -1526,34 +1525,34 @@ getSpriteAction(Cast, CAST)
 getSpriteAction(Dead, DEAD)
 getSpriteAction(Spawn, SPAWN)
 
-std::string Being::getStandAction() const restrict2
+int Being::getStandAction() const restrict2
 {
     if (mHorseId != 0)
-        return SpriteAction::STANDRIDE;
+        return SpriteActionId::STANDRIDE;
     if (mMap != nullptr)
     {
         const unsigned char mask = mMap->getBlockMask(mX, mY);
         if (mTrickDead)
         {
             if ((mask & BlockMask::AIR) != 0)
-                return SpriteAction::DEADSKY;
+                return SpriteActionId::DEADSKY;
             else if ((mask & BlockMask::WATER) != 0)
-                return SpriteAction::DEADWATER;
+                return SpriteActionId::DEADWATER;
             else
-                return SpriteAction::DEAD;
+                return SpriteActionId::DEAD;
         }
         if ((mask & BlockMask::AIR) != 0)
-            return SpriteAction::STANDSKY;
+            return SpriteActionId::STANDSKY;
         else if ((mask & BlockMask::WATER) != 0)
-            return SpriteAction::STANDWATER;
+            return SpriteActionId::STANDWATER;
     }
-    return SpriteAction::STAND;
+    return SpriteActionId::STAND;
 }
 
 void Being::setAction(const BeingActionT &restrict action,
                       const int attackId) restrict2
 {
-    std::string currentAction = SpriteAction::INVALID;
+    int currentAction = SpriteActionId::INVALID;
 
     switch (action)
     {
@@ -1573,7 +1572,7 @@ void Being::setAction(const BeingActionT &restrict action,
             if (mInfo != nullptr)
             {
                 ItemSoundEvent::Type event;
-                if (currentAction == SpriteAction::SITTOP)
+                if (currentAction == SpriteActionId::SITTOP)
                     event = ItemSoundEvent::SITTOP;
                 else
                     event = ItemSoundEvent::SIT;
@@ -1657,7 +1656,7 @@ void Being::setAction(const BeingActionT &restrict action,
             break;
     }
 
-    if (currentAction != SpriteAction::INVALID)
+    if (currentAction != SpriteActionId::INVALID)
     {
         mSpriteAction = currentAction;
         play(currentAction);
@@ -1678,9 +1677,9 @@ void Being::setAction(const BeingActionT &restrict action,
         mAction = action;
     }
 
-    if (currentAction != SpriteAction::MOVE
-        && currentAction != SpriteAction::FLY
-        && currentAction != SpriteAction::SWIM)
+    if (currentAction != SpriteActionId::MOVE
+        && currentAction != SpriteActionId::FLY
+        && currentAction != SpriteActionId::SWIM)
     {
         mActionTime = tick_time;
     }
@@ -626,31 +626,30 @@ class Being notfinal : public ActorSprite,
         { return mGender; }
 
         /**
-         * Return sprite sit action for current environment.
+         * Return sprite sit action id for current environment.
          */
-        std::string getSitAction() const restrict2 A_WARN_UNUSED;
+        int getSitAction() const restrict2 A_WARN_UNUSED;
 
-        std::string getCastAction() const restrict2 A_WARN_UNUSED;
+        int getCastAction() const restrict2 A_WARN_UNUSED;
 
-        std::string getCastAction(const SkillInfo *restrict const skill) const
-                                  restrict2 A_WARN_UNUSED;
+        int getCastAction(const SkillInfo *restrict const skill) const
+                          restrict2 A_WARN_UNUSED;
 
-        std::string getMoveAction() const restrict2 A_WARN_UNUSED;
+        int getMoveAction() const restrict2 A_WARN_UNUSED;
 
-        std::string getDeadAction() const restrict2 A_WARN_UNUSED;
+        int getDeadAction() const restrict2 A_WARN_UNUSED;
 
-        std::string getStandAction() const restrict2 A_WARN_UNUSED;
+        int getStandAction() const restrict2 A_WARN_UNUSED;
 
-        std::string getSpawnAction() const restrict2 A_WARN_UNUSED;
+        int getSpawnAction() const restrict2 A_WARN_UNUSED;
 
-        std::string getWeaponAttackAction(const ItemInfo *restrict const
-                                          weapon) const
-                                          restrict2 A_WARN_UNUSED;
+        int getWeaponAttackAction(const ItemInfo *restrict const weapon) const
+                                  restrict2 A_WARN_UNUSED;
 
-        std::string getAttackAction() const restrict2 A_WARN_UNUSED;
+        int getAttackAction() const restrict2 A_WARN_UNUSED;
 
-        std::string getAttackAction(const Attack *restrict const attack1) const
-                                    restrict2 A_WARN_UNUSED;
+        int getAttackAction(const Attack *restrict const attack1) const
+                            restrict2 A_WARN_UNUSED;
 
         /**
          * Whether or not this player is a GM.
@@ -1179,7 +1178,6 @@ class Being notfinal : public ActorSprite,
         CastingEffect *restrict mCastingEffect;
         AnimatedSprite *restrict mBadges[BadgeIndex::BadgeIndexSize];
 
-        std::string mSpriteAction;
         std::string mName;              /**< Name of being */
         std::string mExtName;           /**< Full name of being */
         std::string mRaceName;
@@ -1214,6 +1212,7 @@ class Being notfinal : public ActorSprite,
         Party *mParty;
 
         int mActionTime;      /**< Time spent in current action */
+        int mSpriteAction;    /**< Current sprite action id */
         int mEmotionTime;     /**< Time until emotion disappears */
 
         /** Time until the last speech sentence disappears */
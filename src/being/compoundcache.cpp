@@ -0,0 +1,142 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "being/compoundcache.h"
+
+#include "logger.h"
+
+#include <map>
+
+#include "debug.h"
+
+namespace
+{
+    typedef std::map<VectorPointers, CompoundItem*> CompoundItems;
+    typedef CompoundItems::iterator CompoundItemsIter;
+    typedef std::list<CompoundItem*> CompoundLru;
+
+    CompoundItems mItems;
+    // most recently used items at front
+    CompoundLru mLru;
+    size_t mMaxSize = 200;
+
+    void removeItem(CompoundItem *const item)
+    {
+        mItems.erase(item->data);
+        mLru.erase(item->lruIterator);
+        delete item;
+    }
+
+    // remove unused items from end of lru list until cache fit in size
+    void cleanUp()
+    {
+        CompoundLru::iterator it = mLru.end();
+        while (mItems.size() > mMaxSize && it != mLru.begin())
+        {
+            -- it;
+            CompoundItem *const item = *it;
+            if (item->refCount == 0)
+            {
+                // iterator to next element is still valid after erase
+                CompoundLru::iterator next = it;
+                ++ next;
+                removeItem(item);
+                it = next;
+            }
+        }
+    }
+}  // namespace
+
+CompoundItem *CompoundCache::get(const VectorPointers &data)
+{
+    const CompoundItemsIter it = mItems.find(data);
+    if (it == mItems.end())
+        return nullptr;
+    CompoundItem *const item = (*it).second;
+    item->refCount ++;
+    mLru.splice(mLru.begin(), mLru, item->lruIterator);
+    return item;
+}
+
+CompoundItem *CompoundCache::add(const VectorPointers &data,
+                                 Image *const image,
+                                 Image *const alphaImage,
+                                 const int offsetX,
+                                 const int offsetY)
+{
+    CompoundItem *item = get(data);
+    if (item != nullptr)
+    {
+        // already cached by other sprite
+        delete image;
+        delete alphaImage;
+        return item;
+    }
+
+    item = new CompoundItem;
+    item->data = data;
+    item->image = image;
+    item->alphaImage = alphaImage;
+    item->offsetX = offsetX;
+    item->offsetY = offsetY;
+    item->refCount = 1;
+    mLru.push_front(item);
+    item->lruIterator = mLru.begin();
+    mItems[data] = item;
+    cleanUp();
+    return item;
+}
+
+void CompoundCache::release(CompoundItem *const item)
+{
+    if (item == nullptr)
+        return;
+    if (item->refCount == 0)
+    {
+        logger->log1("CompoundCache: item already released");
+        return;
+    }
+    item->refCount --;
+    if (item->refCount == 0)
+        cleanUp();
+}
+
+void CompoundCache::setMaxSize(const size_t size)
+{
+    mMaxSize = size;
+    cleanUp();
+}
+
+void CompoundCache::clear()
+{
+    CompoundLru::iterator it = mLru.begin();
+    while (it != mLru.end())
+    {
+        CompoundItem *const item = *it;
+        ++ it;
+        if (item->refCount == 0)
+            removeItem(item);
+    }
+}
+
+size_t CompoundCache::size()
+{
+    return mItems.size();
+}
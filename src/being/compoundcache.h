@@ -0,0 +1,58 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BEING_COMPOUNDCACHE_H
+#define BEING_COMPOUNDCACHE_H
+
+#include "being/compounditem.h"
+
+/**
+ * Global cache of flattened compound sprite images.
+ * Key is list of current frame hashes of all layers. Frame hash already
+ * depend on sprite id, dye colors, action, direction and frame, so
+ * beings with same look share one image.
+ */
+namespace CompoundCache
+{
+    /**
+     * Returns cached item and increase its reference count,
+     * or nullptr if no image for this key.
+     */
+    CompoundItem *get(const VectorPointers &data) A_WARN_UNUSED;
+
+    /**
+     * Adds new item with reference count 1. Cache take ownership of images.
+     */
+    CompoundItem *add(const VectorPointers &data,
+                      Image *const image,
+                      Image *const alphaImage,
+                      const int offsetX,
+                      const int offsetY) A_WARN_UNUSED;
+
+    void release(CompoundItem *const item);
+
+    void setMaxSize(const size_t size);
+
+    void clear();
+
+    size_t size() A_WARN_UNUSED;
+}  // namespace CompoundCache
+
+#endif  // BEING_COMPOUNDCACHE_H
@@ -21,13 +21,15 @@
 #ifndef BEING_COMPOUNDITEM_H
 #define BEING_COMPOUNDITEM_H
 
+#include "utils/vector.h"
+
 #include <list>
 
 #include "localconsts.h"
 
 class Image;
 
-typedef std::list <const void*> VectorPointers;
+typedef STD_VECTOR<const void*> VectorPointers;
 
 class CompoundItem final
 {
@@ -39,8 +41,12 @@ class CompoundItem final
         ~CompoundItem();
 
         VectorPointers data;
+        std::list<CompoundItem*>::iterator lruIterator;
         Image *image;
         Image *alphaImage;
+        int offsetX;
+        int offsetY;
+        unsigned int refCount;
 };
 
 #endif  // BEING_COMPOUNDITEM_H
@@ -25,7 +25,7 @@
 
 #include "sdlshared.h"
 
-#include "being/compounditem.h"
+#include "being/compoundcache.h"
 
 #include "render/surfacegraphics.h"
 
@@ -62,8 +62,6 @@ PRAGMA48(GCC diagnostic pop)
 #ifndef USE_SDL2
 static const int BUFFER_WIDTH = 100;
 static const int BUFFER_HEIGHT = 100;
-static const unsigned cache_max_size = 10;
-static const unsigned cache_clean_part = 3;
 #endif  // USE_SDL2
 
 bool CompoundSprite::mEnableDelay = true;
@@ -71,7 +69,6 @@ bool CompoundSprite::mEnableDelay = true;
 CompoundSprite::CompoundSprite() :
     Sprite(),
     mSprites(),
-    imagesCache(),
     mCacheItem(nullptr),
     mImage(nullptr),
     mAlphaImage(nullptr),
@@ -93,8 +90,6 @@ CompoundSprite::CompoundSprite() :
 CompoundSprite::~CompoundSprite()
 {
     clear();
-    mImage = nullptr;
-    mAlphaImage = nullptr;
 }
 
 bool CompoundSprite::reset()
@@ -130,6 +125,25 @@ bool CompoundSprite::play(const std::string &action)
     return ret;
 }
 
+bool CompoundSprite::play(const int actionId)
+{
+    bool ret = false;
+    bool ret2 = true;
+    FOR_EACH (SpriteIterator, it, mSprites)
+    {
+        if (*it != nullptr)
+        {
+            const bool tmpVal = (*it)->play(actionId);
+            ret |= tmpVal;
+            ret2 &= tmpVal;
+        }
+    }
+    mNeedsRedraw |= ret;
+    if (ret2)
+        mLastTime = 0;
+    return ret;
+}
+
 bool CompoundSprite::update(const int time)
 {
     bool ret = false;
@@ -303,9 +317,7 @@ void CompoundSprite::clear()
         mSprites.clear();
     }
     mNeedsRedraw = true;
-    delete_all(imagesCache);
-    imagesCache.clear();
-    delete2(mCacheItem)
+    releaseImages();
     mLastTime = 0;
 }
 
@@ -372,7 +384,7 @@ void CompoundSprite::redraw() const
 
     SDL_SetAlpha(surface, 0, SDL_ALPHA_OPAQUE);
 
-    delete mAlphaImage;
+    releaseImages();
 
     if (ImageHelper::mEnableAlpha)
     {
@@ -387,7 +399,6 @@ void CompoundSprite::redraw() const
         mAlphaImage = nullptr;
     }
 
-    delete mImage;
     mImage = imageHelper->loadSurface(surface);
     MSDL_FreeSurface(surface);
 #endif  // USE_SDL2
@@ -455,89 +466,77 @@ void CompoundSprite::updateImages() const
 bool CompoundSprite::updateFromCache() const
 {
 #ifndef USE_SDL2
-//    static int hits = 0;
-//    static int miss = 0;
-
-    if ((mCacheItem != nullptr) && (mCacheItem->image != nullptr))
-    {
-        imagesCache.push_front(mCacheItem);
-        mCacheItem = nullptr;
-        if (imagesCache.size() > cache_max_size)
-        {
-            for (unsigned f = 0; f < cache_clean_part; f ++)
-            {
-                CompoundItem *item = imagesCache.back();
-                imagesCache.pop_back();
-                delete item;
-            }
-        }
-    }
-
-//    logger->log("cache size: %d, hit %d, miss %d",
-//        (int)imagesCache.size(), hits, miss);
+    VectorPointers data;
+    getCacheKey(data);
+    if (mCacheItem != nullptr && mCacheItem->data == data)
+        return true;
+
+    CompoundItem *const item = CompoundCache::get(data);
+    releaseImages();
+    if (item == nullptr)
+        return false;
+
+    mCacheItem = item;
+    mImage = item->image;
+    mAlphaImage = item->alphaImage;
+    mOffsetX = item->offsetX;
+    mOffsetY = item->offsetY;
+    return true;
+#else  // USE_SDL2
 
-    const size_t sz = mSprites.size();
-    FOR_EACH (ImagesCache::iterator, it, imagesCache)
-    {
-        CompoundItem *const ic = *it;
-        if ((ic != nullptr) && ic->data.size() == sz)
-        {
-            bool fail(false);
-            VectorPointers::const_iterator it2 = ic->data.begin();
-            const VectorPointers::const_iterator it2_end = ic->data.end();
-
-            for (SpriteConstIterator it1 = mSprites.begin(),
-                 it1_end = mSprites.end();
-                 it1 != it1_end && it2 != it2_end;
-                 ++ it1, ++ it2)
-            {
-                const void *ptr1 = nullptr;
-                const void *ptr2 = nullptr;
-                if (*it1 != nullptr)
-                    ptr1 = (*it1)->getHash();
-                if (*it2 != nullptr)
-                    ptr2 = *it2;
-                if (ptr1 != ptr2)
-                {
-                    fail = true;
-                    break;
-                }
-            }
-            if (!fail)
-            {
-//                hits ++;
-                mImage = (*it)->image;
-                mAlphaImage = (*it)->alphaImage;
-                imagesCache.erase(it);
-                mCacheItem = ic;
-                return true;
-            }
-        }
-    }
-    mImage = nullptr;
-    mAlphaImage = nullptr;
-//    miss++;
-#endif  // USE_SDL2
     return false;
+#endif  // USE_SDL2
 }
 
 void CompoundSprite::initCurrentCacheItem() const
 {
-    delete mCacheItem;
-    mCacheItem = new CompoundItem;
-    mCacheItem->image = mImage;
-    mCacheItem->alphaImage = mAlphaImage;
-//    mCacheItem->alpha = mAlpha;
+    VectorPointers data;
+    getCacheKey(data);
+    Image *const image = mImage;
+    Image *const alphaImage = mAlphaImage;
+    mImage = nullptr;
+    mAlphaImage = nullptr;
+    releaseImages();
+    mCacheItem = CompoundCache::add(data,
+        image,
+        alphaImage,
+        mOffsetX,
+        mOffsetY);
+    mImage = mCacheItem->image;
+    mAlphaImage = mCacheItem->alphaImage;
+    mOffsetX = mCacheItem->offsetX;
+    mOffsetY = mCacheItem->offsetY;
+}
 
+void CompoundSprite::getCacheKey(VectorPointers &data) const
+{
+    data.reserve(mSprites.size());
     FOR_EACH (SpriteConstIterator, it, mSprites)
     {
         if (*it != nullptr)
-            mCacheItem->data.push_back((*it)->getHash());
+            data.push_back((*it)->getHash());
         else
-            mCacheItem->data.push_back(nullptr);
+            data.push_back(nullptr);
     }
 }
 
+void CompoundSprite::releaseImages() const
+{
+    if (mCacheItem != nullptr)
+    {
+        // images owned by shared cache
+        CompoundCache::release(mCacheItem);
+        mCacheItem = nullptr;
+    }
+    else
+    {
+        delete mImage;
+        delete mAlphaImage;
+    }
+    mImage = nullptr;
+    mAlphaImage = nullptr;
+}
+
 bool CompoundSprite::updateNumber(const unsigned num)
 {
     bool res(false);
@@ -554,8 +553,12 @@ bool CompoundSprite::updateNumber(const unsigned num)
 
 CompoundItem::CompoundItem() :
     data(),
+    lruIterator(),
     image(nullptr),
-    alphaImage(nullptr)
+    alphaImage(nullptr),
+    offsetX(0),
+    offsetY(0),
+    refCount(0)
 {
 }
 
@@ -26,8 +26,6 @@
 
 #include "utils/vector.h"
 
-#include <list>
-
 #include "localconsts.h"
 
 class CompoundItem;
@@ -49,6 +47,8 @@ class CompoundSprite notfinal : public Sprite
 
         bool play(const std::string &action) override final;
 
+        bool play(const int actionId) override final;
+
         bool update(const int time) override final;
 
         void drawSimple(Graphics *const graphics,
@@ -118,8 +118,10 @@ class CompoundSprite notfinal : public Sprite
 
         void initCurrentCacheItem() const;
 
-        typedef std::list<CompoundItem*> ImagesCache;
-        mutable ImagesCache imagesCache;
+        void getCacheKey(STD_VECTOR<const void*> &data) const;
+
+        void releaseImages() const;
+
         mutable CompoundItem *mCacheItem;
 
         mutable Image *mImage;
@@ -1564,12 +1564,35 @@ bool LocalPlayer::isReachable(Being *const being,
         return true;
     }
 
+    const int startX = (mPixelX - mapTileSize / 2) / mapTileSize;
+    const int startY = (mPixelY - mapTileSize) / mapTileSize;
+    // straight line without obstacles is one of shortest paths.
+    // walls blocked for path finder in any case.
+    const unsigned char blockWalkMask = getBlockWalkMask();
+    const unsigned char lineMask = CAST_U8(blockWalkMask | BlockMask::WALL);
+    if (mMap->getWalk(being->mX, being->mY, lineMask) &&
+        mMap->lineOfSight(startX, startY, being->mX, being->mY, lineMask))
+    {
+        const int dx = abs(being->mX - startX);
+        const int dy = abs(being->mY - startY);
+        const int diagonal = std::min(dx, dy);
+        const int straight = std::max(dx, dy) - diagonal;
+        // same costs as in Map::findPath
+        if (maxCost <= 0 ||
+            diagonal * (100 * 362 / 256) + straight * 101 <= maxCost * 100)
+        {
+            being->setDistance(diagonal + straight);
+            being->setReachable(Reachable::REACH_YES);
+            return true;
+        }
+    }
+
     const Path debugPath = mMap->findPath(
-        (mPixelX - mapTileSize / 2) / mapTileSize,
-        (mPixelY - mapTileSize) / mapTileSize,
+        startX,
+        startY,
         being->mX,
         being->mY,
-        getBlockWalkMask(),
+        blockWalkMask,
         maxCost);
 
     being->setDistance(CAST_S32(debugPath.size()));
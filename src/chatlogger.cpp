@@ -27,9 +27,13 @@
 #include "fs/mkdir.h"
 
 #include "utils/cast.h"
+#include "utils/foreach.h"
+#include "utils/sdlhelper.h"
 
+#include <algorithm>
 #include <dirent.h>
 #include <iostream>
+#include <map>
 
 #ifdef WIN32
 #include <windows.h>
@@ -38,87 +42,288 @@
 #include <Carbon/Carbon.h>
 #endif  // WIN32
 
+#ifdef WIN32
+#include <io.h>
+#else  // WIN32
+#include <unistd.h>
+#endif  // WIN32
+
 #include "debug.h"
 
 ChatLogger *chatLogger = nullptr;
 
+namespace
+{
+    // seconds between syncs of written files to disk
+    const int syncTime = 5;
+    const size_t maxLineSize = 699;
+
+    typedef std::map<std::string, FILE*> LogFiles;
+    typedef LogFiles::iterator LogFilesIter;
+
+    void closeLogFiles(LogFiles &files)
+    {
+        FOR_EACH (LogFilesIter, it, files)
+        {
+            if (it->second != nullptr)
+                fclose(it->second);
+        }
+        files.clear();
+    }
+
+    void syncLogFiles(LogFiles &files)
+    {
+        FOR_EACH (LogFilesIter, it, files)
+        {
+            if (it->second == nullptr)
+                continue;
+#ifdef WIN32
+            _commit(_fileno(it->second));
+#else  // WIN32
+            fsync(fileno(it->second));
+#endif  // WIN32
+        }
+    }
+}  // namespace
+
 ChatLogger::ChatLogger() :
-    mLogFile(),
-    mLogDir(),
     mBaseLogDir(),
     mServerName(),
-    mLogFileName()
+    mDateDir(),
+    mQueue(),
+    mFileLines(),
+    mMutex(),
+    mThread(nullptr),
+    mWrittenSem(SDL_CreateSemaphore(0)),
+    mQueuedLines(0),
+    mWrittenLines(0),
+    mWaitLines(0),
+    mDateEnd(0),
+    mStop(false)
 {
 }
 
 ChatLogger::~ChatLogger()
 {
-    if (mLogFile.is_open())
-        mLogFile.close();
+    flush();
+    if (mWrittenSem != nullptr)
+        SDL_DestroySemaphore(mWrittenSem);
 }
 
-void ChatLogger::setLogFile(const std::string &logFilename)
+const std::string &ChatLogger::getDateDir()
 {
-    if (mLogFile.is_open())
-        mLogFile.close();
-
-    mLogFile.open(logFilename.c_str(),
-        std::ios_base::app);
-    mLogFileName = logFilename;
-
-    if (!mLogFile.is_open())
+    const time_t now = time(nullptr);
+    if (mDateDir.empty() || now >= mDateEnd)
     {
-        std::cout << "Warning: error while opening " <<
-            logFilename <<
-            " for writing.\n";
+        mDateDir = getDir();
+
+        // directory changes at next midnight
+        struct tm *const timeinfo = localtime(&now);
+        timeinfo->tm_sec = 0;
+        timeinfo->tm_min = 0;
+        timeinfo->tm_hour = 0;
+        timeinfo->tm_mday ++;
+        timeinfo->tm_isdst = -1;
+        mDateEnd = mktime(timeinfo);
     }
+    return mDateDir;
 }
 
-void ChatLogger::setLogDir(const std::string &logDir)
+void ChatLogger::addLine(const std::string &fileName,
+                         const std::string &str)
 {
-    mLogDir = logDir;
+    if (mThread == nullptr)
+    {
+        mStop = false;
+        mThread = SDL::createThread(&writeThread, "chatlogger", this);
+        if (mThread == nullptr)
+        {
+            writeLine(LogLine(mDateDir, fileName, str));
+            return;
+        }
+    }
 
-    if (mLogFile.is_open())
-        mLogFile.close();
+    MutexLocker lock(&mMutex);
+    mQueue.push_back(LogLine(mDateDir, fileName, str));
+    mQueuedLines ++;
+    mFileLines[fileName] = mQueuedLines;
+}
 
-    DIR *const dir = opendir(mLogDir.c_str());
+void ChatLogger::writeLine(const LogLine &line)
+{
+    DIR *const dir = opendir(line.dir.c_str());
     if (dir == nullptr)
-        mkdir_r(mLogDir.c_str());
+        mkdir_r(line.dir.c_str());
     else
         closedir(dir);
+
+    FILE *const file = fopen(line.fileName.c_str(), "ab");
+    if (file == nullptr)
+    {
+        std::cout << "Warning: error while opening " <<
+            line.fileName <<
+            " for writing.\n";
+        return;
+    }
+    fputs(line.text.c_str(), file);
+    fputc('\n', file);
+    fclose(file);
 }
 
-void ChatLogger::log(std::string str)
+void ChatLogger::waitFile(const std::string &fileName)
 {
-    const std::string &dateStr = getDir();
-    const std::string logFileName = strprintf(
-        "%s/#General.log", dateStr.c_str());
-    if (!mLogFile.is_open() ||
-        logFileName != mLogFileName)
+    if (mThread == nullptr || mWrittenSem == nullptr)
+        return;
     {
-        setLogDir(dateStr);
-        setLogFile(logFileName);
+        MutexLocker lock(&mMutex);
+        const std::map<std::string, unsigned int>::iterator it =
+            mFileLines.find(fileName);
+        if (it == mFileLines.end())
+            return;
+        if (it->second <= mWrittenLines)
+        {
+            mFileLines.erase(it);
+            return;
+        }
+        mWaitLines = it->second;
+        mFileLines.erase(it);
     }
+    // writer thread posts after flushing line mWaitLines
+    SDL_SemWait(mWrittenSem);
+}
+
+void ChatLogger::closeFiles()
+{
+    if (mThread == nullptr)
+        return;
+    MutexLocker lock(&mMutex);
+    mQueue.push_back(LogLine(std::string(), std::string(), std::string()));
+}
 
-    str = removeColors(str);
-    writeTo(mLogFile, str);
+void ChatLogger::log(std::string str)
+{
+    const std::string &dateStr = getDateDir();
+    addLine(dateStr + "/#General.log", removeColors(str));
 }
 
 void ChatLogger::log(std::string name,
                      std::string str)
 {
-    const std::string &dateStr = getDir();
-    const std::string logFileName = strprintf("%s/%s.log",
-        dateStr.c_str(), secureName(name).c_str());
+    const std::string &dateStr = getDateDir();
+    addLine(strprintf("%s/%s.log",
+        dateStr.c_str(),
+        secureName(name).c_str()),
+        removeColors(str));
+}
 
-    if (!mLogFile.is_open() || logFileName != mLogFileName)
+void ChatLogger::flush()
+{
+    if (mThread == nullptr)
+        return;
+    // writer thread saves all queued lines and closes files before exit.
+    // Next added line starts new thread.
+    mStop = true;
+    SDL::WaitThread(mThread);
+    mThread = nullptr;
+}
+
+int ChatLogger::writeThread(void *ptr)
+{
+    ChatLogger *const chatLog = static_cast<ChatLogger*>(ptr);
+    if (chatLog == nullptr)
+        return 0;
+
+    LogFiles files;
+    std::string lastDir;
+    STD_VECTOR<LogLine> lines;
+    time_t syncedTime = time(nullptr);
+    bool changed = false;
+
+    while (true)
     {
-        setLogDir(dateStr);
-        setLogFile(logFileName);
+        {
+            MutexLocker lock(&chatLog->mMutex);
+            lines.swap(chatLog->mQueue);
+        }
+
+        if (lines.empty())
+        {
+            if (chatLog->mStop)
+                break;
+            if (changed && time(nullptr) - syncedTime >= syncTime)
+            {
+                syncLogFiles(files);
+                syncedTime = time(nullptr);
+                changed = false;
+            }
+            SDL_Delay(50);
+            continue;
+        }
+
+        size_t writtenLines = 0;
+        FOR_EACH (STD_VECTOR<LogLine>::const_iterator, it, lines)
+        {
+            const LogLine &line = *it;
+            if (line.fileName.empty())
+            {
+                closeLogFiles(files);
+                lastDir.clear();
+                continue;
+            }
+            writtenLines ++;
+            if (line.dir != lastDir)
+            {
+                // date or server changed
+                closeLogFiles(files);
+                lastDir = line.dir;
+                DIR *const dir = opendir(lastDir.c_str());
+                if (dir == nullptr)
+                    mkdir_r(lastDir.c_str());
+                else
+                    closedir(dir);
+            }
+
+            FILE *&file = files[line.fileName];
+            if (file == nullptr)
+            {
+                // binary mode keeps same line ends on all systems
+                file = fopen(line.fileName.c_str(), "ab");
+                if (file == nullptr)
+                {
+                    std::cout << "Warning: error while opening " <<
+                        line.fileName <<
+                        " for writing.\n";
+                    continue;
+                }
+            }
+            fputs(line.text.c_str(), file);
+            fputc('\n', file);
+        }
+
+        FOR_EACH (LogFilesIter, it, files)
+        {
+            if (it->second != nullptr)
+                fflush(it->second);
+        }
+        changed = true;
+
+        {
+            MutexLocker lock(&chatLog->mMutex);
+            chatLog->mWrittenLines += CAST_U32(writtenLines);
+            if (chatLog->mWaitLines != 0 &&
+                chatLog->mWrittenLines >= chatLog->mWaitLines)
+            {
+                chatLog->mWaitLines = 0;
+                SDL_SemPost(chatLog->mWrittenSem);
+            }
+        }
+        lines.clear();
     }
 
-    str = removeColors(str);
-    writeTo(mLogFile, str);
+    if (changed)
+        syncLogFiles(files);
+    closeLogFiles(files);
+    return 0;
 }
 
 std::string ChatLogger::getDir() const
@@ -167,67 +372,90 @@ std::string ChatLogger::secureName(std::string &name)
     return name;
 }
 
-void ChatLogger::writeTo(std::ofstream &file,
-                         const std::string &str)
-{
-    file << str << std::endl;
-}
-
 void ChatLogger::setServerName(const std::string &serverName)
 {
     mServerName = serverName;
     if (mServerName.empty())
         mServerName = config.getStringValue("MostUsedServerName0");
 
-    if (mLogFile.is_open())
-        mLogFile.close();
-
     secureName(mServerName);
-    if (!mLogDir.empty())
-    {
-        const std::string name = pathJoin(mLogDir, mServerName);
-        DIR *const dir = opendir(name.c_str());
-        if (dir == nullptr)
-            mkdir_r(name.c_str());
-        else
-            closedir(dir);
-    }
+    mDateDir.clear();
+    closeFiles();
 }
 
 void ChatLogger::loadLast(std::string name,
                           std::list<std::string> &list,
-                          const unsigned int n) const
+                          const unsigned int n)
 {
-    std::ifstream logFile;
-    std::string fileName = strprintf("%s/%s.log",
+    const std::string fileName = strprintf("%s/%s.log",
         getDir().c_str(),
         secureName(name).c_str());
+    waitFile(fileName);
 
-    logFile.open(fileName.c_str(), std::ios::in);
-
-    if (!logFile.is_open())
+    FILE *const file = fopen(fileName.c_str(), "rb");
+    if (file == nullptr)
         return;
 
-    char line[710];
-    unsigned sz = CAST_U32(list.size());
-    while (logFile.getline(line, 700))
+    // read blocks from file end until n full lines found
+    const long blockSize = 4096;
+    STD_VECTOR<std::string> blocks;
+    unsigned int linesCount = 0;
+    long pos = 0;
+    if (fseek(file, 0, SEEK_END) == 0)
+        pos = ftell(file);
+    while (pos > 0 && linesCount <= n)
     {
-        list.push_back(line);
-        sz ++;
-        if (sz > n)
+        const long sz = std::min(pos, blockSize);
+        pos -= sz;
+        std::string block(CAST_SIZE(sz), '\0');
+        if (fseek(file, pos, SEEK_SET) != 0 ||
+            fread(&block[0], 1, CAST_SIZE(sz), file) != CAST_SIZE(sz))
         {
-            list.pop_front();
-            sz --;
+            break;
         }
+        linesCount += CAST_U32(std::count(block.begin(), block.end(), '\n'));
+        blocks.push_back(block);
+    }
+    fclose(file);
+
+    std::string data;
+    data.reserve(blocks.size() * CAST_SIZE(blockSize));
+    FOR_EACHR (STD_VECTOR<std::string>::const_reverse_iterator, it, blocks)
+        data.append(*it);
+
+    std::list<std::string> lines;
+    size_t start = 0;
+    // first line may be partially read
+    if (pos > 0)
+    {
+        start = data.find('\n');
+        if (start != std::string::npos)
+            start ++;
+    }
+    while (start < data.size())
+    {
+        size_t end = data.find('\n', start);
+        const size_t next = end == std::string::npos ? data.size() : end + 1;
+        if (end == std::string::npos)
+            end = data.size();
+        // logs written in text mode on windows
+        if (end > start && data[end - 1] == '\r')
+            end --;
+        lines.push_back(data.substr(start,
+            std::min(end - start, maxLineSize)));
+        start = next;
     }
+    while (lines.size() > n)
+        lines.pop_front();
 
-    if (logFile.is_open())
-        logFile.close();
+    list.splice(list.end(), lines);
+    while (list.size() > n)
+        list.pop_front();
 }
 
 void ChatLogger::clear()
 {
-    mLogDir.clear();
     mServerName.clear();
-    mLogFileName.clear();
+    mDateDir.clear();
+    closeFiles();
 }
@@ -23,11 +23,22 @@
 #ifndef CHATLOGGER_H
 #define CHATLOGGER_H
 
-#include <fstream>
+#include "utils/mutex.h"
+#include "utils/vector.h"
+
 #include <list>
+#include <map>
 
 #include "localconsts.h"
 
+struct SDL_semaphore;
+struct SDL_Thread;
+
+/**
+ * Chat log writer.
+ * Lines queued by main thread and written by background thread,
+ * which keeps log files open and flushes them once per batch.
+ */
 class ChatLogger final
 {
     public:
@@ -39,7 +50,7 @@ class ChatLogger final
         A_DELETE_COPY(ChatLogger)
 
         /**
-         * Destructor, closes log file.
+         * Destructor, writes queued lines and closes log files.
          */
         ~ChatLogger();
 
@@ -52,7 +63,7 @@ class ChatLogger final
 
         void loadLast(std::string name,
                       std::list<std::string> &list,
-                      const unsigned int n) const;
+                      const unsigned int n);
 
         std::string getDir() const A_WARN_UNUSED;
 
@@ -61,26 +72,76 @@ class ChatLogger final
         void setServerName(const std::string &serverName);
 
         void setBaseLogDir(const std::string &logDir)
-        { mBaseLogDir = logDir; }
+        {
+            mBaseLogDir = logDir;
+            mDateDir.clear();
+        }
 
         void clear();
 
+        /**
+         * Waits until all queued lines written.
+         */
+        void flush();
+
     private:
+        struct LogLine final
+        {
+            LogLine(const std::string &dir0,
+                    const std::string &fileName0,
+                    const std::string &text0) :
+                dir(dir0),
+                fileName(fileName0),
+                text(text0)
+            {
+            }
+
+            A_DEFAULT_COPY(LogLine)
+
+            std::string dir;
+            std::string fileName;
+            std::string text;
+        };
+
+        /**
+         * Returns log directory for current date.
+         */
+        const std::string &getDateDir() A_WARN_UNUSED;
+
+        void addLine(const std::string &fileName,
+                     const std::string &str);
+
+        /**
+         * Waits until writer thread saved all queued lines for file.
+         */
+        void waitFile(const std::string &fileName);
+
         /**
-         * Sets the file to log to and opens it
+         * Writes line without writer thread.
          */
-        void setLogFile(const std::string &logFilename);
+        static void writeLine(const LogLine &line);
 
-        void setLogDir(const std::string &logDir);
+        /**
+         * Asks writer thread to close all files.
+         */
+        void closeFiles();
 
-        static void writeTo(std::ofstream &file,
-                            const std::string &str);
+        static int writeThread(void *ptr);
 
-        std::ofstream mLogFile;
-        std::string mLogDir;
         std::string mBaseLogDir;
         std::string mServerName;
-        std::string mLogFileName;
+        std::string mDateDir;
+        STD_VECTOR<LogLine> mQueue;
+        // last queued line number for each file
+        std::map<std::string, unsigned int> mFileLines;
+        Mutex mMutex;
+        SDL_Thread *mThread;
+        SDL_semaphore *mWrittenSem;
+        unsigned int mQueuedLines;
+        unsigned int mWrittenLines;
+        unsigned int mWaitLines;
+        time_t mDateEnd;
+        volatile bool mStop;
 };
 
 extern ChatLogger *chatLogger;
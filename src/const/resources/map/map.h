@@ -25,4 +25,7 @@
 
 static const int mapTileSize = 32;
 
+// size of pre-rendered layer chunk in tiles
+static const int mapChunkSize = 8;
+
 #endif  // CONST_RESOURCES_MAP_MAP_H
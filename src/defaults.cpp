@@ -198,6 +198,7 @@ void setConfigDefaults(Configuration &cfg)
     AddDEF("rightTolerance", 100);
     AddDEF("logNpcInGui", true);
     AddDEF("download-music", true);
+    AddDEF("updateParallelDownloads", 4);
     AddDEF("guialpha", 0.8F);
     AddDEF("ChatLogLength", 0);
     AddDEF("enableChatLog", true);
@@ -262,6 +263,7 @@ void setConfigDefaults(Configuration &cfg)
     AddDEF("usePersistentIP", true);
     AddDEF("showJobExp", true);
     AddDEF("showExtMinimaps", false);
+    AddDEF("extMinimapZoom", 1);
     AddDEF("hideChatInput", true);
     AddDEF("enableAttackFilter", true);
     AddDEF("enablePickupFilter", true);
@@ -271,12 +273,18 @@ void setConfigDefaults(Configuration &cfg)
     AddDEF("useLocalTime", false);
     AddDEF("enableAdvert", true);
     AddDEF("enableMapReduce", true);
+    AddDEF("useMapCache", true);
+    AddDEF("mapChunkCache", true);
+    AddDEF("parallelMapLoad", true);
+    AddDEF("mapPreload", true);
+    AddDEF("mapPreloadMemory", 64);
     AddDEF("showPlayersStatus", true);
     AddDEF("beingopacity", false);
     AddDEF("adjustPerfomance", true);
     AddDEF("enableAlphaFix", false);
     AddDEF("disableAdvBeingCaching", true);
     AddDEF("disableBeingCaching", false);
+    AddDEF("compoundSpriteCacheSize", 200);
     AddDEF("enableReorderSprites", true);
     AddDEF("showip", false);
     AddDEF("seflMouseHeal", true);
@@ -293,6 +301,7 @@ void setConfigDefaults(Configuration &cfg)
     AddDEF("groupFriends", true);
     AddDEF("grabinput", false);
     AddDEF("usefbo", false);
+    AddDEF("windowRenderCache", false);
     AddDEF("gamma", 1);
     AddDEF("vsync", 0);
     AddDEF("enableBuggyServers", true);
@@ -0,0 +1,231 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fs/hashcache.h"
+
+#include "logger.h"
+#include "settings.h"
+
+#include "net/download.h"
+
+#include "utils/cast.h"
+#include "utils/foreach.h"
+#include "utils/parallel.h"
+#include "utils/stringutils.h"
+
+#include <fstream>
+#include <map>
+#include <sys/stat.h>
+
+#include "debug.h"
+
+namespace
+{
+    struct HashCacheEntry final
+    {
+        HashCacheEntry() :
+            size(0),
+            mtime(0),
+            inode(0),
+            adler(0)
+        {
+        }
+
+        A_DEFAULT_COPY(HashCacheEntry)
+
+        bool operator==(const HashCacheEntry &entry) const
+        {
+            return size == entry.size &&
+                mtime == entry.mtime &&
+                inode == entry.inode;
+        }
+
+        int64_t size;
+        int64_t mtime;
+        uint64_t inode;
+        unsigned long adler;
+    };
+
+    typedef std::map<std::string, HashCacheEntry> HashCacheMap;
+    typedef HashCacheMap::iterator HashCacheMapIter;
+
+    struct HashCacheTask final
+    {
+        HashCacheTask() :
+            paths(),
+            entries()
+        {
+        }
+
+        A_DELETE_COPY(HashCacheTask)
+
+        StringVect paths;
+        STD_VECTOR<HashCacheEntry> entries;
+    };
+
+    HashCacheMap mCache;
+    bool mLoaded = false;
+    bool mChanged = false;
+
+    std::string getCacheFileName()
+    {
+        return pathJoin(settings.localDataDir, "hashcache.txt");
+    }
+
+    bool statFile(const std::string &path,
+                  HashCacheEntry &entry)
+    {
+        struct stat statbuf;
+        if (stat(path.c_str(), &statbuf) != 0)
+            return false;
+        entry.size = static_cast<int64_t>(statbuf.st_size);
+        entry.mtime = static_cast<int64_t>(statbuf.st_mtime);
+        entry.inode = static_cast<uint64_t>(statbuf.st_ino);
+        return true;
+    }
+
+    unsigned long calcFile(const std::string &path)
+    {
+        FILE *const file = fopen(path.c_str(), "rb");
+        if (file == nullptr)
+            return 0;
+        const unsigned long adler = Net::Download::fadler32(file);
+        fclose(file);
+        return adler;
+    }
+
+    void calcThread(void *const data,
+                    const size_t index)
+    {
+        HashCacheTask *const task = static_cast<HashCacheTask*>(data);
+        task->entries[index].adler = calcFile(task->paths[index]);
+    }
+
+    // returns true if entry found in cache and file not changed
+    bool findEntry(const std::string &path,
+                   HashCacheEntry &entry)
+    {
+        HashCache::load();
+        if (!statFile(path, entry))
+            return false;
+        const HashCacheMapIter it = mCache.find(path);
+        if (it == mCache.end() || !((*it).second == entry))
+            return false;
+        entry.adler = (*it).second.adler;
+        return true;
+    }
+}  // namespace
+
+unsigned long HashCache::getAdler32(const std::string &path)
+{
+    HashCacheEntry entry;
+    if (findEntry(path, entry))
+        return entry.adler;
+
+    entry.adler = calcFile(path);
+    if (entry.size > 0)
+    {
+        mCache[path] = entry;
+        mChanged = true;
+    }
+    return entry.adler;
+}
+
+void HashCache::calcAdler32(const StringVect &paths)
+{
+    HashCacheTask task;
+    FOR_EACH (StringVectCIter, it, paths)
+    {
+        HashCacheEntry entry;
+        if (findEntry(*it, entry) || entry.size == 0)
+            continue;
+        task.paths.push_back(*it);
+        task.entries.push_back(entry);
+    }
+    if (task.paths.empty())
+        return;
+
+    logger->log("Calculating checksums for %u files",
+        CAST_U32(task.paths.size()));
+    Parallel::run(&calcThread, &task, task.paths.size(), 0);
+
+    const size_t sz = task.paths.size();
+    for (size_t f = 0; f < sz; f ++)
+        mCache[task.paths[f]] = task.entries[f];
+    mChanged = true;
+}
+
+void HashCache::load()
+{
+    if (mLoaded)
+        return;
+    mLoaded = true;
+    mChanged = false;
+    mCache.clear();
+
+    std::ifstream file;
+    file.open(getCacheFileName().c_str(), std::ios::in);
+    if (!file.is_open())
+        return;
+
+    HashCacheEntry entry;
+    std::string path;
+    while (file >> std::hex >> entry.adler >> std::dec
+           >> entry.size >> entry.mtime >> entry.inode)
+    {
+        file.get();
+        if (!std::getline(file, path))
+            break;
+        if (!path.empty())
+            mCache[path] = entry;
+    }
+}
+
+void HashCache::save()
+{
+    if (!mChanged)
+        return;
+    mChanged = false;
+
+    std::ofstream file;
+    file.open(getCacheFileName().c_str(), std::ios::out);
+    if (!file.is_open())
+    {
+        logger->log("Error saving hash cache: %s",
+            getCacheFileName().c_str());
+        return;
+    }
+    FOR_EACH (HashCacheMapIter, it, mCache)
+    {
+        const HashCacheEntry &entry = (*it).second;
+        file << std::hex << entry.adler << std::dec
+            << " " << entry.size
+            << " " << entry.mtime
+            << " " << entry.inode
+            << " " << (*it).first << "\n";
+    }
+}
+
+void HashCache::clear()
+{
+    mCache.clear();
+    mLoaded = false;
+    mChanged = false;
+}
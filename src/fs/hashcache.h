@@ -0,0 +1,51 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FS_HASHCACHE_H
+#define FS_HASHCACHE_H
+
+#include "utils/stringvector.h"
+
+#include "localconsts.h"
+
+/**
+ * Persistent cache of adler32 checksums for local files.
+ * Entries keyed by path and validated by file size, mtime and inode.
+ */
+namespace HashCache
+{
+    /**
+     * Returns adler32 of file. Cached value used if file not changed.
+     */
+    unsigned long getAdler32(const std::string &path) A_WARN_UNUSED;
+
+    /**
+     * Calculates in parallel checksums for all files not present in cache.
+     */
+    void calcAdler32(const StringVect &paths);
+
+    void load();
+
+    void save();
+
+    void clear();
+}  // namespace HashCache
+
+#endif  // FS_HASHCACHE_H
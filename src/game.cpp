@@ -31,6 +31,7 @@
 #include "soundmanager.h"
 #include "settings.h"
 
+#include "being/compoundcache.h"
 #include "being/crazymoves.h"
 #include "being/localplayer.h"
 #include "being/playerinfo.h"
@@ -117,6 +118,7 @@
 #include "resources/db/mapdb.h"
 
 #include "resources/map/map.h"
+#include "resources/map/mapitem.h"
 
 #include "resources/resourcemanager/resourcemanager.h"
 
@@ -159,6 +161,18 @@ Window *disconnectedDialog = nullptr;
 
 bool mStatsReUpdated = false;
 const time_t adjustDelay = 10;
+// distance in tiles to portal for start preloading destination map
+const int mapPreloadDistance = 15;
+
+static std::string getRealMapPath(const std::string &mapName)
+{
+    std::string realFullMap = pathJoin(paths.getValue("maps", "maps/"),
+        MapDB::getMapName(mapName)).append(".tmx");
+
+    if (!VirtFs::exists(realFullMap))
+        realFullMap.append(".gz");
+    return realFullMap;
+}
 
 /**
  * Initialize every game sub-engines in the right order
@@ -402,6 +416,7 @@ static void destroyGuiWindows()
 Game *Game::mInstance = nullptr;
 
 Game::Game() :
+    mPortalMapPaths(),
     mCurrentMap(nullptr),
     mMapName(""),
     mValidSpeed(true),
@@ -442,6 +457,8 @@ Game::Game() :
 
     CompoundSprite::setEnableDelay(
         config.getBoolValue("enableCompoundSpriteDelay"));
+    CompoundCache::setMaxSize(
+        config.getIntValue("compoundSpriteCacheSize"));
 
     createGuiWindows();
     windowMenu = new WindowMenu(nullptr);
@@ -482,6 +499,7 @@ Game::~Game()
 #ifdef USE_OPENGL
     MapReader::unloadEmptyAtlas();
 #endif  // USE_OPENGL
+    MapReader::unloadPreload();
 
     settings.disableLoggingInGame = false;
     touchManager.setInGame(false);
@@ -512,6 +530,7 @@ Game::~Game()
     delete2(emptyBeingSlot)
 
     Being::clearCache();
+    CompoundCache::clear();
     mInstance = nullptr;
     PlayerInfo::gameDestroyed();
 }
@@ -707,6 +726,19 @@ void Game::slowLogic()
         }
         if (effectManager != nullptr)
             effectManager->logic();
+
+        if (mCurrentMap != nullptr && localPlayer != nullptr)
+        {
+            const MapItem *const portal = mCurrentMap->findNearestPortal(
+                localPlayer->getTileX(),
+                localPlayer->getTileY(),
+                mapPreloadDistance);
+            if (portal != nullptr)
+            {
+                MapReader::preloadMap(getPortalMapPath(
+                    portal->getDestination()));
+            }
+        }
     }
 
     if (mainGraphics->getOpenGL() != RENDER_SOFTWARE)
@@ -721,6 +753,8 @@ void Game::slowLogic()
 
     if (skillDialog != nullptr)
         skillDialog->slowLogic();
+    if (minimap != nullptr)
+        minimap->slowLogic();
 
     PacketCounters::update();
 
@@ -1085,6 +1119,18 @@ void Game::handleInput()
     BLOCK_END("Game::handleInput 1")
 }
 
+const std::string &Game::getPortalMapPath(const std::string &mapName)
+{
+    std::map<std::string, std::string>::const_iterator it =
+        mPortalMapPaths.find(mapName);
+    if (it == mPortalMapPaths.end())
+    {
+        it = mPortalMapPaths.insert(std::make_pair(mapName,
+            getRealMapPath(mapName))).first;
+    }
+    return (*it).second;
+}
+
 /**
  * Changes the currently active map. Should only be called while the game is
  * running.
@@ -1118,14 +1164,11 @@ void Game::changeMap(const std::string &mapPath)
         particleEngine->clear();
 
     mMapName = mapPath;
+    mPortalMapPaths.clear();
 
     std::string fullMap = pathJoin(paths.getValue("maps", "maps/"),
         mMapName).append(".tmx");
-    std::string realFullMap = pathJoin(paths.getValue("maps", "maps/"),
-        MapDB::getMapName(mMapName)).append(".tmx");
-
-    if (!VirtFs::exists(realFullMap))
-        realFullMap.append(".gz");
+    const std::string realFullMap = getRealMapPath(mMapName);
 
     // Attempt to load the new map
     Map *const newMap = MapReader::readMap(fullMap, realFullMap);
@@ -25,6 +25,7 @@
 
 #include "enums/input/inputaction.h"
 
+#include <map>
 #include <string>
 
 #include "localconsts.h"
@@ -139,6 +140,10 @@ class Game final
     private:
         void clearKeysArray();
 
+        const std::string &getPortalMapPath(const std::string &mapName);
+
+        // resolved map file paths of current map portals
+        std::map<std::string, std::string> mPortalMapPaths;
         Map *mCurrentMap;
         std::string mMapName;
         bool mValidSpeed;
@@ -1016,6 +1016,7 @@ void GraphicsManager::initOpenGLFunctions()
     const bool is11 = checkGLVersion(1, 1);
     const bool is12 = checkGLVersion(1, 2);
     const bool is13 = checkGLVersion(1, 3);
+    const bool is14 = checkGLVersion(1, 4);
     const bool is15 = checkGLVersion(1, 5);
     const bool is20 = checkGLVersion(2, 0);
     const bool is21 = checkGLVersion(2, 1);
@@ -1178,6 +1179,20 @@ void GraphicsManager::initOpenGLFunctions()
         config.setValue("usefbo", false);
     }
 
+    if (is14)
+    {
+        assignFunction(glBlendFuncSeparate)
+    }
+    else if (supportExtension("GL_EXT_blend_func_separate"))
+    {
+        logger->log1("found GL_EXT_blend_func_separate");
+        assignFunctionEXT(glBlendFuncSeparate)
+    }
+    else
+    {
+        logger->log1("GL_EXT_blend_func_separate not found");
+    }
+
     // debug extensions
     if (is43 || supportExtension("GL_KHR_debug"))
     {
@@ -123,6 +123,7 @@ Gui::Gui() :
     mClickCount(1),
     mLastMouseDragButton(MouseButton::EMPTY),
     mWidgetWithMouseQueue(),
+    mMouseListeners(),
     mConfigListener(new GuiConfigListener(this)),
     mGuiFont(nullptr),
     mInfoParticleFont(nullptr),
@@ -352,7 +353,6 @@ void Gui::slowLogic()
     const time_t time = cur_time;
     if (mTime != time)
     {
-        logger->flush();
         if (ipc != nullptr)
             ipc->flush();
         mTime = time;
@@ -899,48 +899,54 @@ void Gui::distributeMouseEvent(Widget *const source,
             event.setX(x - widgetX);
             event.setY(y - widgetY);
 
-            std::list<MouseListener*> mouseListeners
+            const std::list<MouseListener*> &widgetListeners
                 = widget->getMouseListeners();
+            const size_t listenersStart = mMouseListeners.size();
+            mMouseListeners.insert(mMouseListeners.end(),
+                widgetListeners.begin(),
+                widgetListeners.end());
+            const size_t listenersEnd = mMouseListeners.size();
 
             const MouseEventTypeT mouseType = event.getType();
             // Send the event to all mouse listeners of the widget.
-            FOR_EACH (std::list<MouseListener*>::const_iterator,
-                 it, mouseListeners)
+            for (size_t f = listenersStart; f < listenersEnd; f ++)
             {
+                MouseListener *const listener = mMouseListeners[f];
                 switch (mouseType)
                 {
                     case MouseEventType::ENTERED:
-                        (*it)->mouseEntered(event);
+                        listener->mouseEntered(event);
                         break;
                     case MouseEventType::EXITED:
-                        (*it)->mouseExited(event);
+                        listener->mouseExited(event);
                         break;
                     case MouseEventType::MOVED:
-                        (*it)->mouseMoved(event);
+                        listener->mouseMoved(event);
                         break;
                     case MouseEventType::PRESSED:
-                        (*it)->mousePressed(event);
+                        listener->mousePressed(event);
                         break;
                     case MouseEventType::RELEASED:
                     case MouseEventType::RELEASED2:
-                        (*it)->mouseReleased(event);
+                        listener->mouseReleased(event);
                         break;
                     case MouseEventType::WHEEL_MOVED_UP:
-                        (*it)->mouseWheelMovedUp(event);
+                        listener->mouseWheelMovedUp(event);
                         break;
                     case MouseEventType::WHEEL_MOVED_DOWN:
-                        (*it)->mouseWheelMovedDown(event);
+                        listener->mouseWheelMovedDown(event);
                         break;
                     case MouseEventType::DRAGGED:
-                        (*it)->mouseDragged(event);
+                        listener->mouseDragged(event);
                         break;
                     case MouseEventType::CLICKED:
-                        (*it)->mouseClicked(event);
+                        listener->mouseClicked(event);
                         break;
                     default:
                         break;
                 }
             }
+            mMouseListeners.resize(listenersStart);
 
             if (toSourceOnly)
                 break;
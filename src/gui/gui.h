@@ -73,6 +73,8 @@
 
 #include "enums/resources/cursor.h"
 
+#include "utils/vector.h"
+
 #include <deque>
 #include <list>
 
@@ -88,6 +90,7 @@ class KeyEvent;
 class KeyListener;
 class MouseEvent;
 class MouseInput;
+class MouseListener;
 class Font;
 class SDLInput;
 class Widget;
@@ -485,6 +488,13 @@ class Gui final
          */
         std::deque<Widget*> mWidgetWithMouseQueue;
 
+        /**
+         * Listeners of widgets handled by distributeMouseEvent.
+         * Copied here before calling, because listener can remove itself.
+         * Nested calls add own listeners after parent call ones.
+         */
+        STD_VECTOR<MouseListener*> mMouseListeners;
+
         GuiConfigListener *mConfigListener;
         /** The global GUI font */
         Font *mGuiFont A_NONNULLPOINTER;
@@ -61,6 +61,17 @@ void TableModel::signalAfterUpdate()
     }
 }
 
+void TableModel::signalCellUpdate(const int row,
+                                  const int column,
+                                  const bool completed)
+{
+    for (std::set<TableModelListener *>::const_iterator it = listeners.begin();
+         it != listeners.end(); ++it)
+    {
+        if (*it != nullptr)
+            (*it)->cellUpdated(row, column, completed);
+    }
+}
 
 #define WIDGET_AT(row, column) (((row) * mColumns) + (column))
 #define DYN_SIZE(h) ((h) >= 0)
@@ -112,13 +123,13 @@ void StaticTableModel::set(const int row, const int column,
         mWidths[column] = widget->getWidth();
     }
 
-    signalBeforeUpdate();
+    signalCellUpdate(row, column, false);
 
     delete mTableModel[WIDGET_AT(row, column)];
 
     mTableModel[WIDGET_AT(row, column)] = widget;
 
-    signalAfterUpdate();
+    signalCellUpdate(row, column, true);
 }
 
 Widget *StaticTableModel::getElementAt(const int row,
@@ -91,6 +91,13 @@ class TableModel notfinal
          */
         virtual void signalAfterUpdate();
 
+        /**
+         * Tells all listeners that one cell is updated
+         */
+        virtual void signalCellUpdate(const int row,
+                                      const int column,
+                                      const bool completed);
+
     private:
         std::set<TableModelListener *> listeners;
 };
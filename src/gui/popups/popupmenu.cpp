@@ -115,6 +115,7 @@ PopupMenu::PopupMenu() :
     mTab(nullptr),
     mSpell(nullptr),
     mCallerWindow(nullptr),
+    mCallerWindowHandle(),
     mRenameListener(),
     mPlayerListener(),
     mDialog(nullptr),
@@ -810,7 +811,7 @@ void PopupMenu::showMapPopup(const int x, const int y,
     mY = y2;
 
     if (isMinimap)
-        mCallerWindow = minimap;
+        setCallerWindow(minimap);
 
     mBrowserBox->clearRows();
 
@@ -854,7 +855,7 @@ void PopupMenu::showOutfitsWindowPopup(const int x, const int y)
     initPopup();
     mX = x;
     mY = y;
-    mCallerWindow = outfitWindow;
+    setCallerWindow(outfitWindow);
 
     mBrowserBox->clearRows();
 
@@ -922,7 +923,7 @@ void PopupMenu::showChatPopup(const int x, const int y, ChatTab *const tab)
     mTab = tab;
     mX = x;
     mY = y;
-    mCallerWindow = chatWindow;
+    setCallerWindow(chatWindow);
 
     mBrowserBox->clearRows();
 
@@ -1167,7 +1168,7 @@ void PopupMenu::showWindowPopup(Window *const window)
 
     initPopup();
     setMousePos();
-    mCallerWindow = window;
+    setCallerWindow(window);
     mBrowserBox->clearRows();
     // TRANSLATORS: popup menu header
     mBrowserBox->addRow(_("window"), false);
@@ -1365,17 +1366,17 @@ void PopupMenu::handleLink(const std::string &link,
     }
     else if (link == "window close" && (mCallerWindow != nullptr))
     {
-        if (Widget::widgetExists(mCallerWindow))
+        if (Widget::widgetExists(mCallerWindowHandle))
             mCallerWindow->close();
     }
     else if (link == "window unlock" && (mCallerWindow != nullptr))
     {
-        if (Widget::widgetExists(mCallerWindow))
+        if (Widget::widgetExists(mCallerWindowHandle))
             mCallerWindow->setSticky(false);
     }
     else if (link == "window lock" && (mCallerWindow != nullptr))
     {
-        if (Widget::widgetExists(mCallerWindow))
+        if (Widget::widgetExists(mCallerWindowHandle))
             mCallerWindow->setSticky(true);
     }
     else if (link == "join chat" && (being != nullptr))
@@ -1564,7 +1565,7 @@ void PopupMenu::handleLink(const std::string &link,
     mMapItem = nullptr;
     mTab = nullptr;
     mSpell = nullptr;
-    mCallerWindow = nullptr;
+    setCallerWindow(nullptr);
     mDialog = nullptr;
     mButton = nullptr;
     mName.clear();
@@ -1590,7 +1591,7 @@ void PopupMenu::showPopup(Window *const parent,
     for (int f = 0; f < maxCards; f ++)
         mItemCards[f] = item->getCard(f);
     mItemColor = item->getColor();
-    mCallerWindow = parent;
+    setCallerWindow(parent);
     mX = x;
     mY = y;
     mName.clear();
@@ -2768,7 +2769,7 @@ void PopupMenu::clear()
     mMapItem = nullptr;
     mTab = nullptr;
     mSpell = nullptr;
-    mCallerWindow = nullptr;
+    setCallerWindow(nullptr);
     mButton = nullptr;
     mTextField = nullptr;
 }
@@ -3616,6 +3617,15 @@ void PopupMenu::showFriendsPopup()
     showPopup(mX, mY);
 }
 
+void PopupMenu::setCallerWindow(Window *const window)
+{
+    mCallerWindow = window;
+    if (window != nullptr)
+        mCallerWindowHandle = window->getHandle();
+    else
+        mCallerWindowHandle = WidgetHandle();
+}
+
 void PopupMenu::moveUp()
 {
     mBrowserBox->moveSelectionUp();
@@ -37,6 +37,7 @@
 
 #include "gui/widgets/linkhandler.h"
 #include "gui/widgets/popup.h"
+#include "gui/widgets/widgethandle.h"
 
 #include "listeners/playerlistener.h"
 #include "listeners/renamelistener.h"
@@ -280,6 +281,8 @@ class PopupMenu final : public Popup, public LinkHandler
 
         void addSocialMenu();
 
+        void setCallerWindow(Window *const window);
+
         bool addBeingMenu();
 
         StaticBrowserBox *mBrowserBox A_NONNULLPOINTER;
@@ -295,6 +298,7 @@ class PopupMenu final : public Popup, public LinkHandler
         ChatTab *mTab;
         TextCommand *mSpell;
         Window *mCallerWindow;
+        WidgetHandle mCallerWindowHandle;
         RenameListener mRenameListener;
         PlayerListener mPlayerListener;
         TextDialog *mDialog;
@@ -26,9 +26,12 @@
 
 #include "configuration.h"
 #include "graphicsmanager.h"
+#include "settings.h"
 
 #include "const/gui/theme.h"
 
+#include "fs/mkdir.h"
+
 #include "fs/virtfs/fs.h"
 #include "fs/virtfs/list.h"
 
@@ -37,10 +40,13 @@
 
 #include "resources/imagerect.h"
 
+#include "resources/atlas/atlasresource.h"
+
 #include "resources/dye/dyepalette.h"
 
 #include "resources/image/image.h"
 
+#include "resources/loaders/atlasloader.h"
 #include "resources/loaders/imageloader.h"
 #include "resources/loaders/imagesetloader.h"
 #include "resources/loaders/subimageloader.h"
@@ -50,10 +56,17 @@
 #include "utils/dtor.h"
 #include "utils/foreach.h"
 
+#include <cstdio>
+
 #include "debug.h"
 
 static std::string defaultThemePath;
 
+// "MPTA" in native byte order
+static const int atlasListMagic = 0x4154504d;
+static const int atlasListVersion = 1;
+static const int atlasMaxPathSize = 4096;
+
 std::string Theme::mThemePath;
 std::string Theme::mThemeName;
 std::string Theme::mScreenDensity;
@@ -79,7 +92,11 @@ Theme::Theme() :
     mSkins(),
     mMinimumOpacity(-1.0F),
     mProgressColors(ProgressColors(CAST_SIZE(
-                    ProgressColorId::THEME_PROG_END)))
+                    ProgressColorId::THEME_PROG_END))),
+    mUsedImages(),
+    mSavedImages(),
+    mAtlasImages(),
+    mAtlas(nullptr)
 {
     initDefaultThemePath();
 
@@ -145,10 +162,18 @@ Theme::Theme() :
 
 Theme::~Theme()
 {
+    saveAtlasList();
     delete_all(mSkins);
     config.removeListener("guialpha", this);
     CHECKLISTENERS
     delete_all(mProgressColors);
+#ifdef USE_OPENGL
+    if (mAtlas != nullptr)
+    {
+        mAtlas->decRef();
+        mAtlas = nullptr;
+    }
+#endif  // USE_OPENGL
 }
 
 Color Theme::getProgressColor(const ProgressColorIdT type,
@@ -653,13 +678,146 @@ std::string Theme::resolveThemePath(const std::string &path)
 
 Image *Theme::getImageFromTheme(const std::string &path)
 {
-    return Loader::getImage(resolveThemePath(path));
+    const std::string fullPath = resolveThemePath(path);
+    if (theme != nullptr)
+        theme->mUsedImages.insert(fullPath);
+    return Loader::getImage(fullPath);
 }
 
 ImageSet *Theme::getImageSetFromTheme(const std::string &path,
                                       const int w, const int h)
 {
-    return Loader::getImageSet(resolveThemePath(path), w, h);
+    const std::string fullPath = resolveThemePath(path);
+    if (theme != nullptr)
+        theme->mUsedImages.insert(fullPath);
+    return Loader::getImageSet(fullPath, w, h);
+}
+
+std::string Theme::getAtlasFileName()
+{
+    std::string name = mThemePath;
+    replaceAll(name, "/", "_");
+    return pathJoin(pathJoin(settings.localDataDir, "themecache"),
+        name + ".bin");
+}
+
+bool Theme::readAtlasList(const std::string &fileName,
+                          StringVect &images)
+{
+    images.clear();
+    FILE *const file = fopen(fileName.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    int header[3] = { 0, 0, 0 };
+    bool ok = fread(header, sizeof(header), 1, file) == 1 &&
+        header[0] == atlasListMagic &&
+        header[1] == atlasListVersion &&
+        header[2] >= 0;
+    const int count = ok ? header[2] : 0;
+    for (int f = 0; ok && f < count; f ++)
+    {
+        int len = 0;
+        ok = fread(&len, sizeof(int), 1, file) == 1 &&
+            len > 0 &&
+            len < atlasMaxPathSize;
+        if (!ok)
+            break;
+        std::string path(CAST_SIZE(len), '\0');
+        ok = fread(&path[0], 1, CAST_SIZE(len), file) == CAST_SIZE(len);
+        if (ok)
+            images.push_back(path);
+    }
+    // data after last path mean broken file too
+    if (ok && fgetc(file) != EOF)
+        ok = false;
+    fclose(file);
+
+    if (!ok)
+    {
+        logger->log("Theme atlas list broken: %s", fileName.c_str());
+        images.clear();
+    }
+    return ok;
+}
+
+bool Theme::writeAtlasList(const std::string &fileName,
+                           const std::set<std::string> &images)
+{
+    const std::string tempName = fileName + ".tmp";
+    FILE *const file = fopen(tempName.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    const int header[3] =
+    {
+        atlasListMagic,
+        atlasListVersion,
+        CAST_S32(images.size())
+    };
+    bool ok = fwrite(header, sizeof(header), 1, file) == 1;
+    FOR_EACH (std::set<std::string>::const_iterator, it, images)
+    {
+        if (!ok)
+            break;
+        const std::string &path = *it;
+        const int len = CAST_S32(path.size());
+        ok = fwrite(&len, sizeof(int), 1, file) == 1 &&
+            fwrite(path.c_str(), 1, path.size(), file) == path.size();
+    }
+    if (fclose(file) != 0)
+        ok = false;
+
+    if (ok)
+    {
+#ifdef WIN32
+        ::remove(fileName.c_str());
+#endif  // WIN32
+        ok = ::rename(tempName.c_str(), fileName.c_str()) == 0;
+    }
+    if (!ok)
+    {
+        logger->log("Error writing theme atlas list: %s", fileName.c_str());
+        ::remove(tempName.c_str());
+    }
+    return ok;
+}
+
+void Theme::loadAtlas()
+{
+#ifdef USE_OPENGL
+    if (!graphicsManager.getUseAtlases() || mAtlas != nullptr)
+        return;
+
+    if (!readAtlasList(getAtlasFileName(), mAtlasImages))
+        return;
+    mSavedImages.insert(mAtlasImages.begin(), mAtlasImages.end());
+    if (mAtlasImages.empty())
+        return;
+
+    mAtlas = Loader::getAtlas("theme", mAtlasImages);
+    logger->log("Theme atlas loaded: %d images",
+        CAST_S32(mAtlasImages.size()));
+#endif  // USE_OPENGL
+}
+
+void Theme::saveAtlasList()
+{
+#ifdef USE_OPENGL
+    if (!graphicsManager.getUseAtlases())
+        return;
+
+    // images not used in this run removed from list
+    if (mUsedImages == mSavedImages)
+        return;
+
+    const std::string dir = pathJoin(settings.localDataDir, "themecache");
+    if (mkdir_r(dir.c_str()) != 0)
+        return;
+
+    if (writeAtlasList(getAtlasFileName(), mUsedImages))
+        mSavedImages = mUsedImages;
+#endif  // USE_OPENGL
 }
 
 #define themeEnumStart(name) #name,
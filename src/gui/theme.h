@@ -36,8 +36,11 @@
 
 #include "utils/stringvector.h"
 
+#include <set>
+
 #include "localconsts.h"
 
+class AtlasResource;
 class DyePalette;
 class Image;
 class ImageRect;
@@ -63,6 +66,18 @@ class Theme final : public Palette,
 
         static void selectSkin();
 
+        /**
+         * Packs theme images used in previous runs into one atlas.
+         * Without saved images list skins use separate images.
+         */
+        void loadAtlas();
+
+        /**
+         * Saves images used in this run as atlas list for next run.
+         * Images not used in this run are dropped from list.
+         */
+        void saveAtlasList();
+
         static std::string getThemePath() A_WARN_UNUSED
         { return mThemePath; }
 
@@ -180,6 +195,16 @@ class Theme final : public Palette,
 
         static ThemeInfo *loadInfo(const std::string &themeName) A_WARN_UNUSED;
 
+#ifndef UNITTESTS
+    private:
+#endif  // UNITTESTS
+        static bool readAtlasList(const std::string &fileName,
+                                  StringVect &images) A_WARN_UNUSED;
+
+        static bool writeAtlasList(const std::string &fileName,
+                                   const std::set<std::string> &images)
+                                   A_WARN_UNUSED;
+
     private:
         Skin *readSkin(const std::string &filename0,
                        const bool full) A_WARN_UNUSED;
@@ -198,6 +223,8 @@ class Theme final : public Palette,
 
         void loadColors(std::string file);
 
+        static std::string getAtlasFileName() A_WARN_UNUSED;
+
         /**
          * Tells if the current skins opacity
          * should not get less than the given value
@@ -206,6 +233,13 @@ class Theme final : public Palette,
 
         typedef STD_VECTOR<DyePalette*> ProgressColors;
         ProgressColors mProgressColors;
+
+        // images loaded from theme in this run
+        std::set<std::string> mUsedImages;
+        // images in saved atlas list
+        std::set<std::string> mSavedImages;
+        StringVect mAtlasImages;
+        AtlasResource *mAtlas;
 };
 
 #endif  // GUI_THEME_H
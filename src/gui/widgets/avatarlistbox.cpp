@@ -737,4 +737,29 @@ void AvatarListBox::optionChanged(const std::string &value)
         mShowGender = config.getBoolValue("showgender");
     else if (value == "showlevel")
         mShowLevel = config.getBoolValue("showlevel");
+    contentChanged();
+}
+
+size_t AvatarListBox::getRowHash(const int row) const
+{
+    AvatarListModel *const model = static_cast<AvatarListModel *>(
+        mListModel);
+    const Avatar *const a = model->getAvatarAt(row);
+    if (a == nullptr)
+        return 0U;
+
+    size_t hash = hashContent(0U, a->getComplexName());
+    hash = hashContent(hash, a->getAdditionString());
+    hash = hashContent(hash, a->getMap());
+    hash = hashContent(hash, CAST_SIZE(a->getHp()));
+    hash = hashContent(hash, CAST_SIZE(a->getMaxHp()));
+    hash = hashContent(hash, CAST_SIZE(a->getDamageHp()));
+    hash = hashContent(hash, CAST_SIZE(a->getLevel()));
+    hash = hashContent(hash, CAST_SIZE(a->getX()));
+    hash = hashContent(hash, CAST_SIZE(a->getY()));
+    hash = hashContent(hash, CAST_SIZE(a->getType()));
+    hash = hashContent(hash, CAST_SIZE(a->getGender()));
+    hash = hashContent(hash, CAST_SIZE(a->getOnline()));
+    hash = hashContent(hash, CAST_SIZE(a->getPoison()));
+    return hashContent(hash, CAST_SIZE(a->getDisplayBold()));
 }
@@ -51,6 +51,9 @@ class AvatarListBox final : public ListBox,
 
         void optionChanged(const std::string &value) override final;
 
+    protected:
+        size_t getRowHash(const int row) const override final A_WARN_UNUSED;
+
     private:
         int mImagePadding;
         bool mShowGender;
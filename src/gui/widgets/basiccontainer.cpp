@@ -63,6 +63,7 @@
 
 #include "gui/widgets/basiccontainer.h"
 
+#include "utils/cast.h"
 #include "utils/checkutils.h"
 #include "utils/foreach.h"
 
@@ -72,6 +73,13 @@
 
 #include "debug.h"
 
+namespace
+{
+    // containers with less children checked without index
+    const size_t minIndexedWidgets = 16;
+    const size_t maxIndexBands = 256;
+}  // namespace
+
 BasicContainer::~BasicContainer()
 {
     // +++ virtual method call
@@ -92,6 +100,7 @@ void BasicContainer::moveToTop(Widget *const widget) restrict2
         {
             mWidgets.erase(iter);
             mWidgets.push_back(widget);
+            mIndexDirty = true;
             break;
         }
     }
@@ -119,6 +128,7 @@ void BasicContainer::moveToBottom(Widget *const widget) restrict2
     {
         mWidgets.erase(iter);
         mWidgets.insert(mWidgets.begin(), widget);
+        mIndexDirty = true;
     }
 
     const WidgetListIterator iter2 = std::find(mLogicWidgets.begin(),
@@ -135,7 +145,10 @@ void BasicContainer::death(const Event &restrict event) restrict2
     const WidgetListIterator iter = std::find(mWidgets.begin(),
         mWidgets.end(), event.getSource());
     if (iter != mWidgets.end())
+    {
         mWidgets.erase(iter);
+        mIndexDirty = true;
+    }
 
     const WidgetListIterator iter2 = std::find(mLogicWidgets.begin(),
         mLogicWidgets.end(), event.getSource());
@@ -218,20 +231,109 @@ Widget *BasicContainer::getWidgetAt(int x, int y) restrict2
     x -= r.x;
     y -= r.y;
 
-    for (WidgetListReverseIterator it = mWidgets.rbegin();
-         it != mWidgets.rend(); ++ it)
+    if (mIndexDirty)
+        updateIndex();
+
+    if (mIndexStarts.empty())
     {
-        const Widget *restrict const widget = *it;
+        for (WidgetListReverseIterator it = mWidgets.rbegin();
+             it != mWidgets.rend(); ++ it)
+        {
+            const Widget *restrict const widget = *it;
+            if (widget->isVisible() &&
+                widget->getDimension().isPointInRect(x, y))
+            {
+                return *it;
+            }
+        }
+        return nullptr;
+    }
+
+    if (y < mIndexTop)
+        return nullptr;
+    const size_t band = CAST_SIZE((y - mIndexTop) / mIndexBandHeight);
+    if (band + 1 >= mIndexStarts.size())
+        return nullptr;
+
+    // items in band sorted in mWidgets order, so top widget is last
+    const unsigned int start = mIndexStarts[band];
+    for (unsigned int f = mIndexStarts[band + 1]; f > start; f --)
+    {
+        Widget *restrict const widget = mWidgets[mIndexItems[f - 1]];
         if (widget->isVisible() &&
             widget->getDimension().isPointInRect(x, y))
         {
-            return *it;
+            return widget;
         }
     }
-
     return nullptr;
 }
 
+void BasicContainer::updateIndex() restrict2
+{
+    mIndexDirty = false;
+    mIndexStarts.clear();
+    mIndexItems.clear();
+
+    const size_t sz = mWidgets.size();
+    if (sz < minIndexedWidgets)
+        return;
+
+    int top = 0;
+    int bottom = 0;
+    bool found = false;
+    FOR_EACH (WidgetListConstIterator, it, mWidgets)
+    {
+        const Rect &rect = (*it)->getDimension();
+        if (rect.width <= 0 || rect.height <= 0)
+            continue;
+        if (!found || rect.y < top)
+            top = rect.y;
+        if (!found || rect.y + rect.height > bottom)
+            bottom = rect.y + rect.height;
+        found = true;
+    }
+    if (!found)
+        return;
+
+    const int height = bottom - top;
+    int bands = CAST_S32(std::min(sz, maxIndexBands));
+    mIndexTop = top;
+    mIndexBandHeight = (height + bands - 1) / bands;
+    bands = (height + mIndexBandHeight - 1) / mIndexBandHeight;
+
+    // count items in each band, then place them
+    mIndexStarts.resize(CAST_SIZE(bands + 1), 0U);
+    for (size_t f = 0; f < sz; f ++)
+    {
+        const Rect &rect = mWidgets[f]->getDimension();
+        if (rect.width <= 0 || rect.height <= 0)
+            continue;
+        const int band1 = (rect.y - top) / mIndexBandHeight;
+        const int band2 = (rect.y + rect.height - 1 - top) /
+            mIndexBandHeight;
+        for (int band = band1; band <= band2; band ++)
+            mIndexStarts[CAST_SIZE(band + 1)] ++;
+    }
+    for (int band = 0; band < bands; band ++)
+        mIndexStarts[CAST_SIZE(band + 1)] += mIndexStarts[CAST_SIZE(band)];
+
+    mIndexItems.resize(mIndexStarts[CAST_SIZE(bands)]);
+    STD_VECTOR<unsigned int> pos(mIndexStarts.begin(),
+        mIndexStarts.end() - 1);
+    for (size_t f = 0; f < sz; f ++)
+    {
+        const Rect &rect = mWidgets[f]->getDimension();
+        if (rect.width <= 0 || rect.height <= 0)
+            continue;
+        const int band1 = (rect.y - top) / mIndexBandHeight;
+        const int band2 = (rect.y + rect.height - 1 - top) /
+            mIndexBandHeight;
+        for (int band = band1; band <= band2; band ++)
+            mIndexItems[pos[CAST_SIZE(band)] ++] = CAST_U32(f);
+    }
+}
+
 void BasicContainer::logic() restrict2
 {
     BLOCK_START("BasicContainer::logic")
@@ -261,6 +363,7 @@ void BasicContainer::add(Widget *const widget) restrict2
     if (widget == nullptr)
         return;
     mWidgets.push_back(widget);
+    mIndexDirty = true;
     if (widget->isAllowLogic())
         mLogicWidgets.push_back(widget);
 
@@ -282,6 +385,7 @@ void BasicContainer::remove(Widget *const restrict widget) restrict2
         if (*iter == widget)
         {
             mWidgets.erase(iter);
+            mIndexDirty = true;
             widget->setFocusHandler(nullptr);
             widget->setWindow(nullptr);
             widget->setParent(nullptr);
@@ -312,6 +416,7 @@ void BasicContainer::clear() restrict2
 
     mWidgets.clear();
     mLogicWidgets.clear();
+    mIndexDirty = true;
 }
 
 void BasicContainer::drawChildren(Graphics *const restrict graphics) restrict2
@@ -83,7 +83,12 @@ class BasicContainer notfinal : public Widget,
             Widget(widget),
             WidgetDeathListener(),
             mWidgets(),
-            mLogicWidgets()
+            mLogicWidgets(),
+            mIndexStarts(),
+            mIndexItems(),
+            mIndexTop(0),
+            mIndexBandHeight(1),
+            mIndexDirty(true)
         { }
 
         A_DELETE_COPY(BasicContainer)
@@ -129,6 +134,9 @@ class BasicContainer notfinal : public Widget,
 
         Widget *getWidgetAt(int x, int y) restrict2 override A_WARN_UNUSED;
 
+        void childDimensionChanged() restrict2 override
+        { mIndexDirty = true; }
+
         // Inherited from WidgetDeathListener
 
         void death(const Event &restrict event) restrict2 override;
@@ -208,6 +216,29 @@ class BasicContainer notfinal : public Widget,
         WidgetList mWidgets;
 
         WidgetList mLogicWidgets;
+
+        /**
+          * Index of children for hit testing. Container area split to
+          * horizontal bands, and mIndexItems holds indexes in mWidgets of
+          * children crossing each band, from mIndexStarts[band] to
+          * mIndexStarts[band + 1].
+          * Built only for containers with many children.
+          */
+        STD_VECTOR<unsigned int> mIndexStarts;
+
+        STD_VECTOR<unsigned int> mIndexItems;
+
+        int mIndexTop;
+
+        int mIndexBandHeight;
+
+        /**
+          * Should be set after mWidgets changed or reordered.
+          */
+        bool mIndexDirty;
+
+    private:
+        void updateIndex() restrict2;
 };
 
 #endif  // GUI_WIDGETS_BASICCONTAINER_H
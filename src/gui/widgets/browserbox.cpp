@@ -47,7 +47,6 @@
 #include "utils/checkutils.h"
 #include "utils/foreach.h"
 #include "utils/stringutils.h"
-#include "utils/timer.h"
 #include "utils/translation/podict.h"
 
 #include <algorithm>
@@ -65,7 +64,7 @@ BrowserBox::BrowserBox(const Widget2 *const widget,
     WidgetListener(),
     mTextRows(),
     mTextRowLinksCount(),
-    mLineParts(),
+    mRowLayouts(),
     mLinks(),
     mLinkHandler(nullptr),
     mSkin(nullptr),
@@ -75,7 +74,10 @@ BrowserBox::BrowserBox(const Widget2 *const widget,
     mHeight(0),
     mWidth(0),
     mYStart(0),
-    mUpdateTime(-1),
+    mRowsTop(0),
+    mNextY(0),
+    mNextLink(0),
+    mLinksBase(0),
     mPadding(0),
     mNewLinePadding(15U),
     mItemPadding(0),
@@ -85,11 +87,11 @@ BrowserBox::BrowserBox(const Widget2 *const widget,
     mOpaque(opaque),
     mUseLinksAndUserColors(true),
     mUseEmotes(true),
-    mAlwaysUpdate(true),
     mProcessVars(false),
     mEnableImages(false),
     mEnableKeys(false),
-    mEnableTabs(false)
+    mEnableTabs(false),
+    mLayoutDirty(true)
 {
     mAllowLogic = false;
 
@@ -172,11 +174,12 @@ void BrowserBox::addRow(const std::string &row, const bool atTop)
     std::string tmp = row;
     std::string newRow;
     const Font *const font = getFont();
-    int linksCount = 0;
+    Links rowLinks;
 
     if (getWidth() < 0)
         return;
 
+    contentChanged();
     if (mProcessVars)
     {
         BrowserBoxTools::replaceVars(tmp);
@@ -227,11 +230,7 @@ void BrowserBox::addRow(const std::string &row, const bool atTop)
             bLink.x1 = font->getWidth(tmp2) - 1;
             bLink.x2 = bLink.x1 + font->getWidth(bLink.caption) + 1;
 
-            if (atTop)
-                mLinks.insert(mLinks.begin(), bLink);
-            else
-                mLinks.push_back(bLink);
-            linksCount ++;
+            rowLinks.push_back(bLink);
 
             newRow.append("##<").append(bLink.caption);
 
@@ -255,15 +254,22 @@ void BrowserBox::addRow(const std::string &row, const bool atTop)
         BrowserBoxTools::replaceTabs(newRow);
     }
 
+    const int linksCount = CAST_S32(rowLinks.size());
     if (atTop)
     {
         mTextRows.push_front(newRow);
         mTextRowLinksCount.push_front(linksCount);
+        mLinks.insert(mLinks.begin(), rowLinks.begin(), rowLinks.end());
+        mLinksBase -= linksCount;
+        if (mSelectedLink >= 0)
+            mSelectedLink += linksCount;
+        mLayoutDirty = true;
     }
     else
     {
         mTextRows.push_back(newRow);
         mTextRowLinksCount.push_back(linksCount);
+        mLinks.insert(mLinks.end(), rowLinks.begin(), rowLinks.end());
     }
 
     // discard older rows when a row limit has been set
@@ -277,65 +283,35 @@ void BrowserBox::addRow(const std::string &row, const bool atTop)
 
             while ((cnt != 0) && !mLinks.empty())
             {
-                mLinks.erase(mLinks.begin());
+                mLinks.pop_front();
+                mLinksBase ++;
+                if (mSelectedLink >= 0)
+                    mSelectedLink --;
                 cnt --;
             }
-        }
-    }
-
-    const int fontHeight = font->getHeight();
-    unsigned int y = 0;
-    unsigned int nextChar;
-    const char *const hyphen = "~";
-    const unsigned int hyphenWidth = CAST_U32(
-        font->getWidth(hyphen));
-    unsigned int x = 0;
 
-    FOR_EACH (TextRowCIter, i, mTextRows)
-    {
-        std::string tempRow = *i;
-        for (uint32_t j = 0, sz = CAST_U32(tempRow.size());
-             j < sz;
-             j++)
-        {
-            const std::string character = tempRow.substr(j, 1);
-            x += CAST_U32(font->getWidth(character));
-            nextChar = j + 1;
-
-            // Wraping between words (at blank spaces)
-            if (nextChar < sz && tempRow.at(nextChar) == ' ')
+            if (!mRowLayouts.empty())
             {
-                int nextSpacePos = CAST_U32(
-                    tempRow.find(' ', (nextChar + 1)));
-                if (nextSpacePos <= 0)
-                    nextSpacePos = CAST_U32(sz) - 1U;
-
-                const unsigned int nextWordWidth =
-                    CAST_U32(font->getWidth(
-                    tempRow.substr(nextChar,
-                    (CAST_U32(nextSpacePos) - nextChar))));
-
-                if ((x + nextWordWidth + 10)
-                    > CAST_U32(getWidth()))
+                mRowLayouts.pop_front();
+                if (mRowLayouts.empty())
                 {
-                    x = mNewLinePadding;  // Ident in new line
-                    y += 1;
-                    j ++;
+                    mLayoutDirty = true;
+                }
+                else
+                {
+                    const TextRowLayout &first = mRowLayouts.front();
+                    mRowsTop = first.y - mPadding;
+                    // colors can be inherited from removed row
+                    if (!(first.color[0] == mForegroundColor) ||
+                        !(first.color[1] == mForegroundColor2))
+                    {
+                        mLayoutDirty = true;
+                    }
                 }
-            }
-            // Wrapping looong lines (brutal force)
-            else if ((x + 2 * hyphenWidth)
-                     > CAST_U32(getWidth()))
-            {
-                x = mNewLinePadding;  // Ident in new line
-                y += 1;
             }
         }
     }
 
-    setHeight(fontHeight * (CAST_S32(
-        CAST_U32(mTextRows.size()) + y)));
-    mUpdateTime = 0;
     updateHeight();
 }
 
@@ -357,13 +333,16 @@ void BrowserBox::addImage(const std::string &path)
 
 void BrowserBox::clearRows()
 {
+    contentChanged();
     mTextRows.clear();
     mTextRowLinksCount.clear();
+    mRowLayouts.clear();
     mLinks.clear();
+    mLinksBase = 0;
     setWidth(0);
     setHeight(0);
     mSelectedLink = -1;
-    mUpdateTime = 0;
+    mLayoutDirty = true;
     mDataWidth = 0;
     updateHeight();
 }
@@ -373,23 +352,17 @@ void BrowserBox::mousePressed(MouseEvent &event)
     if (mLinkHandler == nullptr)
         return;
 
-    const LinkIterator i = std::find_if(mLinks.begin(), mLinks.end(),
-        MouseOverLink(event.getX(), event.getY()));
-
-    if (i != mLinks.end())
+    const int link = findLink(event.getX(), event.getY());
+    if (link >= 0)
     {
-        mLinkHandler->handleLink(i->link, &event);
+        mLinkHandler->handleLink(mLinks[CAST_SIZE(link)].link, &event);
         event.consume();
     }
 }
 
 void BrowserBox::mouseMoved(MouseEvent &event)
 {
-    const LinkIterator i = std::find_if(mLinks.begin(), mLinks.end(),
-        MouseOverLink(event.getX(), event.getY()));
-
-    mSelectedLink = (i != mLinks.end())
-        ? CAST_S32(i - mLinks.begin()) : -1;
+    mSelectedLink = findLink(event.getX(), event.getY());
 }
 
 void BrowserBox::mouseExited(MouseEvent &event A_UNUSED)
@@ -406,12 +379,12 @@ void BrowserBox::draw(Graphics *const graphics)
     if (mYStart < 0)
         mYStart = 0;
 
-    if (mDimension.width != mWidth)
+    if (mDimension.width != mWidth ||
+        mLayoutDirty ||
+        mRowLayouts.size() != mTextRows.size())
     {
-        mWidth = mDimension.width;
-        mHeight = calcHeight();
+        layoutRows(mDimension.width != mWidth || mLayoutDirty);
         setHeight(mHeight);
-        mUpdateTime = cur_time;
         if (mDimension.width != mWidth)
             reportAlways("browserbox resize in draw")
     }
@@ -432,7 +405,7 @@ void BrowserBox::draw(Graphics *const graphics)
             graphics->setColor(mHighlightColor);
             graphics->fillRectangle(Rect(
                 link.x1,
-                link.y1,
+                link.y1 - mRowsTop,
                 link.x2 - link.x1,
                 link.y2 - link.y1));
         }
@@ -443,44 +416,51 @@ void BrowserBox::draw(Graphics *const graphics)
             graphics->setColor(mHyperLinkColor);
             graphics->drawLine(
                 link.x1,
-                link.y2,
+                link.y2 - mRowsTop,
                 link.x2,
-                link.y2);
+                link.y2 - mRowsTop);
         }
     }
 
     Font *const font = getFont();
 
-    FOR_EACH (LinePartCIter, i, mLineParts)
+    const size_t rowsSize = mRowLayouts.size();
+    for (size_t f = getRowIndex(mYStart + mRowsTop); f < rowsSize; f ++)
     {
-        const LinePart &part = *i;
-        if (part.mY + 50 < mYStart)
-            continue;
-        if (part.mY > yEnd)
+        const TextRowLayout &row = mRowLayouts[f];
+        const int rowY = row.y - mRowsTop;
+        if (rowY > yEnd)
             break;
-        if (part.mType == 0U)
+        FOR_EACH (LinePartCIter, i, row.parts)
         {
-            if (part.mBold)
+            const LinePart &part = *i;
+            const int y = rowY + part.mY;
+            if (y > yEnd)
+                break;
+            if (part.mType == 0U)
             {
-                boldFont->drawString(graphics,
-                    part.mColor,
-                    part.mColor2,
-                    part.mText,
-                    part.mX, part.mY);
+                if (part.mBold)
+                {
+                    boldFont->drawString(graphics,
+                        part.mColor,
+                        part.mColor2,
+                        part.mText,
+                        part.mX, y);
+                }
+                else
+                {
+                    font->drawString(graphics,
+                        part.mColor,
+                        part.mColor2,
+                        part.mText,
+                        part.mX, y);
+                }
             }
-            else
+            else if (part.mImage != nullptr)
             {
-                font->drawString(graphics,
-                    part.mColor,
-                    part.mColor2,
-                    part.mText,
-                    part.mX, part.mY);
+                graphics->drawImage(part.mImage, part.mX, y);
             }
         }
-        else if (part.mImage != nullptr)
-        {
-            graphics->drawImage(part.mImage, part.mX, part.mY);
-        }
     }
 
     BLOCK_END("BrowserBox::draw")
@@ -491,18 +471,65 @@ void BrowserBox::safeDraw(Graphics *const graphics)
     BrowserBox::draw(graphics);
 }
 
-int BrowserBox::calcHeight()
+void BrowserBox::layoutRows(const bool full)
 {
-    unsigned int y = CAST_U32(mPadding);
-    int wrappedLines = 0;
-    int moreHeight = 0;
     int maxWidth = mDimension.width - mPadding;
-    int link = 0;
-    bool bold = false;
-    unsigned int wWidth = CAST_U32(maxWidth);
+    if (full || mRowLayouts.empty() || maxWidth < 0)
+    {
+        mRowLayouts.clear();
+        mWidth = mDimension.width;
+        mRowsTop = 0;
+        mNextY = mPadding;
+        mNextLink = mLinksBase;
+        mEndColor[0] = mForegroundColor;
+        mEndColor[1] = mForegroundColor2;
+        mLayoutDirty = false;
+    }
 
     if (maxWidth < 0)
-        return 1;
+    {
+        mHeight = 1;
+        return;
+    }
+
+    // rows without layout always at end
+    size_t pending = mTextRows.size() - mRowLayouts.size();
+    TextRowCIter it = mTextRows.end();
+    std::list<int>::const_iterator itCount = mTextRowLinksCount.end();
+    for (size_t f = 0; f < pending; f ++)
+    {
+        -- it;
+        -- itCount;
+    }
+
+    const int width = maxWidth;
+    for (; pending > 0; pending --, ++ it, ++ itCount)
+    {
+        mRowLayouts.push_back(TextRowLayout());
+        TextRowLayout &layout = mRowLayouts.back();
+        layout.y = mNextY;
+        layout.linkIndex = mNextLink;
+        layout.linksCount = *itCount;
+        layoutRow(*it, layout, maxWidth);
+        mNextY += layout.height;
+        mNextLink += layout.linksCount;
+    }
+    if (width != maxWidth)
+        setWidth(maxWidth);
+
+    mHeight = mNextY - mRowsTop + mPadding;
+}
+
+void BrowserBox::layoutRow(const std::string &row,
+                           TextRowLayout &layout,
+                           int &maxWidth)
+{
+    unsigned int y = 0;
+    const unsigned int wWidth = CAST_U32(mDimension.width - mPadding);
+    int link = layout.linkIndex - mLinksBase;
+    const int linkEnd = std::min(link + layout.linksCount,
+        CAST_S32(mLinks.size()));
+    bool bold = false;
 
     const Font *const font = getFont();
     const int fontHeight = font->getHeight() + 2 * mItemPadding;
@@ -510,381 +537,409 @@ int BrowserBox::calcHeight()
     const char *const hyphen = "~";
     const int hyphenWidth = font->getWidth(hyphen);
 
-    Color selColor[2] = {mForegroundColor, mForegroundColor2};
+    Color *const selColor = mEndColor;
     const Color textColor[2] = {mForegroundColor, mForegroundColor2};
-    mLineParts.clear();
+    layout.color[0] = selColor[0];
+    layout.color[1] = selColor[1];
 
-    FOR_EACH (TextRowCIter, i, mTextRows)
-    {
-        unsigned int x = CAST_U32(mPadding);
-        const std::string row = *(i);
-        bool wrapped = false;
-        int objects = 0;
+    unsigned int x = CAST_U32(mPadding);
+    bool wrapped = false;
+    int objects = 0;
 
-        // Check for separator lines
-        if (row.find("---", 0) == 0)
+    // Check for separator lines
+    if (row.find("---", 0) == 0)
+    {
+        const int dashWidth = fontWidthMinus;
+        for (x = CAST_U32(mPadding); x < wWidth; x ++)
         {
-            const int dashWidth = fontWidthMinus;
-            for (x = CAST_U32(mPadding); x < wWidth; x ++)
-            {
-                mLineParts.push_back(LinePart(CAST_S32(x),
-                    CAST_S32(y) + mItemPadding,
-                    selColor[0], selColor[1], "-", false));
-                x += CAST_U32(CAST_S32(
-                    dashWidth) - 2);
-            }
-
-            y += CAST_U32(fontHeight);
-            continue;
+            layout.parts.push_back(LinePart(CAST_S32(x),
+                mItemPadding,
+                selColor[0], selColor[1], "-", false));
+            x += CAST_U32(CAST_S32(
+                dashWidth) - 2);
         }
-        else if (mEnableImages && row.find("~~~", 0) == 0)
+
+        layout.height = fontHeight;
+        return;
+    }
+    else if (mEnableImages && row.find("~~~", 0) == 0)
+    {
+        std::string str = row.substr(3);
+        const size_t sz = str.size();
+        if (sz > 2 && str.substr(sz - 1) == "~")
+            str = str.substr(0, sz - 1);
+        Image *const img = Loader::getImage(str);
+        if (img != nullptr)
         {
-            std::string str = row.substr(3);
-            const size_t sz = str.size();
-            if (sz > 2 && str.substr(sz - 1) == "~")
-                str = str.substr(0, sz - 1);
-            Image *const img = Loader::getImage(str);
-            if (img != nullptr)
-            {
-                img->incRef();
-                mLineParts.push_back(LinePart(CAST_S32(x),
-                    CAST_S32(y) + mItemPadding,
-                    selColor[0], selColor[1], img));
-                y += CAST_U32(img->getHeight() + 2);
-                moreHeight += img->getHeight();
-                if (img->getWidth() > maxWidth)
-                    maxWidth = img->getWidth() + 2;
-            }
-            continue;
+            img->incRef();
+            layout.parts.push_back(LinePart(CAST_S32(x),
+                mItemPadding,
+                selColor[0], selColor[1], img));
+            layout.height = img->getHeight() + 2;
+            if (img->getWidth() > maxWidth)
+                maxWidth = img->getWidth() + 2;
         }
+        return;
+    }
 
-        Color prevColor[2];
-        prevColor[0] = selColor[0];
-        prevColor[1] = selColor[1];
-        bold = false;
+    Color prevColor[2];
+    prevColor[0] = selColor[0];
+    prevColor[1] = selColor[1];
 
-        const int xPadding = CAST_S32(mNewLinePadding) + mPadding;
+    const int xPadding = CAST_S32(mNewLinePadding) + mPadding;
 
-        for (size_t start = 0, end = std::string::npos;
-             start != std::string::npos;
-             start = end, end = std::string::npos)
-        {
-            bool processed(false);
+    for (size_t start = 0, end = std::string::npos;
+         start != std::string::npos;
+         start = end, end = std::string::npos)
+    {
+        bool processed(false);
 
-            // Wrapped line continuation shall be indented
-            if (wrapped)
-            {
-                y += CAST_U32(fontHeight);
-                x = CAST_U32(xPadding);
-                wrapped = false;
-            }
+        // Wrapped line continuation shall be indented
+        if (wrapped)
+        {
+            y += CAST_U32(fontHeight);
+            x = CAST_U32(xPadding);
+            wrapped = false;
+        }
 
-            size_t idx1 = end;
-            size_t idx2 = end;
+        size_t idx1 = end;
+        size_t idx2 = end;
 
-            // "Tokenize" the string at control sequences
-            if (mUseLinksAndUserColors)
-                idx1 = row.find("##", start + 1);
-            if (start == 0 || mUseLinksAndUserColors)
+        // "Tokenize" the string at control sequences
+        if (mUseLinksAndUserColors)
+            idx1 = row.find("##", start + 1);
+        if (start == 0 || mUseLinksAndUserColors)
+        {
+            // Check for color change in format "##x", x = [L,P,0..9]
+            if (row.find("##", start) == start && row.size() > start + 2)
             {
-                // Check for color change in format "##x", x = [L,P,0..9]
-                if (row.find("##", start) == start && row.size() > start + 2)
-                {
-                    const signed char c = row.at(start + 2);
+                const signed char c = row.at(start + 2);
 
-                    bool valid(false);
-                    const Color col[2] =
-                    {
-                        getThemeCharColor(c, valid),
-                        getThemeCharColor(CAST_S8(
-                            c | 0x80), valid)
-                    };
+                bool valid(false);
+                const Color col[2] =
+                {
+                    getThemeCharColor(c, valid),
+                    getThemeCharColor(CAST_S8(
+                        c | 0x80), valid)
+                };
 
-                    if (c == '>')
-                    {
-                        selColor[0] = prevColor[0];
-                        selColor[1] = prevColor[1];
-                    }
-                    else if (c == '<')
-                    {
-                        prevColor[0] = selColor[0];
-                        prevColor[1] = selColor[1];
-                        selColor[0] = col[0];
-                        selColor[1] = col[1];
-                    }
-                    else if (c == 'B')
-                    {
-                        bold = true;
-                    }
-                    else if (c == 'b')
+                if (c == '>')
+                {
+                    selColor[0] = prevColor[0];
+                    selColor[1] = prevColor[1];
+                }
+                else if (c == '<')
+                {
+                    prevColor[0] = selColor[0];
+                    prevColor[1] = selColor[1];
+                    selColor[0] = col[0];
+                    selColor[1] = col[1];
+                }
+                else if (c == 'B')
+                {
+                    bold = true;
+                }
+                else if (c == 'b')
+                {
+                    bold = false;
+                }
+                else if (valid)
+                {
+                    selColor[0] = col[0];
+                    selColor[1] = col[1];
+                }
+                else
+                {
+                    switch (c)
                     {
-                        bold = false;
+                        case '0':
+                            selColor[0] = mColors[0][ColorName::BLACK];
+                            selColor[1] = mColors[1][ColorName::BLACK];
+                            break;
+                        case '1':
+                            selColor[0] = mColors[0][ColorName::RED];
+                            selColor[1] = mColors[1][ColorName::RED];
+                            break;
+                        case '2':
+                            selColor[0] = mColors[0][ColorName::GREEN];
+                            selColor[1] = mColors[1][ColorName::GREEN];
+                            break;
+                        case '3':
+                            selColor[0] = mColors[0][ColorName::BLUE];
+                            selColor[1] = mColors[1][ColorName::BLUE];
+                            break;
+                        case '4':
+                            selColor[0] = mColors[0][ColorName::ORANGE];
+                            selColor[1] = mColors[1][ColorName::ORANGE];
+                            break;
+                        case '5':
+                            selColor[0] = mColors[0][ColorName::YELLOW];
+                            selColor[1] = mColors[1][ColorName::YELLOW];
+                            break;
+                        case '6':
+                            selColor[0] = mColors[0][ColorName::PINK];
+                            selColor[1] = mColors[1][ColorName::PINK];
+                            break;
+                        case '7':
+                            selColor[0] = mColors[0][ColorName::PURPLE];
+                            selColor[1] = mColors[1][ColorName::PURPLE];
+                            break;
+                        case '8':
+                            selColor[0] = mColors[0][ColorName::GRAY];
+                            selColor[1] = mColors[1][ColorName::GRAY];
+                            break;
+                        case '9':
+                            selColor[0] = mColors[0][ColorName::BROWN];
+                            selColor[1] = mColors[1][ColorName::BROWN];
+                            break;
+                        default:
+                            selColor[0] = textColor[0];
+                            selColor[1] = textColor[1];
+                            break;
                     }
-                    else if (valid)
+                }
+
+                if (c == '<' && link < linkEnd)
+                {
+                    int size;
+                    if (bold)
                     {
-                        selColor[0] = col[0];
-                        selColor[1] = col[1];
+                        size = boldFont->getWidth(
+                            mLinks[CAST_SIZE(link)].caption) + 1;
                     }
                     else
                     {
-                        switch (c)
-                        {
-                            case '0':
-                                selColor[0] = mColors[0][ColorName::BLACK];
-                                selColor[1] = mColors[1][ColorName::BLACK];
-                                break;
-                            case '1':
-                                selColor[0] = mColors[0][ColorName::RED];
-                                selColor[1] = mColors[1][ColorName::RED];
-                                break;
-                            case '2':
-                                selColor[0] = mColors[0][ColorName::GREEN];
-                                selColor[1] = mColors[1][ColorName::GREEN];
-                                break;
-                            case '3':
-                                selColor[0] = mColors[0][ColorName::BLUE];
-                                selColor[1] = mColors[1][ColorName::BLUE];
-                                break;
-                            case '4':
-                                selColor[0] = mColors[0][ColorName::ORANGE];
-                                selColor[1] = mColors[1][ColorName::ORANGE];
-                                break;
-                            case '5':
-                                selColor[0] = mColors[0][ColorName::YELLOW];
-                                selColor[1] = mColors[1][ColorName::YELLOW];
-                                break;
-                            case '6':
-                                selColor[0] = mColors[0][ColorName::PINK];
-                                selColor[1] = mColors[1][ColorName::PINK];
-                                break;
-                            case '7':
-                                selColor[0] = mColors[0][ColorName::PURPLE];
-                                selColor[1] = mColors[1][ColorName::PURPLE];
-                                break;
-                            case '8':
-                                selColor[0] = mColors[0][ColorName::GRAY];
-                                selColor[1] = mColors[1][ColorName::GRAY];
-                                break;
-                            case '9':
-                                selColor[0] = mColors[0][ColorName::BROWN];
-                                selColor[1] = mColors[1][ColorName::BROWN];
-                                break;
-                            default:
-                                selColor[0] = textColor[0];
-                                selColor[1] = textColor[1];
-                                break;
-                        }
-                    }
-
-                    if (c == '<' && link < CAST_S32(mLinks.size()))
-                    {
-                        int size;
-                        if (bold)
-                        {
-                            size = boldFont->getWidth(
-                                mLinks[CAST_SIZE(link)].caption) + 1;
-                        }
-                        else
-                        {
-                            size = font->getWidth(
-                                mLinks[CAST_SIZE(link)].caption) + 1;
-                        }
-
-                        BrowserLink &linkRef = mLinks[CAST_SIZE(
-                            link)];
-                        linkRef.x1 = CAST_S32(x);
-                        linkRef.y1 = CAST_S32(y);
-                        linkRef.x2 = linkRef.x1 + size;
-                        linkRef.y2 = CAST_S32(y) + fontHeight - 1;
-                        link++;
+                        size = font->getWidth(
+                            mLinks[CAST_SIZE(link)].caption) + 1;
                     }
 
-                    processed = true;
-                    start += 3;
-                    if (start == row.size())
-                        break;
+                    BrowserLink &linkRef = mLinks[CAST_SIZE(
+                        link)];
+                    linkRef.x1 = CAST_S32(x);
+                    linkRef.y1 = layout.y + CAST_S32(y);
+                    linkRef.x2 = linkRef.x1 + size;
+                    linkRef.y2 = linkRef.y1 + fontHeight - 1;
+                    link++;
                 }
+
+                processed = true;
+                start += 3;
+                if (start == row.size())
+                    break;
             }
-            if (mUseEmotes)
-                idx2 = row.find("%%", start + 1);
-            if (idx1 < idx2)
-                end = idx1;
-            else
-                end = idx2;
-            if (mUseEmotes)
+        }
+        if (mUseEmotes)
+            idx2 = row.find("%%", start + 1);
+        if (idx1 < idx2)
+            end = idx1;
+        else
+            end = idx2;
+        if (mUseEmotes)
+        {
+            // check for emote icons
+            if (row.size() > start + 2 && row.substr(start, 2) == "%%")
             {
-                // check for emote icons
-                if (row.size() > start + 2 && row.substr(start, 2) == "%%")
+                if (objects < 5)
                 {
-                    if (objects < 5)
+                    const int cid = row.at(start + 2) - '0';
+                    if (cid >= 0)
                     {
-                        const int cid = row.at(start + 2) - '0';
-                        if (cid >= 0)
+                        if (mEmotes != nullptr)
                         {
-                            if (mEmotes != nullptr)
+                            const size_t sz = mEmotes->size();
+                            if (CAST_SIZE(cid) < sz)
                             {
-                                const size_t sz = mEmotes->size();
-                                if (CAST_SIZE(cid) < sz)
+                                Image *const img = mEmotes->get(
+                                    CAST_SIZE(cid));
+                                if (img != nullptr)
                                 {
-                                    Image *const img = mEmotes->get(
-                                        CAST_SIZE(cid));
-                                    if (img != nullptr)
-                                    {
-                                        mLineParts.push_back(LinePart(
-                                            CAST_S32(x),
-                                            CAST_S32(y) + mItemPadding,
-                                            selColor[0], selColor[1], img));
-                                        x += 18;
-                                    }
+                                    layout.parts.push_back(LinePart(
+                                        CAST_S32(x),
+                                        CAST_S32(y) + mItemPadding,
+                                        selColor[0], selColor[1], img));
+                                    x += 18;
                                 }
                             }
                         }
-                        objects ++;
-                        processed = true;
                     }
+                    objects ++;
+                    processed = true;
+                }
 
-                    start += 3;
-                    if (start == row.size())
-                    {
-                        if (x > mDataWidth)
-                            mDataWidth = x;
-                        break;
-                    }
+                start += 3;
+                if (start == row.size())
+                {
+                    if (x > mDataWidth)
+                        mDataWidth = x;
+                    break;
                 }
             }
-            const size_t len = (end == std::string::npos) ? end : end - start;
+        }
+        const size_t len = (end == std::string::npos) ? end : end - start;
 
-            if (start >= row.length())
-                break;
+        if (start >= row.length())
+            break;
 
-            std::string part = row.substr(start, len);
-            int width = 0;
-            if (bold)
-                width = boldFont->getWidth(part);
-            else
-                width = font->getWidth(part);
+        std::string part = row.substr(start, len);
+        int width = 0;
+        if (bold)
+            width = boldFont->getWidth(part);
+        else
+            width = font->getWidth(part);
 
-            // Auto wrap mode
-            if (wWidth > 0 &&
-                width > 0 &&
-                (x + CAST_U32(width) + 10) > wWidth)
+        // Auto wrap mode
+        if (wWidth > 0 &&
+            width > 0 &&
+            (x + CAST_U32(width) + 10) > wWidth)
+        {
+            bool forced = false;
+
+            /* FIXME: This code layout makes it easy to crash remote
+               clients by talking garbage. Forged long utf-8 characters
+               will cause either a buffer underflow in substr or an
+               infinite loop in the main loop. */
+            do
             {
-                bool forced = false;
+                if (!forced)
+                    end = row.rfind(' ', end);
 
-                /* FIXME: This code layout makes it easy to crash remote
-                   clients by talking garbage. Forged long utf-8 characters
-                   will cause either a buffer underflow in substr or an
-                   infinite loop in the main loop. */
-                do
+                // Check if we have to (stupidly) force-wrap
+                if (end == std::string::npos || end <= start)
                 {
-                    if (!forced)
-                        end = row.rfind(' ', end);
-
-                    // Check if we have to (stupidly) force-wrap
-                    if (end == std::string::npos || end <= start)
-                    {
-                        forced = true;
-                        end = row.size();
-                        x += CAST_U32(hyphenWidth);
-                        continue;
-                    }
-
-                    // Skip to the start of the current character
-                    while ((row[end] & 192) == 128)
-                        end--;
-                    end--;  // And then to the last byte of the previous one
-
-                    part = row.substr(start, end - start + 1);
-                    if (bold)
-                        width = boldFont->getWidth(part);
-                    else
-                        width = font->getWidth(part);
+                    forced = true;
+                    end = row.size();
+                    x += CAST_U32(hyphenWidth);
+                    continue;
                 }
-                while (end > start &&
-                       width > 0 &&
-                       (x + CAST_U32(width) + 10) > wWidth);
 
-                if (forced)
-                {
-                    x -= CAST_U32(hyphenWidth);
-                    mLineParts.push_back(LinePart(
-                        CAST_S32(wWidth) - hyphenWidth,
-                        CAST_S32(y) + mItemPadding,
-                        selColor[0], selColor[1], hyphen, bold));
-                    end++;  // Skip to the next character
-                }
+                // Skip to the start of the current character
+                while ((row[end] & 192) == 128)
+                    end--;
+                end--;  // And then to the last byte of the previous one
+
+                part = row.substr(start, end - start + 1);
+                if (bold)
+                    width = boldFont->getWidth(part);
                 else
-                {
-                    end += 2;  // Skip to after the space
-                }
+                    width = font->getWidth(part);
+            }
+            while (end > start &&
+                   width > 0 &&
+                   (x + CAST_U32(width) + 10) > wWidth);
 
-                wrapped = true;
-                wrappedLines++;
+            if (forced)
+            {
+                x -= CAST_U32(hyphenWidth);
+                layout.parts.push_back(LinePart(
+                    CAST_S32(wWidth) - hyphenWidth,
+                    CAST_S32(y) + mItemPadding,
+                    selColor[0], selColor[1], hyphen, bold));
+                end++;  // Skip to the next character
+            }
+            else
+            {
+                end += 2;  // Skip to after the space
             }
 
-            mLineParts.push_back(LinePart(CAST_S32(x),
-                CAST_S32(y) + mItemPadding,
-                selColor[0], selColor[1], part.c_str(), bold));
+            wrapped = true;
+        }
 
-            if (bold)
-                width = boldFont->getWidth(part);
-            else
-                width = font->getWidth(part);
+        layout.parts.push_back(LinePart(CAST_S32(x),
+            CAST_S32(y) + mItemPadding,
+            selColor[0], selColor[1], part.c_str(), bold));
 
-            if (width == 0 && !processed)
-                break;
+        if (bold)
+            width = boldFont->getWidth(part);
+        else
+            width = font->getWidth(part);
 
-            x += CAST_U32(width);
-            if (x > mDataWidth)
-                mDataWidth = x;
-        }
-        y += CAST_U32(fontHeight);
-    }
-    if (CAST_S32(wWidth) != maxWidth)
-        setWidth(maxWidth);
+        if (width == 0 && !processed)
+            break;
 
-    return (CAST_S32(mTextRows.size()) + wrappedLines)
-        * fontHeight + moreHeight + 2 * mPadding;
+        x += CAST_U32(width);
+        if (x > mDataWidth)
+            mDataWidth = x;
+    }
+    layout.height = CAST_S32(y) + fontHeight;
 }
 
 void BrowserBox::updateHeight()
 {
-    if (mAlwaysUpdate || mUpdateTime != cur_time
-        || mTextRows.size() < 3 || (mUpdateTime == 0))
-    {
-        mWidth = mDimension.width;
-        mHeight = calcHeight();
-        setHeight(mHeight);
-        mUpdateTime = cur_time;
-    }
+    layoutRows(mLayoutDirty ||
+        mWidth != mDimension.width);
+    setHeight(mHeight);
 }
 
 void BrowserBox::updateSize(const bool always)
 {
     if (always)
-        mUpdateTime = 0;
+        mLayoutDirty = true;
     updateHeight();
 }
 
+size_t BrowserBox::getRowIndex(const int y) const
+{
+    size_t first = 0;
+    size_t count = mRowLayouts.size();
+    while (count > 0)
+    {
+        const size_t step = count / 2;
+        const TextRowLayout &row = mRowLayouts[first + step];
+        if (row.y + row.height <= y)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+    return first;
+}
+
+int BrowserBox::findLink(const int x, const int y) const
+{
+    const int rowY = y + mRowsTop;
+    const size_t index = getRowIndex(rowY);
+    if (index >= mRowLayouts.size())
+        return -1;
+
+    const TextRowLayout &row = mRowLayouts[index];
+    const int start = std::max(row.linkIndex - mLinksBase, 0);
+    const int end = std::min(row.linkIndex - mLinksBase + row.linksCount,
+        CAST_S32(mLinks.size()));
+    const MouseOverLink mouseOver(x, rowY);
+    for (int f = start; f < end; f ++)
+    {
+        if (mouseOver(mLinks[CAST_SIZE(f)]))
+            return f;
+    }
+    return -1;
+}
+
 std::string BrowserBox::getTextAtPos(const int x, const int y) const
 {
     int textX = 0;
     int textY = 0;
 
     getAbsolutePosition(textX, textY);
-    if (x < textX || y < textY)
+    if (x < textX || y < textY || mRowLayouts.empty())
         return std::string();
 
-    textY = y - textY;
+    const int rowY = y - textY + mRowsTop;
+    size_t index = getRowIndex(rowY);
+    if (index >= mRowLayouts.size())
+        index = mRowLayouts.size() - 1;
+    const TextRowLayout &row = mRowLayouts[index];
+    const int partY = rowY - row.y;
     std::string str;
     int lastY = 0;
 
-    FOR_EACH (LinePartCIter, i, mLineParts)
+    FOR_EACH (LinePartCIter, i, row.parts)
     {
         const LinePart &part = *i;
-        if (part.mY + 50 < mYStart)
-            continue;
-        if (part.mY > textY)
+        if (part.mY > partY)
             break;
 
         if (part.mY > lastY)
@@ -906,6 +961,7 @@ void BrowserBox::setForegroundColorAll(const Color &color1,
 {
     mForegroundColor = color1;
     mForegroundColor2 = color2;
+    mLayoutDirty = true;
 }
 
 void BrowserBox::moveSelectionUp()
@@ -36,6 +36,8 @@
 #include "listeners/mouselistener.h"
 #include "listeners/widgetlistener.h"
 
+#include <deque>
+
 #include "localconsts.h"
 
 class LinkHandler;
@@ -43,6 +45,8 @@ class LinkHandler;
 /**
  * A simple browser box able to handle links and forward events to the
  * parent conteiner.
+ * Layout cached per row. Appended rows laid out incrementally, drawing and
+ * hit testing use only rows from visible range.
  */
 class BrowserBox final : public Widget,
                          public MouseListener,
@@ -126,9 +130,6 @@ class BrowserBox final : public Widget,
         bool hasRows() const noexcept2 A_WARN_UNUSED
         { return !mTextRows.empty(); }
 
-        void setAlwaysUpdate(const bool n) noexcept2
-        { mAlwaysUpdate = n; }
-
         void setProcessVars(const bool n) noexcept2
         { mProcessVars = n; }
 
@@ -160,21 +161,78 @@ class BrowserBox final : public Widget,
 
         void widgetResized(const Event &event) override final;
 
+#ifndef UNITTESTS
     private:
-        int calcHeight() A_WARN_UNUSED;
-
+#endif  // UNITTESTS
         typedef TextRows::iterator TextRowIterator;
         typedef TextRows::const_iterator TextRowCIter;
-        TextRows mTextRows;
-        std::list<int> mTextRowLinksCount;
 
         typedef STD_VECTOR<LinePart> LinePartList;
         typedef LinePartList::iterator LinePartIterator;
         typedef LinePartList::const_iterator LinePartCIter;
-        LinePartList mLineParts;
 
-        typedef STD_VECTOR<BrowserLink> Links;
+        typedef std::deque<BrowserLink> Links;
         typedef Links::iterator LinkIterator;
+
+        /**
+         * Cached layout of one text row.
+         * Line parts positioned relative to row, row and links positions
+         * is virtual and not changed if older rows removed.
+         */
+        struct TextRowLayout final
+        {
+            TextRowLayout() :
+                parts(),
+                y(0),
+                height(0),
+                linkIndex(0),
+                linksCount(0)
+            {
+            }
+
+            A_DEFAULT_COPY(TextRowLayout)
+
+            LinePartList parts;
+            Color color[2];
+            int y;
+            int height;
+            int linkIndex;
+            int linksCount;
+        };
+
+        typedef std::deque<TextRowLayout> RowLayouts;
+
+        /**
+         * Returns index of first row ending after virtual y position.
+         */
+        size_t getRowIndex(const int y) const A_WARN_UNUSED;
+
+        int findLink(const int x, const int y) const A_WARN_UNUSED;
+
+#ifdef UNITTESTS
+        const RowLayouts &getRowLayouts() const noexcept2
+        { return mRowLayouts; }
+
+        const Links &getLinks() const noexcept2
+        { return mLinks; }
+
+        int getRowsTop() const noexcept2
+        { return mRowsTop; }
+#endif  // UNITTESTS
+
+    private:
+        /**
+         * Lays out rows without layout or all rows if full is set.
+         */
+        void layoutRows(const bool full);
+
+        void layoutRow(const std::string &row,
+                       TextRowLayout &layout,
+                       int &maxWidth);
+
+        TextRows mTextRows;
+        std::list<int> mTextRowLinksCount;
+        RowLayouts mRowLayouts;
         Links mLinks;
 
         LinkHandler *mLinkHandler;
@@ -185,7 +243,10 @@ class BrowserBox final : public Widget,
         int mHeight;
         int mWidth;
         int mYStart;
-        time_t mUpdateTime;
+        int mRowsTop;
+        int mNextY;
+        int mNextLink;
+        int mLinksBase;
         int mPadding;
         unsigned int mNewLinePadding;
         int mItemPadding;
@@ -194,15 +255,16 @@ class BrowserBox final : public Widget,
         Color mHighlightColor;
         Color mHyperLinkColor;
         Color mColors[2][ColorName::COLORS_MAX];
+        Color mEndColor[2];
 
         Opaque mOpaque;
         bool mUseLinksAndUserColors;
         bool mUseEmotes;
-        bool mAlwaysUpdate;
         bool mProcessVars;
         bool mEnableImages;
         bool mEnableKeys;
         bool mEnableTabs;
+        bool mLayoutDirty;
 
         static ImageSet *mEmotes;
         static int mInstances;
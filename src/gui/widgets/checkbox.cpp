@@ -310,7 +310,10 @@ void CheckBox::toggleSelected()
 void CheckBox::setCaption(const std::string& caption)
 {
     if (caption != mCaption)
+    {
         mTextChanged = true;
+        contentChanged();
+    }
     mCaption = caption;
 }
 
@@ -153,7 +153,7 @@ class CheckBox final : public Widget,
          * @see isSelected
          */
         void setSelected(const bool selected)
-        { mSelected = selected; }
+        { mSelected = selected; contentChanged(); }
 
         /**
          * Gets the caption of the check box.
@@ -512,8 +512,11 @@ int DropDown::getSelected() const
 
 void DropDown::setSelected(int selected)
 {
-    if (selected >= 0)
+    if (selected >= 0 && selected != mPopup->getSelected())
+    {
         mPopup->setSelected(selected);
+        contentChanged();
+    }
 }
 
 void DropDown::setListModel(ListModel *const listModel)
@@ -524,6 +527,7 @@ void DropDown::setListModel(ListModel *const listModel)
         mPopup->setSelected(0);
 
     adjustHeight();
+    contentChanged();
 }
 
 ListModel *DropDown::getListModel()
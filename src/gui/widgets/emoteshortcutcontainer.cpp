@@ -44,6 +44,7 @@
 
 #include "resources/sprite/animatedsprite.h"
 
+#include "utils/foreach.h"
 #include "utils/stringutils.h"
 
 #include "debug.h"
@@ -83,6 +84,19 @@ void EmoteShortcutContainer::setSkin(const Widget2 *const widget,
     mForegroundColor2 = getThemeColor(ThemeColorId::TEXT_OUTLINE, 255U);
 }
 
+size_t EmoteShortcutContainer::getContentHash() const
+{
+    size_t hash = 0U;
+    FOR_EACH (STD_VECTOR<const EmoteSprite*>::const_iterator, it, mEmoteImg)
+    {
+        const EmoteSprite *const emoteImg = *it;
+        hash = hashContent(hash, emoteImg);
+        if (emoteImg != nullptr && emoteImg->sprite != nullptr)
+            hash = hashContent(hash, emoteImg->sprite->getImage());
+    }
+    return hash;
+}
+
 void EmoteShortcutContainer::draw(Graphics *restrict graphics) restrict2
 {
     if (emoteShortcut == nullptr)
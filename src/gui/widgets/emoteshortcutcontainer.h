@@ -82,6 +82,9 @@ class EmoteShortcutContainer final : public ShortcutContainer
         void setSkin(const Widget2 *const widget,
                      Skin *const skin) override final;
 
+    protected:
+        size_t getContentHash() const override final A_WARN_UNUSED;
+
     private:
         STD_VECTOR<const EmoteSprite*> mEmoteImg;
 
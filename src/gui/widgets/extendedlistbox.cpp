@@ -28,6 +28,9 @@
 
 #include "render/graphics.h"
 
+#include <algorithm>
+#include <climits>
+
 #include "debug.h"
 
 ExtendedListBox::ExtendedListBox(const Widget2 *const widget,
@@ -35,11 +38,18 @@ ExtendedListBox::ExtendedListBox(const Widget2 *const widget,
                                  const std::string &skin,
                                  const unsigned int rowHeight) :
     ListBox(widget, listModel, skin),
+    mLayoutModel(nullptr),
     mImagePadding(mSkin != nullptr ? mSkin->getOption("imagePadding") : 0),
     mSpacing(mSkin != nullptr ? mSkin->getOption("spacing") : 0),
     mHeight(0),
+    mLayoutWidth(-1),
     mListItems(),
-    mSelectedItems()
+    mSelectedItems(),
+    mRowTexts(),
+    mRowImages(),
+    mRowSplits(),
+    mRowsY(),
+    mRowsDirty(true)
 {
     if (rowHeight != 0U)
         mRowHeight = rowHeight;
@@ -68,53 +78,21 @@ void ExtendedListBox::draw(Graphics *const graphics)
     if (textPos < 0)
         textPos = 0;
 
-    const int sz = mListModel->getNumberOfElements();
+    // collect only rows visible in clip area
+    const ClipRect &cr = graphics->getTopClip();
+    const int yStart = cr.y - cr.yOffset - mPadding;
+    const int yEnd = yStart + cr.height;
+
+    updateRows(model, font, width - pad2, yEnd);
+    const int sz = CAST_S32(mRowsY.size());
+    int start = CAST_S32(std::upper_bound(mRowsY.begin(),
+        mRowsY.end(), yStart) - mRowsY.begin()) - 1;
+    if (start < 0)
+        start = 0;
     mListItems.clear();
     mSelectedItems.clear();
-    int y = 0;
-    const int insideWidth = width - pad2;
-    for (int f = 0; f < sz; f ++)
-    {
-        int row = f;
-        bool useImage = true;
-        std::string str = mListModel->getElementAt(f);
-        int strWidth = font->getWidth(str) + 8;
-
-        const Image *const image = model->getImageAt(row);
-        if (image != nullptr)
-            strWidth += image->getWidth() + mImagePadding;
-
-        STD_VECTOR<ExtendedListBoxItem> &list =
-            row == mSelected ? mSelectedItems : mListItems;
-
-        if (insideWidth < strWidth)
-        {
-            const size_t strSize = str.size();
-            size_t divPos = strSize / 2;
-            if (divPos > 0 && CAST_U8(
-                str[divPos - 1]) >= 0xc0)
-            {
-                divPos --;
-            }
-            for (size_t d = divPos; d > 10; d --)
-            {
-                if (str[d] == 32)
-                {
-                    divPos = d + 1;
-                    break;
-                }
-            }
-            list.push_back(ExtendedListBoxItem(row,
-                str.substr(0, divPos), useImage, y));
-            str = str.substr(divPos);
-            y += height;
-            useImage = false;
-        }
-        list.push_back(ExtendedListBoxItem(row, str, useImage, y));
-
-        y += height;
-    }
-    mHeight = y + height;
+    for (int f = start; f < sz && mRowsY[f] < yEnd; f ++)
+        addRowItems(f);
 
     const size_t itemsSz = mListItems.size();
     const size_t selSz = mSelectedItems.size();
@@ -217,41 +195,152 @@ void ExtendedListBox::draw(Graphics *const graphics)
     BLOCK_END("ExtendedListBox::draw")
 }
 
+void ExtendedListBox::updateRows(ExtendedListModel *const model,
+                                 const Font *const font,
+                                 const int insideWidth,
+                                 const int endY)
+{
+    if (insideWidth != mLayoutWidth)
+    {
+        mLayoutWidth = insideWidth;
+        mRowTexts.clear();
+    }
+
+    const int height = CAST_S32(mRowHeight);
+    const int sz = mListModel->getNumberOfElements();
+    const size_t cachedSz = mRowTexts.size();
+    // positions of rows below endY still valid if this stay false
+    bool moved = CAST_SIZE(sz) != cachedSz;
+    mRowTexts.resize(sz);
+    mRowImages.resize(sz, nullptr);
+    mRowSplits.resize(sz, std::string::npos);
+    mRowsY.resize(sz, 0);
+    int y = 0;
+    for (int f = 0; f < sz; f ++)
+    {
+        if (y >= endY && !moved)
+            return;
+        mRowsY[f] = y;
+        std::string str = mListModel->getElementAt(f);
+        const Image *const image = model->getImageAt(f);
+        if (CAST_SIZE(f) >= cachedSz ||
+            image != mRowImages[f] ||
+            str != mRowTexts[f])
+        {
+            int strWidth = font->getWidth(str) + 8;
+            if (image != nullptr)
+                strWidth += image->getWidth() + mImagePadding;
+
+            size_t divPos = std::string::npos;
+            if (insideWidth < strWidth)
+            {
+                const size_t strSize = str.size();
+                divPos = strSize / 2;
+                if (divPos > 0 && CAST_U8(
+                    str[divPos - 1]) >= 0xc0)
+                {
+                    divPos --;
+                }
+                for (size_t d = divPos; d > 10; d --)
+                {
+                    if (str[d] == 32)
+                    {
+                        divPos = d + 1;
+                        break;
+                    }
+                }
+            }
+            if ((divPos == std::string::npos) !=
+                (mRowSplits[f] == std::string::npos))
+            {
+                moved = true;
+            }
+            mRowImages[f] = image;
+            mRowSplits[f] = divPos;
+            mRowTexts[f].swap(str);
+        }
+        y += mRowSplits[f] == std::string::npos ? height : 2 * height;
+    }
+    mHeight = y + height;
+}
+
+void ExtendedListBox::addRowItems(const int row)
+{
+    STD_VECTOR<ExtendedListBoxItem> &list =
+        row == mSelected ? mSelectedItems : mListItems;
+    const std::string &str = mRowTexts[row];
+    const size_t divPos = mRowSplits[row];
+    const int y = mRowsY[row];
+    if (divPos != std::string::npos)
+    {
+        list.push_back(ExtendedListBoxItem(row,
+            str.substr(0, divPos), true, y));
+        list.push_back(ExtendedListBoxItem(row,
+            str.substr(divPos), false, y + CAST_S32(mRowHeight)));
+    }
+    else
+    {
+        list.push_back(ExtendedListBoxItem(row, str, true, y));
+    }
+}
+
 void ExtendedListBox::safeDraw(Graphics *const graphics)
 {
     ExtendedListBox::draw(graphics);
 }
 
+bool ExtendedListBox::isRowsDirty(const int insideWidth)
+{
+    return mRowsDirty ||
+        mLayoutModel != mListModel ||
+        insideWidth != mLayoutWidth ||
+        mListModel->getNumberOfElements() != CAST_S32(mRowTexts.size());
+}
+
 void ExtendedListBox::adjustSize()
 {
+    // called from logic on each tick. All rows measured only after model,
+    // row count, font or width changed. Other rows checked in draw
+    // when they become visible.
+    Font *const font = getFont();
+    const int insideWidth = mDimension.width - 2 - mPadding;
+    if (mListModel != nullptr &&
+        font != nullptr &&
+        isRowsDirty(insideWidth))
+    {
+        updateRows(static_cast<ExtendedListModel *>(mListModel),
+            font,
+            insideWidth,
+            INT_MAX);
+        mLayoutModel = mListModel;
+        mRowsDirty = false;
+    }
     if (mHeight != 0)
         setHeight(mHeight + 2 * mPadding);
     else
         ListBox::adjustSize();
 }
 
+void ExtendedListBox::fontChanged()
+{
+    // all rows measured again in next update
+    mRowTexts.clear();
+    mRowsDirty = true;
+}
+
 int ExtendedListBox::getSelectionByMouse(const int y) const
 {
-    if (mListItems.empty() && mSelectedItems.empty())
+    if (mRowsY.empty())
         return ListBox::getSelectionByMouse(y);
 
     const int height = CAST_S32(mRowHeight);
-    const size_t itemsSz = mListItems.size();
-    for (size_t f = 0; f < itemsSz; f ++)
-    {
-        const ExtendedListBoxItem &item = mListItems[f];
-        const int y2 = item.y + mPadding;
-        if (y2 <= y && y2 + height > y)
-            return item.row;
-    }
-
-    const size_t selSz = mSelectedItems.size();
-    for (size_t f = 0; f < selSz; f ++)
-    {
-        const ExtendedListBoxItem &item = mSelectedItems[f];
-        const int y2 = item.y + mPadding;
-        if (y2 <= y && y2 + height > y)
-            return item.row;
-    }
+    const int y2 = y - mPadding;
+    const int row = CAST_S32(std::upper_bound(mRowsY.begin(),
+        mRowsY.end(), y2) - mRowsY.begin()) - 1;
+    if (row < 0)
+        return 0;
+    const int lines = mRowSplits[row] == std::string::npos ? 1 : 2;
+    if (y2 < mRowsY[row] + lines * height)
+        return row;
     return 0;
 }
@@ -24,6 +24,10 @@
 #include "gui/widgets/extendedlistboxitem.h"
 #include "gui/widgets/listbox.h"
 
+class ExtendedListModel;
+class Font;
+class Image;
+
 class ExtendedListBox final : public ListBox
 {
     public:
@@ -50,12 +54,48 @@ class ExtendedListBox final : public ListBox
 
         int getSelectionByMouse(const int y) const override final;
 
+        void fontChanged() override final;
+
+#ifdef UNITTESTS
+        const STD_VECTOR<int> &getRowsY() const noexcept2
+        { return mRowsY; }
+
+        int getLayoutHeight() const noexcept2
+        { return mHeight; }
+#endif  // UNITTESTS
+
     protected:
+        /**
+         * Updates cached text layout for changed rows.
+         * Rows starting below endY checked only if row count or
+         * height of some row above changed.
+         */
+        void updateRows(ExtendedListModel *const model,
+                        const Font *const font,
+                        const int insideWidth,
+                        const int endY) A_NONNULL(2, 3);
+
+        void addRowItems(const int row);
+
+        /**
+         * Returns true if rows below visible area need new layout.
+         */
+        bool isRowsDirty(const int insideWidth) A_WARN_UNUSED;
+
+        // model used for current layout
+        ListModel *mLayoutModel;
         int mImagePadding;
         int mSpacing;
         int mHeight;
+        int mLayoutWidth;
         STD_VECTOR<ExtendedListBoxItem> mListItems;
         STD_VECTOR<ExtendedListBoxItem> mSelectedItems;
+        STD_VECTOR<std::string> mRowTexts;
+        STD_VECTOR<const Image*> mRowImages;
+        // position where row text wrapped or npos
+        STD_VECTOR<size_t> mRowSplits;
+        STD_VECTOR<int> mRowsY;
+        bool mRowsDirty;
 };
 
 #endif  // GUI_WIDGETS_EXTENDEDLISTBOX_H
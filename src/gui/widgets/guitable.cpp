@@ -206,6 +206,7 @@ void GuiTable::installActionListeners()
     const int rows = mModel->getRows();
     const int columns = mModel->getColumns();
 
+    mActionListeners2.resize(CAST_SIZE(rows * columns), nullptr);
     for (int row = 0; row < rows; ++row)
     {
         for (int column = 0; column < columns; ++column)
@@ -213,8 +214,8 @@ void GuiTable::installActionListeners()
             Widget *const widget = mModel->getElementAt(row, column);
             if (widget != nullptr)
             {
-                mActionListeners2.push_back(new GuiTableActionListener(
-                    this, widget, row, column));
+                mActionListeners2[CAST_SIZE(row * columns + column)] =
+                    new GuiTableActionListener(this, widget, row, column);
             }
         }
     }
@@ -235,7 +236,6 @@ void GuiTable::draw(Graphics *const graphics)
     const Rect &rect = mDimension;
     const int width = rect.width;
     const int height = rect.height;
-    const int y = rect.y;
     if (mOpaque == Opaque_true)
     {
         mBackgroundColor.a = CAST_U32(mAlpha * 255.0F);
@@ -248,13 +248,19 @@ void GuiTable::draw(Graphics *const graphics)
     int rHeight = getRowHeight();
     if (rHeight == 0)
         rHeight = 1;
-    int first_row = -(y / rHeight);
+    const ClipRect &cr = graphics->getTopClip();
+    const int yStart = cr.y - cr.yOffset;
+    int first_row = yStart / rHeight;
 
     if (first_row < 0)
         first_row = 0;
 
-    unsigned int rows_nr = CAST_U32(1 +
-        height / rHeight);  // May overestimate by one.
+    // draw only rows visible in clip area
+    int last_row = (yStart + cr.height) / rHeight;
+    if (last_row < first_row)
+        last_row = first_row;
+    unsigned int rows_nr = CAST_U32(
+        1 + last_row - first_row);  // May overestimate by one.
     unsigned int max_rows_nr;
     if (mModel->getRows() < first_row)
     {
@@ -353,7 +359,6 @@ void GuiTable::safeDraw(Graphics *const graphics)
     const Rect &rect = mDimension;
     const int width = rect.width;
     const int height = rect.height;
-    const int y = rect.y;
     if (mOpaque == Opaque_true)
     {
         mBackgroundColor.a = CAST_U32(mAlpha * 255.0F);
@@ -366,13 +371,19 @@ void GuiTable::safeDraw(Graphics *const graphics)
     int rHeight = getRowHeight();
     if (rHeight == 0)
         rHeight = 1;
-    int first_row = -(y / rHeight);
+    const ClipRect &cr = graphics->getTopClip();
+    const int yStart = cr.y - cr.yOffset;
+    int first_row = yStart / rHeight;
 
     if (first_row < 0)
         first_row = 0;
 
+    // draw only rows visible in clip area
+    int last_row = (yStart + cr.height) / rHeight;
+    if (last_row < first_row)
+        last_row = first_row;
     unsigned int rows_nr = CAST_U32(
-        1 + height / rHeight);  // May overestimate by one.
+        1 + last_row - first_row);  // May overestimate by one.
     unsigned int max_rows_nr;
     if (mModel->getRows() < first_row)
     {
@@ -577,8 +588,45 @@ void GuiTable::mouseDragged(MouseEvent& event)
     setSelectedColumn(getColumnForX(x));
 }
 
+void GuiTable::cellUpdated(const int row,
+                           const int column,
+                           const bool completed)
+{
+    contentChanged();
+    const int columns = mModel->getColumns();
+    const size_t idx = CAST_SIZE(row * columns + column);
+    if (mActionListeners2.size() != CAST_SIZE(mModel->getRows() * columns))
+    {
+        modelUpdated(completed);
+        return;
+    }
+
+    if (!completed)
+    {
+        if (mTopWidget != nullptr &&
+            mTopWidget == mModel->getElementAt(row, column))
+        {
+            mTopWidget = nullptr;
+        }
+        delete2(mActionListeners2[idx])
+        return;
+    }
+
+    Widget *const widget = mModel->getElementAt(row, column);
+    if (widget != nullptr)
+    {
+        delete mActionListeners2[idx];
+        mActionListeners2[idx] = new GuiTableActionListener(
+            this, widget, row, column);
+        if (mFocusHandler != nullptr)
+            widget->setFocusHandler(mFocusHandler);
+    }
+    recomputeDimensions();
+}
+
 void GuiTable::modelUpdated(const bool completed)
 {
+    contentChanged();
     if (completed)
     {
         recomputeDimensions();
@@ -157,6 +157,10 @@ class GuiTable final : public Widget,
         // Constraints inherited from TableModelListener
         void modelUpdated(const bool completed) override final;
 
+        void cellUpdated(const int row,
+                         const int column,
+                         const bool completed) override final;
+
         void requestFocus() override;
 
         void setSelectableGui(bool b)
@@ -187,7 +191,7 @@ class GuiTable final : public Widget,
         /** If someone moves a fresh widget to the top, we must display it. */
         Widget *mTopWidget;
 
-        /** Vector for compactness; used as a list in practice. */
+        /** Action listeners indexed by cell, null for empty cells. */
         STD_VECTOR<GuiTableActionListener *> mActionListeners2;
 
         /**
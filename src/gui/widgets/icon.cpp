@@ -73,6 +73,7 @@ Icon::~Icon()
 void Icon::setImage(Image *const image)
 {
     mImage = image;
+    contentChanged();
     if (mImage != nullptr)
     {
         const SDL_Rect &bounds = mImage->mBounds;
@@ -68,157 +68,63 @@
 
 namespace
 {
-    class ItemIdPair final
-    {
-        public:
-            A_DELETE_COPY(ItemIdPair)
-
-            ItemIdPair(const int id, Item *const item) :
-                mId(id), mItem(item)
-            {
-            }
-
-            int mId;
-            Item* mItem;
-    };
+    // use full sort if more slots changed
+    const int maxMovedSlotsDivider = 8;
 
-    class SortItemAlphaFunctor final
+    class SortSlotKeyFunctor final
     {
         public:
-            A_DEFAULT_COPY(SortItemAlphaFunctor)
-
-            bool operator() (const ItemIdPair *const pair1,
-                             const ItemIdPair *const pair2) const
+            SortSlotKeyFunctor(const STD_VECTOR<ItemSlotKey> &keys,
+                               const bool byKey) :
+                mKeys(&keys),
+                mByKey(byKey)
             {
-                const Item *const item1 = pair1->mItem;
-                const Item *const item2 = pair2->mItem;
-                if ((item1 == nullptr) || (item2 == nullptr))
-                    return false;
-
-                const std::string name1 = item1->getInfo().getName(
-                    item1->getColor());
-                const std::string name2 = item2->getInfo().getName(
-                    item2->getColor());
-                if (name1 == name2)
-                {
-                    return item1->getInvIndex() <
-                        item2->getInvIndex();
-                }
-                return name1 < name2;
             }
-    } itemAlphaInvSorter;
 
-    class SortItemIdFunctor final
-    {
-        public:
-            A_DEFAULT_COPY(SortItemIdFunctor)
+            A_DEFAULT_COPY(SortSlotKeyFunctor)
 
-            bool operator() (const ItemIdPair *const pair1,
-                             const ItemIdPair *const pair2) const
+            bool operator() (const int slot1,
+                             const int slot2) const
             {
-                if ((pair1->mItem == nullptr) || (pair2->mItem == nullptr))
-                    return false;
-
-                const int id1 = pair1->mItem->getId();
-                const int id2 = pair2->mItem->getId();
-                if (id1 == id2)
-                {
-                    return pair1->mItem->getInvIndex() <
-                        pair2->mItem->getInvIndex();
-                }
-                return id1 < id2;
+                // without sorting keep inventory order
+                if (!mByKey)
+                    return slot1 < slot2;
+                const ItemSlotKey &key1 = (*mKeys)[slot1];
+                const ItemSlotKey &key2 = (*mKeys)[slot2];
+                // empty slots always after items
+                if (key1.valid != key2.valid)
+                    return key1.valid;
+                if (key1.value != key2.value)
+                    return key1.value < key2.value;
+                const int cmp = key1.name.compare(key2.name);
+                if (cmp != 0)
+                    return cmp < 0;
+                return slot1 < slot2;
             }
-    } itemIdInvSorter;
-
-    class SortItemWeightFunctor final
-    {
-        public:
-            A_DEFAULT_COPY(SortItemWeightFunctor)
-
-            bool operator() (const ItemIdPair *const pair1,
-                             const ItemIdPair *const pair2) const
-            {
-                if ((pair1->mItem == nullptr) || (pair2->mItem == nullptr))
-                    return false;
 
-                const int w1 = pair1->mItem->getInfo().getWeight();
-                const int w2 = pair2->mItem->getInfo().getWeight();
-                if (w1 == w2)
-                {
-                    const std::string name1 =
-                        pair1->mItem->getInfo().getName();
-                    const std::string name2 =
-                        pair2->mItem->getInfo().getName();
-                    if (name1 == name2)
-                    {
-                        return pair1->mItem->getInvIndex() <
-                            pair2->mItem->getInvIndex();
-                    }
-                    return name1 < name2;
-                }
-                return w1 < w2;
-            }
-    } itemWeightInvSorter;
+        private:
+            const STD_VECTOR<ItemSlotKey> *mKeys;
+            bool mByKey;
+    };
 
-    class SortItemAmountFunctor final
+    class MovedSlotKeyFunctor final
     {
         public:
-            A_DEFAULT_COPY(SortItemAmountFunctor)
-
-            bool operator() (const ItemIdPair *const pair1,
-                             const ItemIdPair *const pair2) const
+            explicit MovedSlotKeyFunctor(const STD_VECTOR<ItemSlotKey> &keys) :
+                mKeys(&keys)
             {
-                if ((pair1->mItem == nullptr) || (pair2->mItem == nullptr))
-                    return false;
-
-                const int c1 = pair1->mItem->getQuantity();
-                const int c2 = pair2->mItem->getQuantity();
-                if (c1 == c2)
-                {
-                    const std::string name1 =
-                        pair1->mItem->getInfo().getName();
-                    const std::string name2 =
-                        pair2->mItem->getInfo().getName();
-                    if (name1 == name2)
-                    {
-                        return pair1->mItem->getInvIndex() <
-                            pair2->mItem->getInvIndex();
-                    }
-                    return name1 < name2;
-                }
-                return c1 < c2;
             }
-    } itemAmountInvSorter;
 
-    class SortItemTypeFunctor final
-    {
-        public:
-            A_DEFAULT_COPY(SortItemTypeFunctor)
+            A_DEFAULT_COPY(MovedSlotKeyFunctor)
 
-            bool operator() (const ItemIdPair *const pair1,
-                             const ItemIdPair *const pair2) const
+            bool operator() (const int slot) const
             {
-                if ((pair1->mItem == nullptr) || (pair2->mItem == nullptr))
-                    return false;
-
-                const ItemInfo &info1 = pair1->mItem->getInfo();
-                const ItemInfo &info2 = pair2->mItem->getInfo();
-                const ItemDbTypeT t1 = info1.getType();
-                const ItemDbTypeT t2 = info2.getType();
-                if (t1 == t2)
-                {
-                    const std::string &name1 = info1.getName();
-                    const std::string &name2 = info2.getName();
-                    if (name1 == name2)
-                    {
-                        return pair1->mItem->getInvIndex() <
-                            pair2->mItem->getInvIndex();
-                    }
-                    return name1 < name2;
-                }
-                return t1 < t2;
+                return (*mKeys)[slot].moved;
             }
-    } itemTypeInvSorter;
+
+        private:
+            const STD_VECTOR<ItemSlotKey> *mKeys;
+    };
 }  // namespace
 
 ItemContainer::ItemContainer(const Widget2 *const widget,
@@ -235,16 +141,21 @@ ItemContainer::ItemContainer(const Widget2 *const widget,
     mProtectedImg(Theme::getImageFromTheme("lock.png")),
     mCellBackgroundImg(Theme::getImageFromThemeXml("inventory_cell.xml", "")),
     mName(),
+    mKeysFilter(),
+    mSlotKeys(),
+    mSortedSlots(),
     mShowMatrix(nullptr),
     mSkin(theme != nullptr ? theme->load("itemcontainer.xml", "",
         true, Theme::getThemePath()) : nullptr),
     mVertexes(new ImageCollection),
+    mKeysInventory(nullptr),
     mEquipedColor(getThemeColor(ThemeColorId::ITEM_EQUIPPED, 255U)),
     mEquipedColor2(getThemeColor(ThemeColorId::ITEM_EQUIPPED_OUTLINE, 255U)),
     mUnEquipedColor(getThemeColor(ThemeColorId::ITEM_NOT_EQUIPPED, 255U)),
     mUnEquipedColor2(getThemeColor(ThemeColorId::ITEM_NOT_EQUIPPED_OUTLINE,
         255U)),
     mSelectionListeners(),
+    mContentHash(0U),
     mGridColumns(1),
     mGridRows(1),
     mDrawRows(1),
@@ -252,6 +163,8 @@ ItemContainer::ItemContainer(const Widget2 *const widget,
     mLastUsedSlot(-1),
     mTag(0),
     mSortType(0),
+    mKeysTag(0),
+    mKeysSortType(0),
     mClicks(1),
     mBoxWidth(mSkin != nullptr ? mSkin->getOption("boxWidth", 35) : 35),
     mBoxHeight(mSkin != nullptr ? mSkin->getOption("boxHeight", 43) : 43),
@@ -318,9 +231,44 @@ void ItemContainer::logic()
         mLastUsedSlot = lastUsedSlot;
         adjustHeight();
     }
+
+    // inventory items drawn without change notifications
+    const size_t hash = getContentHash();
+    if (hash != mContentHash)
+    {
+        mContentHash = hash;
+        contentChanged();
+    }
     BLOCK_END("ItemContainer::logic")
 }
 
+size_t ItemContainer::getContentHash() const
+{
+    if (mShowMatrix == nullptr)
+        return 0U;
+
+    size_t hash = hashContent(CAST_SIZE(mDrawRows),
+        CAST_SIZE(mSelectedIndex));
+    const int sz = mDrawRows * mGridColumns;
+    for (int f = 0; f < sz; f ++)
+    {
+        const int index = mShowMatrix[f];
+        if (index < 0)
+            continue;
+        const Item *const item = mInventory->getItem(index);
+        if (item == nullptr)
+            continue;
+        hash = hashContent(hash, CAST_SIZE(f));
+        hash = hashContent(hash, CAST_SIZE(item->getId()));
+        hash = hashContent(hash, item->getImage());
+        hash = hashContent(hash, CAST_SIZE(item->getQuantity()));
+        hash = hashContent(hash, CAST_SIZE(item->isEquipped()));
+        hash = hashContent(hash, CAST_SIZE(
+            PlayerInfo::isItemProtected(item->getId())));
+    }
+    return hash;
+}
+
 void ItemContainer::draw(Graphics *const graphics)
 {
     if ((mInventory == nullptr) || (mShowMatrix == nullptr))
@@ -1173,93 +1121,165 @@ int ItemContainer::updateMatrix()
     delete []mShowMatrix;
     mShowMatrix = new int[CAST_SIZE(mGridRows * mGridColumns)];
 
-    STD_VECTOR<ItemIdPair*> sortedItems;
-    int i = 0;
-    int j = 0;
+    updateSortedSlots();
 
-    std::string temp = mName;
-    toLower(temp);
+    const int num = CAST_S32(mSortedSlots.size());
+    const int maxSize = mGridRows * mGridColumns;
+    const int shown = std::min(num, maxSize);
+    for (int idx = 0; idx < shown; idx ++)
+        mShowMatrix[idx] = mSortedSlots[idx];
+    for (int idx = shown; idx < maxSize; idx ++)
+        mShowMatrix[idx] = -1;
+    return num;
+}
 
+void ItemContainer::updateSortedSlots()
+{
     const unsigned int invSize = mInventory->getSize();
-    for (unsigned int idx = 0; idx < invSize; idx ++)
+    const bool rebuild = mKeysInventory != mInventory ||
+        mKeysTag != mTag ||
+        mKeysSortType != mSortType ||
+        mSlotKeys.size() != invSize;
+    if (rebuild)
     {
-        Item *const item = mInventory->getItem(idx);
+        mSlotKeys.clear();
+        mSlotKeys.resize(invSize);
+        mKeysInventory = mInventory;
+        mKeysTag = mTag;
+        mKeysSortType = mSortType;
+    }
+
+    std::string filter = mName;
+    toLower(filter);
+    const bool filterChanged = filter != mKeysFilter;
+    // longer filter can only hide items what already visible
+    const bool filterNarrowed = filterChanged &&
+        filter.find(mKeysFilter) != std::string::npos;
+    mKeysFilter = filter;
 
-        if (item == nullptr ||
-            item->getId() == 0 ||
-            !item->isHaveTag(mTag) ||
-            item->getQuantity() == 0)
+    const bool showEmpty = mShowEmptyRows == ShowEmptyRows_true;
+    unsigned int moved = 0;
+    for (unsigned int idx = 0; idx < invSize; idx ++)
+    {
+        ItemSlotKey &key = mSlotKeys[idx];
+        const Item *const item = mInventory->getItem(idx);
+        const bool changed = rebuild ||
+            item != key.item ||
+            (item != nullptr &&
+            (item->getId() != key.id ||
+            item->getQuantity() != key.quantity ||
+            item->getColor() != key.color));
+
+        if (changed)
         {
-            if (mShowEmptyRows == ShowEmptyRows_true)
-                sortedItems.push_back(new ItemIdPair(idx, nullptr));
-            continue;
+            key.item = item;
+            key.name.clear();
+            key.value = 0;
+            if (item != nullptr)
+            {
+                key.id = item->getId();
+                key.quantity = item->getQuantity();
+                key.color = item->getColor();
+            }
+            else
+            {
+                key.id = 0;
+                key.quantity = 0;
+                key.color = ItemColor_zero;
+            }
+            key.valid = item != nullptr &&
+                key.id != 0 &&
+                key.quantity != 0 &&
+                item->isHaveTag(mTag);
+            if (key.valid)
+            {
+                const ItemInfo &info = item->getInfo();
+                switch (mSortType)
+                {
+                    case 0:
+                    default:
+                        break;
+                    case 1:
+                        key.name = info.getName(key.color);
+                        break;
+                    case 2:
+                        key.value = key.id;
+                        break;
+                    case 3:
+                        key.value = info.getWeight();
+                        key.name = info.getName();
+                        break;
+                    case 4:
+                        key.value = key.quantity;
+                        key.name = info.getName();
+                        break;
+                    case 5:
+                        key.value = CAST_S32(info.getType());
+                        key.name = info.getName();
+                        break;
+                }
+            }
         }
-
-        if (!item->isHaveTag(mTag))
+        else if (!filterChanged ||
+                 (filterNarrowed && !key.visible))
+        {
             continue;
+        }
 
-        if (mName.empty())
+        bool visible = showEmpty;
+        if (key.valid)
         {
-            sortedItems.push_back(new ItemIdPair(idx, item));
-            continue;
+            visible = filter.empty() ||
+                item->getInfo().getNameLower().find(filter) !=
+                std::string::npos;
+        }
+        if (changed || visible != key.visible)
+        {
+            key.visible = visible;
+            key.moved = true;
+            moved ++;
         }
-        std::string name = item->getInfo().getName();
-        toLower(name);
-        if (name.find(temp) != std::string::npos)
-            sortedItems.push_back(new ItemIdPair(idx, item));
     }
 
-    switch (mSortType)
-    {
-        case 0:
-        default:
-            break;
-        case 1:
-            std::sort(sortedItems.begin(), sortedItems.end(),
-                itemAlphaInvSorter);
-            break;
-        case 2:
-            std::sort(sortedItems.begin(), sortedItems.end(), itemIdInvSorter);
-            break;
-        case 3:
-            std::sort(sortedItems.begin(), sortedItems.end(),
-                itemWeightInvSorter);
-            break;
-        case 4:
-            std::sort(sortedItems.begin(), sortedItems.end(),
-                itemAmountInvSorter);
-            break;
-        case 5:
-            std::sort(sortedItems.begin(), sortedItems.end(),
-                itemTypeInvSorter);
-            break;
-    }
+    if (moved == 0)
+        return;
 
-    int jMult = j * mGridColumns;
-    const int maxSize = mGridRows * mGridColumns;
-    FOR_EACH (STD_VECTOR<ItemIdPair*>::const_iterator, iter, sortedItems)
+    const SortSlotKeyFunctor sorter(mSlotKeys, mSortType != 0);
+    if (rebuild || moved > invSize / maxMovedSlotsDivider)
     {
-        if (jMult >= maxSize)
-            break;
-
-        mShowMatrix[jMult + i] = (*iter)->mId;
-
-        i ++;
-        if (i >= mGridColumns)
+        mSortedSlots.clear();
+        for (unsigned int idx = 0; idx < invSize; idx ++)
         {
-            i = 0;
-            j ++;
-            jMult += mGridColumns;
+            ItemSlotKey &key = mSlotKeys[idx];
+            key.moved = false;
+            if (key.visible)
+                mSortedSlots.push_back(CAST_S32(idx));
         }
+        if (mSortType != 0)
+            std::sort(mSortedSlots.begin(), mSortedSlots.end(), sorter);
+        return;
     }
 
-    for (int idx = j * mGridColumns + i; idx < maxSize; idx ++)
-        mShowMatrix[idx] = -1;
-
-    const int num = CAST_S32(sortedItems.size());
-    for (size_t idx = 0, sz = num; idx < sz; idx ++)
-        delete sortedItems[idx];
-    return num;
+    // remove changed slots and insert them back at new sorted positions
+    mSortedSlots.erase(std::remove_if(mSortedSlots.begin(),
+        mSortedSlots.end(),
+        MovedSlotKeyFunctor(mSlotKeys)),
+        mSortedSlots.end());
+    for (unsigned int idx = 0; idx < invSize; idx ++)
+    {
+        ItemSlotKey &key = mSlotKeys[idx];
+        if (!key.moved)
+            continue;
+        key.moved = false;
+        if (!key.visible)
+            continue;
+        const int slot = CAST_S32(idx);
+        mSortedSlots.insert(std::lower_bound(mSortedSlots.begin(),
+            mSortedSlots.end(),
+            slot,
+            sorter),
+            slot);
+    }
 }
 
 int ItemContainer::getSlotIndex(int x, int y) const
@@ -28,10 +28,13 @@
 #include "listeners/widgetlistener.h"
 
 #include "enums/simpletypes/forcequantity.h"
+#include "enums/simpletypes/itemcolor.h"
 #include "enums/simpletypes/showemptyrows.h"
 
 #include "gui/widgets/widget.h"
 
+#include "utils/vector.h"
+
 #include "localconsts.h"
 
 class Image;
@@ -40,6 +43,37 @@ class Inventory;
 class Item;
 class SelectionListener;
 
+/**
+ * Cached filter and sort keys for one inventory slot.
+ */
+struct ItemSlotKey final
+{
+    ItemSlotKey() :
+        name(),
+        item(nullptr),
+        id(0),
+        quantity(0),
+        value(0),
+        color(ItemColor_zero),
+        valid(false),
+        visible(false),
+        moved(false)
+    {
+    }
+
+    A_DEFAULT_COPY(ItemSlotKey)
+
+    std::string name;
+    const Item *item;
+    int id;
+    int quantity;
+    int value;
+    ItemColor color;
+    bool valid;
+    bool visible;
+    bool moved;
+};
+
 /**
  * An item container. Used to show items in inventory and trade dialog.
  *
@@ -138,6 +172,11 @@ class ItemContainer final : public Widget,
 
         void setMaxColumns(const int maxColumns);
 
+#ifdef UNITTESTS
+        const STD_VECTOR<int> &getSortedSlots() const noexcept2
+        { return mSortedSlots; }
+#endif  // UNITTESTS
+
     private:
         enum Direction
         {
@@ -173,6 +212,11 @@ class ItemContainer final : public Widget,
 
         void updateSize();
 
+        /**
+         * Updates cached keys of changed slots and keeps sorted slots list.
+         */
+        void updateSortedSlots();
+
         /**
          * Gets the inventory slot index based on the cursor position.
          *
@@ -184,15 +228,24 @@ class ItemContainer final : public Widget,
 
         int getSlotByXY(int x, int y) const;
 
+        /**
+         * Gets hash of drawn items.
+         */
+        size_t getContentHash() const A_WARN_UNUSED;
+
         Inventory *mInventory;
         Image *mSelImg;
         Image *mProtectedImg;
         Image *mCellBackgroundImg;
         std::string mName;
+        std::string mKeysFilter;
+        STD_VECTOR<ItemSlotKey> mSlotKeys;
+        STD_VECTOR<int> mSortedSlots;
 
         int *mShowMatrix;
         Skin *mSkin;
         ImageCollection *mVertexes;
+        const Inventory *mKeysInventory;
         Color mEquipedColor;
         Color mEquipedColor2;
         Color mUnEquipedColor;
@@ -200,6 +253,7 @@ class ItemContainer final : public Widget,
         typedef std::list<SelectionListener*> SelectionListenerList;
         typedef SelectionListenerList::iterator SelectionListenerIterator;
         SelectionListenerList mSelectionListeners;
+        size_t mContentHash;
         int mGridColumns;
         int mGridRows;
         int mDrawRows;
@@ -207,6 +261,8 @@ class ItemContainer final : public Widget,
         int mLastUsedSlot;
         int mTag;
         int mSortType;
+        int mKeysTag;
+        int mKeysSortType;
         int mClicks;
         int mBoxWidth;
         int mBoxHeight;
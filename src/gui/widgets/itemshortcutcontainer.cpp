@@ -92,6 +92,51 @@ void ItemShortcutContainer::setSkin(const Widget2 *const widget,
     }
 }
 
+size_t ItemShortcutContainer::getContentHash() const
+{
+    const ItemShortcut *const selShortcut = itemShortcut[mNumber];
+    const Inventory *const inv = PlayerInfo::getInventory();
+    if (selShortcut == nullptr || inv == nullptr)
+        return 0U;
+
+    size_t hash = 0U;
+    for (unsigned i = 0; i < mMaxItems; i++)
+    {
+        const int itemId = selShortcut->getItem(i);
+        hash = hashContent(hash, CAST_SIZE(itemId));
+        if (itemId < 0)
+            continue;
+
+        if (itemId < SPELL_MIN_ID)
+        {
+            const Item *const item = inv->findItem(itemId,
+                selShortcut->getItemColor(i));
+            if (item != nullptr)
+            {
+                hash = hashContent(hash, item->getImage());
+                hash = hashContent(hash, CAST_SIZE(item->getQuantity()));
+                hash = hashContent(hash, CAST_SIZE(item->isEquipped()));
+            }
+        }
+        else if (itemId < SKILL_MIN_ID && (spellManager != nullptr))
+        {
+            const TextCommand *const spell = spellManager
+                ->getSpellByItem(itemId);
+            if (spell != nullptr)
+            {
+                hash = hashContent(hash, spell->getImage());
+                hash = hashContent(hash, spell->getSymbol());
+            }
+        }
+        else if (skillDialog != nullptr)
+        {
+            hash = hashContent(hash, skillDialog->getSkill(
+                itemId - SKILL_MIN_ID));
+        }
+    }
+    return hash;
+}
+
 void ItemShortcutContainer::draw(Graphics *const graphics)
 {
     BLOCK_START("ItemShortcutContainer::draw")
@@ -77,6 +77,9 @@ class ItemShortcutContainer final : public ShortcutContainer
         void setSkin(const Widget2 *const widget,
                      Skin *const skin) override final;
 
+    protected:
+        size_t getContentHash() const override final A_WARN_UNUSED;
+
     private:
         Color mEquipedColor;
         Color mEquipedColor2;
@@ -207,7 +207,10 @@ void Label::adjustSize()
 void Label::setForegroundColor(const Color &color)
 {
     if (mForegroundColor != color || mForegroundColor2 != color)
+    {
         mTextChanged = true;
+        contentChanged();
+    }
 //    logger->log("Label::setForegroundColor: " + mCaption);
     mForegroundColor = color;
     mForegroundColor2 = color;
@@ -217,7 +220,10 @@ void Label::setForegroundColorAll(const Color &color1,
                                   const Color &color2)
 {
     if (mForegroundColor != color1 || mForegroundColor2 != color2)
+    {
         mTextChanged = true;
+        contentChanged();
+    }
 //    logger->log("Label::setForegroundColorAll: " + mCaption);
     mForegroundColor = color1;
     mForegroundColor2 = color2;
@@ -263,7 +269,10 @@ void Label::resizeTo(const int maxSize, const int minSize)
 void Label::setCaption(const std::string& caption)
 {
     if (caption != mCaption)
+    {
         mTextChanged = true;
+        contentChanged();
+    }
     mCaption = caption;
 }
 
@@ -33,8 +33,13 @@
 
 LayoutArray::LayoutArray() :
     mCells(),
-    mSpacing(4)
+    mSpacing(4),
+    mDirty(true)
 {
+    mFillUpp[0] = 0;
+    mFillUpp[1] = 0;
+    mFillValid[0] = false;
+    mFillValid[1] = false;
 }
 
 LayoutArray::~LayoutArray()
@@ -62,7 +67,10 @@ LayoutCell &LayoutArray::at(const int x, const int y,
     resizeGrid(x + w, y + h);
     LayoutCell *&cell = mCells[CAST_SIZE(y)][static_cast<size_t>(x)];
     if (cell == nullptr)
+    {
         cell = new LayoutCell;
+        cell->mParent = this;
+    }
     return *cell;
 }
 
@@ -74,6 +82,8 @@ void LayoutArray::resizeGrid(int w, const int h)
     if (!extW && !extH)
         return;
 
+    mDirty = true;
+
     if (extH)
     {
         mSizes[1].resize(CAST_SIZE(h), LayoutType::DEF);
@@ -100,12 +110,14 @@ void LayoutArray::setColWidth(const int n, const int w)
 {
     resizeGrid(n + 1, 0);
     mSizes[0U][CAST_SIZE(n)] = w;
+    mDirty = true;
 }
 
 void LayoutArray::setRowHeight(const int n, const int h)
 {
     resizeGrid(0, n + 1);
     mSizes[1][CAST_SIZE(n)] = h;
+    mDirty = true;
 }
 
 void LayoutArray::matchColWidth(const int n1, const int n2)
@@ -116,6 +128,7 @@ void LayoutArray::matchColWidth(const int n1, const int n2)
         widths[CAST_SIZE(n2)]);
     mSizes[0][CAST_SIZE(n1)] = s;
     mSizes[0][CAST_SIZE(n2)] = s;
+    mDirty = true;
 }
 
 void LayoutArray::extend(const int x, const int y, const int w, const int h)
@@ -123,6 +136,7 @@ void LayoutArray::extend(const int x, const int y, const int w, const int h)
     LayoutCell &cell = at(x, y, w, h);
     cell.mExtent[0] = w;
     cell.mExtent[1] = h;
+    mDirty = true;
 }
 
 LayoutCell &LayoutArray::place(Widget *const widget, const int x,
@@ -154,6 +168,7 @@ LayoutCell &LayoutArray::place(Widget *const widget, const int x,
         cs = 0;
     if (rs == LayoutType::DEF && h == 1)
         rs = 0;
+    mDirty = true;
     return cell;
 }
 
@@ -192,14 +207,15 @@ void LayoutArray::align(int &restrict pos, int &restrict size, const int dim,
     }
 }
 
-STD_VECTOR<int> LayoutArray::getSizes(const int dim, int upp) const
+void LayoutArray::updateMinSizes()
 {
-    if (dim < 0 || dim >= 2)
-        return mSizes[1];
+    if (!mDirty)
+        return;
 
     const int gridW = CAST_S32(mSizes[0].size());
     const int gridH = CAST_S32(mSizes[1].size());
-    STD_VECTOR<int> sizes = mSizes[dim];
+    mMinSizes[0] = mSizes[0];
+    mMinSizes[1] = mSizes[1];
 
     // Compute minimum sizes.
     for (int gridY = 0; gridY < gridH; ++gridY)
@@ -211,16 +227,32 @@ STD_VECTOR<int> LayoutArray::getSizes(const int dim, int upp) const
             if ((cell == nullptr) || cell->mType == LayoutCell::NONE)
                 continue;
 
-            if (cell->mExtent[dim] == 1)
+            for (int dim = 0; dim < 2; ++dim)
             {
+                if (cell->mExtent[dim] != 1)
+                    continue;
                 const int n = (dim == 0 ? gridX : gridY);
                 const int s = cell->mSize[dim] + cell->mVPadding * 2;
+                STD_VECTOR<int> &sizes = mMinSizes[dim];
                 if (s > sizes[CAST_SIZE(n)])
                     sizes[CAST_SIZE(n)] = s;
             }
         }
     }
 
+    mFillValid[0] = false;
+    mFillValid[1] = false;
+    mDirty = false;
+}
+
+STD_VECTOR<int> LayoutArray::getSizes(const int dim, int upp)
+{
+    if (dim < 0 || dim >= 2)
+        return mSizes[1];
+
+    updateMinSizes();
+    STD_VECTOR<int> sizes = mMinSizes[dim];
+
     if (upp == LayoutType::DEF)
         return sizes;
 
@@ -264,7 +296,20 @@ STD_VECTOR<int> LayoutArray::getSizes(const int dim, int upp) const
     return sizes;
 }
 
-int LayoutArray::getSize(const int dim) const
+const STD_VECTOR<int> &LayoutArray::getFillSizes(const int dim,
+                                                 const int upp)
+{
+    updateMinSizes();
+    if (!mFillValid[dim] || mFillUpp[dim] != upp)
+    {
+        mFillSizes[dim] = getSizes(dim, upp);
+        mFillUpp[dim] = upp;
+        mFillValid[dim] = true;
+    }
+    return mFillSizes[dim];
+}
+
+int LayoutArray::getSize(const int dim)
 {
     STD_VECTOR<int> sizes = getSizes(dim, LayoutType::DEF);
     int size = 0;
@@ -284,8 +329,9 @@ void LayoutArray::reflow(const int nx, const int ny,
     const int gridW = CAST_S32(mSizes[0].size());
     const int gridH = CAST_S32(mSizes[1].size());
 
-    STD_VECTOR<int> widths  = getSizes(0, nw);
-    STD_VECTOR<int> heights = getSizes(1, nh);
+    // copies, because resized widgets may change this layout
+    const STD_VECTOR<int> widths  = getFillSizes(0, nw);
+    const STD_VECTOR<int> heights = getFillSizes(1, nh);
 
     const int szW = CAST_S32(widths.size());
     const int szH = CAST_S32(heights.size());
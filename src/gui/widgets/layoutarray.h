@@ -116,17 +116,34 @@ class LayoutArray final
          * Gets the column/row sizes along a given axis.
          * @param upp target size for the array. Ignored if AUTO_DEF.
          */
-        STD_VECTOR<int> getSizes(const int dim, int upp) const A_WARN_UNUSED;
+        STD_VECTOR<int> getSizes(const int dim, int upp) A_WARN_UNUSED;
+
+        /**
+         * Gets the column/row sizes along a given axis.
+         * Result cached until layout or target size changed.
+         */
+        const STD_VECTOR<int> &getFillSizes(const int dim,
+                                            const int upp) A_WARN_UNUSED;
+
+        /**
+         * Updates cached minimum sizes if layout changed.
+         */
+        void updateMinSizes();
 
         /**
          * Gets the total size along a given axis.
          */
-        int getSize(const int dim) const A_WARN_UNUSED;
+        int getSize(const int dim) A_WARN_UNUSED;
 
         STD_VECTOR<int> mSizes[2];
         STD_VECTOR< STD_VECTOR < LayoutCell * > > mCells;
+        STD_VECTOR<int> mMinSizes[2];
+        STD_VECTOR<int> mFillSizes[2];
 
         int mSpacing;
+        int mFillUpp[2];
+        bool mFillValid[2];
+        bool mDirty;
 };
 
 #endif  // GUI_WIDGETS_LAYOUTARRAY_H
@@ -51,6 +51,7 @@ LayoutArray &LayoutCell::getArray()
 
     mArray = new LayoutArray;
     mType = ARRAY;
+    setParentDirty();
     mExtent[0] = 1;
     mExtent[1] = 1;
     mHPadding = 0;
@@ -100,6 +101,13 @@ void LayoutCell::computeSizes()
 
     mSize[0] = mArray->getSize(0);
     mSize[1] = mArray->getSize(1);
+    setParentDirty();
+}
+
+void LayoutCell::setParentDirty()
+{
+    if (mParent != nullptr)
+        mParent->mDirty = true;
 }
 
 LayoutCell &LayoutCell::at(const int x, const int y)
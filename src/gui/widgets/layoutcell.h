@@ -57,7 +57,7 @@ class LayoutCell notfinal
          * Sets the padding around the cell content.
          */
         LayoutCell &setPadding(int p)
-        { mHPadding = p; mVPadding = p; return *this; }
+        { mHPadding = p; mVPadding = p; setParentDirty(); return *this; }
 
         int getVPadding() const
         { return mVPadding; }
@@ -69,7 +69,7 @@ class LayoutCell notfinal
          * Sets the vertical padding around the cell content.
          */
         LayoutCell &setVPadding(int p)
-        { mVPadding = p; return *this; }
+        { mVPadding = p; setParentDirty(); return *this; }
 
         /**
          * Sets the horisontal padding around the cell content.
@@ -131,7 +131,7 @@ class LayoutCell notfinal
         void computeSizes();
 
         void setType(int t)
-        { mType = t; }
+        { mType = t; setParentDirty(); }
 
         int getWidth() const noexcept2 A_WARN_UNUSED
         { return mExtent[0]; }
@@ -139,11 +139,11 @@ class LayoutCell notfinal
         int getHeight() const noexcept2 A_WARN_UNUSED
         { return mExtent[1]; }
 
-        void setWidth(const int w) noexcept2
-        { mExtent[0] = w; }
+        void setWidth(const int w)
+        { mExtent[0] = w; setParentDirty(); }
 
-        void setHeight(const int h) noexcept2
-        { mExtent[1] = h; }
+        void setHeight(const int h)
+        { mExtent[1] = h; setParentDirty(); }
 
         enum
         {
@@ -157,6 +157,7 @@ class LayoutCell notfinal
     private:
         LayoutCell() :
             mWidget(nullptr),
+            mParent(nullptr),
             mHPadding(0),
             mVPadding(0),
             mType(NONE)
@@ -192,6 +193,12 @@ class LayoutCell notfinal
          */
         void reflow(int nx, int ny, int nw, int nh);
 
+        /**
+         * Drops cached sizes of array what owns this cell.
+         */
+        void setParentDirty();
+
+        LayoutArray *mParent;
         int mSize[2];
         int mHPadding;
         int mVPadding;
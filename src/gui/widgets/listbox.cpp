@@ -104,6 +104,7 @@ ListBox::ListBox(const Widget2 *const widget,
     mPadding(0),
     mPressedIndex(-2),
     mRowHeight(0),
+    mContentHash(0U),
     mItemPadding(1),
     mSkin(nullptr),
     mDistributeMousePressed(true),
@@ -173,6 +174,10 @@ void ListBox::draw(Graphics *const graphics)
     const int rowHeight = CAST_S32(getRowHeight());
     const int width = mDimension.width;
 
+    int start = 0;
+    int end = 0;
+    getVisibleRows(graphics, mPadding, rowHeight, start, end);
+
     if (mCenterText)
     {
         // Draw filled rectangle around the selected list element
@@ -191,9 +196,8 @@ void ListBox::draw(Graphics *const graphics)
                 mSelected * rowHeight + mPadding + mItemPadding);
         }
         // Draw the list elements
-        const int sz = mListModel->getNumberOfElements();
-        for (int i = 0, y = mPadding + mItemPadding;
-             i < sz; ++i, y += rowHeight)
+        for (int i = start, y = mPadding + mItemPadding + start * rowHeight;
+             i < end; ++i, y += rowHeight)
         {
             if (i != mSelected)
             {
@@ -224,9 +228,8 @@ void ListBox::draw(Graphics *const graphics)
                 mSelected * rowHeight + mPadding + mItemPadding);
         }
         // Draw the list elements
-        const int sz = mListModel->getNumberOfElements();
-        for (int i = 0, y = mPadding + mItemPadding; i < sz;
-             ++i, y += rowHeight)
+        for (int i = start, y = mPadding + mItemPadding + start * rowHeight;
+             i < end; ++i, y += rowHeight)
         {
             if (i != mSelected)
             {
@@ -242,6 +245,30 @@ void ListBox::draw(Graphics *const graphics)
     BLOCK_END("ListBox::draw")
 }
 
+void ListBox::getVisibleRows(const Graphics *const graphics,
+                             const int top,
+                             const int rowHeight,
+                             int &start,
+                             int &end) const
+{
+    const int sz = mListModel->getNumberOfElements();
+    if (rowHeight <= 0)
+    {
+        start = 0;
+        end = sz;
+        return;
+    }
+    const ClipRect &cr = graphics->getTopClip();
+    const int yStart = cr.y - cr.yOffset - top;
+    const int yEnd = yStart + cr.height;
+    start = yStart > 0 ? yStart / rowHeight : 0;
+    end = yEnd > 0 ? (yEnd + rowHeight - 1) / rowHeight : 0;
+    if (end > sz)
+        end = sz;
+    if (start > end)
+        start = end;
+}
+
 void ListBox::keyPressed(KeyEvent &event)
 {
     const InputActionT action = event.getActionId();
@@ -385,9 +412,43 @@ void ListBox::logic()
 {
     BLOCK_START("ListBox::logic")
     adjustSize();
+    // list models have no change notifications
+    const size_t hash = getContentHash();
+    if (hash != mContentHash)
+    {
+        mContentHash = hash;
+        contentChanged();
+    }
     BLOCK_END("ListBox::logic")
 }
 
+size_t ListBox::getContentHash() const
+{
+    if (mListModel == nullptr)
+        return 0U;
+
+    const int sz = mListModel->getNumberOfElements();
+    size_t hash = hashContent(CAST_SIZE(sz), CAST_SIZE(mSelected));
+    int start = 0;
+    int end = sz;
+    const int rowHeight = CAST_S32(getRowHeight());
+    if (mParent != nullptr && rowHeight > 0)
+    {
+        // rows outside of scroll area not drawn
+        const int yStart = -mDimension.y - mPadding;
+        start = yStart > 0 ? yStart / rowHeight : 0;
+        end = std::min(sz, start + mParent->getHeight() / rowHeight + 2);
+    }
+    for (int f = start; f < end; f ++)
+        hash = hashContent(hash, getRowHash(f));
+    return hash;
+}
+
+size_t ListBox::getRowHash(const int row) const
+{
+    return hashContent(0U, mListModel->getElementAt(row));
+}
+
 int ListBox::getSelectionByMouse(const int y) const
 {
     if (y < mPadding)
@@ -410,6 +471,7 @@ void ListBox::setSelected(const int selected)
         else
             mSelected = selected;
     }
+    contentChanged();
 
     Rect scroll;
 
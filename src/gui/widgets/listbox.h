@@ -249,6 +249,29 @@ class ListBox notfinal : public Widget,
         void distributeValueChangedEvent();
 
     protected:
+        /**
+         * Gets range of rows visible in current clip area.
+         *
+         * @param top position of first row.
+         * @param start first visible row.
+         * @param end row after last visible row.
+         */
+        void getVisibleRows(const Graphics *const graphics,
+                            const int top,
+                            const int rowHeight,
+                            int &start,
+                            int &end) const A_NONNULL(2);
+
+        /**
+         * Gets hash of row content. Override if row shows more than text.
+         */
+        virtual size_t getRowHash(const int row) const A_WARN_UNUSED;
+
+        /**
+         * Gets hash of rows visible in parent.
+         */
+        size_t getContentHash() const A_WARN_UNUSED;
+
         /**
          * The selected item as an index in the list model.
          */
@@ -286,6 +309,7 @@ class ListBox notfinal : public Widget,
         int mPadding;
         int mPressedIndex;
         unsigned int mRowHeight;
+        size_t mContentHash;
         int mItemPadding;
         Skin *mSkin;
         static float mAlpha;
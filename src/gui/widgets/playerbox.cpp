@@ -33,6 +33,8 @@
 
 #include "resources/image/image.h"
 
+#include "utils/foreach.h"
+
 #include "debug.h"
 
 PlayerBox::PlayerBox(Widget2 *const widget,
@@ -47,6 +49,7 @@ PlayerBox::PlayerBox(Widget2 *const widget,
     mSelectedBackground(),
     mSkin(nullptr),
     mSelectedSkin(nullptr),
+    mContentHash(0U),
     mOffsetX(-mapTileSize / 2),
     mOffsetY(-mapTileSize),
     mDrawBackground(false),
@@ -66,6 +69,7 @@ PlayerBox::PlayerBox(Widget2 *const widget,
     mSelectedBackground(),
     mSkin(nullptr),
     mSelectedSkin(nullptr),
+    mContentHash(0U),
     mOffsetX(-mapTileSize / 2),
     mOffsetY(-mapTileSize),
     mDrawBackground(false),
@@ -86,7 +90,6 @@ PlayerBox::~PlayerBox()
 
 void PlayerBox::init(std::string name, std::string selectedName)
 {
-    mAllowLogic = false;
     setFrameSize(2);
     addMouseListener(this);
 
@@ -123,6 +126,27 @@ void PlayerBox::init(std::string name, std::string selectedName)
     }
 }
 
+void PlayerBox::logic()
+{
+    BLOCK_START("PlayerBox::logic")
+    size_t hash = hashContent(0U, mBeing);
+    if (mBeing != nullptr)
+    {
+        FOR_EACH (CompoundSprite::SpriteConstIterator, it, mBeing->mSprites)
+        {
+            const Sprite *const sprite = *it;
+            if (sprite != nullptr)
+                hash = hashContent(hash, sprite->getImage());
+        }
+    }
+    if (hash != mContentHash)
+    {
+        mContentHash = hash;
+        contentChanged();
+    }
+    BLOCK_END("PlayerBox::logic")
+}
+
 void PlayerBox::draw(Graphics *const graphics)
 {
     BLOCK_START("PlayerBox::draw")
@@ -71,7 +71,12 @@ class PlayerBox final : public Widget,
          * character.
          */
         void setPlayer(Being *being)
-        { mBeing = being; }
+        { mBeing = being; contentChanged(); }
+
+        /**
+         * Being sprites animated without change notifications.
+         */
+        void logic() override final;
 
         /**
          * Draws the scroll area.
@@ -92,7 +97,7 @@ class PlayerBox final : public Widget,
         { return mBeing; }
 
         void setSelected(bool b)
-        { mSelected = b; }
+        { mSelected = b; contentChanged(); }
 
         void mouseReleased(MouseEvent& event) override final;
 
@@ -103,6 +108,7 @@ class PlayerBox final : public Widget,
         ImageRect mSelectedBackground;
         Skin *mSkin;
         Skin *mSelectedSkin;
+        size_t mContentHash;
         int mOffsetX;
         int mOffsetY;
         bool mDrawBackground;
@@ -143,6 +143,7 @@ void ProgressBar::logic()
         if (mBackgroundColorToGo.b < mBackgroundColor.b)
             mBackgroundColor.b--;
         mRedraw = true;
+        contentChanged();
     }
 
     if (mSmoothProgress && mProgressToGo != mProgress)
@@ -153,6 +154,7 @@ void ProgressBar::logic()
         if (mProgressToGo < mProgress)
             mProgress = std::max(0.0F, mProgress - 0.005F);
         mRedraw = true;
+        contentChanged();
     }
     BLOCK_END("ProgressBar::logic")
 }
@@ -319,6 +321,7 @@ void ProgressBar::setProgress(const float progress)
     const float p = std::min(1.0F, std::max(0.0F, progress));
     mProgressToGo = p;
     mRedraw = true;
+    contentChanged();
 
     if (!mSmoothProgress)
         mProgress = p;
@@ -335,6 +338,7 @@ void ProgressBar::setProgressPalette(const ProgressColorIdT progressPalette)
     const ProgressColorIdT oldPalette = mProgressPalette;
     mProgressPalette = progressPalette;
     mRedraw = true;
+    contentChanged();
 
     if (mProgressPalette != oldPalette &&
         mProgressPalette >= ProgressColorId::PROG_HP)
@@ -347,6 +351,7 @@ void ProgressBar::setProgressPalette(const ProgressColorIdT progressPalette)
 void ProgressBar::setBackgroundColor(const Color &color)
 {
     mRedraw = true;
+    contentChanged();
     mBackgroundColorToGo = color;
 
     if (!mSmoothColorChange)
@@ -358,6 +363,7 @@ void ProgressBar::setColor(const Color &color1, const Color &color2)
     mForegroundColor = color1;
     mForegroundColor2 = color2;
     mTextChanged = true;
+    contentChanged();
 }
 
 void ProgressBar::widgetResized(const Event &event A_UNUSED)
@@ -376,6 +382,7 @@ void ProgressBar::setText(const std::string &str)
     {
         mText = str;
         mTextChanged = true;
+        contentChanged();
     }
 }
 
@@ -66,8 +66,8 @@ ProgressIndicator::~ProgressIndicator()
 void ProgressIndicator::logic()
 {
     BLOCK_START("ProgressIndicator::logic")
-    if (mIndicator != nullptr)
-        mIndicator->update(10);
+    if (mIndicator != nullptr && mIndicator->update(10))
+        contentChanged();
     BLOCK_END("ProgressIndicator::logic")
 }
 
@@ -301,7 +301,11 @@ void RadioButton::setSelected(const bool selected)
         }
     }
 
-    mSelected = selected;
+    if (mSelected != selected)
+    {
+        mSelected = selected;
+        contentChanged();
+    }
 }
 
 void RadioButton::mouseClicked(MouseEvent& event)
@@ -345,7 +349,10 @@ void RadioButton::setGroup(const std::string &group)
 void RadioButton::setCaption(const std::string& caption)
 {
     if (caption != mCaption)
+    {
         mTextChanged = true;
+        contentChanged();
+    }
     mCaption = caption;
 }
 
@@ -1215,12 +1215,14 @@ void ScrollArea::setHorizontalScrollPolicy(const ScrollPolicy hPolicy)
 {
     mHPolicy = hPolicy;
     checkPolicies();
+    contentChanged();
 }
 
 void ScrollArea::setVerticalScrollPolicy(const ScrollPolicy vPolicy)
 {
     mVPolicy = vPolicy;
     checkPolicies();
+    contentChanged();
 }
 
 void ScrollArea::setScrollPolicy(const ScrollPolicy hPolicy,
@@ -1229,11 +1231,13 @@ void ScrollArea::setScrollPolicy(const ScrollPolicy hPolicy,
     mHPolicy = hPolicy;
     mVPolicy = vPolicy;
     checkPolicies();
+    contentChanged();
 }
 
 void ScrollArea::setVerticalScrollAmount(const int vScroll)
 {
     const int max = getVerticalMaxScroll();
+    const int oldScroll = mVScroll;
 
     mVScroll = vScroll;
 
@@ -1242,11 +1246,15 @@ void ScrollArea::setVerticalScrollAmount(const int vScroll)
 
     if (vScroll < 0)
         mVScroll = 0;
+
+    if (mVScroll != oldScroll)
+        contentChanged();
 }
 
 void ScrollArea::setHorizontalScrollAmount(int hScroll)
 {
     const int max = getHorizontalMaxScroll();
+    const int oldScroll = mHScroll;
 
     mHScroll = hScroll;
 
@@ -1254,6 +1262,9 @@ void ScrollArea::setHorizontalScrollAmount(int hScroll)
         mHScroll = max;
     else if (hScroll < 0)
         mHScroll = 0;
+
+    if (mHScroll != oldScroll)
+        contentChanged();
 }
 
 void ScrollArea::setScrollAmount(const int hScroll, const int vScroll)
@@ -1301,7 +1312,10 @@ int ScrollArea::getVerticalMaxScroll()
 void ScrollArea::setScrollbarWidth(const int width)
 {
     if (width > 0)
+    {
         mScrollbarWidth = width;
+        contentChanged();
+    }
 }
 
 void ScrollArea::showWidgetPart(Widget *const widget, const Rect &area)
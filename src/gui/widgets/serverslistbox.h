@@ -77,7 +77,10 @@ class ServersListBox final : public ListBox
             const int pad2 = height / 4 + mPadding;
             const int width = getWidth();
             // Draw the list elements
-            for (int i = 0, y = 0; i < model->getNumberOfElements();
+            int start = 0;
+            int end = 0;
+            getVisibleRows(graphics, mPadding, height, start, end);
+            for (int i = start, y = start * height; i < end;
                  ++i, y += height)
             {
                 const ServerInfo &info = model->getServer(i);
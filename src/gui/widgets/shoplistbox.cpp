@@ -86,6 +86,7 @@ ShopListBox::ShopListBox(const Widget2 *const widget,
 void ShopListBox::setPlayersMoney(const int money)
 {
     mPlayerMoney = money;
+    contentChanged();
 }
 
 void ShopListBox::draw(Graphics *const graphics)
@@ -103,13 +104,16 @@ void ShopListBox::draw(Graphics *const graphics)
     const unsigned int alpha = CAST_U32(mAlpha * 255.0F);
     Font *const font = getFont();
 
-    const int sz = mListModel->getNumberOfElements();
     const int fontHeigh = getFont()->getHeight();
     const int width = mDimension.width - 2 * mPadding;
+    const int rowHeight = CAST_S32(mRowHeight);
+    int start = 0;
+    int end = 0;
+    getVisibleRows(graphics, mPadding, rowHeight, start, end);
     // Draw the list elements
-    for (int i = 0, y = 0;
-         i < sz;
-         ++i, y += mRowHeight)
+    for (int i = start, y = start * rowHeight;
+         i < end;
+         ++i, y += rowHeight)
     {
         bool needDraw(false);
         Color temp;
@@ -205,6 +209,21 @@ void ShopListBox::adjustSize()
 void ShopListBox::setPriceCheck(const bool check)
 {
     mPriceCheck = check;
+    contentChanged();
+}
+
+size_t ShopListBox::getRowHash(const int row) const
+{
+    size_t hash = ListBox::getRowHash(row);
+    if (mShopItems == nullptr)
+        return hash;
+    const ShopItem *const item = mShopItems->at(row);
+    if (item == nullptr)
+        return hash;
+    hash = hashContent(hash, item->getImage());
+    hash = hashContent(hash, CAST_SIZE(item->getDisabled()));
+    return hashContent(hash, CAST_SIZE(mProtectItems &&
+        PlayerInfo::isItemProtected(item->getId())));
 }
 
 void ShopListBox::mouseMoved(MouseEvent &event)
@@ -86,7 +86,7 @@ class ShopListBox final : public ListBox
         void mouseExited(MouseEvent& event) override final;
 
         void setProtectItems(bool p)
-        { mProtectItems = p; }
+        { mProtectItems = p; contentChanged(); }
 
         void setType(const ShopListBoxTypeT type)
         { mType = type; }
@@ -94,6 +94,9 @@ class ShopListBox final : public ListBox
         ShopListBoxTypeT getType() const
         { return mType; }
 
+    protected:
+        size_t getRowHash(const int row) const override final A_WARN_UNUSED;
+
     private:
         int mPlayerMoney;
 
@@ -54,7 +54,8 @@ ShortcutContainer::ShortcutContainer(Widget2 *const widget) :
     mImageOffsetY(2),
     mTextOffsetX(2),
     mTextOffsetY(2),
-    mVertexes(new ImageCollection)
+    mVertexes(new ImageCollection),
+    mContentHash(0U)
 {
     mAllowLogic = false;
 
@@ -110,6 +111,18 @@ void ShortcutContainer::widgetResized(const Event &event A_UNUSED)
     mRedraw = true;
 }
 
+void ShortcutContainer::logic()
+{
+    BLOCK_START("ShortcutContainer::logic")
+    const size_t hash = getContentHash();
+    if (hash != mContentHash)
+    {
+        mContentHash = hash;
+        contentChanged();
+    }
+    BLOCK_END("ShortcutContainer::logic")
+}
+
 int ShortcutContainer::getIndexFromGrid(const int pointX,
                                         const int pointY) const
 {
@@ -57,6 +57,11 @@ class ShortcutContainer notfinal : public Widget,
 
         void widgetMoved(const Event& event) override final;
 
+        /**
+         * Item amounts and cooldowns drawn without change notifications.
+         */
+        void logic() override final;
+
         /**
          * Handles mouse when dragged.
          */
@@ -110,6 +115,11 @@ class ShortcutContainer notfinal : public Widget,
         int getIndexFromGrid(const int pointX,
                              const int pointY) const A_WARN_UNUSED;
 
+        /**
+         * Gets hash of drawn shortcuts.
+         */
+        virtual size_t getContentHash() const A_WARN_UNUSED = 0;
+
         Image *mBackgroundImg;
         Skin *mSkin;
         static float mAlpha;
@@ -124,6 +134,7 @@ class ShortcutContainer notfinal : public Widget,
         int mTextOffsetX;
         int mTextOffsetY;
         ImageCollection *mVertexes;
+        size_t mContentHash;
 };
 
 #endif  // GUI_WIDGETS_SHORTCUTCONTAINER_H
@@ -115,10 +115,15 @@ class SkillListBox final : public ListBox
             const int space = font->getHeight() + mSpacing;
             const int width2 = width1 - mPadding;
 
+            const int rowHeight = CAST_S32(getRowHeight());
+            int start = 0;
+            int end = 0;
+            getVisibleRows(graphics, 1 + mPadding, rowHeight, start, end);
+
             graphics->setColor(mCooldownColor);
-            for (int i = 0, y = 1 + mPadding;
-                 i < model->getNumberOfElements();
-                 ++i, y += getRowHeight())
+            for (int i = start, y = 1 + mPadding + start * rowHeight;
+                 i < end;
+                 ++i, y += rowHeight)
             {
                 SkillInfo *const e = model->getSkillAt(i);
                 if (e != nullptr)
@@ -131,9 +136,9 @@ class SkillListBox final : public ListBox
                 }
             }
 
-            for (int i = 0, y = 1 + mPadding;
-                 i < model->getNumberOfElements();
-                 ++i, y += getRowHeight())
+            for (int i = start, y = 1 + mPadding + start * rowHeight;
+                 i < end;
+                 ++i, y += rowHeight)
             {
                 SkillInfo *const e = model->getSkillAt(i);
                 if (e != nullptr)
@@ -277,6 +282,20 @@ class SkillListBox final : public ListBox
             skillPopup->hide();
         }
 
+    protected:
+        size_t getRowHash(const int row) const override final A_WARN_UNUSED
+        {
+            const SkillModel *const model = static_cast<SkillModel*>(
+                mListModel);
+            const SkillInfo *const e = model->getSkillAt(row);
+            if (e == nullptr)
+                return 0U;
+            // cooldown bar drawn without notifications
+            size_t hash = hashContent(0U, e->data);
+            hash = hashContent(hash, e->skillLevel);
+            return hashContent(hash, CAST_SIZE(e->cooldown));
+        }
+
     private:
         SkillModel *mModel;
         Color mTextColor;
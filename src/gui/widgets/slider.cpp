@@ -468,11 +468,14 @@ void Slider::setScale(const double scaleStart, const double scaleEnd)
 {
     mScaleStart = scaleStart;
     mScaleEnd = scaleEnd;
+    mRedraw = true;
+    contentChanged();
 }
 
 void Slider::setValue(const double value)
 {
     mRedraw = true;
+    const double oldValue = mValue;
     if (value > mScaleEnd)
         mValue = mScaleEnd;
     else if (value < mScaleStart)
@@ -481,6 +484,8 @@ void Slider::setValue(const double value)
         mValue = value;
     mValue = CAST_S32((mValue - mScaleStart) / mStepLength)
         * mStepLength + mScaleStart;
+    if (mValue != oldValue)
+        contentChanged();
 }
 
 double Slider::markerPositionToValue(const int v) const
@@ -64,6 +64,30 @@ void SpellShortcutContainer::setSkin(const Widget2 *const widget,
     mForegroundColor2 = getThemeColor(ThemeColorId::TEXT_OUTLINE, 255U);
 }
 
+size_t SpellShortcutContainer::getContentHash() const
+{
+    if (spellShortcut == nullptr)
+        return 0U;
+
+    size_t hash = hashContent(0U,
+        CAST_SIZE(spellShortcut->getSelectedItem()));
+    for (unsigned i = 0; i < mMaxItems; i++)
+    {
+        const int itemId = getItemByIndex(i);
+        hash = hashContent(hash, CAST_SIZE(itemId));
+        if (spellManager == nullptr)
+            continue;
+
+        const TextCommand *const spell = spellManager->getSpell(itemId);
+        if (spell != nullptr)
+        {
+            hash = hashContent(hash, spell->getImage());
+            hash = hashContent(hash, spell->getSymbol());
+        }
+    }
+    return hash;
+}
+
 void SpellShortcutContainer::draw(Graphics *const graphics)
 {
     if (spellShortcut == nullptr)
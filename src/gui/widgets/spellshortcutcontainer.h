@@ -79,6 +79,9 @@ class SpellShortcutContainer final : public ShortcutContainer
 
         int getItemByIndex(const int index) const A_WARN_UNUSED;
 
+    protected:
+        size_t getContentHash() const override final A_WARN_UNUSED;
+
     private:
         unsigned int mNumber;
         bool mSpellClicked;
@@ -182,6 +182,7 @@ void StaticBrowserBox::addRow(const std::string &row,
     if (getWidth() < 0)
         return;
 
+    contentChanged();
     mSeparator = false;
 
     if (mProcessVars)
@@ -311,6 +312,7 @@ void StaticBrowserBox::addImage(const std::string &path)
 
 void StaticBrowserBox::clearRows()
 {
+    contentChanged();
     mTextRows.clear();
     mTextRowLinksCount.clear();
     mLinks.clear();
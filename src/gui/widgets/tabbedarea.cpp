@@ -426,6 +426,7 @@ void TabbedArea::setSelectedTab(Tab *const tab)
         newTab->setCurrent();
 
     widgetResized(Event(nullptr));
+    contentChanged();
 }
 
 void TabbedArea::setSelectedTabDefault()
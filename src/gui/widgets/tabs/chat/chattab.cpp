@@ -87,7 +87,6 @@ ChatTab::ChatTab(const Widget2 *const widget,
     mTextOutput->setMaxRow(config.getIntValue("ChatLogLength"));
     if (chatWindow != nullptr)
         mTextOutput->setLinkHandler(chatWindow->mItemLinkHandler);
-    mTextOutput->setAlwaysUpdate(false);
 
     mScrollArea->setScrollPolicy(ScrollArea::SHOW_NEVER,
         ScrollArea::SHOW_ALWAYS);
@@ -194,6 +194,11 @@ Setup_Misc::Setup_Misc(const Widget2 *const widget) :
         "showExtMinimaps", this, "showExtMinimapsEvent",
         MainConfig_true);
 
+    // TRANSLATORS: settings option
+    new SetupItemIntTextField(_("Extended minimap zoom"), "",
+        "extMinimapZoom", this, "extMinimapZoomEvent", 1, 2,
+        MainConfig_true);
+
     // TRANSLATORS: settings option
     new SetupItemCheckBox(_("Draw path"), "", "drawPath",
         this, "drawPathEvent",
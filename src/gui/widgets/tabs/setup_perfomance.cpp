@@ -126,6 +126,11 @@ Setup_Perfomance::Setup_Perfomance(const Widget2 *const widget) :
         "", "enableDSA", this, "enableDSAEvent",
         MainConfig_true);
 
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Cache windows content (OpenGL, Software)"),
+        "", "windowRenderCache", this, "windowRenderCacheEvent",
+        MainConfig_true);
+
 
     // TRANSLATORS: settings option
     new SetupItemLabel(_("Better quality (disable for better performance)"),
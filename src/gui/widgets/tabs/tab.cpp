@@ -419,6 +419,7 @@ void Tab::setLabelFont(Font *const font)
     mLabel->adjustSize();
     adjustSize();
     mRedraw = true;
+    contentChanged();
 }
 
 
@@ -467,6 +468,7 @@ void Tab::setImage(Image *const image)
         mImage->decRef();
     mImage = image;
     adjustSize();
+    contentChanged();
 }
 
 const std::string &Tab::getCaption() const
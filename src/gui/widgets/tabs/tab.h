@@ -122,6 +122,7 @@ class Tab notfinal : public BasicContainer,
             mTabColor = color1;
             mTabOutlineColor = color2;
             mRedraw = true;
+            contentChanged();
         }
 
         /**
@@ -133,6 +134,7 @@ class Tab notfinal : public BasicContainer,
             mTabHighlightedColor = color1;
             mTabHighlightedOutlineColor = color2;
             mRedraw = true;
+            contentChanged();
         }
 
         /**
@@ -144,6 +146,7 @@ class Tab notfinal : public BasicContainer,
             mTabSelectedColor = color1;
             mTabSelectedOutlineColor = color2;
             mRedraw = true;
+            contentChanged();
         }
 
         /**
@@ -155,6 +158,7 @@ class Tab notfinal : public BasicContainer,
             mFlashColor = color1;
             mFlashOutlineColor = color2;
             mRedraw = true;
+            contentChanged();
         }
 
         /**
@@ -166,13 +170,14 @@ class Tab notfinal : public BasicContainer,
             mPlayerFlashColor = color1;
             mPlayerFlashOutlineColor = color2;
             mRedraw = true;
+            contentChanged();
         }
 
         /**
          * Set tab flashing state
          */
         void setFlash(const int flash)
-        { mFlash = flash; mRedraw = true; }
+        { mFlash = flash; mRedraw = true; contentChanged(); }
 
         int getFlash() const noexcept2 A_WARN_UNUSED
         { return mFlash; }
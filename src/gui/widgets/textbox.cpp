@@ -227,6 +227,7 @@ void TextBox::setText(const std::string& text)
 {
     mCaretColumn = 0;
     mCaretRow = 0;
+    contentChanged();
 
     mTextRows.clear();
     if (text.empty())
@@ -510,6 +511,7 @@ std::string TextBox::getText() const
 void TextBox::setTextRow(const int row, const std::string& text)
 {
     mTextRows[row] = text;
+    contentChanged();
 
     if (mCaretRow == row)
         setCaretColumn(mCaretColumn);
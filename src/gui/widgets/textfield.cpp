@@ -806,6 +806,7 @@ void TextField::setText(const std::string& text)
         mCaretPosition = sz;
     mText = text;
     mTextChanged = true;
+    contentChanged();
 }
 
 void TextField::mouseDragged(MouseEvent& event)
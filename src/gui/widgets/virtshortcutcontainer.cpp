@@ -74,6 +74,32 @@ void VirtShortcutContainer::setSkin(const Widget2 *const widget,
         255U);
 }
 
+size_t VirtShortcutContainer::getContentHash() const
+{
+    const Inventory *const inv = PlayerInfo::getInventory();
+    if (mShortcut == nullptr || inv == nullptr)
+        return 0U;
+
+    size_t hash = 0U;
+    for (unsigned i = 0; i < mMaxItems; i++)
+    {
+        const int itemId = mShortcut->getItem(i);
+        hash = hashContent(hash, CAST_SIZE(itemId));
+        if (itemId < 0)
+            continue;
+
+        const Item *const item = inv->findItem(itemId,
+            mShortcut->getItemColor(i));
+        if (item != nullptr)
+        {
+            hash = hashContent(hash, item->getImage());
+            hash = hashContent(hash, CAST_SIZE(item->getQuantity()));
+            hash = hashContent(hash, CAST_SIZE(item->isEquipped()));
+        }
+    }
+    return hash;
+}
+
 void VirtShortcutContainer::draw(Graphics *const graphics)
 {
     if (mShortcut == nullptr)
@@ -79,6 +79,9 @@ class VirtShortcutContainer final : public ShortcutContainer
         void setSkin(const Widget2 *const widget,
                      Skin *const skin) override final;
 
+    protected:
+        size_t getContentHash() const override final A_WARN_UNUSED;
+
     private:
         bool mItemClicked;
 
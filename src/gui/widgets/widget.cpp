@@ -73,12 +73,15 @@
 #include "listeners/widgetdeathlistener.h"
 #include "listeners/widgetlistener.h"
 
+#include "utils/cast.h"
 #include "utils/foreach.h"
 
 #include "debug.h"
 
 Font* Widget::mGlobalFont = nullptr;
-std::list<Widget*> Widget::mAllWidgets;
+STD_VECTOR<Widget*> Widget::mAllWidgets;
+STD_VECTOR<unsigned int> Widget::mWidgetGenerations;
+STD_VECTOR<unsigned int> Widget::mFreeWidgetSlots;
 std::set<Widget*> Widget::mAllWidgetsSet;
 
 Widget::Widget(const Widget2 *const widget) :
@@ -108,9 +111,22 @@ Widget::Widget(const Widget2 *const widget) :
     mAllowLogic(true),
     mMouseConsume(true),
     mRedraw(true),
-    mSelectable(true)
+    mSelectable(true),
+    mHandle()
 {
-    mAllWidgets.push_back(this);
+    if (mFreeWidgetSlots.empty())
+    {
+        mHandle.slot = CAST_U32(mAllWidgets.size());
+        mAllWidgets.push_back(this);
+        mWidgetGenerations.push_back(1U);
+    }
+    else
+    {
+        mHandle.slot = mFreeWidgetSlots.back();
+        mFreeWidgetSlots.pop_back();
+        mAllWidgets[mHandle.slot] = this;
+    }
+    mHandle.generation = mWidgetGenerations[mHandle.slot];
     mAllWidgetsSet.insert(this);
 }
 
@@ -125,7 +141,13 @@ Widget::~Widget()
     // +++ call to virtual member
     setFocusHandler(nullptr);
 
-    mAllWidgets.remove(this);
+    mAllWidgets[mHandle.slot] = nullptr;
+    // generation 0 reserved for default handle
+    unsigned int &generation = mWidgetGenerations[mHandle.slot];
+    generation ++;
+    if (generation == 0U)
+        generation = 1U;
+    mFreeWidgetSlots.push_back(mHandle.slot);
     mAllWidgetsSet.erase(this);
 }
 
@@ -170,14 +192,23 @@ void Widget::setDimension(const Rect& dimension)
     const Rect oldDimension = mDimension;
     mDimension = dimension;
 
-    if (mDimension.width != oldDimension.width
-        || mDimension.height != oldDimension.height)
-    {
+    const bool resized = mDimension.width != oldDimension.width
+        || mDimension.height != oldDimension.height;
+    const bool moved = mDimension.x != oldDimension.x
+        || mDimension.y != oldDimension.y;
+
+    if (resized)
         distributeResizedEvent();
-    }
 
-    if (mDimension.x != oldDimension.x || mDimension.y != oldDimension.y)
+    if (moved)
         distributeMovedEvent();
+
+    if (resized || moved)
+    {
+        if (mParent != nullptr)
+            mParent->childDimensionChanged();
+        contentChanged();
+    }
 }
 
 bool Widget::isFocused() const
@@ -231,7 +262,11 @@ void Widget::setVisible(Visible visible)
     else
         distributeHiddenEvent();
 
-    mVisible = visible;
+    if (mVisible != visible)
+    {
+        mVisible = visible;
+        contentChanged();
+    }
 }
 
 void Widget::setFocusHandler(FocusHandler *const focusHandler)
@@ -338,10 +373,12 @@ void Widget::setGlobalFont(Font *const font)
 {
     mGlobalFont = font;
 
-    FOR_EACH (std::list<Widget*>::const_iterator, iter, mAllWidgets)
+    // widgets can be created from handlers, so size checked on each step
+    for (size_t f = 0; f < mAllWidgets.size(); f ++)
     {
-        if ((*iter)->mCurrentFont == nullptr)
-            (*iter)->fontChanged();
+        Widget *const widget = mAllWidgets[f];
+        if (widget != nullptr && widget->mCurrentFont == nullptr)
+            widget->fontChanged();
     }
 }
 
@@ -353,8 +390,12 @@ void Widget::setFont(Font *const font)
 
 void Widget::distributeWindowResizeEvent()
 {
-    FOR_EACH (std::list<Widget*>::const_iterator, iter, mAllWidgets)
-        (*iter)->windowResized();
+    for (size_t f = 0; f < mAllWidgets.size(); f ++)
+    {
+        Widget *const widget = mAllWidgets[f];
+        if (widget != nullptr)
+            widget->windowResized();
+    }
 }
 
 bool Widget::widgetExists(const Widget *const widget)
@@ -363,6 +404,13 @@ bool Widget::widgetExists(const Widget *const widget)
         != mAllWidgetsSet.end();
 }
 
+bool Widget::widgetExists(const WidgetHandle &handle)
+{
+    return handle.slot < mWidgetGenerations.size() &&
+        mWidgetGenerations[handle.slot] == handle.generation &&
+        mAllWidgets[handle.slot] != nullptr;
+}
+
 void Widget::setSize(const int width, const int height)
 {
     Rect newDimension = mDimension;
@@ -507,6 +555,26 @@ void Widget::distributeShownEvent()
     }
 }
 
+size_t Widget::hashContent(const size_t hash,
+                           const size_t value)
+{
+    return (hash ^ value) * 16777619U;
+}
+
+size_t Widget::hashContent(size_t hash,
+                           const std::string &str)
+{
+    FOR_EACH (std::string::const_iterator, it, str)
+        hash = hashContent(hash, CAST_SIZE(CAST_U8(*it)));
+    return hash;
+}
+
+size_t Widget::hashContent(const size_t hash,
+                           const void *const ptr)
+{
+    return hashContent(hash, reinterpret_cast<size_t>(ptr));
+}
+
 void Widget::showPart(const Rect &rectangle)
 {
     if (mParent != nullptr)
@@ -69,6 +69,9 @@
 #include "gui/rect.h"
 
 #include "gui/widgets/widget2.h"
+#include "gui/widgets/widgethandle.h"
+
+#include "utils/vector.h"
 
 #include <list>
 
@@ -165,7 +168,7 @@ class Widget notfinal : public Widget2
           * @see getFrameSize, drawFrame
           */
         void setFrameSize(const unsigned int frameSize) noexcept2
-        { mFrameSize = frameSize; }
+        { mFrameSize = frameSize; contentChanged(); }
 
         /**
           * Gets the size of the widget's frame. The frame is not considered a part of
@@ -348,8 +351,14 @@ class Widget notfinal : public Widget2
           *                false otherwise.
           * @see isEnabled
           */
-        void setEnabled(const bool enabled) noexcept2
-        { mEnabled = enabled; }
+        void setEnabled(const bool enabled)
+        {
+            if (mEnabled != enabled)
+            {
+                mEnabled = enabled;
+                contentChanged();
+            }
+        }
 
         /**
           * Checks if the widget is enabled. A disabled
@@ -387,7 +396,7 @@ class Widget notfinal : public Widget2
           * @see getBaseColor
           */
         void setBaseColor(const Color& color) noexcept2
-        { mBaseColor = color; }
+        { mBaseColor = color; contentChanged(); }
 
         /**
           * Gets the base color.
@@ -405,7 +414,7 @@ class Widget notfinal : public Widget2
           * @see getForegroundColor
           */
         void setForegroundColor(const Color& color) noexcept2
-        { mForegroundColor = color; }
+        { mForegroundColor = color; contentChanged(); }
 
         /**
           * Gets the foreground color.
@@ -422,7 +431,7 @@ class Widget notfinal : public Widget2
           * @see setBackgroundColor
           */
         void setBackgroundColor(const Color &color) noexcept2
-        { mBackgroundColor = color; }
+        { mBackgroundColor = color; contentChanged(); }
 
         /**
           * Gets the background color.
@@ -675,6 +684,22 @@ class Widget notfinal : public Widget2
           */
         static bool widgetExists(const Widget *const widget) A_WARN_UNUSED;
 
+        /**
+          * Checks if widget referenced by handle still exists.
+          * Unlike pointer check, handle never matches new widget created
+          * at address of deleted one.
+          *
+          * @param handle The handle of widget to check.
+          * @return True if widget still exists, false otherwise.
+          */
+        static bool widgetExists(const WidgetHandle &handle) A_WARN_UNUSED;
+
+        /**
+          * Gets the handle of widget in widgets registry.
+          */
+        const WidgetHandle &getHandle() const noexcept2 A_WARN_UNUSED
+        { return mHandle; }
+
         /**
           * Checks if tab in is enabled. Tab in means that you can set focus
           * to this widget by pressing the tab button. If tab in is disabled
@@ -866,6 +891,21 @@ class Widget notfinal : public Widget2
         virtual void moveToTop(Widget* widget A_UNUSED)
         { }
 
+        /**
+          * Called by child widget when its position or size changed.
+          */
+        virtual void childDimensionChanged()
+        { }
+
+        /**
+          * Called when widget look changed. Outdates cached window content.
+          */
+        virtual void contentChanged()
+        {
+            if (mParent != nullptr)
+                mParent->contentChanged();
+        }
+
         /**
           * Moves a widget in this widget to the bottom of this widget.
           * The moved widget will be drawn below all other widgets in this widget.
@@ -992,6 +1032,19 @@ class Widget notfinal : public Widget2
           */
         void distributeShownEvent();
 
+        /**
+          * Mixes drawn value into content hash. Used by widgets which
+          * content changes without notifications.
+          */
+        static size_t hashContent(const size_t hash,
+                                  const size_t value) A_WARN_UNUSED;
+
+        static size_t hashContent(size_t hash,
+                                  const std::string &str) A_WARN_UNUSED;
+
+        static size_t hashContent(const size_t hash,
+                                  const void *const ptr) A_WARN_UNUSED;
+
         /**
           * Typdef.
           */
@@ -1170,10 +1223,17 @@ class Widget notfinal : public Widget2
         static Font* mGlobalFont;
 
     private:
+        WidgetHandle mHandle;
+
         /**
-          * Holds a list of all instances of widgets.
+          * Holds all instances of widgets, indexed by handle slot.
+          * Slots of deleted widgets set to nullptr and reused.
           */
-        static std::list<Widget*> mAllWidgets;
+        static STD_VECTOR<Widget*> mAllWidgets;
+
+        static STD_VECTOR<unsigned int> mWidgetGenerations;
+
+        static STD_VECTOR<unsigned int> mFreeWidgetSlots;
 
         static std::set<Widget*> mAllWidgetsSet;
 };
@@ -0,0 +1,46 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUI_WIDGETS_WIDGETHANDLE_H
+#define GUI_WIDGETS_WIDGETHANDLE_H
+
+#include "localconsts.h"
+
+/**
+ * Reference to widget in widgets registry.
+ * Slot generation changes when widget deleted, so handle to deleted widget
+ * never matches other widget created in same slot or at same address.
+ * Generation 0 never issued, so default handle never matches any widget.
+ */
+struct WidgetHandle final
+{
+    WidgetHandle() :
+        slot(0U),
+        generation(0U)
+    {
+    }
+
+    A_DEFAULT_COPY(WidgetHandle)
+
+    unsigned int slot;
+    unsigned int generation;
+};
+
+#endif  // GUI_WIDGETS_WIDGETHANDLE_H
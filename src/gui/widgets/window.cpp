@@ -92,6 +92,7 @@
 #include "gui/widgets/layout.h"
 
 #include "render/renderers.h"
+#include "render/windowcache.h"
 
 #include "render/vertexes/imagecollection.h"
 
@@ -129,6 +130,7 @@ Window::Window(const std::string &caption,
     mCaptionOffsetY(5),
     mShowTitle(true),
     mLastRedraw(true),
+    mAllowRenderCache(true),
     mGrip(nullptr),
     mParentWindow(parent),
     mLayout(nullptr),
@@ -142,6 +144,8 @@ Window::Window(const std::string &caption,
     mMaxWinWidth(mainGraphics->mWidth),
     mMaxWinHeight(mainGraphics->mHeight),
     mVertexes(new ImageCollection),
+    mRenderCache(config.getBoolValue("windowRenderCache") &&
+        mainGraphics->canCacheWindows() ? new WindowCache : nullptr),
     mCaptionAlign(Graphics::LEFT),
     mTitlePadding(4),
     mGripPadding(2),
@@ -161,7 +165,9 @@ Window::Window(const std::string &caption,
     mPlayVisibleSound(false),
     mInit(false),
     mTextChanged(true),
-    mAllowClose(false)
+    mAllowClose(false),
+    mRenderCacheDirty(true),
+    mRenderCacheChanged(false)
 {
     logger->log("Window::Window(\"%s\")", caption.c_str());
 
@@ -281,6 +287,12 @@ Window::~Window()
 
     removeWidgetListener(this);
     delete2(mVertexes)
+    if (mRenderCache != nullptr)
+    {
+        if (mainGraphics != nullptr)
+            mainGraphics->deleteWindowCache(*mRenderCache);
+        delete2(mRenderCache)
+    }
 
     windowInstances--;
 
@@ -312,7 +324,117 @@ void Window::draw(Graphics *const graphics)
     if (mSkin == nullptr)
         return;
 
+    if (mRenderCache == nullptr ||
+        !mAllowRenderCache ||
+        mDimension.width <= 0 ||
+        mDimension.height <= 0)
+    {
+        drawWindow(graphics);
+        return;
+    }
+
     BLOCK_START("Window::draw")
+    const bool changed = isRenderCacheDirty(graphics);
+    const bool changedBefore = mRenderCacheChanged;
+    mRenderCacheDirty = false;
+    mRenderCacheChanged = changed;
+    if ((changed && changedBefore) || isLiveDrawn(graphics))
+    {
+        // content changes every frame, so cache would be only overhead
+        mRenderCache->valid = false;
+        drawWindow(graphics);
+        BLOCK_END("Window::draw")
+        return;
+    }
+    if (!changed && graphics->drawWindowCache(*mRenderCache))
+    {
+        BLOCK_END("Window::draw")
+        return;
+    }
+
+    const ClipRect &clipArea = graphics->getTopClip();
+    mRenderCache->x = clipArea.xOffset;
+    mRenderCache->y = clipArea.yOffset;
+    mRenderCache->width = mDimension.width;
+    mRenderCache->height = mDimension.height;
+    if (graphics->beginWindowCache(*mRenderCache))
+    {
+        // software renderers need more than one pass to get alpha
+        do
+        {
+            drawWindow(graphics);
+        }
+        while (!graphics->endWindowCache(*mRenderCache));
+        graphics->drawWindowCache(*mRenderCache);
+    }
+    else
+    {
+        // nested window or frame buffer error. Try again next frame.
+        mRenderCache->valid = false;
+        drawWindow(graphics);
+    }
+    BLOCK_END("Window::draw")
+}
+
+bool Window::isLiveDrawn(const Graphics *const graphics) const
+{
+    // hover effects
+    if (gui != nullptr)
+    {
+        const ClipRect &clipArea = graphics->getTopClip();
+        const int x = clipArea.xOffset;
+        const int y = clipArea.yOffset;
+        const int mouseX = gui->getLastMouseX();
+        const int mouseY = gui->getLastMouseY();
+        if (mouseX >= x && mouseX < x + mDimension.width &&
+            mouseY >= y && mouseY < y + mDimension.height)
+        {
+            return true;
+        }
+    }
+
+    // text input cursor
+    if (mFocusHandler != nullptr)
+    {
+        const Widget *widget = mFocusHandler->getFocused();
+        while (widget != nullptr)
+        {
+            if (widget == this)
+                return true;
+            widget = widget->getParent();
+        }
+    }
+    return false;
+}
+
+bool Window::isRenderCacheDirty(const Graphics *const graphics) const
+{
+    const WindowCache *const cache = mRenderCache;
+    if (mRenderCacheDirty ||
+        mRedraw ||
+        mTextChanged ||
+        mResizeHandles != mOldResizeHandles ||
+        cache->width != mDimension.width ||
+        cache->height != mDimension.height)
+    {
+        return true;
+    }
+
+    const ClipRect &clipArea = graphics->getTopClip();
+    const int x = clipArea.xOffset;
+    const int y = clipArea.yOffset;
+    return cache->x != x || cache->y != y;
+}
+
+void Window::contentChanged()
+{
+    mRenderCacheDirty = true;
+    Widget::contentChanged();
+}
+
+void Window::drawWindow(Graphics *const graphics)
+{
+    BLOCK_START("Window::drawWindow")
     bool update = false;
 
     if (mResizeHandles != mOldResizeHandles)
@@ -416,7 +538,7 @@ void Window::draw(Graphics *const graphics)
     {
         drawChildren(graphics);
     }
-    BLOCK_END("Window::draw")
+    BLOCK_END("Window::drawWindow")
 }
 
 void Window::safeDraw(Graphics *const graphics)
@@ -1300,6 +1422,8 @@ void Window::adjustSizeToScreen()
         mDimension.height = screenHeight;
     if (oldWidth != mDimension.width || oldHeight != mDimension.height)
         widgetResized(Event(this));
+    if (mParent != nullptr)
+        mParent->childDimensionChanged();
 }
 
 int Window::getResizeHandles(const MouseEvent &event)
@@ -1440,6 +1564,8 @@ void Window::ensureOnScreen()
         mDimension.x = 0;
     if (mDimension.y < 0)
         mDimension.y = 0;
+    if (mParent != nullptr)
+        mParent->childDimensionChanged();
 }
 
 Rect Window::getWindowArea() const
@@ -89,6 +89,8 @@ class LayoutCell;
 class Skin;
 class WindowContainer;
 
+struct WindowCache;
+
 /**
  * A window. This window can be dragged around and has a title bar. Windows are
  * invisible by default.
@@ -582,6 +584,8 @@ class Window notfinal : public BasicContainer2,
          */
         virtual void resizeToContent();
 
+        void contentChanged() override;
+
 #ifdef USE_PROFILER
         virtual void logic();
 #endif  // USE_PROFILER
@@ -654,6 +658,7 @@ class Window notfinal : public BasicContainer2,
         int mCaptionOffsetY;
         bool mShowTitle;              /**< Window has a title bar */
         bool mLastRedraw;
+        bool mAllowRenderCache;       /**< Content can be drawn from cache */
 
     private:
         enum ResizeHandles
@@ -683,6 +688,20 @@ class Window notfinal : public BasicContainer2,
          */
         int getResizeHandles(const MouseEvent &event) A_WARN_UNUSED;
 
+        void drawWindow(Graphics *const graphics) A_NONNULL(2);
+
+        /**
+         * Checks if cached content may be outdated.
+         */
+        bool isRenderCacheDirty(const Graphics *const graphics) const
+                                A_NONNULL(2) A_WARN_UNUSED;
+
+        /**
+         * Checks if window have hover or focus effects.
+         */
+        bool isLiveDrawn(const Graphics *const graphics) const
+                         A_NONNULL(2) A_WARN_UNUSED;
+
         Image *mGrip;                 /**< Resize grip */
         Window *mParentWindow;        /**< The parent window */
         Layout *mLayout;              /**< Layout handler */
@@ -707,6 +726,7 @@ class Window notfinal : public BasicContainer2,
          */
         static const unsigned resizeBorderWidth = 10;
         ImageCollection *mVertexes A_NONNULLPOINTER;
+        WindowCache *mRenderCache;
         Graphics::Alignment mCaptionAlign;
         int mTitlePadding;
         int mGripPadding;
@@ -727,6 +747,8 @@ class Window notfinal : public BasicContainer2,
         bool mInit;
         bool mTextChanged;
         bool mAllowClose;
+        bool mRenderCacheDirty;       /**< Child content changed */
+        bool mRenderCacheChanged;     /**< Content changed in last frame */
 };
 
 #endif  // GUI_WIDGETS_WINDOW_H
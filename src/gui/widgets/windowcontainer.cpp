@@ -89,6 +89,7 @@ void WindowContainer::moveWidgetAfter(Widget *const after,
             ++ afterIter;
             mWidgets.erase(widgetIter);
             mWidgets.insert(afterIter, widget);
+            mIndexDirty = true;
         }
     }
 
@@ -147,6 +147,7 @@ void CutInWindow::logic()
     if (mImage != nullptr)
     {
         const int time = tick_time * MILLISECONDS_IN_A_TICK;
-        mImage->update(time);
+        if (mImage->update(time))
+            contentChanged();
     }
 }
@@ -29,8 +29,6 @@
 
 #include "being/localplayer.h"
 
-#include "enums/resources/map/blockmask.h"
-
 #include "fs/virtfs/fs.h"
 
 #include "gui/popupmanager.h"
@@ -47,10 +45,11 @@
 #include "resources/image/image.h"
 
 #include "resources/map/map.h"
-#include "resources/map/metatile.h"
+#include "resources/map/minimapcache.h"
 
 #include "resources/loaders/imageloader.h"
 
+#include "utils/delete2.h"
 #include "utils/gettext.h"
 #include "utils/foreach.h"
 #include "utils/sdlcheckutils.h"
@@ -67,6 +66,9 @@ Minimap::Minimap() :
     mWidthProportion(0.5),
     mHeightProportion(0.5),
     mMapImage(nullptr),
+    mMinimapCache(nullptr),
+    mMapWidth(0),
+    mMapHeight(0),
     mMapOriginX(0),
     mMapOriginY(0),
     mCustomMapImage(false),
@@ -81,6 +83,8 @@ Minimap::Minimap() :
     // set this to false as the minimap window size is changed
     // depending on the map size
     setResizable(true);
+    // map scrolls and beings move every frame
+    mAllowRenderCache = false;
     if (setupWindow != nullptr)
         setupWindow->registerWindowForReset(this);
 
@@ -100,6 +104,7 @@ Minimap::~Minimap()
     config.setValue(getWindowName() + "Show", mShow);
     config.removeListeners(this);
     CHECKLISTENERS
+    delete2(mMinimapCache)
     deleteMapImage();
 }
 
@@ -130,51 +135,24 @@ void Minimap::setMap(const Map *const map)
     }
 
     setCaption(caption);
+    delete2(mMinimapCache)
     deleteMapImage();
 
     if (map != nullptr)
     {
         if (config.getBoolValue("showExtMinimaps"))
         {
-            SDL_Surface *const surface = MSDL_CreateRGBSurface(SDL_SWSURFACE,
-                map->getWidth(), map->getHeight(), 32,
-                0x00ff0000, 0x0000ff00, 0x000000ff, 0x00000000);
-            if (surface == nullptr)
-            {
-                if (!isSticky())
-                    setVisible(Visible_false);
-                BLOCK_END("Minimap::setMap")
-                return;
-            }
-
-            // I'm not sure if the locks are necessary since it's a SWSURFACE
-            SDL_LockSurface(surface);
-            int* data = static_cast<int*>(surface->pixels);
-            if (data == nullptr)
-            {
-                if (!isSticky())
-                    setVisible(Visible_false);
-                BLOCK_END("Minimap::setMap")
-                return;
-            }
-            const int size = surface->h * surface->w;
-            const int mask = (BlockMask::WALL |
-                BlockMask::AIR |
-                BlockMask::WATER |
-                BlockMask::PLAYERWALL);
-
-            for (int ptr = 0; ptr < size; ptr ++)
-            {
-                *(data ++) = (map->mMetaTiles[ptr].blockmask & mask) != 0 ?
-                    0x0 : 0x00ffffff;
-            }
-
-            SDL_UnlockSurface(surface);
-
-            mMapImage = imageHelper->loadSurface(surface);
-            mMapImage->setAlpha(settings.guiAlpha);
-            mCustomMapImage = true;
-            MSDL_FreeSurface(surface);
+            // image shown from slowLogic after generation or load from cache
+            mMapWidth = map->getWidth();
+            mMapHeight = map->getHeight();
+            mMinimapCache = new MinimapCache(
+                map->getProperty("shortName", std::string()),
+                map->getCacheHash(),
+                mMapWidth,
+                mMapHeight,
+                config.getIntValue("extMinimapZoom"));
+            mMinimapCache->setBlockPlanes(map->getBlockPlanes());
+            mMinimapCache->start();
         }
         else
         {
@@ -205,36 +183,7 @@ void Minimap::setMap(const Map *const map)
 
     if ((mMapImage != nullptr) && (map != nullptr))
     {
-        const int width = mMapImage->mBounds.w + 2 * getPadding();
-        const int height = mMapImage->mBounds.h
-            + getTitleBarHeight() + getPadding();
-        const int mapWidth = mMapImage->mBounds.w < 100 ? width : 100;
-        const int mapHeight = mMapImage->mBounds.h < 100 ? height : 100;
-        const int minWidth = mapWidth > 310 ? 310 : mapWidth;
-        const int minHeight = mapHeight > 220 ? 220 : mapHeight;
-
-        setMinWidth(minWidth);
-        setMinHeight(minHeight);
-
-        mWidthProportion = static_cast<float>(
-                mMapImage->mBounds.w) / static_cast<float>(map->getWidth());
-        mHeightProportion = static_cast<float>(
-                mMapImage->mBounds.h) / static_cast<float>(map->getHeight());
-
-        setMaxWidth(width);
-        setMaxHeight(height);
-        if (mAutoResize)
-        {
-            setWidth(width);
-            setHeight(height);
-        }
-
-        const Rect &rect = mDimension;
-        setDefaultSize(rect.x, rect.y, rect.width, rect.height);
-        resetToDefaultSize();
-
-        if (mShow)
-            setVisible(Visible_true);
+        updateImageSize(map->getWidth(), map->getHeight());
     }
     else
     {
@@ -244,6 +193,68 @@ void Minimap::setMap(const Map *const map)
     BLOCK_END("Minimap::setMap")
 }
 
+void Minimap::slowLogic()
+{
+    if (mMinimapCache == nullptr || !mMinimapCache->isDone())
+        return;
+
+    BLOCK_START("Minimap::slowLogic")
+    SDL_Surface *const surface = mMinimapCache->takeSurface();
+    delete2(mMinimapCache)
+    if (surface == nullptr)
+    {
+        BLOCK_END("Minimap::slowLogic")
+        return;
+    }
+
+    // texture upload must stay in main thread
+    deleteMapImage();
+    mMapImage = imageHelper->loadSurface(surface);
+    MSDL_FreeSurface(surface);
+    if (mMapImage != nullptr)
+    {
+        mMapImage->setAlpha(settings.guiAlpha);
+        mCustomMapImage = true;
+        updateImageSize(mMapWidth, mMapHeight);
+    }
+    BLOCK_END("Minimap::slowLogic")
+}
+
+void Minimap::updateImageSize(const int mapWidth,
+                              const int mapHeight)
+{
+    const int width = mMapImage->mBounds.w + 2 * getPadding();
+    const int height = mMapImage->mBounds.h
+        + getTitleBarHeight() + getPadding();
+    const int mapWidth2 = mMapImage->mBounds.w < 100 ? width : 100;
+    const int mapHeight2 = mMapImage->mBounds.h < 100 ? height : 100;
+    const int minWidth = mapWidth2 > 310 ? 310 : mapWidth2;
+    const int minHeight = mapHeight2 > 220 ? 220 : mapHeight2;
+
+    setMinWidth(minWidth);
+    setMinHeight(minHeight);
+
+    mWidthProportion = static_cast<float>(
+            mMapImage->mBounds.w) / static_cast<float>(mapWidth);
+    mHeightProportion = static_cast<float>(
+            mMapImage->mBounds.h) / static_cast<float>(mapHeight);
+
+    setMaxWidth(width);
+    setMaxHeight(height);
+    if (mAutoResize)
+    {
+        setWidth(width);
+        setHeight(height);
+    }
+
+    const Rect &rect = mDimension;
+    setDefaultSize(rect.x, rect.y, rect.width, rect.height);
+    resetToDefaultSize();
+
+    if (mShow)
+        setVisible(Visible_true);
+}
+
 void Minimap::toggle()
 {
     setVisible(fromBool(!isWindowVisible(), Visible), isSticky());
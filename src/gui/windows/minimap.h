@@ -27,6 +27,7 @@
 
 class Image;
 class Map;
+class MinimapCache;
 
 /**
  * Minimap window. Shows a minimap image and the name of the current map.
@@ -51,6 +52,11 @@ class Minimap final : public Window, public ConfigListener
          */
         void setMap(const Map *const map);
 
+        /**
+         * Shows generated map image when background generation finished.
+         */
+        void slowLogic();
+
         /**
          * Toggles the displaying of the minimap.
          */
@@ -80,9 +86,15 @@ class Minimap final : public Window, public ConfigListener
     private:
         void deleteMapImage();
 
+        void updateImageSize(const int mapWidth,
+                             const int mapHeight);
+
         float mWidthProportion;
         float mHeightProportion;
         Image *mMapImage;
+        MinimapCache *mMinimapCache;
+        int mMapWidth;
+        int mMapHeight;
         int mMapOriginX;
         int mMapOriginY;
         bool mCustomMapImage;
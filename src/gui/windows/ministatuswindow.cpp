@@ -333,8 +333,8 @@ void MiniStatusWindow::logic()
     for (size_t i = 0, sz = mIcons.size(); i < sz; i++)
     {
         AnimatedSprite *const icon = mIcons[i];
-        if (icon != nullptr)
-            icon->update(tick_time * 10);
+        if (icon != nullptr && icon->update(tick_time * 10))
+            contentChanged();
     }
     BLOCK_END("MiniStatusWindow::logic")
 }
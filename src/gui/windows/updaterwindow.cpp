@@ -30,6 +30,7 @@
 #include "enums/gui/layouttype.h"
 
 #include "fs/files.h"
+#include "fs/hashcache.h"
 #include "fs/mkdir.h"
 #include "fs/paths.h"
 
@@ -45,6 +46,7 @@
 #include "gui/widgets/staticbrowserbox.h"
 
 #include "net/download.h"
+#include "net/downloadscheduler.h"
 #include "net/updatetypeoperators.h"
 
 #include "resources/db/moddb.h"
@@ -184,6 +186,7 @@ UpdaterWindow::UpdaterWindow(const std::string &restrict updateHost,
     mCurrentChecksum(0),
     mMemoryBuffer(nullptr),
     mDownload(nullptr),
+    mDownloadScheduler(nullptr),
     mUpdateFiles(),
     mTempUpdateFiles(),
     mUpdateServerPath(mUpdateHost),
@@ -274,8 +277,15 @@ UpdaterWindow::~UpdaterWindow()
 
         delete2(mDownload)
     }
+    if (mDownloadScheduler != nullptr)
+    {
+        mDownloadScheduler->cancel();
+
+        delete2(mDownloadScheduler)
+    }
     free(mMemoryBuffer);
     delete2(mItemLinkHandler)
+    HashCache::save();
 }
 
 void UpdaterWindow::setProgress(const float p)
@@ -321,6 +331,8 @@ void UpdaterWindow::action(const ActionEvent &event)
         {
             if (mDownload != nullptr)
                 mDownload->cancel();
+            if (mDownloadScheduler != nullptr)
+                mDownloadScheduler->cancel();
             mDownloadStatus = UpdateDownloadStatus::UPDATE_ERROR;
         }
     }
@@ -577,52 +589,62 @@ size_t UpdaterWindow::memoryWrite(void *ptr, size_t size,
     return totalMem;
 }
 
-void UpdaterWindow::download()
+STD_VECTOR<std::string> UpdaterWindow::getFileUrls(
+    const std::string &fileName) const
 {
-    if (mDownload != nullptr)
-    {
-        mDownload->cancel();
-        delete mDownload;
-    }
+    STD_VECTOR<std::string> urls;
     if (mDownloadStatus == UpdateDownloadStatus::UPDATE_PATCH)
     {
-        mDownload = new Net::Download(this,
-            branding.getStringValue("updateMirror1") + mCurrentFile,
-            &updateProgress,
-            true, false, mValidateXml);
+        urls.push_back(branding.getStringValue("updateMirror1") + fileName);
         for (int f = 2; f < 8; f ++)
         {
             const std::string url = branding.getStringValue(
                 "updateMirror" + toString(f));
             if (!url.empty())
-                mDownload->addMirror(url + mCurrentFile);
+                urls.push_back(url + fileName);
         }
     }
     else
     {
-        mDownload = new Net::Download(this,
-            urlJoin(mUpdateHost, mCurrentFile),
-            &updateProgress,
-            false, false, mValidateXml);
+        urls.push_back(urlJoin(mUpdateHost, fileName));
 
         if (mDownloadStatus == UpdateDownloadStatus::UPDATE_LIST2 ||
             mDownloadStatus == UpdateDownloadStatus::UPDATE_RESOURCES2)
         {
-            const std::string str = urlJoin(mUpdateServerPath, mCurrentFile);
-            mDownload->addMirror(updateServer3 + str);
-            mDownload->addMirror(updateServer4 + str);
-            mDownload->addMirror(updateServer5 + str);
+            const std::string str = urlJoin(mUpdateServerPath, fileName);
+            urls.push_back(updateServer3 + str);
+            urls.push_back(updateServer4 + str);
+            urls.push_back(updateServer5 + str);
         }
         else
         {
             const STD_VECTOR<std::string> &mirrors = settings.updateMirrors;
             FOR_EACH (STD_VECTOR<std::string>::const_iterator, it, mirrors)
             {
-                mDownload->addMirror(pathJoin(*it,
-                    mCurrentFile));
+                urls.push_back(pathJoin(*it,
+                    fileName));
             }
         }
     }
+    return urls;
+}
+
+void UpdaterWindow::download()
+{
+    if (mDownload != nullptr)
+    {
+        mDownload->cancel();
+        delete mDownload;
+    }
+    const STD_VECTOR<std::string> urls = getFileUrls(mCurrentFile);
+    mDownload = new Net::Download(this,
+        urls[0],
+        &updateProgress,
+        mDownloadStatus == UpdateDownloadStatus::UPDATE_PATCH,
+        false,
+        mValidateXml);
+    for (size_t f = 1; f < urls.size(); f ++)
+        mDownload->addMirror(urls[f]);
 
     if (mStoreInMemory)
     {
@@ -652,6 +674,67 @@ void UpdaterWindow::download()
     mDownload->start();
 }
 
+void UpdaterWindow::downloadFiles(const STD_VECTOR<UpdateFile> &files)
+{
+    if (mDownloadScheduler != nullptr)
+    {
+        mDownloadScheduler->cancel();
+        delete mDownloadScheduler;
+    }
+    mDownloadScheduler = new Net::DownloadScheduler(this,
+        &updateProgress,
+        config.getIntValue("updateParallelDownloads"));
+
+    StringVect paths;
+    FOR_EACH (STD_VECTOR<UpdateFile>::const_iterator, it, files)
+        paths.push_back(pathJoin(mUpdatesDir, (*it).name));
+    HashCache::calcAdler32(paths);
+
+    unsigned int skipped = 0;
+    FOR_EACH (STD_VECTOR<UpdateFile>::const_iterator, it, files)
+    {
+        const UpdateFile &thisFile = *it;
+        if (mDownloadStatus == UpdateDownloadStatus::UPDATE_RESOURCES &&
+            thisFile.type == "music" &&
+            !config.getBoolValue("download-music"))
+        {
+            skipped ++;
+            continue;
+        }
+        unsigned long checksum = 0;
+        std::stringstream ss(thisFile.hash);
+        ss >> std::hex >> checksum;
+
+        const std::string filePath = pathJoin(mUpdatesDir, thisFile.name);
+        if (validateFile(filePath, checksum))
+        {
+            logger->log("%s already here", thisFile.name.c_str());
+            skipped ++;
+            continue;
+        }
+        mDownloadScheduler->addFile(filePath,
+            checksum,
+            getFileUrls(thisFile.name));
+    }
+
+    if (mDownloadScheduler->getFilesCount() == 0)
+    {
+        delete2(mDownloadScheduler)
+        mUpdateIndex = CAST_U32(files.size());
+        return;
+    }
+
+    mUpdateIndex = skipped;
+    mCurrentFile = strprintf(
+        // TRANSLATORS: updater window label
+        _("%u files"),
+        CAST_U32(mDownloadScheduler->getFilesCount()));
+    setLabel(mCurrentFile + " (0%)");
+    mDownloadComplete = false;
+
+    mDownloadScheduler->start();
+}
+
 void UpdaterWindow::loadUpdates()
 {
     if (mUpdateFiles.empty())
@@ -842,10 +925,13 @@ void UpdaterWindow::logic()
         }
 
         mProgressBar->setProgress(mDownloadProgress);
+        unsigned int updateIndex = mUpdateIndex;
+        if (mDownloadScheduler != nullptr)
+            updateIndex += mDownloadScheduler->getCompletedCount();
         if (!mUpdateFiles.empty() &&
-            CAST_SIZE(mUpdateIndex) <= mUpdateFiles.size())
+            CAST_SIZE(updateIndex) <= mUpdateFiles.size())
         {
-            mProgressBar->setText(strprintf("%u/%u", mUpdateIndex
+            mProgressBar->setText(strprintf("%u/%u", updateIndex
                 + mUpdateIndexOffset + 1, CAST_U32(
                 mUpdateFiles.size()) + CAST_S32(
                 mTempUpdateFiles.size()) + 1));
@@ -871,6 +957,8 @@ void UpdaterWindow::logic()
                 false);
             if (mDownload != nullptr)
                 mBrowserBox->addRow(mDownload->getError(), false);
+            if (mDownloadScheduler != nullptr)
+                mBrowserBox->addRow(mDownloadScheduler->getError(), false);
             mBrowserBox->updateHeight();
             mScrollArea->setVerticalScrollAmount(
                     mScrollArea->getVerticalMaxScroll());
@@ -944,38 +1032,15 @@ void UpdaterWindow::logic()
         case UpdateDownloadStatus::UPDATE_RESOURCES:
             if (mDownloadComplete)
             {
+                if (mDownloadScheduler != nullptr)
+                {
+                    delete2(mDownloadScheduler)
+                    mUpdateIndex = CAST_U32(mUpdateFiles.size());
+                }
                 if (CAST_SIZE(mUpdateIndex) < mUpdateFiles.size())
                 {
-                    UpdateFile thisFile = mUpdateFiles[mUpdateIndex];
-                    if (thisFile.type == "music"
-                        && !config.getBoolValue("download-music"))
-                    {
-                        mUpdateIndex++;
-                        break;
-                    }
-                    mCurrentFile = thisFile.name;
-                    std::string checksum;
-                    checksum = thisFile.hash;
-                    std::stringstream ss(checksum);
-                    ss >> std::hex >> mCurrentChecksum;
-
-                    std::ifstream temp(pathJoin(mUpdatesDir,
-                        mCurrentFile).c_str());
-
                     mValidateXml = false;
-                    if (!temp.is_open() || !validateFile(pathJoin(
-                        mUpdatesDir, mCurrentFile),
-                        mCurrentChecksum))
-                    {
-                        temp.close();
-                        download();
-                    }
-                    else
-                    {
-                        temp.close();
-                        logger->log("%s already here", mCurrentFile.c_str());
-                    }
-                    mUpdateIndex++;
+                    downloadFiles(mUpdateFiles);
                 }
                 else
                 {
@@ -1017,33 +1082,16 @@ void UpdaterWindow::logic()
         case UpdateDownloadStatus::UPDATE_RESOURCES2:
             if (mDownloadComplete)
             {
+                if (mDownloadScheduler != nullptr)
+                {
+                    delete2(mDownloadScheduler)
+                    mUpdateIndex = CAST_U32(mTempUpdateFiles.size());
+                }
                 mValidateXml = false;
                 if (CAST_SIZE(mUpdateIndex)
                     < mTempUpdateFiles.size())
                 {
-                    const UpdateFile thisFile = mTempUpdateFiles[mUpdateIndex];
-                    mCurrentFile = thisFile.name;
-                    std::string checksum;
-                    checksum = thisFile.hash;
-                    std::stringstream ss(checksum);
-                    ss >> std::hex >> mCurrentChecksum;
-
-                    std::ifstream temp((pathJoin(mUpdatesDir,
-                        mCurrentFile)).c_str());
-
-                    if (!temp.is_open() || !validateFile(pathJoin(
-                        mUpdatesDir, mCurrentFile),
-                        mCurrentChecksum))
-                    {
-                        temp.close();
-                        download();
-                    }
-                    else
-                    {
-                        temp.close();
-                        logger->log("%s already here", mCurrentFile.c_str());
-                    }
-                    mUpdateIndex++;
+                    downloadFiles(mTempUpdateFiles);
                 }
                 else
                 {
@@ -1072,13 +1120,10 @@ void UpdaterWindow::logic()
 bool UpdaterWindow::validateFile(const std::string &filePath,
                                  const unsigned long hash)
 {
-    FILE *const file = fopen(filePath.c_str(), "rb");
-    if (file == nullptr)
+    if (!Files::existsLocal(filePath))
         return false;
 
-    const unsigned long adler = Net::Download::fadler32(file);
-    fclose(file);
-    return adler == hash;
+    return HashCache::getAdler32(filePath) == hash;
 }
 
 unsigned long UpdaterWindow::getFileHash(const std::string &filePath)
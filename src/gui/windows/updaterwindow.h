@@ -49,6 +49,7 @@ class StaticBrowserBox;
 namespace Net
 {
     class Download;
+    class DownloadScheduler;
 }  // namespace Net
 
 /**
@@ -146,6 +147,15 @@ class UpdaterWindow final : public Window,
     private:
         void download();
 
+        /**
+         * Starts parallel download of all files what not exists or
+         * have wrong checksum.
+         */
+        void downloadFiles(const STD_VECTOR<UpdateFile> &files);
+
+        STD_VECTOR<std::string> getFileUrls(const std::string &fileName)
+                                            const A_WARN_UNUSED;
+
         /**
          * Loads the updates this window has gotten into the resource manager
          */
@@ -198,6 +208,9 @@ class UpdaterWindow final : public Window,
         /** Download handle. */
         Net::Download *mDownload;
 
+        /** Parallel download handle for update files. */
+        Net::DownloadScheduler *mDownloadScheduler;
+
         /** List of files to download. */
         STD_VECTOR<UpdateFile> mUpdateFiles;
 
@@ -47,6 +47,17 @@ class TableModelListener notfinal
          */
         virtual void modelUpdated(const bool completed) = 0;
 
+        /**
+         * Invoked by the TableModel when only one cell is being replaced.
+         * Triggered twice like modelUpdated.
+         *
+         * \param completed whether we are signalling the end of the update
+         */
+        virtual void cellUpdated(const int row A_UNUSED,
+                                 const int column A_UNUSED,
+                                 const bool completed)
+        { modelUpdated(completed); }
+
         virtual ~TableModelListener()
         { }
 };
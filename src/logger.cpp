@@ -27,7 +27,7 @@
 #include "listeners/debugmessagelistener.h"
 
 #include "utils/cast.h"
-#include "utils/foreach.h"
+#include "utils/sdlhelper.h"
 #include "utils/stringutils.h"
 
 #include <iostream>
@@ -38,7 +38,14 @@
 #include <Carbon/Carbon.h>
 #endif  // WIN32
 
+#include <csignal>
+#include <cstring>
 #include <sys/time.h>
+#ifdef WIN32
+#include <io.h>
+#else  // WIN32
+#include <unistd.h>
+#endif  // WIN32
 
 #include <sstream>
 
@@ -77,25 +84,141 @@
 
 #include "debug.h"
 
-#define DATESTREAM \
-    std::string timeStr = strprintf( \
-        "[%02d:%02d:%02d.%02d]", \
-        CAST_S32(((tv.tv_sec / 60) / 60) % 24), \
-        CAST_S32((tv.tv_sec / 60) % 60), \
-        CAST_S32(tv.tv_sec % 60), \
-        CAST_S32((tv.tv_usec / 10000) % 100));
+namespace
+{
+    // queue size, must be power of two
+    const unsigned int logRingSize = 1024;
+    const unsigned int logRingMask = logRingSize - 1;
+    // most lines formatted without heap allocation
+    const size_t logLineSize = 1024;
+    const size_t logTimeSize = 32;
+
+    const int crashSignals[] =
+    {
+        SIGSEGV,
+        SIGABRT,
+        SIGFPE,
+        SIGILL
+    };
+    const size_t crashSignalsCount = sizeof(crashSignals) / sizeof(int);
+    void (*oldCrashHandlers[crashSignalsCount])(int);
+    bool crashHandlersSet = false;
+    // log file descriptor of main logger for crash handlers
+    int crashLogFd = -1;
+
+    size_t printTime(char *const buf)
+    {
+        timeval tv;
+        gettimeofday(&tv, nullptr);
+        const int len = snprintf(buf,
+            logTimeSize,
+            "[%02d:%02d:%02d.%02d] ",
+            CAST_S32(((tv.tv_sec / 60) / 60) % 24),
+            CAST_S32((tv.tv_sec / 60) % 60),
+            CAST_S32(tv.tv_sec % 60),
+            CAST_S32((tv.tv_usec / 10000) % 100));
+        return len > 0 ? CAST_SIZE(len) : 0U;
+    }
+
+    // allocates timestamped line with space for text of given size
+    char *newLine(const size_t size,
+                  char *&text)
+    {
+        char timeBuf[logTimeSize];
+        const size_t timeLen = printTime(timeBuf);
+        char *const line = new char[timeLen + size + 1];
+        memcpy(line, timeBuf, timeLen);
+        text = line + timeLen;
+        text[size] = 0;
+        return line;
+    }
+
+    char *newLine(const char *const str)
+    {
+        const size_t size = strlen(str);
+        char *text = nullptr;
+        char *const line = newLine(size, text);
+        memcpy(text, str, size);
+        return line;
+    }
+
+    void crashHandler(int sig)
+    {
+        // only async signal safe calls allowed here
+        if (logger != nullptr && crashLogFd != -1)
+            logger->writeQueueRaw(crashLogFd);
+        for (size_t f = 0; f < crashSignalsCount; f ++)
+        {
+            if (crashSignals[f] == sig)
+                signal(sig, oldCrashHandlers[f]);
+        }
+        raise(sig);
+    }
+
+    void setCrashHandlers()
+    {
+        if (crashHandlersSet)
+            return;
+        crashHandlersSet = true;
+        for (size_t f = 0; f < crashSignalsCount; f ++)
+        {
+            oldCrashHandlers[f] = signal(crashSignals[f], &crashHandler);
+            if (oldCrashHandlers[f] == SIG_ERR)
+                oldCrashHandlers[f] = SIG_DFL;
+        }
+    }
+}  // namespace
+
+// formats line into heap buffer sized by vsnprintf result
+#define FORMAT_LINE(line, text, fmt) \
+    { \
+        char buf[logLineSize]; \
+        va_list ap; \
+        va_start(ap, fmt); \
+        const int size = vsnprintf(buf, logLineSize, fmt, ap); \
+        va_end(ap); \
+        if (size < 0) \
+            return; \
+        line = newLine(CAST_SIZE(size), text); \
+        if (CAST_SIZE(size) < logLineSize) \
+        { \
+            memcpy(text, buf, CAST_SIZE(size)); \
+        } \
+        else \
+        { \
+            va_start(ap, fmt); \
+            vsnprintf(text, CAST_SIZE(size) + 1, fmt, ap); \
+            va_end(ap); \
+        } \
+    }
+
+struct Logger::LogRecord final
+{
+    // equal to position + 1 when text ready for writer
+    volatile unsigned int sequence;
+    char *text;
+};
 
 Logger *logger = nullptr;          // Log object
 
 Logger::Logger() :
     mLogFile(nullptr),
-    mDelayedLog(),
-    mMutex(SDL_CreateMutex()),
-    mThreadLocked(false),
+    mRecords(new LogRecord[logRingSize]),
+    mThread(nullptr),
+    mPushPos(0),
+    mPopPos(0),
+    mFlushedPos(0),
+    mDropped(0),
+    mStop(false),
     mLogToStandardOut(true),
     mDebugLog(false),
     mReportUnimplemented(false)
 {
+    for (unsigned int f = 0; f < logRingSize; f ++)
+    {
+        mRecords[f].sequence = f;
+        mRecords[f].text = nullptr;
+    }
 #if defined __native_client__ && defined(NACL_LOG)
     std::cout.setf(std::ios_base::unitbuf);
 #endif  // defined __native_client__ && defined(NACL_LOG)
@@ -104,11 +227,22 @@ Logger::Logger() :
 Logger::~Logger()
 {
     closeFile();
-    SDL_DestroyMutex(mMutex);
+    for (unsigned int f = 0; f < logRingSize; f ++)
+        delete [] mRecords[f].text;
+    delete [] mRecords;
 }
 
 void Logger::closeFile()
 {
+    if (this == logger)
+        crashLogFd = -1;
+    if (mThread != nullptr)
+    {
+        mStop = true;
+        SDL::WaitThread(mThread);
+        mThread = nullptr;
+        mStop = false;
+    }
     if (mLogFile != nullptr)
     {
         fclose(mLogFile);
@@ -135,230 +269,211 @@ void Logger::setLogFile(const std::string &logFilename)
     else
     {
         mLogToStandardOut = false;
+        mThread = SDL::createThread(&writeThread, "logger", this);
+        if (this == logger)
+        {
+            crashLogFd = fileno(mLogFile);
+            setCrashHandlers();
+        }
     }
 }
 
-void Logger::log(const std::string &str)
-{
-    log("%s", str.c_str());
-}
-
-#ifdef ENABLEDEBUGLOG
-void Logger::dlog(const std::string &str)
+void Logger::pushLine(char *const line)
 {
-    if (!mDebugLog)
-        return;
-
-    // Get the current system time
-    timeval tv;
-    gettimeofday(&tv, nullptr);
-
-    // Print the log entry
-    DATESTREAM
-    DSPECIALLOG(str.c_str())
-
-    if (mLogFile != nullptr)
+    if (mThread != nullptr)
     {
-        fprintf(mLogFile,
-            "%s %s\n",
-            timeStr.c_str(),
-            str.c_str());
+        // reserve record for line. If writer not freed record yet,
+        // queue is full and line dropped.
+        unsigned int pos = mPushPos;
+        while (true)
+        {
+            LogRecord &record = mRecords[pos & logRingMask];
+            const unsigned int sequence = record.sequence;
+            __sync_synchronize();
+            const int diff = CAST_S32(sequence - pos);
+            if (diff == 0)
+            {
+                if (__sync_bool_compare_and_swap(&mPushPos, pos, pos + 1))
+                {
+                    record.text = line;
+                    // publish record to writer thread
+                    __sync_synchronize();
+                    record.sequence = pos + 1;
+                    return;
+                }
+            }
+            else if (diff < 0)
+            {
+                __sync_fetch_and_add(&mDropped, 1);
+                delete [] line;
+                return;
+            }
+            pos = mPushPos;
+        }
     }
 
-    if (mLogToStandardOut)
+    if (mLogFile != nullptr)
     {
-        fprintf(stdout,
-            "%s %s\n",
-            timeStr.c_str(),
-            str.c_str());
+        fprintf(mLogFile, "%s\n", line);
+        fflush(mLogFile);
     }
+    if (mLogToStandardOut)
+        fprintf(stdout, "%s\n", line);
+    delete [] line;
 }
 
-void Logger::dlog2(const std::string &str,
-                   const int pos,
-                   const char* const comment)
+int Logger::writeQueue(FILE *const file,
+                       const bool toStdout)
 {
-    if (!mDebugLog)
-        return;
-
-    // Get the current system time
-    timeval tv;
-    gettimeofday(&tv, nullptr);
-
-    // Print the log entry
-    DATESTREAM
-    DSPECIALLOG(str.c_str())
-
-    if (mLogFile != nullptr)
+    int count = 0;
+    while (true)
     {
-        if (comment != nullptr)
+        const unsigned int pos = mPopPos;
+        LogRecord &record = mRecords[pos & logRingMask];
+        if (record.sequence != pos + 1)
+            break;
+        __sync_synchronize();
+        mPopPos = pos + 1;
+        char *const text = record.text;
+        record.text = nullptr;
+        if (file != nullptr)
         {
-            fprintf(mLogFile,
-                "%s %04d %s: %s\n",
-                timeStr.c_str(),
-                pos,
-                str.c_str(),
-                comment);
+            fputs(text, file);
+            fputc('\n', file);
         }
-        else
+        if (toStdout)
         {
-            fprintf(mLogFile,
-                "%s %04d %s\n",
-                timeStr.c_str(),
-                pos,
-                str.c_str());
+            fputs(text, stdout);
+            fputc('\n', stdout);
         }
-        fflush(mLogFile);
+        delete [] text;
+        __sync_synchronize();
+        record.sequence = pos + logRingSize;
+        count ++;
     }
 
-    if (mLogToStandardOut)
+    const unsigned int dropped = __sync_fetch_and_and(&mDropped, 0);
+    if (dropped != 0 && file != nullptr)
     {
-        if (comment != nullptr)
-        {
-            fprintf(stdout,
-                "%s %04d %s: %s\n",
-                timeStr.c_str(),
-                pos,
-                str.c_str(),
-                comment);
-        }
-        else
-        {
-            fprintf(stdout,
-                "%s %04d %s\n",
-                timeStr.c_str(),
-                pos,
-                str.c_str());
-        }
+        fprintf(file, "Warning: %u log lines dropped\n", dropped);
+        count ++;
     }
+    return count;
 }
-#endif  // ENABLEDEBUGLOG
 
-void Logger::log1(const char *const buf)
+int Logger::writeThread(void *ptr)
 {
-    if (settings.disableLoggingInGame)
-        return;
-
-    // Get the current system time
-    timeval tv;
-    gettimeofday(&tv, nullptr);
+    Logger *const instance = static_cast<Logger*>(ptr);
+    if (instance == nullptr)
+        return 0;
 
-    // Print the log entry
-    DATESTREAM
-    SPECIALLOG(buf)
-
-    if (mLogFile != nullptr)
+    while (true)
     {
-        fprintf(mLogFile,
-            "%s %s\n",
-            timeStr.c_str(),
-            buf);
-        fflush(mLogFile);
+        FILE *const file = instance->mLogFile;
+        if (instance->writeQueue(file, instance->mLogToStandardOut) != 0)
+        {
+            if (file != nullptr)
+                fflush(file);
+            instance->mFlushedPos = instance->mPopPos;
+            continue;
+        }
+        if (instance->mStop)
+            break;
+        SDL_Delay(2);
     }
+    return 0;
+}
 
-    if (mLogToStandardOut)
+void Logger::writeQueueRaw(const int fd) const
+{
+    // lines not removed from queue, process terminates after crash.
+    // lines taken by writer thread but not flushed from stdio lost.
+    const unsigned int end = mPushPos;
+    for (unsigned int pos = mPopPos; CAST_S32(end - pos) > 0; pos ++)
     {
-        fprintf(stdout,
-            "%s %s\n",
-            timeStr.c_str(),
-            buf);
+        const LogRecord &record = mRecords[pos & logRingMask];
+        const char *const text = record.text;
+        if (record.sequence != pos + 1 || text == nullptr)
+            continue;
+        if (write(fd, text, strlen(text)) < 0 ||
+            write(fd, "\n", 1) < 0)
+        {
+            return;
+        }
     }
 }
 
-void Logger::log(const char *const log_text, ...)
+void Logger::log(const std::string &str)
 {
-    if (settings.disableLoggingInGame)
-        return;
-
-    unsigned size = 1024;
-    if (strlen(log_text) * 3 > size)
-        size = CAST_U32(strlen(log_text) * 3);
-
-    char* buf = new char[CAST_SIZE(size + 1)];
-    va_list ap;
+    log1(str.c_str());
+}
 
-    // Use a temporary buffer to fill in the variables
-    va_start(ap, log_text);
-    vsnprintf(buf, size, log_text, ap);
-    buf[size] = 0;
-    va_end(ap);
+#ifdef ENABLEDEBUGLOG
+void Logger::dlog(const std::string &str)
+{
+    if (!mDebugLog)
+        return;
 
-    // Get the current system time
-    timeval tv;
-    gettimeofday(&tv, nullptr);
+    DSPECIALLOG(str.c_str())
+    pushLine(newLine(str.c_str()));
+}
 
-    // Print the log entry
-    DATESTREAM
-    SPECIALLOG(buf)
+void Logger::dlog2(const std::string &str,
+                   const int pos,
+                   const char* const comment)
+{
+    if (!mDebugLog)
+        return;
 
-    if (mLogFile != nullptr)
+    DSPECIALLOG(str.c_str())
+    if (comment != nullptr)
     {
-        fprintf(mLogFile,
-            "%s %s\n",
-            timeStr.c_str(),
-            buf);
-        fflush(mLogFile);
+        pushLine(newLine(strprintf("%04d %s: %s",
+            pos,
+            str.c_str(),
+            comment).c_str()));
     }
-
-    if (mLogToStandardOut)
+    else
     {
-        fprintf(stdout,
-            "%s %s\n",
-            timeStr.c_str(),
-            buf);
+        pushLine(newLine(strprintf("%04d %s",
+            pos,
+            str.c_str()).c_str()));
     }
-
-    // Delete temporary buffer
-    delete [] buf;
 }
+#endif  // ENABLEDEBUGLOG
 
-void Logger::assertLog(const char *const log_text, ...)
+void Logger::log1(const char *const buf)
 {
     if (settings.disableLoggingInGame)
         return;
 
-    unsigned size = 1024;
-    if (strlen(log_text) * 3 > size)
-        size = CAST_U32(strlen(log_text) * 3);
-
-    char* buf = new char[CAST_SIZE(size + 1)];
-    va_list ap;
-
-    // Use a temporary buffer to fill in the variables
-    va_start(ap, log_text);
-    vsnprintf(buf, size, log_text, ap);
-    buf[size] = 0;
-    va_end(ap);
-
-    // Get the current system time
-    timeval tv;
-    gettimeofday(&tv, nullptr);
-
-    // Print the log entry
-    DATESTREAM
     SPECIALLOG(buf)
+    pushLine(newLine(buf));
+}
 
-    if (mLogFile != nullptr)
-    {
-        fprintf(mLogFile,
-            "%s %s\n",
-            timeStr.c_str(),
-            buf);
-        fflush(mLogFile);
-    }
+void Logger::log(const char *const log_text, ...)
+{
+    if (settings.disableLoggingInGame)
+        return;
 
-    if (mLogToStandardOut)
-    {
-        fprintf(stdout,
-            "%s %s\n",
-            timeStr.c_str(),
-            buf);
-    }
+    char *line = nullptr;
+    char *text = nullptr;
+    FORMAT_LINE(line, text, log_text)
+    SPECIALLOG(text)
+    pushLine(line);
+}
 
-    DebugMessageListener::distributeEvent(buf);
+void Logger::assertLog(const char *const log_text, ...)
+{
+    if (settings.disableLoggingInGame)
+        return;
 
-    // Delete temporary buffer
-    delete [] buf;
+    char *line = nullptr;
+    char *text = nullptr;
+    FORMAT_LINE(line, text, log_text)
+    SPECIALLOG(text)
+    DebugMessageListener::distributeEvent(text);
+    pushLine(line);
 }
 
 void Logger::log_r(const char *const log_text, ...)
@@ -366,74 +481,28 @@ void Logger::log_r(const char *const log_text, ...)
     if (settings.disableLoggingInGame)
         return;
 
-    SDL_mutexP(mMutex);
-
-    unsigned size = 1024;
-    if (strlen(log_text) * 3 > size)
-        size = CAST_U32(strlen(log_text) * 3);
-
-    char* buf = new char[CAST_SIZE(size + 1)];
-    va_list ap;
-
-    // Use a temporary buffer to fill in the variables
-    va_start(ap, log_text);
-    vsnprintf(buf, size, log_text, ap);
-    buf[size] = 0;
-    va_end(ap);
-
-    // Get the current system time
-    timeval tv;
-    gettimeofday(&tv, nullptr);
-
-    // Print the log entry
-    DATESTREAM
-    SPECIALLOG(buf)
-
-    if (mLogFile != nullptr)
-    {
-        std::string tmpStr = strprintf(
-            "%s %s\n",
-            timeStr.c_str(),
-            buf);
-        mThreadLocked = true;
-        mDelayedLog.push_back(tmpStr);
-        mThreadLocked = false;
-    }
-
-    if (mLogToStandardOut)
-    {
-        fprintf(stdout,
-            "%s %s\n",
-            timeStr.c_str(),
-            buf);
-    }
-
-    // Delete temporary buffer
-    delete [] buf;
-
-    SDL_mutexV(mMutex);
+    char *line = nullptr;
+    char *text = nullptr;
+    FORMAT_LINE(line, text, log_text)
+    SPECIALLOG(text)
+    pushLine(line);
 }
 
 void Logger::flush()
 {
-    if (!mThreadLocked)
-    {
-        SDL_mutexP(mMutex);
-        FOR_EACH (STD_VECTOR<std::string>::const_iterator, it, mDelayedLog)
-        {
-            fputs((*it).c_str(), mLogFile);
-            fputs("\n", mLogFile);
-        }
-        fflush(mLogFile);
-        mDelayedLog.clear();
-        SDL_mutexV(mMutex);
-    }
+    if (mThread == nullptr)
+        return;
+    // wait until writer thread saved all lines queued before this call
+    const unsigned int pos = mPushPos;
+    while (CAST_S32(pos - mFlushedPos) > 0)
+        SDL_Delay(1);
 }
 
 // here string must be safe for any usage
 void Logger::safeError(const std::string &error_text)
 {
     log("Error: %s", error_text.c_str());
+    flush();
 #ifdef USE_SDL2
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
         "Error",
@@ -471,6 +540,7 @@ void Logger::safeError(const std::string &error_text)
 void Logger::error(const std::string &error_text)
 {
     log("Error: %s", error_text.c_str());
+    flush();
 #ifdef USE_SDL2
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
         "Error",
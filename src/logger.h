@@ -36,13 +36,13 @@ PRAGMA48(GCC diagnostic pop)
 
 #ifdef ENABLEDEBUGLOG
 #define DEBUGLOG(str) \
-    if (logger && !mIgnore) \
+    if (logger && !mIgnore && logger->isDebugLog()) \
         logger->dlog(str)
 #define DEBUGLOG2(str, pos, comment) \
-    if (logger && !mIgnore) \
+    if (logger && !mIgnore && logger->isDebugLog()) \
         logger->dlog2(str, pos, comment)
 #define DEBUGLOGSTR(str) \
-    if (logger) \
+    if (logger && logger->isDebugLog()) \
         logger->dlog(str)
 #define IGNOREDEBUGLOG mIgnore = Net::isIgnorePacket(mId)
 #else  // ENABLEDEBUGLOG
@@ -61,8 +61,13 @@ PRAGMA48(GCC diagnostic pop)
 #define WRONGPACKETSIZE \
     logger->unimplemented(CAST_U32(mId), mLength, mPos)
 
+struct SDL_Thread;
+
 /**
  * The Log Class : Useful to write debug or info messages
+ * When log file opened, lines pushed to lock free queue and
+ * written by separate thread. If queue full, lines dropped and counted.
+ * Crash signals write queued lines before program terminated.
  */
 class Logger final
 {
@@ -134,6 +139,7 @@ class Logger final
 
         /**
          * Enters a message in the log (thread safe).
+         * Same as log, kept for code called from other threads.
          */
         void log_r(const char *const log_text, ...) A_NONNULL(2)
 #ifdef __GNUC__
@@ -162,8 +168,17 @@ class Logger final
          */
         void log(const std::string &str);
 
+        /**
+         * Waits until all queued lines written to log file.
+         */
         void flush();
 
+        /**
+         * Writes queued lines to file descriptor without taking them from
+         * queue. Uses only write, so safe in signal handlers.
+         */
+        void writeQueueRaw(const int fd) const;
+
 #ifdef ENABLEDEBUGLOG
         /**
          * Enters debug message in the log. The message will be timestamped.
@@ -180,6 +195,9 @@ class Logger final
         void setDebugLog(const bool n)
         { mDebugLog = n; }
 
+        bool isDebugLog() const noexcept2 A_WARN_UNUSED
+        { return mDebugLog; }
+
         void setReportUnimplemented(const bool n)
         { mReportUnimplemented = n; }
 
@@ -215,10 +233,26 @@ class Logger final
         FILE *getFile() const;
 
     private:
+        struct LogRecord;
+
+        /**
+         * Queues line allocated with new[] and takes ownership of it.
+         */
+        void pushLine(char *const line);
+
+        int writeQueue(FILE *const file,
+                       const bool toStdout);
+
+        static int writeThread(void *ptr);
+
         FILE *mLogFile;
-        STD_VECTOR<std::string> mDelayedLog;
-        SDL_mutex *mMutex;
-        volatile bool mThreadLocked;
+        LogRecord *mRecords;
+        SDL_Thread *mThread;
+        volatile unsigned int mPushPos;
+        volatile unsigned int mPopPos;
+        volatile unsigned int mFlushedPos;
+        volatile unsigned int mDropped;
+        volatile bool mStop;
         bool mLogToStandardOut;
         bool mDebugLog;
         bool mReportUnimplemented;
@@ -54,9 +54,13 @@ PRAGMA48(GCC diagnostic pop)
 #ifdef UNITTESTS
 #include "logger.h"
 
+#include "utils/base64decoder.h"
 #include "utils/cpu.h"
 #include "utils/sdlhelper.h"
+#include "resources/dye/dye.h"
 #include "resources/dye/dyepalette.h"
+#include "resources/map/blockmaskplanes.h"
+
 #ifdef UNITTESTS_CATCH
 #define CATCH_CONFIG_RUNNER
 #ifdef UNITTESTS_EMBED
@@ -210,6 +214,9 @@ int main(int argc, char *argv[])
     VirtFs::init(argv[0]);
     Cpu::detect();
     DyePalette::initFunctions();
+    Dye::initFunctions();
+    Base64::initFunctions();
+    BlockMaskPlanes::initFunctions();
 #ifdef UNITTESTS_CATCH
     return Catch::Session().run(argc, argv);
 #elif defined(UNITTESTS_DOCTEST)
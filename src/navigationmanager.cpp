@@ -22,35 +22,18 @@
 
 #include "enums/resources/map/blockmask.h"
 
+#include "resources/map/blockmaskplanes.h"
 #include "resources/map/map.h"
-#include "resources/map/metatile.h"
 #include "resources/map/walklayer.h"
 
+#include <cstring>
+
 #include "debug.h"
 
 static const int blockWalkMask = (BlockMask::WALL |
     BlockMask::AIR |
     BlockMask::WATER);
 
-#ifndef DYECMD
-namespace
-{
-    struct Cell final
-    {
-        Cell(const int x0, const int y0) :
-            x(x0),
-            y(y0)
-        {
-        }
-
-        A_DEFAULT_COPY(Cell)
-
-        int x;
-        int y;
-    };
-}  // namespace
-#endif  // DYECMD
-
 NavigationManager::NavigationManager()
 {
 }
@@ -60,7 +43,8 @@ NavigationManager::~NavigationManager()
 }
 
 #ifndef DYECMD
-Resource *NavigationManager::loadWalkLayer(const Map *const map)
+Resource *NavigationManager::loadWalkLayer(const Map *const map,
+                                           const int *const cachedData)
 {
     if (map == nullptr)
         return nullptr;
@@ -71,108 +55,22 @@ Resource *NavigationManager::loadWalkLayer(const Map *const map)
         return nullptr;
     WalkLayer *const walkLayer = new WalkLayer(width, height);
 
-    const MetaTile *const tiles = map->getMetaTiles();
     int *const data = walkLayer->getData();
-    if ((tiles == nullptr) || (data == nullptr))
+    if (data == nullptr)
         return walkLayer;
 
-    int x = 0;
-    int y = 0;
-    int num = 1;
-    while (findWalkableTile(x, y, width, height, tiles, data))
+    if (cachedData != nullptr)
     {
-        fillNum(x, y, width, height, num, tiles, data);
-        num ++;
+        memcpy(data, cachedData, width * height * sizeof(int));
+        return walkLayer;
     }
 
+    const BlockMaskPlanes *const planes = map->getBlockPlanes();
+    if (planes == nullptr)
+        return walkLayer;
+    STD_VECTOR<uint64_t> blocked;
+    planes->combineRows(blockWalkMask, blocked);
+    BlockMaskPlanes::fillAreas(&blocked[0], width, height, data);
     return walkLayer;
 }
-
-void NavigationManager::fillNum(int x, int y,
-                                const int width,
-                                const int height,
-                                const int num,
-                                const MetaTile *const tiles,
-                                int *const data)
-{
-    STD_VECTOR<Cell> cells;
-    cells.push_back(Cell(x, y));
-    while (!cells.empty())
-    {
-        const Cell cell = cells.back();
-        cells.pop_back();
-        int ptr;
-        x = cell.x;
-        y = cell.y;
-        data[x + width * y] = num;
-        if (x > 0)
-        {
-            ptr = (x - 1) + width * y;
-            if (data[ptr] == 0)
-            {
-                if ((tiles[ptr].blockmask & blockWalkMask) == 0)
-                    cells.push_back(Cell(x - 1, y));
-                else
-                    data[ptr] = -num;
-            }
-        }
-        if (x < width - 1)
-        {
-            ptr = (x + 1) + width * y;
-            if (data[ptr] == 0)
-            {
-                if ((tiles[ptr].blockmask & blockWalkMask) == 0)
-                    cells.push_back(Cell(x + 1, y));
-                else
-                    data[ptr] = -num;
-            }
-        }
-        if (y > 0)
-        {
-            ptr = x + width * (y - 1);
-            if (data[ptr] == 0)
-            {
-                if ((tiles[ptr].blockmask & blockWalkMask) == 0)
-                    cells.push_back(Cell(x, y - 1));
-                else
-                    data[ptr] = -num;
-            }
-        }
-        if (y < height - 1)
-        {
-            ptr = x + width * (y + 1);
-            if (data[ptr] == 0)
-            {
-                if ((tiles[ptr].blockmask & blockWalkMask) == 0)
-                    cells.push_back(Cell(x, y + 1));
-                else
-                    data[ptr] = -num;
-            }
-        }
-    }
-}
-
-bool NavigationManager::findWalkableTile(int &x1, int &y1,
-                                         const int width,
-                                         const int height,
-                                         const MetaTile *const tiles,
-                                         const int *const data)
-{
-    for (int y = 0; y < height; y ++)
-    {
-        const int y2 = y * width;
-        for (int x = 0; x < width; x ++)
-        {
-            const int ptr = x + y2;
-            if (((tiles[ptr].blockmask & blockWalkMask) == 0) &&
-                data[ptr] == 0)
-            {
-                x1 = x;
-                y1 = y;
-                return true;
-            }
-        }
-    }
-    return false;
-}
 #endif  // DYECMD
@@ -26,8 +26,6 @@
 class Map;
 class Resource;
 
-struct MetaTile;
-
 class NavigationManager final
 {
     public:
@@ -38,23 +36,8 @@ class NavigationManager final
         ~NavigationManager();
 
 #ifndef DYECMD
-        static Resource *loadWalkLayer(const Map *const map);
-#endif  // DYECMD
-
-    private:
-#ifndef DYECMD
-        static bool findWalkableTile(int &x1, int &y1,
-                                     const int width,
-                                     const int height,
-                                     const MetaTile *const tiles,
-                                     const int *const data) A_NONNULL(5, 6);
-
-        static void fillNum(int x, int y,
-                            const int width,
-                            const int height,
-                            const int num,
-                            const MetaTile *const tiles,
-                            int *const data) A_NONNULL(6, 7);
+        static Resource *loadWalkLayer(const Map *const map,
+                                       const int *const cachedData);
 #endif  // DYECMD
 };
 
@@ -65,7 +65,9 @@ Download::Download(void *const ptr,
     mFileName(),
     mUrlQueue(),
     mWriteFunction(nullptr),
+    mFile(nullptr),
     mAdler(0),
+    mFileAdler(0),
     mUpdateFunction(updateFunction),
     mThread(nullptr),
     mCurl(nullptr),
@@ -124,21 +126,19 @@ unsigned long Download::fadler32(FILE *const file)
     if (file == nullptr)
         return 0;
 
-    // Obtain file size
-    fseek(file, 0, SEEK_END);
-    const long fileSize = ftell(file);
-    if (fileSize < 0)
-    {   // file size error
-        return 0;
-    }
     rewind(file);
 
-    // Calculate Adler-32 checksum
-    char *const buffer = new char[CAST_SIZE(fileSize)];
-    const uInt read = static_cast<uInt>(fread(buffer, 1, fileSize, file));
+    // Calculate Adler-32 checksum by blocks
+    const size_t bufferSize = 65536;
+    char *const buffer = new char[bufferSize];
     unsigned long adler = adler32(0L, nullptr, 0);
-    adler = adler32(static_cast<uInt>(adler),
-        reinterpret_cast<Bytef*>(buffer), read);
+    size_t read = 0;
+    while ((read = fread(buffer, 1, bufferSize, file)) > 0)
+    {
+        adler = adler32(static_cast<uInt>(adler),
+            reinterpret_cast<Bytef*>(buffer),
+            static_cast<uInt>(read));
+    }
     delete [] buffer;
     return adler;
 }
@@ -320,8 +320,13 @@ int Download::downloadThread(void *ptr)
                         file = fopen(outFilename.c_str(), "w+b");
                         if (file != nullptr)
                         {
+                            // adler32 calculated while writing to file
+                            d->mFile = file;
+                            d->mFileAdler = adler32(0L, nullptr, 0);
+                            curl_easy_setopt(d->mCurl, CURLOPT_WRITEFUNCTION,
+                                &Download::fileWriteFunction);
                             curl_easy_setopt(d->mCurl, CURLOPT_WRITEDATA,
-                                file);
+                                d);
                         }
                     }
                     curl_easy_setopt(d->mCurl,
@@ -409,7 +414,7 @@ int Download::downloadThread(void *ptr)
                         // Don't check resources.xml checksum
                         if (d->mOptions.checkAdler != 0U)
                         {
-                            const unsigned long adler = fadler32(file);
+                            const unsigned long adler = d->mFileAdler;
 
                             if (d->mAdler != adler)
                             {
@@ -639,6 +644,23 @@ void Download::prepareForm(curl_httppost **form, const std::string &fileName)
         CURLFORM_END);
 }
 
+size_t Download::fileWriteFunction(void *ptr,
+                                   size_t size,
+                                   size_t nmemb,
+                                   void *stream)
+{
+    Download *const d = reinterpret_cast<Download*>(stream);
+    if (d == nullptr || d->mFile == nullptr)
+        return 0;
+    const size_t totalMem = size * nmemb;
+    if (fwrite(ptr, 1, totalMem, d->mFile) != totalMem)
+        return 0;
+    d->mFileAdler = adler32(d->mFileAdler,
+        reinterpret_cast<const Bytef*>(ptr),
+        static_cast<uInt>(totalMem));
+    return totalMem;
+}
+
 size_t Download::writeFunction(void *ptr,
                                size_t size,
                                size_t nmemb,
@@ -115,6 +115,8 @@ class Download final
 
     private:
         static int downloadThread(void *ptr);
+        static size_t fileWriteFunction(void *ptr, size_t size,
+                                        size_t nmemb, void *stream);
         static int downloadProgress(void *clientp, double dltotal,
                                     double dlnow, double ultotal,
                                     double ulnow);
@@ -130,7 +132,9 @@ class Download final
         std::string mFileName;
         std::queue<std::string> mUrlQueue;
         WriteFunction mWriteFunction;
+        FILE *mFile;
         unsigned long mAdler;
+        unsigned long mFileAdler;
         DownloadUpdate mUpdateFunction;
         SDL_Thread *mThread;
         CURL *mCurl;
@@ -0,0 +1,444 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "net/downloadscheduler.h"
+
+#include "logger.h"
+#include "settings.h"
+
+#include "fs/files.h"
+
+#include "utils/cast.h"
+#include "utils/dtor.h"
+#include "utils/foreach.h"
+#include "utils/sdlhelper.h"
+
+#include <zlib.h>
+
+#include <cstring>
+#include <list>
+
+#include "debug.h"
+
+extern volatile bool isTerminate;
+
+namespace Net
+{
+
+DownloadScheduler::DownloadScheduler(void *const ptr,
+                                     const DownloadUpdate updateFunction,
+                                     const int maxParallel) :
+    mPtr(ptr),
+    mUpdateFunction(updateFunction),
+    mJobs(),
+    mThread(nullptr),
+    mMulti(nullptr),
+    mError(static_cast<char*>(calloc(CURL_ERROR_SIZE + 1, 1))),
+    mMaxParallel(maxParallel > 0 ? maxParallel : 1),
+    mCompleted(0U),
+    mCancel(false)
+{
+}
+
+DownloadScheduler::~DownloadScheduler()
+{
+    mCancel = true;
+    SDL::WaitThread(mThread);
+    mThread = nullptr;
+    delete_all(mJobs);
+    mJobs.clear();
+    free(mError);
+}
+
+void DownloadScheduler::addFile(const std::string &fileName,
+                                const int64_t adler32,
+                                const STD_VECTOR<std::string> &urls)
+{
+    if (urls.empty())
+        return;
+    DownloadJob *const job = new DownloadJob;
+    job->scheduler = this;
+    job->fileName = fileName;
+    job->partName = fileName + ".part";
+    if (adler32 > -1)
+    {
+        job->adler = static_cast<unsigned long>(adler32);
+        job->checkAdler = true;
+    }
+    FOR_EACH (STD_VECTOR<std::string>::const_iterator, it, urls)
+        job->urls.push(*it);
+    job->url = job->urls.front();
+    job->urls.pop();
+    mJobs.push_back(job);
+}
+
+bool DownloadScheduler::start()
+{
+    logger->log("Starting parallel download of %u files",
+        CAST_U32(mJobs.size()));
+
+    mThread = SDL::createThread(&downloadThread, "downloadscheduler", this);
+    if (mThread == nullptr)
+    {
+        logger->log1("Could not create download scheduler thread!");
+        mUpdateFunction(mPtr, DownloadStatus::ThreadError, 0, 0);
+        return false;
+    }
+    return true;
+}
+
+void DownloadScheduler::cancel()
+{
+    logger->log1("Canceling parallel download");
+    mCancel = true;
+    SDL::WaitThread(mThread);
+    mThread = nullptr;
+}
+
+/**
+ * Opens part file for job. If part file already present, its adler32
+ * calculated and download will be resumed from end of file.
+ */
+bool DownloadScheduler::openPartFile(DownloadJob *const job)
+{
+    job->resumeFrom = 0;
+    job->rangeChecked = false;
+    job->fileAdler = adler32(0L, nullptr, 0);
+    job->file = fopen(job->partName.c_str(), "r+b");
+    if (job->file != nullptr)
+    {
+        char *const buffer = new char[65536];
+        size_t read = 0;
+        while ((read = fread(buffer, 1, 65536, job->file)) > 0)
+        {
+            job->fileAdler = adler32(job->fileAdler,
+                reinterpret_cast<Bytef*>(buffer),
+                static_cast<uInt>(read));
+            job->resumeFrom += read;
+        }
+        delete [] buffer;
+        fseek(job->file, 0, SEEK_END);
+        if (job->resumeFrom > 0)
+        {
+            logger->log_r("Resuming %s from %d",
+                job->fileName.c_str(),
+                CAST_S32(job->resumeFrom));
+        }
+        return true;
+    }
+    job->file = fopen(job->partName.c_str(), "w+b");
+    return job->file != nullptr;
+}
+
+bool DownloadScheduler::startJob(DownloadJob *const job)
+{
+    if (!openPartFile(job))
+    {
+        logger->log_r("Cant create file: %s", job->partName.c_str());
+        return false;
+    }
+    job->dlTotal = 0.0;
+    job->dlNow = 0.0;
+    job->error[0] = 0;
+    job->curl = curl_easy_init();
+    if (job->curl == nullptr)
+    {
+        closeJob(job);
+        return false;
+    }
+
+    logger->log_r("Downloading: %s", job->url.c_str());
+    CURL *const curl = job->curl;
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, job);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
+    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION,
+        &DownloadScheduler::writeFunction);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, job);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, settings.userAgent.c_str());
+    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, job->error);
+    curl_easy_setopt(curl, CURLOPT_URL, job->url.c_str());
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0);
+    curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION,
+        &DownloadScheduler::downloadProgress);
+    curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, job);
+#if LIBCURL_VERSION_NUM >= 0x070a00
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1);
+#endif  // LIBCURL_VERSION_NUM >= 0x070a00
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 30);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 1800);
+    if (job->resumeFrom > 0)
+    {
+        // no compression here, range must match file offsets
+        curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE,
+            static_cast<curl_off_t>(job->resumeFrom));
+    }
+    else
+    {
+        Download::addHeaders(curl);
+    }
+    Download::addProxy(curl);
+    Download::secureCurl(curl);
+    Download::addCommonFlags(curl);
+
+    if (curl_multi_add_handle(mMulti, curl) != CURLM_OK)
+    {
+        closeJob(job);
+        return false;
+    }
+    return true;
+}
+
+void DownloadScheduler::closeJob(DownloadJob *const job)
+{
+    if (job->curl != nullptr)
+    {
+        curl_multi_remove_handle(mMulti, job->curl);
+        curl_easy_cleanup(job->curl);
+        job->curl = nullptr;
+    }
+    if (job->file != nullptr)
+    {
+        fclose(job->file);
+        job->file = nullptr;
+    }
+}
+
+void DownloadScheduler::finishJob(DownloadJob *const job,
+                                  const CURLcode res)
+{
+    closeJob(job);
+
+    if (res == CURLE_OK)
+    {
+        if (job->checkAdler &&
+            job->fileAdler != job->adler)
+        {
+            logger->log_r("Checksum for file %s failed: (%lx/%lx)",
+                job->fileName.c_str(),
+                job->fileAdler,
+                job->adler);
+            ::remove(job->partName.c_str());
+        }
+        else
+        {
+            // Any existing file with this name is deleted first,
+            // otherwise the rename will fail on Windows.
+            ::remove(job->fileName.c_str());
+            if (Files::renameFile(job->partName, job->fileName) == 0)
+            {
+                job->complete = true;
+                mCompleted = mCompleted + 1;
+                return;
+            }
+        }
+    }
+    else
+    {
+        logger->log_r("curl error %d: %s host: %s",
+            res, job->error, job->url.c_str());
+        strncpy(mError, job->error, CURL_ERROR_SIZE);
+        // http errors like 416 mean part file can not be resumed
+        if (res == CURLE_HTTP_RETURNED_ERROR ||
+            res == CURLE_WRITE_ERROR)
+        {
+            ::remove(job->partName.c_str());
+        }
+    }
+
+    job->attempts ++;
+    if (job->attempts >= 3)
+    {
+        if (job->urls.empty())
+        {
+            job->failed = true;
+            return;
+        }
+        job->attempts = 0;
+        job->url = job->urls.front();
+        job->urls.pop();
+        logger->log_r("selected url: %s", job->url.c_str());
+    }
+}
+
+int DownloadScheduler::reportProgress()
+{
+    // progress counted in percents of each file
+    size_t done = 0;
+    FOR_EACH (STD_VECTOR<DownloadJob*>::const_iterator, it, mJobs)
+    {
+        const DownloadJob *const job = *it;
+        if (job->complete || job->failed)
+        {
+            done += 100;
+        }
+        else if (job->curl != nullptr && job->dlTotal > 0.0)
+        {
+            const double total = job->dlTotal + job->resumeFrom;
+            const double now = job->dlNow + job->resumeFrom;
+            done += CAST_SIZE(now * 100.0 / total);
+        }
+    }
+    return mUpdateFunction(mPtr,
+        DownloadStatus::Idle,
+        mJobs.size() * 100,
+        done);
+}
+
+int DownloadScheduler::downloadThread(void *ptr)
+{
+    DownloadScheduler *const d = reinterpret_cast<DownloadScheduler*>(ptr);
+    if (d == nullptr)
+        return 0;
+
+    d->mUpdateFunction(d->mPtr, DownloadStatus::Starting, 0, 0);
+    d->mMulti = curl_multi_init();
+    if (d->mMulti == nullptr)
+    {
+        d->mUpdateFunction(d->mPtr, DownloadStatus::Error, 0, 0);
+        return 0;
+    }
+
+    std::list<DownloadJob*> pending;
+    FOR_EACH (STD_VECTOR<DownloadJob*>::iterator, it, d->mJobs)
+        pending.push_back(*it);
+    int active = 0;
+    bool failed = false;
+
+    while (!d->mCancel && isTerminate == false)
+    {
+        while (active < d->mMaxParallel && !pending.empty())
+        {
+            DownloadJob *const job = pending.front();
+            pending.pop_front();
+            if (d->startJob(job))
+            {
+                active ++;
+            }
+            else
+            {
+                job->failed = true;
+                failed = true;
+            }
+        }
+        if (active == 0)
+            break;
+
+        int running = 0;
+        curl_multi_perform(d->mMulti, &running);
+
+        int left = 0;
+        CURLMsg *msg = nullptr;
+        while ((msg = curl_multi_info_read(d->mMulti, &left)) != nullptr)
+        {
+            if (msg->msg != CURLMSG_DONE)
+                continue;
+            DownloadJob *job = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &job);
+            if (job == nullptr)
+                continue;
+            const CURLcode res = msg->data.result;
+            active --;
+            d->finishJob(job, res);
+            if (job->failed)
+                failed = true;
+            else if (!job->complete)
+                pending.push_back(job);
+        }
+
+        if (d->reportProgress() != 0)
+            d->mCancel = true;
+
+#if LIBCURL_VERSION_NUM >= 0x071c00
+        curl_multi_wait(d->mMulti, nullptr, 0, 100, nullptr);
+#else  // LIBCURL_VERSION_NUM >= 0x071c00
+        SDL_Delay(10);
+#endif  // LIBCURL_VERSION_NUM >= 0x071c00
+    }
+
+    FOR_EACH (STD_VECTOR<DownloadJob*>::iterator, it, d->mJobs)
+        d->closeJob(*it);
+    curl_multi_cleanup(d->mMulti);
+    d->mMulti = nullptr;
+
+    if (d->mCancel || isTerminate == true)
+    {
+        d->mUpdateFunction(d->mPtr, DownloadStatus::Cancelled, 0, 0);
+    }
+    else if (failed)
+    {
+        d->mUpdateFunction(d->mPtr, DownloadStatus::Error, 0, 0);
+    }
+    else
+    {
+        d->mUpdateFunction(d->mPtr, DownloadStatus::Complete, 0, 0);
+    }
+    return 0;
+}
+
+size_t DownloadScheduler::writeFunction(void *ptr,
+                                        size_t size,
+                                        size_t nmemb,
+                                        void *stream)
+{
+    DownloadJob *const job = reinterpret_cast<DownloadJob*>(stream);
+    if (job == nullptr || job->scheduler->mCancel)
+        return 0;
+    if (!job->rangeChecked)
+    {
+        job->rangeChecked = true;
+        long code = 0;
+        curl_easy_getinfo(job->curl, CURLINFO_RESPONSE_CODE, &code);
+        if (job->resumeFrom > 0 && code != 206)
+        {
+            // server ignored range request, start from beginning
+            job->file = freopen(job->partName.c_str(), "w+b", job->file);
+            job->fileAdler = adler32(0L, nullptr, 0);
+            job->resumeFrom = 0;
+            if (job->file == nullptr)
+                return 0;
+        }
+    }
+    const size_t totalMem = size * nmemb;
+    if (fwrite(ptr, 1, totalMem, job->file) != totalMem)
+        return 0;
+    job->fileAdler = adler32(job->fileAdler,
+        reinterpret_cast<const Bytef*>(ptr),
+        static_cast<uInt>(totalMem));
+    return totalMem;
+}
+
+int DownloadScheduler::downloadProgress(void *clientp,
+                                        double dltotal,
+                                        double dlnow,
+                                        double ultotal A_UNUSED,
+                                        double ulnow A_UNUSED)
+{
+    DownloadJob *const job = reinterpret_cast<DownloadJob*>(clientp);
+    if (job == nullptr)
+        return -5;
+    job->dlTotal = dltotal;
+    job->dlNow = dlnow;
+    if (job->scheduler->mCancel || isTerminate == true)
+        return -1;
+    return 0;
+}
+
+}  // namespace Net
@@ -0,0 +1,159 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NET_DOWNLOADSCHEDULER_H
+#define NET_DOWNLOADSCHEDULER_H
+
+#include "net/download.h"
+
+#include "utils/vector.h"
+
+#include "localconsts.h"
+
+namespace Net
+{
+
+/**
+ * Downloads set of files in parallel using curl multi interface.
+ * Each file written to "<name>.part" and renamed after adler32 check.
+ * Adler32 calculated while data received, and partially downloaded
+ * files resumed with http range requests.
+ */
+class DownloadScheduler final
+{
+    public:
+        DownloadScheduler(void *const ptr,
+                          const DownloadUpdate updateFunction,
+                          const int maxParallel);
+
+        A_DELETE_COPY(DownloadScheduler)
+
+        ~DownloadScheduler();
+
+        /**
+         * Adds file to download.
+         * @param fileName target file name
+         * @param adler32 expected checksum or -1 for skip check
+         * @param urls urls to try, first is main, other is mirrors
+         */
+        void addFile(const std::string &fileName,
+                     const int64_t adler32,
+                     const STD_VECTOR<std::string> &urls);
+
+        /**
+         * Starts the download thread.
+         */
+        bool start();
+
+        /**
+         * Cancels all downloads and waits for download thread.
+         */
+        void cancel();
+
+        const char *getError() const A_WARN_UNUSED
+        { return mError; }
+
+        size_t getFilesCount() const A_WARN_UNUSED
+        { return mJobs.size(); }
+
+        unsigned int getCompletedCount() const A_WARN_UNUSED
+        { return mCompleted; }
+
+    private:
+        struct DownloadJob final
+        {
+            DownloadJob() :
+                fileName(),
+                partName(),
+                urls(),
+                url(),
+                error(),
+                curl(nullptr),
+                file(nullptr),
+                scheduler(nullptr),
+                resumeFrom(0),
+                adler(0),
+                fileAdler(0),
+                dlTotal(0.0),
+                dlNow(0.0),
+                attempts(0),
+                checkAdler(false),
+                rangeChecked(false),
+                complete(false),
+                failed(false)
+            {
+            }
+
+            A_DELETE_COPY(DownloadJob)
+
+            std::string fileName;
+            std::string partName;
+            std::queue<std::string> urls;
+            std::string url;
+            char error[CURL_ERROR_SIZE + 1];
+            CURL *curl;
+            FILE *file;
+            DownloadScheduler *scheduler;
+            int64_t resumeFrom;
+            unsigned long adler;
+            unsigned long fileAdler;
+            double dlTotal;
+            double dlNow;
+            int attempts;
+            bool checkAdler;
+            bool rangeChecked;
+            bool complete;
+            bool failed;
+        };
+
+        bool startJob(DownloadJob *const job);
+
+        void finishJob(DownloadJob *const job,
+                       const CURLcode res);
+
+        void closeJob(DownloadJob *const job);
+
+        int reportProgress();
+
+        static bool openPartFile(DownloadJob *const job);
+
+        static int downloadThread(void *ptr);
+
+        static size_t writeFunction(void *ptr, size_t size,
+                                    size_t nmemb, void *stream);
+
+        static int downloadProgress(void *clientp, double dltotal,
+                                    double dlnow, double ultotal,
+                                    double ulnow);
+
+        void *mPtr;
+        DownloadUpdate mUpdateFunction;
+        STD_VECTOR<DownloadJob*> mJobs;
+        SDL_Thread *mThread;
+        CURLM *mMulti;
+        char *mError;
+        int mMaxParallel;
+        volatile unsigned int mCompleted;
+        volatile bool mCancel;
+};
+
+}  // namespace Net
+
+#endif  // NET_DOWNLOADSCHEDULER_H
@@ -254,8 +254,7 @@ float MessageIn::readFloat(const char *const str)
         memcpy(&value, mData + CAST_SIZE(mPos), sizeof(float));
     }
 #ifdef ENABLEDEBUGLOG
-    std::string text = strprintf("readFloat: %f", value);
-    DEBUGLOG2(str, mPos, text.c_str());
+    DEBUGLOG2(str, mPos, strprintf("readFloat: %f", value).c_str());
 #endif
     mPos += 4;
     PacketCounters::incInBytes(4);
@@ -473,7 +472,7 @@ unsigned char *MessageIn::readBytes(int length, const char *const dstr)
     mPos += length;
 
 #ifdef ENABLEDEBUGLOG
-    if (!mIgnore)
+    if (!mIgnore && logger->isDebugLog())
     {
         std::string str;
         for (int f = 0; f < length; f ++)
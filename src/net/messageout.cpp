@@ -133,8 +133,7 @@ void MessageOut::writeBeingId(const BeingId value, const char *const str)
 void MessageOut::writeFloat(const float value, const char *const str)
 {
 #ifdef ENABLEDEBUGLOG
-    std::string text = strprintf("writeFloat: %f", value);
-    DEBUGLOG2(text, mPos, str);
+    DEBUGLOG2(strprintf("writeFloat: %f", value), mPos, str);
 #endif
     expand(4);
     memcpy(mData + CAST_SIZE(mPos), &value, sizeof(float));
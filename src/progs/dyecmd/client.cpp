@@ -53,6 +53,7 @@
 
 #include "resources/imagehelper.h"
 
+#include "resources/dye/dye.h"
 #include "resources/dye/dyepalette.h"
 
 #include "resources/resourcemanager/resourcemanager.h"
@@ -272,6 +273,7 @@ void Client::gameInit()
     logVars();
     Cpu::detect();
     DyePalette::initFunctions();
+    Dye::initFunctions();
 #if defined(USE_OPENGL)
 #if !defined(ANDROID) && !defined(__APPLE__) && !defined(__native_client__)
     if (!settings.options.safeMode && settings.options.test.empty()
@@ -24,12 +24,17 @@
 #include "maingui.h"
 #include "sdlshared.h"
 
+#include "fs/files.h"
+
 #include "fs/virtfs/fs.h"
 
+#include "resources/dye/dye.h"
 #include "resources/dye/dyepalette.h"
 
 #include "resources/image/image.h"
 
+#include "resources/imagehelper.h"
+
 #ifdef USE_SDL2
 #include "resources/surfaceimagehelper.h"
 #endif  // USE_SDL2
@@ -39,10 +44,14 @@
 #include "resources/resourcemanager/resourcemanager.h"
 
 #include "utils/cpu.h"
+#include "utils/foreach.h"
 #include "utils/gettext.h"
+#include "utils/parallel.h"
 #include "utils/pnglib.h"
 #include "utils/sdlhelper.h"
+#include "utils/stringutils.h"
 
+#include <algorithm>
 #include <iostream>
 
 #ifndef USE_SDL2
@@ -64,6 +73,147 @@ static void printHelp()
     std::cout << _("or") << std::endl;
     // TRANSLATORS: command line help
     std::cout << _("dyecmd srcdyestring dstfile") << std::endl;
+    // TRANSLATORS: command line help
+    std::cout << _("or") << std::endl;
+    // TRANSLATORS: command line help
+    std::cout << _("dyecmd --batch manifestfile") << std::endl;
+    // TRANSLATORS: command line help
+    std::cout << _("or") << std::endl;
+    // TRANSLATORS: command line help
+    std::cout << _("dyecmd --batch srcdir dyestring dstdir") << std::endl;
+}
+
+namespace
+{
+    struct DyeJob final
+    {
+        DyeJob(const std::string &src0,
+               const std::string &dye0,
+               const std::string &dst0) :
+            src(src0),
+            dye(dye0),
+            dst(dst0),
+            pixels(0),
+            ok(false)
+        {
+        }
+
+        std::string src;
+        std::string dye;
+        std::string dst;
+        int pixels;
+        bool ok;
+    };
+}  // namespace
+
+static void dyeFile(void *const data,
+                    const size_t index)
+{
+    DyeJob &job = (*static_cast<STD_VECTOR<DyeJob>*>(data))[index];
+    SDL_Surface *const tmpImage = ImageHelper::loadPng(
+        SDL_RWFromFile(job.src.c_str(), "rb"));
+    if (tmpImage == nullptr)
+        return;
+
+    const Dye dye(job.dye);
+    SDL_Surface *const surface = ImageHelper::dyeSurface(tmpImage, dye);
+    SDL_FreeSurface(tmpImage);
+    if (surface == nullptr)
+        return;
+
+    SDL_Surface *const surface32 = ImageHelper::convertTo32Bit(surface);
+    SDL_FreeSurface(surface);
+    if (surface32 == nullptr)
+        return;
+    job.pixels = surface32->w * surface32->h;
+    job.ok = PngLib::writePNG(surface32, job.dst);
+    SDL_FreeSurface(surface32);
+}
+
+static bool fillBatchJobs(STD_VECTOR<DyeJob> &jobs,
+                          const int argc,
+                          char **argv)
+{
+    if (argc == 3)
+    {
+        // manifest lines: srcfile dyestring dstfile
+        StringVect lines;
+        if (!Files::loadTextFileLocal(argv[2], lines))
+            return false;
+        FOR_EACH (StringVectCIter, it, lines)
+        {
+            std::string line = *it;
+            trim(line);
+            if (line.empty() || line[0] == '#')
+                continue;
+            StringVect parts;
+            splitToStringVector(parts, line, ' ');
+            if (parts.size() != 3)
+            {
+                printf("Wrong manifest line: %s\n", line.c_str());
+                return false;
+            }
+            jobs.push_back(DyeJob(parts[0], parts[1], parts[2]));
+        }
+        return true;
+    }
+
+    const std::string srcDir = argv[2];
+    const std::string dyeString = argv[3];
+    const std::string dstDir = argv[4];
+    StringVect files;
+    Files::enumFiles(files, srcDir, true);
+    std::sort(files.begin(), files.end());
+    FOR_EACH (StringVectCIter, it, files)
+    {
+        const std::string &name = *it;
+        if (!findLast(name, ".png"))
+            continue;
+        jobs.push_back(DyeJob(pathJoin(srcDir, name),
+            dyeString,
+            pathJoin(dstDir, name)));
+    }
+    return true;
+}
+
+static int batchMain(const int argc,
+                     char **argv)
+{
+    STD_VECTOR<DyeJob> jobs;
+    if (!fillBatchJobs(jobs, argc, argv))
+    {
+        printf("Error reading batch list\n");
+        return 1;
+    }
+
+    const uint32_t startTime = SDL_GetTicks();
+    Parallel::run(&dyeFile, &jobs, jobs.size(), 0);
+    const uint32_t time = SDL_GetTicks() - startTime;
+
+    int64_t pixels = 0;
+    int failed = 0;
+    FOR_EACH (STD_VECTOR<DyeJob>::const_iterator, it, jobs)
+    {
+        const DyeJob &job = *it;
+        if (job.ok)
+        {
+            pixels += job.pixels;
+        }
+        else
+        {
+            printf("Error processing image: %s\n", job.src.c_str());
+            failed ++;
+        }
+    }
+    const double mpix = static_cast<double>(pixels) / 1000000.0;
+    printf("Processed %d files, %d failed, %.2f MPix in %u ms, "
+        "%.2f MPix/s\n",
+        CAST_S32(jobs.size()),
+        failed,
+        mpix,
+        time,
+        time != 0U ? mpix * 1000.0 / time : 0.0);
+    return failed != 0 ? 1 : 0;
 }
 
 int main(int argc, char **argv)
@@ -72,7 +222,8 @@ int main(int argc, char **argv)
     {
         return mainGui(argc, argv);
     }
-    if (argc < 3 || argc > 4)
+    const bool batch = argc >= 2 && strcmp(argv[1], "--batch") == 0;
+    if (batch ? (argc != 3 && argc != 5) : (argc < 3 || argc > 4))
     {
         printHelp();
         return 1;
@@ -86,6 +237,14 @@ int main(int argc, char **argv)
 
     Cpu::detect();
     DyePalette::initFunctions();
+    Dye::initFunctions();
+
+    if (batch)
+    {
+        const int ret = batchMain(argc, argv);
+        VirtFs::deinit();
+        return ret;
+    }
 
     GraphicsManager::createWindow(10, 10, 0, SDL_ANYFORMAT);
 
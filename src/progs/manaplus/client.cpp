@@ -108,12 +108,16 @@
 #include "resources/dbmanager.h"
 #include "resources/imagehelper.h"
 
+#include "resources/dye/dye.h"
 #include "resources/dye/dyepalette.h"
 
+#include "resources/map/blockmaskplanes.h"
+
 #include "resources/resourcemanager/resourcemanager.h"
 
 #include "resources/sprite/spritereference.h"
 
+#include "utils/base64decoder.h"
 #include "utils/checkutils.h"
 #include "utils/cpu.h"
 #include "utils/delete2.h"
@@ -410,6 +414,9 @@ void Client::gameInit()
     logVars();
     Cpu::detect();
     DyePalette::initFunctions();
+    Dye::initFunctions();
+    Base64::initFunctions();
+    BlockMaskPlanes::initFunctions();
 #if defined(USE_OPENGL)
 #if !defined(ANDROID) && !defined(__APPLE__) && \
     !defined(__native_client__) && !defined(__SWITCH__) && !defined(UNITTESTS)
@@ -462,6 +469,7 @@ void Client::gameInit()
 
     theme = new Theme;
     Theme::selectSkin();
+    theme->loadAtlas();
     ActorSprite::load();
     touchManager.init();
 
@@ -1418,6 +1426,8 @@ int Client::gameExec()
                     if (generalHandler != nullptr)
                         generalHandler->reloadPartially();
                     mGame = new Game;
+                    // save atlas list now in case client will not exit cleanly
+                    theme->saveAtlasList();
                     BLOCK_END("Client::gameExec State::GAME")
                     break;
 
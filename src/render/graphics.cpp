@@ -65,6 +65,10 @@
 
 #include "render/graphics.h"
 
+#include "render/windowcache.h"
+
+#include "utils/sdlcheckutils.h"
+
 #ifdef USE_OPENGL
 #include "configuration.h"
 #include "graphicsmanager.h"
@@ -126,6 +130,9 @@ Graphics::Graphics() :
     mActualHeight(0),
     mClipStack(1000),
     mWindow(nullptr),
+    mCacheScreen(nullptr),
+    mCacheBlack(nullptr),
+    mCacheWhite(nullptr),
     mBpp(0),
     mAlpha(false),
     mFullscreen(false),
@@ -153,6 +160,7 @@ Graphics::Graphics() :
 Graphics::~Graphics()
 {
     endDraw();
+    freeSoftwareCachePasses();
 }
 
 void Graphics::cleanUp()
@@ -743,6 +751,211 @@ void Graphics::popClipArea() restrict2
     mClipStack.pop();
 }
 
+bool Graphics::beginSoftwareWindowCache(WindowCache &restrict cache,
+                                        SDL_Surface *restrict &screen)
+                                        restrict2
+{
+    if (mCacheScreen != nullptr ||
+        cache.failed ||
+        screen == nullptr ||
+        mClipStack.empty())
+    {
+        return false;
+    }
+
+    // passes use screen coordinates, so cached vertexes stay valid
+    if (mCacheBlack == nullptr ||
+        mCacheBlack->w != screen->w ||
+        mCacheBlack->h != screen->h)
+    {
+        freeSoftwareCachePasses();
+        mCacheBlack = MSDL_CreateRGBSurface(SDL_SWSURFACE,
+            screen->w, screen->h, 32,
+            0x00ff0000U, 0x0000ff00U, 0x000000ffU, 0U);
+        mCacheWhite = MSDL_CreateRGBSurface(SDL_SWSURFACE,
+            screen->w, screen->h, 32,
+            0x00ff0000U, 0x0000ff00U, 0x000000ffU, 0U);
+        if (mCacheBlack == nullptr ||
+            mCacheWhite == nullptr)
+        {
+            freeSoftwareCachePasses();
+            cache.failed = true;
+            return false;
+        }
+    }
+
+    const ClipRect &top = mClipStack.top();
+    const int x = top.xOffset;
+    const int y = top.yOffset;
+    const int x1 = std::max(x, 0);
+    const int y1 = std::max(y, 0);
+    const int x2 = std::min(x + cache.width, screen->w);
+    const int y2 = std::min(y + cache.height, screen->h);
+    if (x2 <= x1 || y2 <= y1)
+        return false;
+
+    // draw whole visible part of window
+    ClipRect &clipArea = mClipStack.push();
+    clipArea.x = x1;
+    clipArea.y = y1;
+    clipArea.width = x2 - x1;
+    clipArea.height = y2 - y1;
+    clipArea.xOffset = x;
+    clipArea.yOffset = y;
+
+    SDL_Rect rect;
+    rect.x = static_cast<RectPos>(x1);
+    rect.y = static_cast<RectPos>(y1);
+    rect.w = static_cast<RectSize>(x2 - x1);
+    rect.h = static_cast<RectSize>(y2 - y1);
+    SDL_SetClipRect(mCacheBlack, &rect);
+    SDL_SetClipRect(mCacheWhite, &rect);
+    SDL_FillRect(mCacheBlack, &rect, 0x00000000U);
+    SDL_FillRect(mCacheWhite, &rect, 0x00ffffffU);
+
+    mCacheScreen = screen;
+    screen = mCacheBlack;
+    cache.pass = 0;
+    return true;
+}
+
+bool Graphics::endSoftwareWindowCache(WindowCache &restrict cache,
+                                      SDL_Surface *restrict &screen)
+                                      restrict2
+{
+    if (mCacheScreen == nullptr)
+        return true;
+
+    if (cache.pass == 0)
+    {
+        // same window over white background gives alpha
+        cache.pass = 1;
+        screen = mCacheWhite;
+        return false;
+    }
+
+    const int width = cache.width;
+    const int height = cache.height;
+    if (cache.surface != nullptr &&
+        (cache.surface->w != width ||
+        cache.surface->h != height))
+    {
+        MSDL_FreeSurface(cache.surface);
+        cache.surface = nullptr;
+    }
+    if (cache.surface == nullptr)
+    {
+        cache.surface = MSDL_CreateRGBSurface(SDL_SWSURFACE,
+            width, height, 32,
+            0x00ff0000U, 0x0000ff00U, 0x000000ffU, 0xff000000U);
+    }
+
+    const ClipRect &top = mClipStack.top();
+    if (cache.surface != nullptr)
+    {
+        SDL_Surface *const surface = cache.surface;
+        SDL_FillRect(surface, nullptr, 0x00000000U);
+        const int blackPitch = mCacheBlack->pitch;
+        const int whitePitch = mCacheWhite->pitch;
+        const int pitch = surface->pitch;
+        const int x1 = top.x;
+        const int x2 = top.x + top.width;
+        const int y2 = top.y + top.height;
+        for (int y = top.y; y < y2; y ++)
+        {
+            const uint32_t *const black = reinterpret_cast<uint32_t*>(
+                static_cast<uint8_t*>(mCacheBlack->pixels) +
+                CAST_SIZE(y * blackPitch));
+            const uint32_t *const white = reinterpret_cast<uint32_t*>(
+                static_cast<uint8_t*>(mCacheWhite->pixels) +
+                CAST_SIZE(y * whitePitch));
+            uint32_t *const dst = reinterpret_cast<uint32_t*>(
+                static_cast<uint8_t*>(surface->pixels) +
+                CAST_SIZE((y - top.yOffset) * pitch));
+            const int xOffset = top.xOffset;
+            for (int x = x1; x < x2; x ++)
+            {
+                const uint32_t b = black[x];
+                // b = a * c, w = a * c + (1 - a) * 255
+                const int alpha = 255 -
+                    CAST_S32((white[x] >> 8) & 0xffU) +
+                    CAST_S32((b >> 8) & 0xffU);
+                if (alpha <= 0)
+                    continue;
+                const uint32_t a = CAST_U32(std::min(alpha, 255));
+                const uint32_t r = std::min(((b >> 16) & 0xffU) * 255U / a,
+                    255U);
+                const uint32_t g = std::min(((b >> 8) & 0xffU) * 255U / a,
+                    255U);
+                const uint32_t bl = std::min((b & 0xffU) * 255U / a, 255U);
+                dst[x - xOffset] = (a << 24) | (r << 16) | (g << 8) | bl;
+            }
+        }
+        cache.valid = true;
+    }
+    else
+    {
+        cache.valid = false;
+        cache.failed = true;
+    }
+
+    cache.pass = 0;
+    screen = mCacheScreen;
+    mCacheScreen = nullptr;
+    // restore clip rect of screen
+    popClipArea();
+    return true;
+}
+
+bool Graphics::drawSoftwareWindowCache(const WindowCache &restrict cache,
+                                       SDL_Surface *restrict const screen)
+                                       restrict2
+{
+    if (!cache.valid ||
+        cache.surface == nullptr ||
+        screen == nullptr ||
+        mClipStack.empty())
+    {
+        return false;
+    }
+
+    const ClipRect &top = mClipStack.top();
+    SDL_Rect rect;
+    rect.x = static_cast<RectPos>(top.xOffset);
+    rect.y = static_cast<RectPos>(top.yOffset);
+    rect.w = static_cast<RectSize>(cache.width);
+    rect.h = static_cast<RectSize>(cache.height);
+    // surface with alpha mask blended by SDL
+    SDL_BlitSurface(cache.surface, nullptr, screen, &rect);
+    return true;
+}
+
+void Graphics::deleteSoftwareWindowCache(WindowCache &restrict cache)
+                                         restrict2
+{
+    if (cache.surface != nullptr)
+    {
+        MSDL_FreeSurface(cache.surface);
+        cache.surface = nullptr;
+    }
+    cache.pass = 0;
+    cache.valid = false;
+}
+
+void Graphics::freeSoftwareCachePasses() restrict2
+{
+    if (mCacheBlack != nullptr)
+    {
+        MSDL_FreeSurface(mCacheBlack);
+        mCacheBlack = nullptr;
+    }
+    if (mCacheWhite != nullptr)
+    {
+        MSDL_FreeSurface(mCacheWhite);
+        mCacheWhite = nullptr;
+    }
+}
+
 #ifdef USE_OPENGL
 void Graphics::setOpenGLFlags() restrict2
 {
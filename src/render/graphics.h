@@ -100,6 +100,7 @@ class ImageRect;
 class ImageVertexes;
 
 struct SDL_Window;
+struct WindowCache;
 
 /**
  * A central point of control for graphics.
@@ -480,6 +481,39 @@ class Graphics notfinal
         virtual void screenResized() restrict2
         { }
 
+        /**
+         * Checks if renderer can draw windows into cache.
+         */
+        virtual bool canCacheWindows() const restrict2 A_WARN_UNUSED
+        { return false; }
+
+        /**
+         * Redirects drawing of window at top clip area into cache.
+         * Returns false if renderer cannot cache windows.
+         */
+        virtual bool beginWindowCache(WindowCache &restrict cache A_UNUSED)
+                                      restrict2
+        { return false; }
+
+        /**
+         * Finishes drawing into cache.
+         * Returns false if window must be drawn again for next pass.
+         */
+        virtual bool endWindowCache(WindowCache &restrict cache A_UNUSED)
+                                    restrict2
+        { return true; }
+
+        /**
+         * Draws cached window content at top clip area.
+         */
+        virtual bool drawWindowCache(const WindowCache &restrict
+                                     cache A_UNUSED) restrict2
+        { return false; }
+
+        virtual void deleteWindowCache(WindowCache &restrict cache A_UNUSED)
+                                       restrict2
+        { }
+
         int mWidth;
         int mHeight;
         int mActualWidth;
@@ -514,6 +548,21 @@ class Graphics notfinal
         void setOpenGLFlags() restrict2;
 #endif  // USE_OPENGL
 
+        bool beginSoftwareWindowCache(WindowCache &restrict cache,
+                                      SDL_Surface *restrict &screen)
+                                      restrict2;
+
+        bool endSoftwareWindowCache(WindowCache &restrict cache,
+                                    SDL_Surface *restrict &screen) restrict2;
+
+        bool drawSoftwareWindowCache(const WindowCache &restrict cache,
+                                     SDL_Surface *restrict const screen)
+                                     restrict2;
+
+        void deleteSoftwareWindowCache(WindowCache &restrict cache) restrict2;
+
+        void freeSoftwareCachePasses() restrict2;
+
         /**
          * Holds the clip area stack.
          */
@@ -521,6 +570,13 @@ class Graphics notfinal
 
         SDL_Window *restrict mWindow;
 
+        /**
+         * Screen while window drawn into software cache passes.
+         */
+        SDL_Surface *restrict mCacheScreen;
+        SDL_Surface *restrict mCacheBlack;
+        SDL_Surface *restrict mCacheWhite;
+
 #ifdef USE_SDL2
         static SDL_Renderer *restrict mRenderer;
 #endif  // USE_SDL2
@@ -24,13 +24,11 @@
 
 #include "render/normalopenglgraphics.h"
 
-#ifdef OPENGLERRORS
 #include "graphicsmanager.h"
-#endif  // OPENGLERRORS
 
-#ifdef DEBUG_OPENGL
+#include "render/windowcache.h"
+
 #include "render/opengl/mgl.h"
-#endif  // DEBUG_OPENGL
 
 #include "render/vertexes/imagecollection.h"
 
@@ -39,6 +37,7 @@
 
 #include "resources/image/image.h"
 
+#include "utils/delete2.h"
 #include "utils/sdlcheckutils.h"
 
 #include "debug.h"
@@ -115,7 +114,11 @@ NormalOpenGLGraphics::NormalOpenGLGraphics() :
     mOldTexture(),
     mOldTextureId(0),
 #endif  // DEBUG_BIND_TEXTURE
-    mFbo()
+    mFbo(),
+    mCacheX(0),
+    mCacheY(0),
+    mCacheHeight(0),
+    mCacheDraw(false)
 {
     mOpenGL = RENDER_NORMAL_OPENGL;
     mName = "normal OpenGL";
@@ -1359,10 +1362,7 @@ void NormalOpenGLGraphics::pushClipArea(const Rect &restrict area) restrict2
         glTranslatef(static_cast<GLfloat>(transX),
                      static_cast<GLfloat>(transY), 0);
     }
-    glScissor(clipArea.x * mScale,
-        (mRect.h - clipArea.y - clipArea.height) * mScale,
-        clipArea.width * mScale,
-        clipArea.height * mScale);
+    setScissor(clipArea);
 }
 
 void NormalOpenGLGraphics::popClipArea() restrict2
@@ -1387,10 +1387,207 @@ void NormalOpenGLGraphics::popClipArea() restrict2
         glTranslatef(static_cast<GLfloat>(transX),
                      static_cast<GLfloat>(transY), 0);
     }
-    glScissor(clipArea.x * mScale,
-        (mRect.h - clipArea.y - clipArea.height) * mScale,
-        clipArea.width * mScale,
-        clipArea.height * mScale);
+    setScissor(clipArea);
+}
+
+void NormalOpenGLGraphics::setScissor(const ClipRect &restrict clipArea)
+                                      restrict2
+{
+    if (mCacheDraw)
+    {
+        glScissor((clipArea.x - mCacheX) * mScale,
+            (mCacheHeight - clipArea.y + mCacheY - clipArea.height) * mScale,
+            clipArea.width * mScale,
+            clipArea.height * mScale);
+    }
+    else
+    {
+        glScissor(clipArea.x * mScale,
+            (mRect.h - clipArea.y - clipArea.height) * mScale,
+            clipArea.width * mScale,
+            clipArea.height * mScale);
+    }
+}
+
+bool NormalOpenGLGraphics::canCacheWindows() const restrict2
+{
+    return mglGenFramebuffers != nullptr &&
+        mglBlendFuncSeparate != nullptr;
+}
+
+bool NormalOpenGLGraphics::beginWindowCache(WindowCache &restrict cache)
+                                            restrict2
+{
+    if (mCacheDraw ||
+        cache.failed ||
+        mClipStack.empty() ||
+        mglGenFramebuffers == nullptr ||
+        mglBlendFuncSeparate == nullptr)
+    {
+        return false;
+    }
+
+    const int width = cache.width * mScale;
+    const int height = cache.height * mScale;
+    if (width <= 0 || height <= 0)
+        return false;
+
+    if (cache.fbo == nullptr ||
+        cache.fboWidth != width ||
+        cache.fboHeight != height)
+    {
+        deleteWindowCache(cache);
+        cache.fbo = new FBOInfo;
+        cache.fboWidth = width;
+        cache.fboHeight = height;
+        // createFBO leave new frame buffer bound
+        GraphicsManager::createFBO(width, height, cache.fbo);
+        mTextureBinded = 0;
+        if (mglCheckFramebufferStatus != nullptr &&
+            mglCheckFramebufferStatus(GL_FRAMEBUFFER) !=
+            GL_FRAMEBUFFER_COMPLETE)
+        {
+            deleteWindowCache(cache);
+            cache.failed = true;
+            return false;
+        }
+    }
+    else
+    {
+        mglBindFramebuffer(GL_FRAMEBUFFER, cache.fbo->fboId);
+    }
+
+    // draw whole window even if it partially outside of screen
+    const ClipRect &top = mClipStack.top();
+    const int x = top.xOffset;
+    const int y = top.yOffset;
+    ClipRect &clipArea = mClipStack.push();
+    clipArea.x = x;
+    clipArea.y = y;
+    clipArea.width = cache.width;
+    clipArea.height = cache.height;
+    clipArea.xOffset = x;
+    clipArea.yOffset = y;
+
+    mCacheX = x;
+    mCacheY = y;
+    mCacheHeight = cache.height;
+    mCacheDraw = true;
+
+    glViewport(0, 0, width, height);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(static_cast<double>(x),
+        static_cast<double>(x + cache.width),
+        static_cast<double>(y + cache.height),
+        static_cast<double>(y),
+        -1.0, 1.0);
+    glMatrixMode(GL_MODELVIEW);
+    setScissor(clipArea);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // keep alpha of translucent skins for later blending with screen
+    mglBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+        GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    return true;
+}
+
+bool NormalOpenGLGraphics::endWindowCache(WindowCache &restrict cache)
+                                          restrict2
+{
+    if (!mCacheDraw)
+        return true;
+
+    Graphics::popClipArea();
+    mCacheDraw = false;
+    cache.valid = true;
+
+    mglBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, mActualWidth, mActualHeight);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0.0, static_cast<double>(mRect.w),
+        static_cast<double>(mRect.h),
+        0.0, -1.0, 1.0);
+    glMatrixMode(GL_MODELVIEW);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (!mClipStack.empty())
+        setScissor(mClipStack.top());
+    return true;
+}
+
+bool NormalOpenGLGraphics::drawWindowCache(const WindowCache &restrict cache)
+                                           restrict2
+{
+    if (!cache.valid || cache.fbo == nullptr)
+        return false;
+
+    setColorAlpha(1.0F);
+    bindTexture(OpenGLImageHelper::mTextureType, cache.fbo->textureId);
+    enableTexturingAndBlending();
+    // cache content already multiplied by alpha
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    const int width = cache.width;
+    const int height = cache.height;
+    GLint vert[] =
+    {
+        0, 0,
+        width, 0,
+        width, height,
+        0, height
+    };
+
+    // frame buffer rows stored from bottom to top
+    if (OpenGLImageHelper::mTextureType == GL_TEXTURE_2D)
+    {
+        GLfloat tex[] =
+        {
+            0.0F, 1.0F,
+            1.0F, 1.0F,
+            1.0F, 0.0F,
+            0.0F, 0.0F
+        };
+        bindPointerIntFloat(&vert[0], &tex[0]);
+    }
+    else
+    {
+        const int fboWidth = cache.fboWidth;
+        const int fboHeight = cache.fboHeight;
+        GLint tex[] =
+        {
+            0, fboHeight,
+            fboWidth, fboHeight,
+            fboWidth, 0,
+            0, 0
+        };
+        bindPointerInt(&vert[0], &tex[0]);
+    }
+#ifdef DEBUG_DRAW_CALLS
+    mDrawCalls ++;
+#endif  // DEBUG_DRAW_CALLS
+
+    glDrawArrays(GL_QUADS, 0, 4);
+#ifdef OPENGLERRORS
+    graphicsManager.logError();
+#endif  // OPENGLERRORS
+
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    return true;
+}
+
+void NormalOpenGLGraphics::deleteWindowCache(WindowCache &restrict cache)
+                                             restrict2
+{
+    if (cache.fbo != nullptr)
+    {
+        GraphicsManager::deleteFBO(cache.fbo);
+        delete2(cache.fbo)
+        mTextureBinded = 0;
+    }
+    cache.fboWidth = 0;
+    cache.fboHeight = 0;
+    cache.valid = false;
 }
 
 void NormalOpenGLGraphics::drawPoint(int x, int y) restrict2
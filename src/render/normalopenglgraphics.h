@@ -84,6 +84,20 @@ class NormalOpenGLGraphics final : public Graphics
 
         void testDraw() restrict2 override final;
 
+        bool canCacheWindows() const restrict2 override final;
+
+        bool beginWindowCache(WindowCache &restrict cache) restrict2
+                              override final;
+
+        bool endWindowCache(WindowCache &restrict cache) restrict2
+                            override final;
+
+        bool drawWindowCache(const WindowCache &restrict cache) restrict2
+                             override final;
+
+        void deleteWindowCache(WindowCache &restrict cache) restrict2
+                               override final;
+
         #include "render/graphicsdef.hpp"
         RENDER_GRAPHICSDEF_HPP
 
@@ -102,6 +116,8 @@ class NormalOpenGLGraphics final : public Graphics
 #endif  // DEBUG_BIND_TEXTURE
 
     private:
+        void setScissor(const ClipRect &restrict clipArea) restrict2;
+
         GLfloat *mFloatTexArray A_NONNULLPOINTER;
         GLint *mIntTexArray A_NONNULLPOINTER;
         GLint *mIntVertArray A_NONNULLPOINTER;
@@ -126,6 +142,10 @@ class NormalOpenGLGraphics final : public Graphics
 #endif  // DEBUG_BIND_TEXTURE
 
         FBOInfo mFbo;
+        int mCacheX;
+        int mCacheY;
+        int mCacheHeight;
+        bool mCacheDraw;
 };
 #endif  // defined USE_OPENGL && !defined ANDROID &&
         // !defined(__native_client__)
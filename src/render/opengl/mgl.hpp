@@ -139,6 +139,7 @@ defName(glTextureSubImage2D);
 defName(glTextureSubImage2DEXT);
 defName(glClearTexImage);
 defName(glClearTexSubImage);
+defName(glBlendFuncSeparate);
 #ifdef WIN32
 defName(wglGetExtensionsString);
 #endif
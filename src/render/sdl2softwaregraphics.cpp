@@ -1531,4 +1531,29 @@ void SDL2SoftwareGraphics::calcImageRect(ImageVertexes *restrict const vert,
     #include "render/graphics_calcImageRect.hpp"
 }
 
+bool SDL2SoftwareGraphics::canCacheWindows() const restrict2
+{
+    return true;
+}
+
+bool SDL2SoftwareGraphics::beginWindowCache(WindowCache &restrict cache) restrict2
+{
+    return beginSoftwareWindowCache(cache, mSurface);
+}
+
+bool SDL2SoftwareGraphics::endWindowCache(WindowCache &restrict cache) restrict2
+{
+    return endSoftwareWindowCache(cache, mSurface);
+}
+
+bool SDL2SoftwareGraphics::drawWindowCache(const WindowCache &restrict cache) restrict2
+{
+    return drawSoftwareWindowCache(cache, mSurface);
+}
+
+void SDL2SoftwareGraphics::deleteWindowCache(WindowCache &restrict cache) restrict2
+{
+    deleteSoftwareWindowCache(cache);
+}
+
 #endif  // USE_SDL2
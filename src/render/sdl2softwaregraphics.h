@@ -66,6 +66,20 @@ class SDL2SoftwareGraphics final : public Graphics
         #include "render/softwaregraphicsdef.hpp"
         RENDER_SOFTWAREGRAPHICSDEF_HPP
 
+        bool canCacheWindows() const restrict2 override final;
+
+        bool beginWindowCache(WindowCache &restrict cache) restrict2
+                              override final;
+
+        bool endWindowCache(WindowCache &restrict cache) restrict2
+                            override final;
+
+        bool drawWindowCache(const WindowCache &restrict cache) restrict2
+                             override final;
+
+        void deleteWindowCache(WindowCache &restrict cache) restrict2
+                               override final;
+
         bool resizeScreen(const int width,
                           const int height) restrict2 override final;
 
@@ -1518,4 +1518,29 @@ void SDLGraphics::calcImageRect(ImageVertexes *restrict const vert,
     #include "render/graphics_calcImageRect.hpp"
 }
 
+bool SDLGraphics::canCacheWindows() const restrict2
+{
+    return true;
+}
+
+bool SDLGraphics::beginWindowCache(WindowCache &restrict cache) restrict2
+{
+    return beginSoftwareWindowCache(cache, mWindow);
+}
+
+bool SDLGraphics::endWindowCache(WindowCache &restrict cache) restrict2
+{
+    return endSoftwareWindowCache(cache, mWindow);
+}
+
+bool SDLGraphics::drawWindowCache(const WindowCache &restrict cache) restrict2
+{
+    return drawSoftwareWindowCache(cache, mWindow);
+}
+
+void SDLGraphics::deleteWindowCache(WindowCache &restrict cache) restrict2
+{
+    deleteSoftwareWindowCache(cache);
+}
+
 #endif  // USE_SDL2
@@ -57,6 +57,20 @@ class SDLGraphics final : public Graphics
         #include "render/softwaregraphicsdef.hpp"
         RENDER_SOFTWAREGRAPHICSDEF_HPP
 
+        bool canCacheWindows() const restrict2 override final;
+
+        bool beginWindowCache(WindowCache &restrict cache) restrict2
+                              override final;
+
+        bool endWindowCache(WindowCache &restrict cache) restrict2
+                            override final;
+
+        bool drawWindowCache(const WindowCache &restrict cache) restrict2
+                             override final;
+
+        void deleteWindowCache(WindowCache &restrict cache) restrict2
+                               override final;
+
     protected:
         int SDL_FakeUpperBlit(const SDL_Surface *restrict const src,
                               SDL_Rect *restrict const srcrect,
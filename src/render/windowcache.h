@@ -0,0 +1,65 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDER_WINDOWCACHE_H
+#define RENDER_WINDOWCACHE_H
+
+#include "localconsts.h"
+
+struct FBOInfo;
+struct SDL_Surface;
+
+/**
+ * Offscreen copy of window content.
+ * Geometry filled by window, render target owned by graphics.
+ */
+struct WindowCache final
+{
+    WindowCache() :
+        fbo(nullptr),
+        surface(nullptr),
+        x(0),
+        y(0),
+        width(0),
+        height(0),
+        fboWidth(0),
+        fboHeight(0),
+        pass(0),
+        valid(false),
+        failed(false)
+    {
+    }
+
+    A_DELETE_COPY(WindowCache)
+
+    FBOInfo *fbo;
+    SDL_Surface *surface;
+    int x;
+    int y;
+    int width;
+    int height;
+    int fboWidth;
+    int fboHeight;
+    int pass;
+    bool valid;
+    bool failed;
+};
+
+#endif  // RENDER_WINDOWCACHE_H
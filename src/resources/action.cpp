@@ -26,12 +26,14 @@
 
 #include "utils/dtor.h"
 #include "utils/foreach.h"
+#include "utils/likely.h"
 
 #include "debug.h"
 
 Action::Action(const std::string &name) noexcept2 :
     MemoryCounter(),
     mAnimations(),
+    mDirections(),
     mCounterName(name),
     mNumber(100)
 {
@@ -44,6 +46,17 @@ Action::~Action()
 
 const Animation *Action::getAnimation(SpriteDirection::Type direction)
                                       const noexcept2
+{
+    if (A_LIKELY(direction >= SpriteDirection::DEFAULT &&
+        direction < SpriteDirection::INVALID))
+    {
+        return mDirections[direction];
+    }
+    return findAnimation(direction);
+}
+
+const Animation *Action::findAnimation(SpriteDirection::Type direction)
+                                       const noexcept2
 {
     Animations::const_iterator i = mAnimations.find(direction);
 
@@ -74,6 +87,16 @@ void Action::setAnimation(const SpriteDirection::Type direction,
                           Animation *const animation) noexcept2
 {
     mAnimations[direction] = animation;
+    updateDirections();
+}
+
+void Action::updateDirections() noexcept2
+{
+    for (int f = SpriteDirection::DEFAULT; f < SpriteDirection::INVALID; f ++)
+    {
+        mDirections[f] = findAnimation(
+            static_cast<SpriteDirection::Type>(f));
+    }
 }
 
 void Action::setLastFrameDelay(const int delay) noexcept2
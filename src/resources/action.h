@@ -71,7 +71,14 @@ class Action final : public MemoryCounter
         typedef Animations::iterator AnimationIter;
         typedef Animations::const_iterator AnimationCIter;
 
+        const Animation *findAnimation(SpriteDirection::Type direction) const
+                                       noexcept2 A_WARN_UNUSED;
+
+        void updateDirections() noexcept2;
+
         Animations mAnimations;
+        /**< Resolved animation for each direction, including fallbacks. */
+        const Animation *mDirections[SpriteDirection::INVALID];
         std::string mCounterName;
         unsigned mNumber;
 };
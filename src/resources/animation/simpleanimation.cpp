@@ -129,6 +129,19 @@ bool SimpleAnimation::update(const int timePassed)
     return updated;
 }
 
+int SimpleAnimation::getFrameTimeLeft() const
+{
+    if ((mCurrentFrame == nullptr) ||
+        (mAnimation == nullptr) ||
+        !mInitialized ||
+        mCurrentFrame->delay <= 0)
+    {
+        return -1;
+    }
+    // frame changed after time become bigger than delay
+    return mCurrentFrame->delay - mAnimationTime + 1;
+}
+
 int SimpleAnimation::getLength() const
 {
     if (mAnimation == nullptr)
@@ -63,6 +63,11 @@ class SimpleAnimation final
 
         bool update(const int timePassed);
 
+        /**
+         * Returns time until current frame changed or -1 if it never change.
+         */
+        int getFrameTimeLeft() const A_WARN_UNUSED;
+
         void draw(Graphics *const graphics,
                   const int posX, const int posY) const A_NONNULL(2);
 
@@ -26,7 +26,11 @@
 
 #include "resources/dye/dyepalette.h"
 
+#ifdef SIMD_SUPPORTED
+#include "utils/cpu.h"
+#endif  // SIMD_SUPPORTED
 #include "utils/delete2.h"
+#include "utils/parallel.h"
 
 #include <sstream>
 
@@ -39,6 +43,43 @@ PRAGMA48(GCC diagnostic pop)
 
 #include "debug.h"
 
+NormalDyeFunctionPtr Dye::funcNormalDye = &Dye::normalDyeDefault;
+
+namespace
+{
+    // pixels count processed by one worker thread call
+    const int dyeBandSize = 65536;
+
+    struct DyeBands final
+    {
+        DyeBands(uint32_t *const pixels0,
+                 const int bufSize0,
+                 const NormalDyeTable &table0) :
+            pixels(pixels0),
+            table(table0),
+            bufSize(bufSize0)
+        {
+        }
+
+        A_DELETE_COPY(DyeBands)
+
+        uint32_t *pixels;
+        const NormalDyeTable &table;
+        int bufSize;
+    };
+
+    void dyeBand(void *const data,
+                 const size_t index)
+    {
+        const DyeBands *const bands = static_cast<const DyeBands*>(data);
+        const int start = CAST_S32(index) * dyeBandSize;
+        const int size = std::min(dyeBandSize, bands->bufSize - start);
+        Dye::funcNormalDye(bands->pixels + CAST_SIZE(start),
+            size,
+            bands->table);
+    }
+}  // namespace
+
 Dye::Dye(const std::string &restrict description)
 {
     for (int i = 0; i < dyePalateSize; ++i)
@@ -154,70 +195,71 @@ int Dye::getType() const restrict2 noexcept2
     return 0;
 }
 
-void Dye::normalDye(uint32_t *restrict pixels,
-                    const int bufSize) const restrict2
+void Dye::fillNormalTable(NormalDyeTable &restrict table,
+                          const uint32_t alphaMask,
+                          const uint32_t shift0,
+                          const uint32_t shift1,
+                          const uint32_t shift2) const restrict2
 {
-    if (pixels == nullptr)
-        return;
+    table.alphaMask = alphaMask;
+    table.shift[0] = shift0;
+    table.shift[1] = shift1;
+    table.shift[2] = shift2;
 
-    for (const uint32_t *const p_end = pixels + CAST_SIZE(bufSize);
-         pixels != p_end;
-         ++ pixels)
-    {
-        const uint32_t p = *pixels;
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        const int alpha = p & 0xff000000;
-#else  // SDL_BYTEORDER == SDL_BIG_ENDIAN
-
-        const int alpha = p & 0xff;
-#endif  // SDL_BYTEORDER == SDL_BIG_ENDIAN
-
-        if (alpha == 0)
-            continue;
-        unsigned int color[3];
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        color[0] = (p) & 255U;
-        color[1] = (p >> 8U) & 255U;
-        color[2] = (p >> 16U) & 255U;
-#else  // SDL_BYTEORDER == SDL_BIG_ENDIAN
+    for (unsigned int intensity = 0; intensity < 256; intensity ++)
+        table.colors[intensity] = 0U;
 
-        color[0] = (p >> 24U) & 255U;
-        color[1] = (p >> 16U) & 255U;
-        color[2] = (p >> 8U) & 255U;
-#endif  // SDL_BYTEORDER == SDL_BIG_ENDIAN
-
-        const unsigned int cmax = std::max(
-            color[0], std::max(color[1], color[2]));
-        if (cmax == 0)
-            continue;
-
-        const unsigned int cmin = std::min(
-            color[0], std::min(color[1], color[2]));
-        const unsigned int intensity = color[0] + color[1] + color[2];
-
-        if (cmin != cmax && (cmin != 0 || (intensity != cmax
-            && intensity != 2 * cmax)))
+    for (unsigned int i = 1; i < 8; i ++)
+    {
+        const DyePalette *const palette = mDyePalettes[i - 1];
+        uint32_t *const colors = &table.colors[i * 256];
+        for (unsigned int intensity = 0; intensity < 256; intensity ++)
         {
-            // not pure
-            continue;
+            unsigned int color[3];
+            color[0] = (i & 1U) != 0U ? intensity : 0U;
+            color[1] = (i & 2U) != 0U ? intensity : 0U;
+            color[2] = (i & 4U) != 0U ? intensity : 0U;
+            if (palette != nullptr)
+                palette->getColor(intensity, color);
+            colors[intensity] = (color[0] << shift0) |
+                (color[1] << shift1) |
+                (color[2] << shift2);
         }
+    }
+}
 
-        const unsigned int i = static_cast<int>(color[0] != 0) |
-            (static_cast<int>(color[1] != 0) << 1) |
-            (static_cast<int>(color[2] != 0) << 2);
+void Dye::applyNormalTable(uint32_t *restrict pixels,
+                           const int bufSize,
+                           const NormalDyeTable &restrict table)
+{
+    if (bufSize < dyeBandSize * 2)
+    {
+        funcNormalDye(pixels, bufSize, table);
+        return;
+    }
+
+    DyeBands bands(pixels, bufSize, table);
+    Parallel::run(&dyeBand,
+        &bands,
+        CAST_SIZE((bufSize + dyeBandSize - 1) / dyeBandSize),
+        0);
+}
 
-        if (mDyePalettes[i - 1] != nullptr)
-            mDyePalettes[i - 1]->getColor(cmax, color);
+void Dye::normalDye(uint32_t *restrict pixels,
+                    const int bufSize) const restrict2
+{
+    if (pixels == nullptr)
+        return;
 
+    NormalDyeTable table;
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        *pixels = (color[0]) | (color[1] << 8)
-            | (color[2] << 16) | alpha;
+    fillNormalTable(table, 0xff000000U, 0U, 8U, 16U);
 #else  // SDL_BYTEORDER == SDL_BIG_ENDIAN
 
-        *pixels = (color[0] << 24) | (color[1] << 16)
-            | (color[2] << 8) | alpha;
+    fillNormalTable(table, 0xffU, 24U, 16U, 8U);
 #endif  // SDL_BYTEORDER == SDL_BIG_ENDIAN
-    }
+
+    applyNormalTable(pixels, bufSize, table);
 }
 
 void Dye::normalOGLDye(uint32_t *restrict pixels,
@@ -226,62 +268,26 @@ void Dye::normalOGLDye(uint32_t *restrict pixels,
     if (pixels == nullptr)
         return;
 
-    for (const uint32_t *const p_end = pixels + CAST_SIZE(bufSize);
-         pixels != p_end;
-         ++ pixels)
-    {
-        const uint32_t p = *pixels;
+    NormalDyeTable table;
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        const uint32_t alpha = p & 255U;
+    fillNormalTable(table, 0xffU, 24U, 16U, 8U);
 #else  // SDL_BYTEORDER == SDL_BIG_ENDIAN
 
-        const uint32_t alpha = p & 0xff000000U;
+    fillNormalTable(table, 0xff000000U, 0U, 8U, 16U);
 #endif  // SDL_BYTEORDER == SDL_BIG_ENDIAN
 
-        if (alpha == 0)
-            continue;
-        unsigned int color[3];
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        color[0] = (p >> 24U) & 255U;
-        color[1] = (p >> 16U) & 255U;
-        color[2] = (p >> 8U) & 255U;
-#else  // SDL_BYTEORDER == SDL_BIG_ENDIAN
-
-        color[0] = (p) & 255U;
-        color[1] = (p >> 8U) & 255U;
-        color[2] = (p >> 16U) & 255U;
-#endif  // SDL_BYTEORDER == SDL_BIG_ENDIAN
-
-        const unsigned int cmax = std::max(
-            color[0], std::max(color[1], color[2]));
-        if (cmax == 0)
-            continue;
-
-        const unsigned int cmin = std::min(
-            color[0], std::min(color[1], color[2]));
-        const unsigned int intensity = color[0] + color[1] + color[2];
-
-        if (cmin != cmax && (cmin != 0 || (intensity != cmax
-            && intensity != 2 * cmax)))
-        {
-            // not pure
-            continue;
-        }
-
-        const unsigned int i = static_cast<int>(color[0] != 0) |
-            (static_cast<int>(color[1] != 0) << 1) |
-            (static_cast<int>(color[2] != 0) << 2);
-
-        if (mDyePalettes[i - 1] != nullptr)
-            mDyePalettes[i - 1]->getColor(cmax, color);
-
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        *pixels = (color[0] << 24) | (color[1] << 16)
-            | (color[2] << 8) | alpha;
-#else  // SDL_BYTEORDER == SDL_BIG_ENDIAN
+    applyNormalTable(pixels, bufSize, table);
+}
 
-        *pixels = (color[0]) | (color[1] << 8)
-            | (color[2] << 16) | alpha;
-#endif  // SDL_BYTEORDER == SDL_BIG_ENDIAN
-    }
+void Dye::initFunctions()
+{
+#ifdef SIMD_SUPPORTED
+    const uint32_t flags = Cpu::getFlags();
+    if ((flags & Cpu::FEATURE_AVX2) != 0U)
+        funcNormalDye = &Dye::normalDyeAvx2;
+    else if ((flags & Cpu::FEATURE_SSE2) != 0U)
+        funcNormalDye = &Dye::normalDyeSse2;
+    else
+#endif  // SIMD_SUPPORTED
+        funcNormalDye = &Dye::normalDyeDefault;
 }
@@ -33,6 +33,32 @@ const int dyePalateSize = 9;
 const int sPaleteIndex = 7;
 const int aPaleteIndex = 8;
 
+/**
+ * Lookup table for normal dye.
+ * Index is pure color channels bitmask * 256 + color intensity.
+ */
+struct NormalDyeTable final
+{
+    NormalDyeTable() :
+        colors(),
+        alphaMask(0U)
+    {
+        shift[0] = 0U;
+        shift[1] = 0U;
+        shift[2] = 0U;
+    }
+
+    A_DELETE_COPY(NormalDyeTable)
+
+    uint32_t colors[8 * 256];
+    uint32_t alphaMask;
+    uint32_t shift[3];
+};
+
+typedef void (*NormalDyeFunctionPtr) (uint32_t *restrict pixels,
+                                      const int bufSize,
+                                      const NormalDyeTable &restrict table);
+
 /**
  * Class for dispatching pixel-recoloring amongst several palettes.
  */
@@ -83,6 +109,43 @@ class Dye final
         void normalOGLDye(uint32_t *restrict pixels,
                           const int bufSize) const restrict2;
 
+        /**
+         * Fill lookup table for normal dye with given pixel layout.
+         */
+        void fillNormalTable(NormalDyeTable &restrict table,
+                             const uint32_t alphaMask,
+                             const uint32_t shift0,
+                             const uint32_t shift1,
+                             const uint32_t shift2) const restrict2;
+
+        /**
+         * Apply normal dye table to pixels. Big buffers split to bands
+         * and processed in worker threads.
+         */
+        static void applyNormalTable(uint32_t *restrict pixels,
+                                     const int bufSize,
+                                     const NormalDyeTable &restrict table);
+
+        static void normalDyeDefault(uint32_t *restrict pixels,
+                                     const int bufSize,
+                                     const NormalDyeTable &restrict table);
+
+#ifdef SIMD_SUPPORTED
+        __attribute__ ((target ("sse2")))
+        static void normalDyeSse2(uint32_t *restrict pixels,
+                                  const int bufSize,
+                                  const NormalDyeTable &restrict table);
+
+        __attribute__ ((target ("avx2")))
+        static void normalDyeAvx2(uint32_t *restrict pixels,
+                                  const int bufSize,
+                                  const NormalDyeTable &restrict table);
+#endif  // SIMD_SUPPORTED
+
+        static void initFunctions();
+
+        static NormalDyeFunctionPtr funcNormalDye;
+
     private:
         /**
          * The order of the palettes, as well as their uppercase letter, is:
@@ -0,0 +1,217 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/dye/dye.h"
+
+#include "utils/cast.h"
+
+#ifdef SIMD_SUPPORTED
+// avx2
+#include <immintrin.h>
+#endif  // SIMD_SUPPORTED
+
+#include "debug.h"
+
+void Dye::normalDyeDefault(uint32_t *restrict pixels,
+                           const int bufSize,
+                           const NormalDyeTable &restrict table)
+{
+    const uint32_t alphaMask = table.alphaMask;
+    const uint32_t shift0 = table.shift[0];
+    const uint32_t shift1 = table.shift[1];
+    const uint32_t shift2 = table.shift[2];
+
+    for (const uint32_t *const p_end = pixels + CAST_SIZE(bufSize);
+         pixels != p_end;
+         ++ pixels)
+    {
+        const uint32_t p = *pixels;
+        if ((p & alphaMask) == 0U)
+            continue;
+
+        const unsigned int color0 = (p >> shift0) & 255U;
+        const unsigned int color1 = (p >> shift1) & 255U;
+        const unsigned int color2 = (p >> shift2) & 255U;
+        const unsigned int cmax = std::max(color0, std::max(color1, color2));
+        if (cmax == 0)
+            continue;
+
+        // pure color have only channels equal to zero or to cmax
+        if ((color0 != 0 && color0 != cmax) ||
+            (color1 != 0 && color1 != cmax) ||
+            (color2 != 0 && color2 != cmax))
+        {
+            continue;
+        }
+
+        const unsigned int i = static_cast<int>(color0 != 0) |
+            (static_cast<int>(color1 != 0) << 1) |
+            (static_cast<int>(color2 != 0) << 2);
+
+        *pixels = (p & alphaMask) | table.colors[(i << 8) | cmax];
+    }
+}
+
+#ifdef SIMD_SUPPORTED
+
+__attribute__ ((target ("sse2")))
+void Dye::normalDyeSse2(uint32_t *restrict pixels,
+                        const int bufSize,
+                        const NormalDyeTable &restrict table)
+{
+    const uint32_t alphaMask = table.alphaMask;
+    const uint32_t shift0 = table.shift[0];
+    const uint32_t shift1 = table.shift[1];
+    const uint32_t shift2 = table.shift[2];
+    const int mod = bufSize % 4;
+    const int bufEnd = bufSize - mod;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i allBits = _mm_set1_epi32(-1);
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    const __m128i alphaMaskVec = _mm_set1_epi32(CAST_S32(alphaMask));
+    const __m128i colorMaskVec = _mm_set1_epi32(CAST_S32(~alphaMask));
+
+    for (int ptr = 0; ptr < bufEnd; ptr += 4)
+    {
+        const __m128i base = _mm_loadu_si128(reinterpret_cast<__m128i*>(
+            &pixels[ptr]));
+        const __m128i color = _mm_and_si128(base, colorMaskVec);
+
+        // max of color bytes in lowest byte of each pixel
+        __m128i cmax = _mm_max_epu8(color, _mm_srli_epi32(color, 8));
+        cmax = _mm_max_epu8(cmax, _mm_srli_epi32(cmax, 16));
+        cmax = _mm_and_si128(cmax, byteMask);
+
+        // cmax copied to all color bytes
+        __m128i cmaxAll = _mm_or_si128(cmax, _mm_slli_epi32(cmax, 8));
+        cmaxAll = _mm_or_si128(cmaxAll, _mm_slli_epi32(cmaxAll, 16));
+        cmaxAll = _mm_and_si128(cmaxAll, colorMaskVec);
+
+        // pure color have only channels equal to zero or to cmax
+        const __m128i channelOk = _mm_or_si128(
+            _mm_cmpeq_epi8(color, cmaxAll),
+            _mm_cmpeq_epi8(color, zero));
+        const __m128i pure = _mm_cmpeq_epi32(channelOk, allBits);
+        const __m128i skip = _mm_or_si128(
+            _mm_cmpeq_epi32(_mm_and_si128(base, alphaMaskVec), zero),
+            _mm_cmpeq_epi32(cmax, zero));
+        const int mask = _mm_movemask_epi8(_mm_andnot_si128(skip, pure));
+        if (mask == 0)
+            continue;
+
+        for (int f = 0; f < 4; f ++)
+        {
+            if ((mask & (1 << (f * 4))) == 0)
+                continue;
+            const uint32_t p = pixels[ptr + f];
+            const unsigned int color0 = (p >> shift0) & 255U;
+            const unsigned int color1 = (p >> shift1) & 255U;
+            const unsigned int color2 = (p >> shift2) & 255U;
+            const unsigned int cmax1 = std::max(color0,
+                std::max(color1, color2));
+            const unsigned int i = static_cast<int>(color0 != 0) |
+                (static_cast<int>(color1 != 0) << 1) |
+                (static_cast<int>(color2 != 0) << 2);
+            pixels[ptr + f] = (p & alphaMask) |
+                table.colors[(i << 8) | cmax1];
+        }
+    }
+
+    // complete end without simd
+    normalDyeDefault(pixels + CAST_SIZE(bufEnd), mod, table);
+}
+
+__attribute__ ((target ("avx2")))
+void Dye::normalDyeAvx2(uint32_t *restrict pixels,
+                        const int bufSize,
+                        const NormalDyeTable &restrict table)
+{
+    const uint32_t alphaMask = table.alphaMask;
+    const int mod = bufSize % 8;
+    const int bufEnd = bufSize - mod;
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i allBits = _mm256_set1_epi32(-1);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+    const __m256i alphaMaskVec = _mm256_set1_epi32(CAST_S32(alphaMask));
+    const __m256i colorMaskVec = _mm256_set1_epi32(CAST_S32(~alphaMask));
+    const __m128i shift0 = _mm_cvtsi32_si128(CAST_S32(table.shift[0]));
+    const __m128i shift1 = _mm_cvtsi32_si128(CAST_S32(table.shift[1]));
+    const __m128i shift2 = _mm_cvtsi32_si128(CAST_S32(table.shift[2]));
+    const int *const colors = reinterpret_cast<const int*>(table.colors);
+
+    for (int ptr = 0; ptr < bufEnd; ptr += 8)
+    {
+        const __m256i base = _mm256_loadu_si256(reinterpret_cast<__m256i*>(
+            &pixels[ptr]));
+        const __m256i color = _mm256_and_si256(base, colorMaskVec);
+
+        // max of color bytes in lowest byte of each pixel
+        __m256i cmax = _mm256_max_epu8(color, _mm256_srli_epi32(color, 8));
+        cmax = _mm256_max_epu8(cmax, _mm256_srli_epi32(cmax, 16));
+        cmax = _mm256_and_si256(cmax, byteMask);
+
+        // cmax copied to all color bytes
+        __m256i cmaxAll = _mm256_or_si256(cmax, _mm256_slli_epi32(cmax, 8));
+        cmaxAll = _mm256_or_si256(cmaxAll, _mm256_slli_epi32(cmaxAll, 16));
+        cmaxAll = _mm256_and_si256(cmaxAll, colorMaskVec);
+
+        // pure color have only channels equal to zero or to cmax
+        const __m256i zeroBytes = _mm256_cmpeq_epi8(color, zero);
+        const __m256i channelOk = _mm256_or_si256(
+            _mm256_cmpeq_epi8(color, cmaxAll),
+            zeroBytes);
+        const __m256i pure = _mm256_cmpeq_epi32(channelOk, allBits);
+        const __m256i skip = _mm256_or_si256(
+            _mm256_cmpeq_epi32(_mm256_and_si256(base, alphaMaskVec), zero),
+            _mm256_cmpeq_epi32(cmax, zero));
+        const __m256i lanes = _mm256_andnot_si256(skip, pure);
+        if (_mm256_testz_si256(lanes, lanes) != 0)
+            continue;
+
+        // palette index from non zero channels
+        const __m256i nonZero = _mm256_andnot_si256(zeroBytes, allBits);
+        __m256i index = _mm256_and_si256(
+            _mm256_srl_epi32(nonZero, shift0), one);
+        index = _mm256_or_si256(index, _mm256_slli_epi32(
+            _mm256_and_si256(_mm256_srl_epi32(nonZero, shift1), one), 1));
+        index = _mm256_or_si256(index, _mm256_slli_epi32(
+            _mm256_and_si256(_mm256_srl_epi32(nonZero, shift2), one), 2));
+        index = _mm256_or_si256(_mm256_slli_epi32(index, 8), cmax);
+
+        const __m256i newColor = _mm256_mask_i32gather_epi32(zero,
+            colors,
+            index,
+            lanes,
+            4);
+        const __m256i newPixel = _mm256_or_si256(
+            _mm256_and_si256(base, alphaMaskVec),
+            newColor);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&pixels[ptr]),
+            _mm256_blendv_epi8(base, newPixel, lanes));
+    }
+
+    // complete end without simd
+    normalDyeDefault(pixels + CAST_SIZE(bufEnd), mod, table);
+}
+
+#endif  // SIMD_SUPPORTED
@@ -72,6 +72,27 @@ Image *ImageHelper::load(SDL_RWops *const rw, Dye const &dye)
         return nullptr;
     }
 
+    SDL_Surface *const surf = dyeSurface(tmpImage, dye);
+    MSDL_FreeSurface(tmpImage);
+
+    if (surf == nullptr)
+    {
+        BLOCK_END("ImageHelper::load")
+        return nullptr;
+    }
+
+    Image *const image = loadSurface(surf);
+    MSDL_FreeSurface(surf);
+    BLOCK_END("ImageHelper::load")
+    return image;
+}
+
+SDL_Surface *ImageHelper::dyeSurface(SDL_Surface *const tmpImage,
+                                     Dye const &dye)
+{
+    if (tmpImage == nullptr)
+        return nullptr;
+
     SDL_PixelFormat rgba;
     rgba.palette = nullptr;
     rgba.BitsPerPixel = 32;
@@ -92,7 +113,6 @@ Image *ImageHelper::load(SDL_RWops *const rw, Dye const &dye)
 
     SDL_Surface *const surf = MSDL_ConvertSurface(
         tmpImage, &rgba, SDL_SWSURFACE);
-    MSDL_FreeSurface(tmpImage);
 
     if (surf == nullptr)
         return nullptr;
@@ -123,11 +143,7 @@ Image *ImageHelper::load(SDL_RWops *const rw, Dye const &dye)
             break;
         }
     }
-
-    Image *const image = loadSurface(surf);
-    MSDL_FreeSurface(surf);
-    BLOCK_END("ImageHelper::load")
-    return image;
+    return surf;
 }
 
 SDL_Surface* ImageHelper::convertTo32Bit(SDL_Surface *const tmpImage)
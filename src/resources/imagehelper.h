@@ -92,6 +92,12 @@ class ImageHelper notfinal
         static SDL_Surface *convertTo32Bit(SDL_Surface *const tmpImage)
                                            A_WARN_UNUSED;
 
+        /**
+         * Converts surface to 32 bit rgba and applies dye to it.
+         */
+        static SDL_Surface *dyeSurface(SDL_Surface *const tmpImage,
+                                       Dye const &dye) A_WARN_UNUSED;
+
         static void dumpSurfaceFormat(const SDL_Surface *const image);
 
         constexpr2 static void setEnableAlpha(const bool n) noexcept2
@@ -43,6 +43,7 @@ ItemInfo::ItemInfo() :
     mDisplay(),
     mMissile(),
     mName(),
+    mNameLower(),
     mNameEn(),
     mDescription(),
     mEffect(),
@@ -254,6 +255,13 @@ const std::string ItemInfo::getDescription(const ItemColor color) const
     return replaceColors(mDescription, color);
 }
 
+void ItemInfo::setName(const std::string &name)
+{
+    mName = name;
+    mNameLower = name;
+    toLower(mNameLower);
+}
+
 const std::string ItemInfo::getName(const ItemColor color) const
 {
     return replaceColors(mName, color);
@@ -67,12 +67,17 @@ class ItemInfo final
         int getId() const noexcept2 A_WARN_UNUSED
         { return mId; }
 
-        void setName(const std::string &name) noexcept2
-        { mName = name; }
+        void setName(const std::string &name);
 
         const std::string &getName() const noexcept2 A_WARN_UNUSED
         { return mName; }
 
+        /**
+         * Lower case name precomputed for name filters.
+         */
+        const std::string &getNameLower() const noexcept2 A_WARN_UNUSED
+        { return mNameLower; }
+
         const std::string getName(const ItemColor color)
                                   const A_WARN_UNUSED;
 
@@ -342,6 +347,7 @@ class ItemInfo final
         SpriteDisplay mDisplay;     /**< Display info (like icon) */
         MissileInfo mMissile;
         std::string mName;
+        std::string mNameLower;
         std::string mNameEn;
         std::string mDescription;   /**< Short description. */
         std::string mEffect;        /**< Description of effects. */
@@ -39,6 +39,7 @@ struct WalkLayerLoader final
 
     const std::string name;
     const Map *const map;
+    const int *const cachedData;
 
     static Resource *load(const void *const v)
     {
@@ -47,7 +48,8 @@ struct WalkLayerLoader final
 
         const WalkLayerLoader *const rl = static_cast<const
             WalkLayerLoader *>(v);
-        Resource *const resource = NavigationManager::loadWalkLayer(rl->map);
+        Resource *const resource = NavigationManager::loadWalkLayer(rl->map,
+            rl->cachedData);
         if (resource == nullptr)
             reportAlways("WalkLayer creation error")
         return resource;
@@ -55,16 +57,18 @@ struct WalkLayerLoader final
 };
 
 WalkLayer *Loader::getWalkLayer(const std::string &name,
-                                Map *const map)
+                                Map *const map,
+                                const int *const cachedData)
 {
-    WalkLayerLoader rl = {name, map};
+    WalkLayerLoader rl = {name, map, cachedData};
     return static_cast<WalkLayer*>(ResourceManager::get("walklayer_" + name,
         WalkLayerLoader::load, &rl));
 }
 #else  // DYECMD
 
 WalkLayer *Loader::getWalkLayer(const std::string &name A_UNUSED,
-                                Map *const map A_UNUSED)
+                                Map *const map A_UNUSED,
+                                const int *const cachedData A_UNUSED)
 {
     return nullptr;
 }
@@ -33,7 +33,8 @@ class WalkLayer;
 namespace Loader
 {
     WalkLayer *getWalkLayer(const std::string &name,
-                            Map *const map) A_WARN_UNUSED;
+                            Map *const map,
+                            const int *const cachedData) A_WARN_UNUSED;
 }  // namespace Loader
 
 #endif  // RESOURCES_LOADERS_WALKLAYERLOADER_H
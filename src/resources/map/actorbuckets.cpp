@@ -0,0 +1,218 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/actorbuckets.h"
+
+#include "const/resources/map/map.h"
+
+#include "resources/map/blockmaskplanes.h"
+
+#include "utils/cast.h"
+#include "utils/foreach.h"
+
+#include <algorithm>
+
+#include "debug.h"
+
+namespace
+{
+    // extra space around sprite for cursors, hp bars and sprite offsets
+    const int cullMargin = mapTileSize * 2;
+
+    class SortPixelYFunctor final
+    {
+        public:
+            SortPixelYFunctor()
+            {
+            }
+
+            A_DEFAULT_COPY(SortPixelYFunctor)
+
+            bool operator() (const Actor *const actor1,
+                             const Actor *const actor2) const
+            {
+                return actor1->getSortPixelY() < actor2->getSortPixelY();
+            }
+    };
+}  // namespace
+
+ActorBuckets::ActorBuckets() :
+    mActors(),
+    mTempActors(),
+    mTempKeys(),
+    mCounts(),
+    mOccluders(nullptr),
+    mOccludersStride(0),
+    mOccludersWidth(0),
+    mOccludersHeight(0),
+    mViewX(0),
+    mViewY(0),
+    mViewWidth(0),
+    mViewHeight(0),
+    mMinY(0),
+    mMaxY(-1)
+{
+}
+
+void ActorBuckets::setView(const int x,
+                           const int y,
+                           const int width,
+                           const int height) noexcept2
+{
+    mViewX = x;
+    mViewY = y;
+    mViewWidth = width;
+    mViewHeight = height;
+}
+
+void ActorBuckets::setOccluders(const uint64_t *const rows,
+                                const int stride,
+                                const int width,
+                                const int height) noexcept2
+{
+    mOccluders = rows;
+    mOccludersStride = stride;
+    mOccludersWidth = width;
+    mOccludersHeight = height;
+}
+
+bool ActorBuckets::isHidden(const Actor *const actor) const
+{
+    const int width = actor->getWidth();
+    // size unknown, particles and other effects
+    if (width <= 0)
+        return false;
+
+    const int x = actor->getPixelX();
+    const int y = actor->getPixelY();
+    const int x1 = x - width / 2 - cullMargin;
+    const int x2 = x + width / 2 + cullMargin;
+    const int y1 = y - actor->getHeight() - cullMargin;
+    const int y2 = y + cullMargin;
+    if (x2 < mViewX ||
+        x1 >= mViewX + mViewWidth ||
+        y2 < mViewY ||
+        y1 >= mViewY + mViewHeight)
+    {
+        return true;
+    }
+
+    if (mOccluders == nullptr || x1 < 0 || y1 < 0)
+        return false;
+    const int tileX1 = x1 / mapTileSize;
+    const int tileY1 = y1 / mapTileSize;
+    const int tileX2 = x2 / mapTileSize;
+    const int tileY2 = y2 / mapTileSize;
+    if (tileX2 >= mOccludersWidth || tileY2 >= mOccludersHeight)
+        return false;
+    for (int tileY = tileY1; tileY <= tileY2; tileY ++)
+    {
+        if (BlockMaskPlanes::findBit(mOccluders + tileY * mOccludersStride,
+            tileX1, tileX2 + 1, false) <= tileX2)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ActorBuckets::build(const Actors &actors,
+                         const int minY,
+                         const int maxY)
+{
+    mMinY = minY;
+    mMaxY = maxY;
+    mActors.clear();
+    mTempActors.clear();
+    mTempKeys.clear();
+    if (maxY < minY)
+        return;
+
+    const size_t range = CAST_SIZE(maxY - minY + 1);
+    mCounts.assign(range + 1, 0U);
+    bool clampedMin = false;
+    bool clampedMax = false;
+    FOR_EACH (ActorsCIter, it, actors)
+    {
+        Actor *const actor = *it;
+        if (actor == nullptr || isHidden(actor))
+            continue;
+        int key = actor->getSortPixelY();
+        if (key < minY)
+        {
+            key = minY;
+            clampedMin = true;
+        }
+        else if (key > maxY)
+        {
+            key = maxY;
+            clampedMax = true;
+        }
+        key -= minY;
+        mTempActors.push_back(actor);
+        mTempKeys.push_back(key);
+        mCounts[CAST_SIZE(key) + 1] ++;
+    }
+
+    // counting sort, stable for equal keys
+    for (size_t f = 1; f <= range; f ++)
+        mCounts[f] += mCounts[f - 1];
+    const size_t sz = mTempActors.size();
+    mActors.resize(sz);
+    for (size_t f = 0; f < sz; f ++)
+    {
+        size_t &pos = mCounts[CAST_SIZE(mTempKeys[f])];
+        mActors[pos] = mTempActors[f];
+        pos ++;
+    }
+    // now mCounts[key] is count of actors with keys <= key
+
+    // clamped actors must keep order by real sort y in edge buckets
+    if (clampedMin)
+    {
+        std::stable_sort(mActors.begin(),
+            mActors.begin() + mCounts[0],
+            SortPixelYFunctor());
+    }
+    if (clampedMax)
+    {
+        const size_t start = range > 1 ? mCounts[range - 2] : 0U;
+        std::stable_sort(mActors.begin() + start,
+            mActors.end(),
+            SortPixelYFunctor());
+    }
+}
+
+size_t ActorBuckets::getCountBefore(const int y) const
+{
+    if (y < mMinY)
+        return 0U;
+    if (y >= mMaxY)
+        return mActors.size();
+    return mCounts[CAST_SIZE(y - mMinY)];
+}
+
+int ActorBuckets::calcMemory() const
+{
+    return CAST_S32(sizeof(ActorBuckets) +
+        (mActors.capacity() + mTempActors.capacity()) * sizeof(Actor*) +
+        mTempKeys.capacity() * sizeof(int) +
+        mCounts.capacity() * sizeof(size_t));
+}
@@ -0,0 +1,94 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_ACTORBUCKETS_H
+#define RESOURCES_MAP_ACTORBUCKETS_H
+
+#include "being/actor.h"
+
+#include "utils/vector.h"
+
+#include "localconsts.h"
+
+/**
+ * Actors for map draw, sorted by sort pixel y with counting sort.
+ * Actors outside of view or covered by opaque tiles skipped.
+ */
+class ActorBuckets final
+{
+    public:
+        ActorBuckets();
+
+        A_DELETE_COPY(ActorBuckets)
+
+        /**
+         * Sets view rect in map pixels for culling.
+         */
+        void setView(const int x,
+                     const int y,
+                     const int width,
+                     const int height) noexcept2;
+
+        /**
+         * Sets bit rows of opaque tiles or nullptr for disable occlusion.
+         */
+        void setOccluders(const uint64_t *const rows,
+                          const int stride,
+                          const int width,
+                          const int height) noexcept2;
+
+        /**
+         * Sorts visible actors. Sort pixel y outside of [minY, maxY]
+         * clamped to this range.
+         */
+        void build(const Actors &actors,
+                   const int minY,
+                   const int maxY);
+
+        const STD_VECTOR<Actor*> &getActors() const noexcept2 A_WARN_UNUSED
+        { return mActors; }
+
+        /**
+         * Returns count of actors with sort pixel y <= y.
+         */
+        size_t getCountBefore(const int y) const A_WARN_UNUSED;
+
+        bool isHidden(const Actor *const actor) const A_WARN_UNUSED;
+
+        int calcMemory() const A_WARN_UNUSED;
+
+    private:
+        STD_VECTOR<Actor*> mActors;
+        STD_VECTOR<Actor*> mTempActors;
+        STD_VECTOR<int> mTempKeys;
+        STD_VECTOR<size_t> mCounts;
+        const uint64_t *mOccluders;
+        int mOccludersStride;
+        int mOccludersWidth;
+        int mOccludersHeight;
+        int mViewX;
+        int mViewY;
+        int mViewWidth;
+        int mViewHeight;
+        int mMinY;
+        int mMaxY;
+};
+
+#endif  // RESOURCES_MAP_ACTORBUCKETS_H
@@ -0,0 +1,475 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/blockmaskplanes.h"
+
+#include "utils/cast.h"
+#include "utils/cpu.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef SIMD_SUPPORTED
+// avx2
+#include <immintrin.h>
+#endif  // SIMD_SUPPORTED
+
+#include "debug.h"
+
+namespace
+{
+    typedef void (*OrWordsFunctionPtr)(uint64_t *restrict const dst,
+                                       const uint64_t *restrict const src,
+                                       const size_t count);
+
+    typedef bool (*AnyWordsFunctionPtr)(const uint64_t *restrict const src,
+                                        const size_t count);
+
+    void orWords(uint64_t *restrict const dst,
+                 const uint64_t *restrict const src,
+                 const size_t count)
+    {
+        for (size_t f = 0; f < count; f ++)
+            dst[f] |= src[f];
+    }
+
+#ifdef SIMD_SUPPORTED
+    __attribute__ ((target ("avx2")))
+    void orWordsAvx2(uint64_t *restrict const dst,
+                     const uint64_t *restrict const src,
+                     const size_t count)
+    {
+        size_t f = 0;
+        for (; f + 4 <= count; f += 4)
+        {
+            __m256i *const ptr = reinterpret_cast<__m256i*>(dst + f);
+            const __m256i val = _mm256_or_si256(
+                _mm256_loadu_si256(ptr),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                src + f)));
+            _mm256_storeu_si256(ptr, val);
+        }
+        for (; f < count; f ++)
+            dst[f] |= src[f];
+    }
+
+#endif  // SIMD_SUPPORTED
+
+    OrWordsFunctionPtr funcOrWords = &orWords;
+    AnyWordsFunctionPtr funcAnyWords = &BlockMaskPlanes::anyWordsDefault;
+
+    const uint64_t allBits = ~static_cast<uint64_t>(0U);
+
+    struct Cell final
+    {
+        Cell(const int x0, const int y0) :
+            x(x0),
+            y(y0)
+        {
+        }
+
+        A_DEFAULT_COPY(Cell)
+
+        int x;
+        int y;
+    };
+
+    void fillArea(int x, int y,
+                  const int width,
+                  const int height,
+                  const int num,
+                  const uint64_t *restrict const blocked,
+                  const int stride,
+                  int *restrict const data)
+    {
+        // scanline fill, walkable spans found by bit scan in blocked rows.
+        // padding bits after width always set in blocked rows.
+        STD_VECTOR<Cell> cells;
+        cells.push_back(Cell(x, y));
+        while (!cells.empty())
+        {
+            const Cell cell = cells.back();
+            cells.pop_back();
+            x = cell.x;
+            y = cell.y;
+            int *const dataRow = data + width * y;
+            if (dataRow[x] != 0)
+                continue;
+
+            const uint64_t *const row = blocked + stride * y;
+            const int x1 = BlockMaskPlanes::findBitBack(row, x, true) + 1;
+            const int x2 = BlockMaskPlanes::findBit(row, x, width, true);
+            for (int f = x1; f < x2; f ++)
+                dataRow[f] = num;
+            if (x1 > 0 && dataRow[x1 - 1] == 0)
+                dataRow[x1 - 1] = -num;
+            if (x2 < width && dataRow[x2] == 0)
+                dataRow[x2] = -num;
+
+            for (int y2 = y - 1; y2 <= y + 1; y2 += 2)
+            {
+                if (y2 < 0 || y2 >= height)
+                    continue;
+                const uint64_t *const row2 = blocked + stride * y2;
+                int *const dataRow2 = data + width * y2;
+                bool inSpan = false;
+                for (int f = x1; f < x2; f ++)
+                {
+                    if (dataRow2[f] != 0)
+                    {
+                        inSpan = false;
+                        continue;
+                    }
+                    if ((row2[f >> 6] & (static_cast<uint64_t>(1U) <<
+                        (f & 63))) != 0U)
+                    {
+                        dataRow2[f] = -num;
+                        inSpan = false;
+                    }
+                    else if (!inSpan)
+                    {
+                        cells.push_back(Cell(f, y2));
+                        inSpan = true;
+                    }
+                }
+            }
+        }
+    }
+}  // namespace
+
+BlockMaskPlanes::BlockMaskPlanes(const int width,
+                                 const int height) :
+    mData(),
+    mPlaneSize(0),
+    mWidth(width),
+    mHeight(height),
+    mStride((width + 63) / 64)
+{
+    mPlaneSize = CAST_SIZE(mStride) * CAST_SIZE(mHeight);
+    mData.resize(planesCount * mPlaneSize, 0U);
+}
+
+void BlockMaskPlanes::initFunctions()
+{
+#ifdef SIMD_SUPPORTED
+    if ((Cpu::getFlags() & Cpu::FEATURE_AVX2) != 0U)
+    {
+        funcOrWords = &orWordsAvx2;
+        funcAnyWords = &BlockMaskPlanes::anyWordsAvx2;
+        return;
+    }
+#endif  // SIMD_SUPPORTED
+    funcOrWords = &orWords;
+    funcAnyWords = &BlockMaskPlanes::anyWordsDefault;
+}
+
+bool BlockMaskPlanes::anyWordsDefault(const uint64_t *restrict const src,
+                                      const size_t count)
+{
+    for (size_t f = 0; f < count; f ++)
+    {
+        if (src[f] != 0U)
+            return true;
+    }
+    return false;
+}
+
+#ifdef SIMD_SUPPORTED
+__attribute__ ((target ("avx2")))
+bool BlockMaskPlanes::anyWordsAvx2(const uint64_t *restrict const src,
+                                   const size_t count)
+{
+    size_t f = 0;
+    for (; f + 4 <= count; f += 4)
+    {
+        const __m256i val = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(src + f));
+        if (_mm256_testz_si256(val, val) == 0)
+            return true;
+    }
+    for (; f < count; f ++)
+    {
+        if (src[f] != 0U)
+            return true;
+    }
+    return false;
+}
+#endif  // SIMD_SUPPORTED
+
+void BlockMaskPlanes::addMask(const int x,
+                              const int y,
+                              const unsigned char mask)
+{
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+        return;
+    const size_t idx = CAST_SIZE(y * mStride + (x >> 6));
+    const uint64_t bit = static_cast<uint64_t>(1U) << (x & 63);
+    for (int plane = 0; plane < planesCount; plane ++)
+    {
+        if ((mask & (1U << plane)) != 0U)
+            mData[plane * mPlaneSize + idx] |= bit;
+    }
+}
+
+void BlockMaskPlanes::setMask(const int x,
+                              const int y,
+                              const unsigned char mask)
+{
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+        return;
+    const size_t idx = CAST_SIZE(y * mStride + (x >> 6));
+    const uint64_t bit = static_cast<uint64_t>(1U) << (x & 63);
+    for (int plane = 0; plane < planesCount; plane ++)
+    {
+        if ((mask & (1U << plane)) != 0U)
+            mData[plane * mPlaneSize + idx] |= bit;
+        else
+            mData[plane * mPlaneSize + idx] &= ~bit;
+    }
+}
+
+void BlockMaskPlanes::setMasks(const unsigned char *restrict const masks)
+{
+    mData.assign(mData.size(), 0U);
+    for (int y = 0; y < mHeight; y ++)
+    {
+        const unsigned char *restrict const row = masks + y * mWidth;
+        for (int x = 0; x < mWidth; x ++)
+        {
+            if (row[x] != 0U)
+                addMask(x, y, row[x]);
+        }
+    }
+}
+
+bool BlockMaskPlanes::isBlocked(const int x,
+                                const int y,
+                                const unsigned char mask) const
+{
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+        return true;
+    const size_t idx = CAST_SIZE(y * mStride + (x >> 6));
+    const uint64_t bit = static_cast<uint64_t>(1U) << (x & 63);
+    for (int plane = 0; plane < planesCount; plane ++)
+    {
+        if ((mask & (1U << plane)) != 0U &&
+            (mData[plane * mPlaneSize + idx] & bit) != 0U)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BlockMaskPlanes::anyBlocked(int x1, int y1,
+                                 int x2, int y2,
+                                 const unsigned char mask) const
+{
+    if (x1 > x2)
+        std::swap(x1, x2);
+    if (y1 > y2)
+        std::swap(y1, y2);
+    if (x1 < 0 || y1 < 0 || x2 >= mWidth || y2 >= mHeight)
+        return true;
+
+    const int w1 = x1 >> 6;
+    const int w2 = x2 >> 6;
+    const uint64_t firstMask = allBits << (x1 & 63);
+    const uint64_t lastMask = allBits >> (63 - (x2 & 63));
+    const size_t inner = w2 > w1 ? CAST_SIZE(w2 - w1 - 1) : 0U;
+    for (int plane = 0; plane < planesCount; plane ++)
+    {
+        if ((mask & (1U << plane)) == 0U)
+            continue;
+        const uint64_t *restrict row = &mData[plane * mPlaneSize +
+            CAST_SIZE(y1 * mStride)];
+        for (int y = y1; y <= y2; y ++, row += mStride)
+        {
+            if (w1 == w2)
+            {
+                if ((row[w1] & firstMask & lastMask) != 0U)
+                    return true;
+                continue;
+            }
+            if ((row[w1] & firstMask) != 0U ||
+                (row[w2] & lastMask) != 0U)
+            {
+                return true;
+            }
+            if (inner != 0U && funcAnyWords(row + w1 + 1, inner))
+                return true;
+        }
+    }
+    return false;
+}
+
+bool BlockMaskPlanes::lineOfSight(const int x1, const int y1,
+                                  const int x2, const int y2,
+                                  const unsigned char mask) const
+{
+    if (x1 < 0 || y1 < 0 || x1 >= mWidth || y1 >= mHeight ||
+        x2 < 0 || y2 < 0 || x2 >= mWidth || y2 >= mHeight)
+    {
+        return false;
+    }
+
+    const int dx = abs(x2 - x1);
+    const int dy = -abs(y2 - y1);
+    // straight lines checked as rect
+    if (dy == 0)
+    {
+        if (dx < 2)
+            return true;
+        return !anyBlocked(std::min(x1, x2) + 1, y1,
+            std::max(x1, x2) - 1, y1, mask);
+    }
+    if (dx == 0)
+    {
+        if (dy > -2)
+            return true;
+        return !anyBlocked(x1, std::min(y1, y2) + 1,
+            x1, std::max(y1, y2) - 1, mask);
+    }
+
+    const int sx = x1 < x2 ? 1 : -1;
+    const int sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy;
+    int x = x1;
+    int y = y1;
+    for (;;)
+    {
+        const int e2 = 2 * err;
+        const bool stepX = e2 >= dy;
+        const bool stepY = e2 <= dx;
+        // diagonal step can not cut corners
+        if (stepX && stepY &&
+            (isBlocked(x + sx, y, mask) || isBlocked(x, y + sy, mask)))
+        {
+            return false;
+        }
+        if (stepX)
+        {
+            err += dy;
+            x += sx;
+        }
+        if (stepY)
+        {
+            err += dx;
+            y += sy;
+        }
+        if (x == x2 && y == y2)
+            return true;
+        if (isBlocked(x, y, mask))
+            return false;
+    }
+}
+
+void BlockMaskPlanes::combineRows(const unsigned char mask,
+                                  STD_VECTOR<uint64_t> &rows) const
+{
+    rows.assign(mPlaneSize, 0U);
+    if (mPlaneSize == 0U)
+        return;
+    for (int plane = 0; plane < planesCount; plane ++)
+    {
+        if ((mask & (1U << plane)) != 0U)
+            funcOrWords(&rows[0], &mData[plane * mPlaneSize], mPlaneSize);
+    }
+    const int tail = mWidth & 63;
+    if (tail != 0)
+    {
+        const uint64_t padding = allBits << tail;
+        for (int y = 0; y < mHeight; y ++)
+            rows[CAST_SIZE(y * mStride + mStride - 1)] |= padding;
+    }
+}
+
+const uint64_t *BlockMaskPlanes::getRow(const unsigned char bit,
+                                        const int y) const
+{
+    const int plane = __builtin_ctz(CAST_U32(bit));
+    return &mData[CAST_SIZE(plane) * mPlaneSize + CAST_SIZE(y * mStride)];
+}
+
+int BlockMaskPlanes::findBit(const uint64_t *restrict const row,
+                             int x,
+                             const int end,
+                             const bool value)
+{
+    while (x < end)
+    {
+        const int w = x >> 6;
+        const uint64_t bits = (value ? row[w] : ~row[w]) &
+            (allBits << (x & 63));
+        if (bits != 0U)
+        {
+            const int pos = (w << 6) + __builtin_ctzll(bits);
+            return pos < end ? pos : end;
+        }
+        x = (w + 1) << 6;
+    }
+    return end;
+}
+
+int BlockMaskPlanes::findBitBack(const uint64_t *restrict const row,
+                                 int x,
+                                 const bool value)
+{
+    while (x >= 0)
+    {
+        const int w = x >> 6;
+        const uint64_t bits = (value ? row[w] : ~row[w]) &
+            (allBits >> (63 - (x & 63)));
+        if (bits != 0U)
+            return (w << 6) + 63 - __builtin_clzll(bits);
+        x = (w << 6) - 1;
+    }
+    return -1;
+}
+
+void BlockMaskPlanes::fillAreas(const uint64_t *restrict const rows,
+                                const int width,
+                                const int height,
+                                int *restrict const data)
+{
+    const int stride = (width + 63) / 64;
+    int num = 1;
+    for (int y = 0; y < height; y ++)
+    {
+        const uint64_t *const row = rows + stride * y;
+        const int *const dataRow = data + width * y;
+        int x = findBit(row, 0, width, false);
+        while (x < width)
+        {
+            if (dataRow[x] == 0)
+            {
+                fillArea(x, y, width, height, num, rows, stride, data);
+                num ++;
+            }
+            x = findBit(row, x + 1, width, false);
+        }
+    }
+}
+
+int BlockMaskPlanes::calcMemory() const
+{
+    return CAST_S32(sizeof(BlockMaskPlanes) +
+        mData.capacity() * sizeof(uint64_t));
+}
@@ -0,0 +1,148 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_BLOCKMASKPLANES_H
+#define RESOURCES_MAP_BLOCKMASKPLANES_H
+
+#include "utils/vector.h"
+
+#include "localconsts.h"
+
+/**
+ * Packed bitplanes for map blockmasks.
+ * Each BlockMask bit stored in own plane, one bit per tile,
+ * rows padded to 64 bit words.
+ */
+class BlockMaskPlanes final
+{
+    public:
+        BlockMaskPlanes(const int width,
+                        const int height);
+
+        A_DELETE_COPY(BlockMaskPlanes)
+
+        static void initFunctions();
+
+        void addMask(const int x,
+                     const int y,
+                     const unsigned char mask);
+
+        void setMask(const int x,
+                     const int y,
+                     const unsigned char mask);
+
+        /**
+         * Replaces masks of all tiles.
+         */
+        void setMasks(const unsigned char *restrict const masks);
+
+        bool isBlocked(const int x,
+                       const int y,
+                       const unsigned char mask) const A_WARN_UNUSED;
+
+        /**
+         * Combines planes from mask in rows, one row per map row.
+         * Padding bits after map width set as blocked.
+         */
+        void combineRows(const unsigned char mask,
+                         STD_VECTOR<uint64_t> &rows) const;
+
+        /**
+         * Returns row of plane for single BlockMask bit.
+         */
+        const uint64_t *getRow(const unsigned char bit,
+                               const int y) const A_WARN_UNUSED;
+
+        /**
+         * Returns true if any tile in rect blocked or rect not in map.
+         */
+        bool anyBlocked(int x1, int y1,
+                        int x2, int y2,
+                        const unsigned char mask) const A_WARN_UNUSED;
+
+        /**
+         * Returns true if no tiles between points blocked.
+         * Start and end tiles itself not checked.
+         * Diagonal steps need both corner tiles not blocked, same as in
+         * path finding.
+         */
+        bool lineOfSight(const int x1, const int y1,
+                         const int x2, const int y2,
+                         const unsigned char mask) const A_WARN_UNUSED;
+
+        int getStride() const noexcept2 A_WARN_UNUSED
+        { return mStride; }
+
+        int calcMemory() const A_WARN_UNUSED;
+
+        /**
+         * Returns position of first bit with given value in [x, end)
+         * or end if not found.
+         */
+        static int findBit(const uint64_t *restrict const row,
+                           int x,
+                           const int end,
+                           const bool value) A_WARN_UNUSED;
+
+        /**
+         * Returns position of last bit with given value in [0, x]
+         * or -1 if not found.
+         */
+        static int findBitBack(const uint64_t *restrict const row,
+                               int x,
+                               const bool value) A_WARN_UNUSED;
+
+        /**
+         * Numbers connected areas of not blocked tiles in rows from
+         * combineRows. Area tiles get numbers from 1, blocked tiles
+         * next to area get negative area number, other tiles 0.
+         * Data must be zero filled.
+         */
+        static void fillAreas(const uint64_t *restrict const rows,
+                              const int width,
+                              const int height,
+                              int *restrict const data) A_NONNULL(1, 4);
+
+        /**
+         * Returns true if any word not zero.
+         */
+        static bool anyWordsDefault(const uint64_t *restrict const src,
+                                    const size_t count) A_WARN_UNUSED;
+
+#ifdef SIMD_SUPPORTED
+        /**
+         * Returns true if any word not zero.
+         */
+        __attribute__ ((target ("avx2")))
+        static bool anyWordsAvx2(const uint64_t *restrict const src,
+                                 const size_t count) A_WARN_UNUSED;
+#endif  // SIMD_SUPPORTED
+
+    private:
+        static const int planesCount = 8;
+
+        STD_VECTOR<uint64_t> mData;
+        size_t mPlaneSize;
+        int mWidth;
+        int mHeight;
+        int mStride;
+};
+
+#endif  // RESOURCES_MAP_BLOCKMASKPLANES_H
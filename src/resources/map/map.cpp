@@ -50,14 +50,18 @@
 
 #include "resources/loaders/imageloader.h"
 
+#include "resources/map/actorbuckets.h"
+#include "resources/map/blockmaskplanes.h"
 #include "resources/map/location.h"
 #include "resources/map/mapheights.h"
 #include "resources/map/mapobjectlist.h"
 #include "resources/map/maplayer.h"
 #include "resources/map/mapitem.h"
+#include "resources/map/maptiletable.h"
 #include "resources/map/objectslayer.h"
 #include "resources/map/speciallayer.h"
 #include "resources/map/tileanimation.h"
+#include "resources/map/tileanimationwheel.h"
 #include "resources/map/tileset.h"
 #include "resources/map/walklayer.h"
 
@@ -73,26 +77,13 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <climits>
 #include <fstream>
 #include <queue>
 
 #include "debug.h"
 
-class ActorFunctuator final
-{
-    public:
-        A_DEFAULT_COPY(ActorFunctuator)
-
-        bool operator()(const Actor *const a,
-                        const Actor *const b) const
-        {
-            if ((a == nullptr) || (b == nullptr))
-                return false;
-            return a->getSortPixelY() < b->getSortPixelY();
-        }
-} actorCompare;
-
 Map::Map(const std::string &name,
          const int width,
          const int height,
@@ -103,12 +94,17 @@ Map::Map(const std::string &name,
     mTileWidth(tileWidth), mTileHeight(tileHeight),
     mMaxTileHeight(height),
     mMetaTiles(new MetaTile[mWidth * mHeight]),
+    mBlockPlanes(new BlockMaskPlanes(mWidth, mHeight)),
+    mTileTable(new MapTileTable),
+    mTileAnimationWheel(new TileAnimationWheel),
     mWalkLayer(nullptr),
     mLayers(),
     mDrawUnderLayers(),
     mDrawOverLayers(),
     mTilesets(),
     mActors(),
+    mActorBuckets(new ActorBuckets),
+    mOpaqueTiles(),
     mHasWarps(false),
     mDrawLayersFlags(MapType::NORMAL),
     mOnClosedList(1),
@@ -135,6 +131,7 @@ Map::Map(const std::string &name,
     mActorFixX(0),
     mActorFixY(0),
     mVersion(0),
+    mCacheHash(0),
     mSpecialLayer(new SpecialLayer("special layer", width, height)),
     mTempLayer(new SpecialLayer("temp layer", width, height)),
     mObjects(new ObjectsLayer(width, height)),
@@ -153,6 +150,7 @@ Map::Map(const std::string &name,
 #endif  // USE_OPENGL
     mHeights(nullptr),
     mRedrawMap(true),
+    mRedrawAnimatedRows(false),
     mBeingOpacity(false),
 #ifdef USE_OPENGL
     mCachedDraw(mOpenGL == RENDER_NORMAL_OPENGL ||
@@ -188,9 +186,13 @@ Map::~Map()
     }
     mFringeLayer = nullptr;
     delete_all(mLayers);
+    delete2(mTileTable)
+    delete2(mBlockPlanes)
+    delete2(mActorBuckets)
     delete_all(mTilesets);
     delete_all(mForegrounds);
     delete_all(mBackgrounds);
+    delete2(mTileAnimationWheel)
     delete_all(mTileAnimations);
     delete2(mSpecialLayer)
     delete2(mTempLayer)
@@ -326,13 +328,9 @@ void Map::addTileset(Tileset *const tileset) restrict2
 
 void Map::update(const int ticks) restrict2
 {
-    // Update animated tiles
-    FOR_EACH (TileAnimationMapCIter, iAni, mTileAnimations)
-    {
-        TileAnimation *restrict const tileAni = iAni->second;
-        if ((tileAni != nullptr) && tileAni->update(ticks))
-            mRedrawMap = true;
-    }
+    // Update animated tiles with changed frames
+    if (mTileAnimationWheel->update(ticks))
+        mRedrawAnimatedRows = true;
 }
 
 void Map::draw(Graphics *restrict const graphics,
@@ -357,7 +355,23 @@ void Map::draw(Graphics *restrict const graphics,
     // Make sure actors are sorted ascending by Y-coordinate
     // so that they overlap correctly
     BLOCK_START("Map::draw sort")
-    mActors.sort(actorCompare);
+    mActorBuckets->setView(scrollX, scrollY,
+        graphics->mWidth, graphics->mHeight);
+    // with being opacity hidden actors still drawn over layers
+    if (mOpaqueTiles.empty() || mBeingOpacity)
+    {
+        mActorBuckets->setOccluders(nullptr, 0, 0, 0);
+    }
+    else
+    {
+        mActorBuckets->setOccluders(&mOpaqueTiles[0],
+            mBlockPlanes->getStride(),
+            mWidth,
+            mHeight);
+    }
+    mActorBuckets->build(mActors,
+        (startY + mActorFixY - 1) * mapTileSize,
+        (endY + mActorFixY + 1) * mapTileSize);
     BLOCK_END("Map::draw sort")
 
     // update scrolling of all ambient layers
@@ -402,6 +416,11 @@ void Map::draw(Graphics *restrict const graphics,
             mDrawScrollY = scrollY;
             updateFlag = 1;
         }
+        else if (mRedrawAnimatedRows)
+        {   // only animated tiles changed
+            updateFlag = 3;
+        }
+        mRedrawAnimatedRows = false;
     }
 #endif  // USE_OPENGL
 
@@ -415,7 +434,7 @@ void Map::draw(Graphics *restrict const graphics,
                 startX, startY,
                 endX, endY,
                 scrollX, scrollY,
-                mActors);
+                *mActorBuckets);
         }
     }
     else
@@ -423,7 +442,14 @@ void Map::draw(Graphics *restrict const graphics,
 #ifdef USE_OPENGL
         if (mCachedDraw)
         {
-            if (updateFlag != 0)
+            if (updateFlag == 3)
+            {
+                FOR_EACH (Layers::iterator, it, mDrawUnderLayers)
+                    (*it)->updateOGLRows(graphics);
+                FOR_EACH (Layers::iterator, it, mDrawOverLayers)
+                    (*it)->updateOGLRows(graphics);
+            }
+            else if (updateFlag != 0)
             {
                 FOR_EACH (Layers::iterator, it, mDrawUnderLayers)
                 {
@@ -452,7 +478,7 @@ void Map::draw(Graphics *restrict const graphics,
                     startX, startY,
                     endX, endY,
                     scrollX, scrollY,
-                    mActors);
+                    *mActorBuckets);
             }
 
             FOR_EACH (Layers::iterator, it, mDrawOverLayers)
@@ -477,7 +503,7 @@ void Map::draw(Graphics *restrict const graphics,
                     startX, startY,
                     endX, endY,
                     scrollX, scrollY,
-                    mActors);
+                    *mActorBuckets);
             }
 
             FOR_EACH (Layers::iterator, it, mDrawOverLayers)
@@ -494,8 +520,9 @@ void Map::draw(Graphics *restrict const graphics,
     {
         // Draws beings with a lower opacity to make them visible
         // even when covered by a wall or some other elements...
-        ActorsCIter ai = mActors.begin();
-        const ActorsCIter ai_end = mActors.end();
+        const STD_VECTOR<Actor*> &actors = mActorBuckets->getActors();
+        STD_VECTOR<Actor*>::const_iterator ai = actors.begin();
+        const STD_VECTOR<Actor*>::const_iterator ai_end = actors.end();
 
         if (mOpenGL == RENDER_SOFTWARE)
         {
@@ -542,28 +569,28 @@ void Map::draw(Graphics *restrict const graphics,
     BLOCK_END("Map::draw")
 }
 
-#define fillCollision(collision, color) \
-    if (x < endX && mMetaTiles[tilePtr].blockmask & (collision))\
-    {\
-        width = mapTileSize;\
-        for (int x2 = tilePtr + 1; x < endX; x2 ++)\
-        {\
-            if (!(mMetaTiles[x2].blockmask & (collision)))\
-                break;\
-            width += mapTileSize;\
-            x ++;\
-            tilePtr ++;\
-        }\
-        if (width && userPalette)\
-        {\
-            graphics->setColor(userPalette->getColorWithAlpha(\
-                UserColorId::color));\
-            graphics->fillRectangle(Rect(\
-                x0 * mTileWidth - scrollX, \
-                y * mTileHeight - scrollY, \
-                width, mapTileSize));\
-        }\
-    }\
+namespace
+{
+    const unsigned char collisionMasks[] =
+    {
+        BlockMask::WALL,
+        BlockMask::AIR,
+        BlockMask::WATER,
+        BlockMask::GROUNDTOP,
+        BlockMask::PLAYERWALL,
+        BlockMask::MONSTERWALL
+    };
+
+    const UserColorIdT collisionColors[] =
+    {
+        UserColorId::COLLISION_HIGHLIGHT,
+        UserColorId::AIR_COLLISION_HIGHLIGHT,
+        UserColorId::WATER_COLLISION_HIGHLIGHT,
+        UserColorId::GROUNDTOP_COLLISION_HIGHLIGHT,
+        UserColorId::COLLISION_HIGHLIGHT,
+        UserColorId::MONSTER_COLLISION_HIGHLIGHT
+    };
+}  // namespace
 
 void Map::drawCollision(Graphics *restrict const graphics,
                         const int scrollX,
@@ -596,21 +623,34 @@ void Map::drawCollision(Graphics *restrict const graphics,
             mapTileSize, mapTileSize);
     }
 
+    if (startX >= endX || userPalette == nullptr)
+        return;
+
+    // tile with several collision types drawn with all their colors
+    const size_t collisionsCount = sizeof(collisionMasks) /
+        sizeof(collisionMasks[0]);
     for (int y = startY; y < endY; y++)
     {
-        const int yWidth = y * mWidth;
-        int tilePtr = startX + yWidth;
-        for (int x = startX; x < endX; x++, tilePtr++)
+        const int pixelY = y * mTileHeight - scrollY;
+        for (size_t f = 0; f < collisionsCount; f ++)
         {
-            int width = 0;
-            const int x0 = x;
-
-            fillCollision(BlockMask::WALL, COLLISION_HIGHLIGHT)
-            fillCollision(BlockMask::AIR, AIR_COLLISION_HIGHLIGHT)
-            fillCollision(BlockMask::WATER, WATER_COLLISION_HIGHLIGHT)
-            fillCollision(BlockMask::GROUNDTOP, GROUNDTOP_COLLISION_HIGHLIGHT)
-            fillCollision(BlockMask::PLAYERWALL, COLLISION_HIGHLIGHT)
-            fillCollision(BlockMask::MONSTERWALL, MONSTER_COLLISION_HIGHLIGHT)
+            const uint64_t *restrict const row = mBlockPlanes->getRow(
+                collisionMasks[f], y);
+            int x = BlockMaskPlanes::findBit(row, startX, endX, true);
+            if (x == endX)
+                continue;
+            graphics->setColor(userPalette->getColorWithAlpha(
+                collisionColors[f]));
+            while (x < endX)
+            {
+                const int x2 = BlockMaskPlanes::findBit(row,
+                    x, endX, false);
+                graphics->fillRectangle(Rect(
+                    x * mTileWidth - scrollX,
+                    pixelY,
+                    (x2 - x) * mapTileSize, mapTileSize));
+                x = BlockMaskPlanes::findBit(row, x2, endX, true);
+            }
         }
     }
 }
@@ -740,6 +780,7 @@ void Map::addBlockMask(const int x, const int y,
             // Do nothing.
             break;
     }
+    mBlockPlanes->setMask(x, y, mMetaTiles[tileNum].blockmask);
 }
 
 void Map::setBlockMask(const int x, const int y,
@@ -779,6 +820,15 @@ void Map::setBlockMask(const int x, const int y,
             // Do nothing.
             break;
     }
+    mBlockPlanes->setMask(x, y, mMetaTiles[tileNum].blockmask);
+}
+
+void Map::setBlockMasks(const unsigned char *restrict const masks) restrict2
+{
+    const int sz = mWidth * mHeight;
+    for (int f = 0; f < sz; f ++)
+        mMetaTiles[f].blockmask = masks[f];
+    mBlockPlanes->setMasks(masks);
 }
 
 bool Map::getWalk(const int x, const int y,
@@ -803,6 +853,20 @@ unsigned char Map::getBlockMask(const int x,
     return mMetaTiles[x + y * mWidth].blockmask;
 }
 
+bool Map::anyBlocked(const int x1, const int y1,
+                     const int x2, const int y2,
+                     const unsigned char blockWalkMask) const restrict2
+{
+    return mBlockPlanes->anyBlocked(x1, y1, x2, y2, blockWalkMask);
+}
+
+bool Map::lineOfSight(const int x1, const int y1,
+                      const int x2, const int y2,
+                      const unsigned char blockWalkMask) const restrict2
+{
+    return mBlockPlanes->lineOfSight(x1, y1, x2, y2, blockWalkMask);
+}
+
 void Map::setWalk(const int x, const int y) restrict2
 {
     addBlockMask(x, y, BlockType::GROUNDTOP);
@@ -1288,12 +1352,14 @@ void Map::addRange(const std::string &restrict name,
 }
 
 void Map::addPortal(const std::string &restrict name,
+                    const std::string &restrict destination,
                     const int type,
                     const int x, const int y,
                     const int dx, const int dy) restrict2
 {
     addPortalTile(name, type, (x / mapTileSize) + (dx / mapTileSize / 2),
         (y / mapTileSize) + (dy / mapTileSize / 2));
+    mMapPortals.back()->setDestination(destination);
 }
 
 void Map::addPortalTile(const std::string &restrict name,
@@ -1348,6 +1414,29 @@ MapItem *Map::findPortalXY(const int x, const int y) const restrict2
     return nullptr;
 }
 
+const MapItem *Map::findNearestPortal(const int x,
+                                      const int y,
+                                      const int maxDistance) const restrict2
+{
+    const MapItem *restrict found = nullptr;
+    int foundDistance = maxDistance + 1;
+    FOR_EACH (STD_VECTOR<MapItem*>::const_iterator, it, mMapPortals)
+    {
+        const MapItem *restrict const item = *it;
+        if (item == nullptr || item->mDestination.empty())
+            continue;
+
+        const int distance = std::max(std::abs(item->mX - x),
+            std::abs(item->mY - y));
+        if (distance < foundDistance)
+        {
+            found = item;
+            foundDistance = distance;
+        }
+    }
+    return found;
+}
+
 const TileAnimation *Map::getAnimationForGid(const int gid) const restrict2
 {
     if (mTileAnimations.empty())
@@ -1498,7 +1587,7 @@ void Map::reduce() restrict2
                     continue;
 
                 Image *restrict const img =
-                    layer->mTiles[x + y * layer->mWidth].image;
+                    layer->getTile(x + y * layer->mWidth);
                 if (img != nullptr)
                 {
                     if (img->hasAlphaChannel() && img->isAlphaCalculated())
@@ -1589,7 +1678,7 @@ void Map::reduce() restrict2
                 }
 
                 const Image *restrict img =
-                    layer->mTiles[x + y * layer->mWidth].image;
+                    layer->getTile(x + y * layer->mWidth);
                 if ((img != nullptr) && !img->isAlphaVisible())
                 {   // removing all down tiles
                     ++ ri;
@@ -1603,10 +1692,10 @@ void Map::reduce() restrict2
                             continue;
                         }
                         const size_t pos = x + y * CAST_SIZE(layer2->mWidth);
-                        img = layer2->mTiles[pos].image;
+                        img = layer2->getTile(CAST_S32(pos));
                         if (img != nullptr)
                         {
-                            layer2->mTiles[pos].image = nullptr;
+                            layer2->setTile(CAST_S32(pos), nullptr);
                             cnt ++;
                         }
                         ++ ri;
@@ -1640,7 +1729,10 @@ void Map::updateDrawLayersList() restrict2
     mDrawOverLayers.clear();
 
     if (mDrawOnlyFringe)
+    {
+        updateOpaqueTiles();
         return;
+    }
 
     LayersCIter layers = mLayers.begin();
     const LayersCIter layers_end = mLayers.end();
@@ -1660,7 +1752,10 @@ void Map::updateDrawLayersList() restrict2
     }
 
     if (mDrawLayersFlags == MapType::SPECIAL2)
+    {
+        updateOpaqueTiles();
         return;
+    }
 
     for (; layers != layers_end; ++ layers)
     {
@@ -1670,6 +1765,56 @@ void Map::updateDrawLayersList() restrict2
 
         mDrawOverLayers.push_back(layer);
     }
+    updateOpaqueTiles();
+}
+
+void Map::updateOpaqueTiles() restrict2
+{
+    mOpaqueTiles.clear();
+    const int stride = mBlockPlanes->getStride();
+    bool found(false);
+    FOR_EACH (LayersCIter, it, mDrawOverLayers)
+    {
+        const MapLayer *restrict const layer = *it;
+        // skip layers with changing tiles
+        if (layer->mTileCondition != -1 || layer->isAnimated())
+            continue;
+
+        for (int y = 0; y < layer->mHeight; y ++)
+        {
+            const int mapY = y + layer->mY;
+            if (mapY < 0 || mapY >= mHeight)
+                continue;
+            for (int x = 0; x < layer->mWidth; x ++)
+            {
+                const int mapX = x + layer->mX;
+                if (mapX < 0 || mapX >= mWidth)
+                    continue;
+                const Image *restrict const img =
+                    layer->getTile(x + y * layer->mWidth);
+                if (img == nullptr ||
+                    img->mBounds.w != mapTileSize ||
+                    img->mBounds.h != mapTileSize)
+                {
+                    continue;
+                }
+                // alpha visibility known after Map::reduce
+                if (img->isHasAlphaChannel() &&
+                    (!img->isAlphaCalculated() || img->isAlphaVisible()))
+                {
+                    continue;
+                }
+                if (!found)
+                {
+                    mOpaqueTiles.assign(CAST_SIZE(stride) *
+                        CAST_SIZE(mHeight), 0U);
+                    found = true;
+                }
+                mOpaqueTiles[CAST_SIZE(mapY * stride + (mapX >> 6))] |=
+                    static_cast<uint64_t>(1U) << (mapX & 63);
+            }
+        }
+    }
 }
 
 void Map::setMask(const int mask) restrict2
@@ -1694,9 +1839,11 @@ void Map::addAnimation(const int gid,
     if (it != mTileAnimations.end())
     {
         logger->log("duplicate map animation with gid = %d", gid);
+        mTileAnimationWheel->remove((*it).second);
         delete (*it).second;
     }
     mTileAnimations[gid] = animation;
+    mTileAnimationWheel->add(animation);
 }
 
 void Map::setDrawLayersFlags(const MapTypeT &restrict n) restrict2
@@ -1744,11 +1891,20 @@ void Map::updateConditionLayers() restrict2
 
 void Map::preCacheLayers() restrict2
 {
+    // software renderer can draw static layers from pre-rendered chunks
+    const bool chunked = !mCachedDraw &&
+        mOpenGL == RENDER_SOFTWARE &&
+        config.getBoolValue("mapChunkCache");
     FOR_EACH (LayersCIter, it, mLayers)
     {
         MapLayer *restrict const layer = *it;
         if (layer != nullptr)
+        {
             layer->updateCache(mWidth, mHeight);
+            layer->setChunked(chunked &&
+                !layer->isFringeLayer() &&
+                !layer->isAnimated());
+        }
     }
 }
 
@@ -1776,6 +1932,11 @@ int Map::calcMemoryChilds(const int level) const
 
     if (mWalkLayer != nullptr)
         sz += mWalkLayer->calcMemory(level + 1);
+    sz += mTileTable->calcMemory();
+    sz += mBlockPlanes->calcMemory();
+    sz += mActorBuckets->calcMemory();
+    sz += CAST_S32(mOpaqueTiles.capacity() * sizeof(uint64_t));
+    sz += mTileAnimationWheel->calcMemory();
     FOR_EACH (LayersCIter, it, mLayers)
     {
         sz += (*it)->calcMemory(level + 1);
@@ -41,18 +41,22 @@
 
 #include "resources/map/properties.h"
 
+class ActorBuckets;
 class AmbientLayer;
 #ifdef USE_OPENGL
 class AtlasResource;
 #endif  // USE_OPENGL
+class BlockMaskPlanes;
 
 class MapHeights;
 class MapItem;
 class MapLayer;
+class MapTileTable;
 class ObjectsLayer;
 class SpecialLayer;
 class Tileset;
 class TileAnimation;
+class TileAnimationWheel;
 class WalkLayer;
 
 struct MetaTile;
@@ -133,6 +137,9 @@ class Map final : public Properties,
         const Tileset *getTilesetWithGid(const int gid) const
                                          restrict2 A_WARN_UNUSED;
 
+        const Tilesets &getTilesets() const restrict2 noexcept2 A_WARN_UNUSED
+        { return mTilesets; }
+
         /**
          * Get tile reference.
          */
@@ -146,6 +153,12 @@ class Map final : public Properties,
         void setBlockMask(const int x, const int y,
                           const BlockTypeT type) restrict2;
 
+        /**
+         * Replaces blockmasks of all tiles. Used by map cache.
+         */
+        void setBlockMasks(const unsigned char *restrict const masks)
+                           restrict2 A_NONNULL(2);
+
         /**
          * Gets walkability for a tile with a blocking bitmask. When called
          * without walkmask, only blocks against colliding tiles.
@@ -159,6 +172,22 @@ class Map final : public Properties,
         unsigned char getBlockMask(const int x,
                                    const int y) const restrict2;
 
+        /**
+         * Returns true if any tile in rect blocked with mask.
+         */
+        bool anyBlocked(const int x1, const int y1,
+                        const int x2, const int y2,
+                        const unsigned char blockWalkMask) const
+                        restrict2 A_WARN_UNUSED;
+
+        /**
+         * Returns true if no tiles between two tiles blocked with mask.
+         */
+        bool lineOfSight(const int x1, const int y1,
+                         const int x2, const int y2,
+                         const unsigned char blockWalkMask) const
+                         restrict2 A_WARN_UNUSED;
+
         /**
          * Returns the width of this map in tiles.
          */
@@ -240,6 +269,9 @@ class Map final : public Properties,
         SpecialLayer *getSpecialLayer() const restrict2 noexcept2 A_WARN_UNUSED
         { return mSpecialLayer; }
 
+        MapTileTable *getTileTable() const restrict2 noexcept2 A_WARN_UNUSED
+        { return mTileTable; }
+
         void setHasWarps(const bool n) restrict2 noexcept2
         { mHasWarps = n; }
 
@@ -248,7 +280,12 @@ class Map final : public Properties,
 
         std::string getUserMapDirectory() const restrict2 A_WARN_UNUSED;
 
+        /**
+         * Adds portal from map object. Destination is map name from
+         * object properties or empty string if unknown.
+         */
         void addPortal(const std::string &restrict name,
+                       const std::string &restrict destination,
                        const int type,
                        const int x, const int y,
                        const int dx, const int dy) restrict2;
@@ -283,6 +320,14 @@ class Map final : public Properties,
         MapItem *findPortalXY(const int x,
                               const int y) const restrict2 A_WARN_UNUSED;
 
+        /**
+         * Finds nearest portal with known destination map.
+         */
+        const MapItem *findNearestPortal(const int x,
+                                         const int y,
+                                         const int maxDistance) const
+                                         restrict2 A_WARN_UNUSED;
+
         int getActorsCount() const restrict2 A_WARN_UNUSED
         { return CAST_S32(mActors.size()); }
 
@@ -312,6 +357,15 @@ class Map final : public Properties,
         void setVersion(const int n) restrict2 noexcept2
         { mVersion = n; }
 
+        /**
+         * Adler32 of source map file, or 0 if map data can't be cached.
+         */
+        unsigned long getCacheHash() const restrict2 noexcept2 A_WARN_UNUSED
+        { return mCacheHash; }
+
+        void setCacheHash(const unsigned long hash) restrict2 noexcept2
+        { mCacheHash = hash; }
+
         void reduce() restrict2;
 
         void redrawMap() restrict2 noexcept2
@@ -330,6 +384,11 @@ class Map final : public Properties,
                                             restrict2 noexcept2 A_WARN_UNUSED
         { return mTileAnimations; }
 
+#ifdef UNITTESTS
+        const Layers &getLayers() const restrict2 noexcept2 A_WARN_UNUSED
+        { return mLayers; }
+#endif  // UNITTESTS
+
 #ifdef USE_OPENGL
         int getAtlasCount() const restrict2 A_WARN_UNUSED;
 
@@ -343,6 +402,9 @@ class Map final : public Properties,
         const MetaTile *getMetaTiles() const restrict2 noexcept2
         { return mMetaTiles; }
 
+        const BlockMaskPlanes *getBlockPlanes() const restrict2 noexcept2
+        { return mBlockPlanes; }
+
         const WalkLayer *getWalkLayer() const restrict2 noexcept2
         { return mWalkLayer; }
 
@@ -358,6 +420,11 @@ class Map final : public Properties,
 
         void updateDrawLayersList() restrict2;
 
+        /**
+         * Collects fully opaque tiles from over layers for actors culling.
+         */
+        void updateOpaqueTiles() restrict2;
+
         bool isHeightsPresent() const restrict2 noexcept2
         { return mHeights != nullptr; }
 
@@ -376,7 +443,6 @@ class Map final : public Properties,
 
     protected:
         friend class Actor;
-        friend class Minimap;
 
         /**
          * Adds an actor to the map.
@@ -414,12 +480,17 @@ class Map final : public Properties,
         const int mTileHeight;
         int mMaxTileHeight;
         MetaTile *const mMetaTiles;
+        BlockMaskPlanes *mBlockPlanes;
+        MapTileTable *mTileTable;
+        TileAnimationWheel *mTileAnimationWheel;
         WalkLayer *mWalkLayer;
         Layers mLayers;
         Layers mDrawUnderLayers;
         Layers mDrawOverLayers;
         Tilesets mTilesets;
         Actors mActors;
+        ActorBuckets *mActorBuckets;
+        STD_VECTOR<uint64_t> mOpaqueTiles;
         bool mHasWarps;
 
         // draw flags
@@ -476,6 +547,7 @@ class Map final : public Properties,
         int mActorFixX;
         int mActorFixY;
         int mVersion;
+        unsigned long mCacheHash;
 
         SpecialLayer *mSpecialLayer;
         SpecialLayer *mTempLayer;
@@ -498,6 +570,7 @@ class Map final : public Properties,
 
         const MapHeights *mHeights;
         bool mRedrawMap;
+        bool mRedrawAnimatedRows;
         bool mBeingOpacity;
         bool mCachedDraw;
         bool mCustom;
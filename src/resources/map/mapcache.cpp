@@ -0,0 +1,389 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/mapcache.h"
+
+#include "logger.h"
+#include "settings.h"
+
+#include "fs/mkdir.h"
+
+#include "resources/map/metatile.h"
+#include "resources/map/tileset.h"
+#include "resources/map/walklayer.h"
+
+#include "utils/cast.h"
+#include "utils/foreach.h"
+#include "utils/stringutils.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef WIN32
+#include <io.h>
+#else  // WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // WIN32
+
+#include "debug.h"
+
+namespace
+{
+    // "MPMC" in native byte order. Other byte order rejected as bad magic.
+    const int cacheMagic = 0x434d504d;
+    const int cacheVersion = 1;
+
+    enum
+    {
+        HEADER_MAGIC = 0,
+        HEADER_VERSION,
+        HEADER_HASH,
+        HEADER_WIDTH,
+        HEADER_HEIGHT,
+        HEADER_TILESETS,
+        HEADER_LAYERS,
+        HEADER_BLOCKMASKS,
+        HEADER_WALK,
+        HEADER_SIZE = 12
+    };
+
+    const int layerHeaderSize = 4;
+
+    size_t alignSize(const size_t size)
+    {
+        return (size + 3) & ~static_cast<size_t>(3);
+    }
+}  // namespace
+
+MapCache::MapCache(const std::string &name,
+                   const unsigned long hash,
+                   const int width,
+                   const int height) :
+    mName(name),
+    mLayers(),
+    mOutTilesets(),
+    mOutLayers(),
+    mOutLayersInfo(),
+    mOutBlockMasks(),
+    mOutWalkData(),
+    mData(nullptr),
+    mSize(0),
+    mTilesets(nullptr),
+    mBlockMasks(nullptr),
+    mWalkData(nullptr),
+    mHash(hash),
+    mWidth(width),
+    mHeight(height),
+    mTilesetsCount(0)
+{
+}
+
+MapCache::~MapCache()
+{
+    unload();
+}
+
+std::string MapCache::getFileName() const
+{
+    return pathJoin(pathJoin(settings.localDataDir, "mapcache"),
+        mName + ".bin");
+}
+
+bool MapCache::load()
+{
+    unload();
+    const std::string fileName = getFileName();
+#ifdef WIN32
+    // text mode would translate line ends in binary data
+    const int fd = open(fileName.c_str(), O_RDONLY | O_BINARY);
+#else  // WIN32
+    const int fd = open(fileName.c_str(), O_RDONLY);
+#endif  // WIN32
+    if (fd == -1)
+        return false;
+
+    struct stat statbuf;
+    if (fstat(fd, &statbuf) != 0 ||
+        statbuf.st_size < CAST_S32(HEADER_SIZE * sizeof(int)))
+    {
+        close(fd);
+        return false;
+    }
+    mSize = CAST_SIZE(statbuf.st_size);
+
+#ifdef WIN32
+    mData = new char[mSize];
+    if (read(fd, mData, CAST_U32(mSize)) != CAST_S32(mSize))
+    {
+        delete [] mData;
+        mData = nullptr;
+    }
+#else  // WIN32
+    void *const ptr = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr != MAP_FAILED)
+        mData = static_cast<char*>(ptr);
+#endif  // WIN32
+
+    close(fd);
+    if (mData == nullptr)
+    {
+        mSize = 0;
+        return false;
+    }
+
+    if (!parse())
+    {
+        logger->log("Map cache outdated: %s", fileName.c_str());
+        unload();
+        return false;
+    }
+    logger->log("Map cache loaded: %s", fileName.c_str());
+    return true;
+}
+
+bool MapCache::parse()
+{
+    const int *const header = reinterpret_cast<const int*>(mData);
+    if (header[HEADER_MAGIC] != cacheMagic ||
+        header[HEADER_VERSION] != cacheVersion ||
+        CAST_U32(header[HEADER_HASH]) != CAST_U32(mHash) ||
+        header[HEADER_WIDTH] != mWidth ||
+        header[HEADER_HEIGHT] != mHeight ||
+        header[HEADER_TILESETS] < 0 ||
+        header[HEADER_LAYERS] < 0)
+    {
+        return false;
+    }
+
+    const size_t sz = CAST_SIZE(mWidth) * CAST_SIZE(mHeight);
+    const int *const end = reinterpret_cast<const int*>(mData + mSize);
+    const int *ptr = header + HEADER_SIZE;
+
+    mTilesetsCount = header[HEADER_TILESETS];
+    if (end - ptr < mTilesetsCount)
+        return false;
+    mTilesets = ptr;
+    ptr += mTilesetsCount;
+
+    const int layers = header[HEADER_LAYERS];
+    mLayers.reserve(layers);
+    for (int f = 0; f < layers; f ++)
+    {
+        if (end - ptr < layerHeaderSize)
+            return false;
+        MapCacheLayer layer;
+        layer.width = ptr[0];
+        layer.height = ptr[1];
+        layer.count = ptr[2];
+        layer.decoded = ptr[3] != 0;
+        ptr += layerHeaderSize;
+        if (layer.count < 0 || end - ptr < layer.count)
+            return false;
+        layer.gids = ptr;
+        ptr += layer.count;
+        mLayers.push_back(layer);
+    }
+
+    if (header[HEADER_BLOCKMASKS] != 0)
+    {
+        const size_t words = alignSize(sz) / sizeof(int);
+        if (CAST_SIZE(end - ptr) < words)
+            return false;
+        mBlockMasks = reinterpret_cast<const unsigned char*>(ptr);
+        ptr += words;
+    }
+
+    if (header[HEADER_WALK] != 0)
+    {
+        if (CAST_SIZE(end - ptr) < sz)
+            return false;
+        mWalkData = ptr;
+    }
+    return true;
+}
+
+void MapCache::unload()
+{
+    if (mData != nullptr)
+    {
+#ifdef WIN32
+        delete [] mData;
+#else  // WIN32
+        munmap(mData, mSize);
+#endif  // WIN32
+        mData = nullptr;
+    }
+    mSize = 0;
+    mLayers.clear();
+    mTilesets = nullptr;
+    mBlockMasks = nullptr;
+    mWalkData = nullptr;
+    mTilesetsCount = 0;
+}
+
+bool MapCache::getLayer(const size_t index,
+                        MapCacheLayer &layer) const
+{
+    if (index >= mLayers.size())
+        return false;
+    layer = mLayers[index];
+    return true;
+}
+
+void MapCache::addLayer(const int width,
+                        const int height,
+                        const int *const gids,
+                        const int count,
+                        const bool decoded)
+{
+    MapCacheLayer layer;
+    layer.width = width;
+    layer.height = height;
+    layer.count = count;
+    layer.decoded = decoded;
+    mOutLayersInfo.push_back(layer);
+    mOutLayers.push_back(STD_VECTOR<int>(gids, gids + count));
+}
+
+bool MapCache::checkTilesets(const STD_VECTOR<Tileset*> &tilesets) const
+{
+    if (CAST_SIZE(mTilesetsCount) != tilesets.size())
+        return false;
+    for (int f = 0; f < mTilesetsCount; f ++)
+    {
+        const Tileset *const tileset = tilesets[f];
+        if (tileset == nullptr ||
+            tileset->getFirstGid() != mTilesets[f])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MapCache::setTilesets(const STD_VECTOR<Tileset*> &tilesets)
+{
+    mOutTilesets.clear();
+    FOR_EACH (STD_VECTOR<Tileset*>::const_iterator, it, tilesets)
+    {
+        const Tileset *const tileset = *it;
+        mOutTilesets.push_back(tileset != nullptr ?
+            tileset->getFirstGid() : -1);
+    }
+}
+
+void MapCache::setBlockMasks(const MetaTile *const tiles)
+{
+    const size_t sz = CAST_SIZE(mWidth) * CAST_SIZE(mHeight);
+    mOutBlockMasks.resize(alignSize(sz), 0);
+    for (size_t f = 0; f < sz; f ++)
+        mOutBlockMasks[f] = tiles[f].blockmask;
+}
+
+void MapCache::setWalkData(const WalkLayer *const walkLayer)
+{
+    const int *const data = walkLayer->getData();
+    if (data == nullptr)
+        return;
+    mOutWalkData.assign(data,
+        data + CAST_SIZE(mWidth) * CAST_SIZE(mHeight));
+}
+
+bool MapCache::save() const
+{
+    const std::string dir = pathJoin(settings.localDataDir, "mapcache");
+    if (mkdir_r(dir.c_str()) != 0)
+        return false;
+
+    const std::string fileName = getFileName();
+    const std::string tempName = fileName + ".tmp";
+    FILE *const file = fopen(tempName.c_str(), "wb");
+    if (file == nullptr)
+    {
+        logger->log("Error creating map cache: %s", tempName.c_str());
+        return false;
+    }
+
+    int header[HEADER_SIZE] = { 0 };
+    header[HEADER_MAGIC] = cacheMagic;
+    header[HEADER_VERSION] = cacheVersion;
+    header[HEADER_HASH] = CAST_S32(CAST_U32(mHash));
+    header[HEADER_WIDTH] = mWidth;
+    header[HEADER_HEIGHT] = mHeight;
+    header[HEADER_TILESETS] = CAST_S32(mOutTilesets.size());
+    header[HEADER_LAYERS] = CAST_S32(mOutLayers.size());
+    header[HEADER_BLOCKMASKS] = mOutBlockMasks.empty() ? 0 : 1;
+    header[HEADER_WALK] = mOutWalkData.empty() ? 0 : 1;
+
+    bool ok = fwrite(header, sizeof(header), 1, file) == 1;
+    if (ok && !mOutTilesets.empty())
+    {
+        ok = fwrite(&mOutTilesets[0], sizeof(int),
+            mOutTilesets.size(), file) == mOutTilesets.size();
+    }
+    const size_t layers = mOutLayers.size();
+    for (size_t f = 0; ok && f < layers; f ++)
+    {
+        const MapCacheLayer &info = mOutLayersInfo[f];
+        const STD_VECTOR<int> &gids = mOutLayers[f];
+        const int layerHeader[layerHeaderSize] =
+        {
+            info.width,
+            info.height,
+            info.count,
+            info.decoded ? 1 : 0
+        };
+        ok = fwrite(layerHeader, sizeof(layerHeader), 1, file) == 1;
+        if (ok && !gids.empty())
+        {
+            ok = fwrite(&gids[0], sizeof(int),
+                gids.size(), file) == gids.size();
+        }
+    }
+    if (ok && !mOutBlockMasks.empty())
+    {
+        ok = fwrite(&mOutBlockMasks[0], 1,
+            mOutBlockMasks.size(), file) == mOutBlockMasks.size();
+    }
+    if (ok && !mOutWalkData.empty())
+    {
+        ok = fwrite(&mOutWalkData[0], sizeof(int),
+            mOutWalkData.size(), file) == mOutWalkData.size();
+    }
+    if (fclose(file) != 0)
+        ok = false;
+
+    if (ok)
+    {
+#ifdef WIN32
+        ::remove(fileName.c_str());
+#endif  // WIN32
+        ok = ::rename(tempName.c_str(), fileName.c_str()) == 0;
+    }
+    if (!ok)
+    {
+        logger->log("Error writing map cache: %s", fileName.c_str());
+        ::remove(tempName.c_str());
+        return false;
+    }
+    logger->log("Map cache saved: %s", fileName.c_str());
+    return true;
+}
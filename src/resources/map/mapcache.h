@@ -0,0 +1,142 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_MAPCACHE_H
+#define RESOURCES_MAP_MAPCACHE_H
+
+#include "utils/vector.h"
+
+#include <string>
+
+#include "localconsts.h"
+
+class Tileset;
+class WalkLayer;
+
+struct MetaTile;
+
+/**
+ * Decoded layer data from map cache.
+ */
+struct MapCacheLayer final
+{
+    MapCacheLayer() :
+        gids(nullptr),
+        width(0),
+        height(0),
+        count(0),
+        decoded(false)
+    {
+    }
+
+    A_DEFAULT_COPY(MapCacheLayer)
+
+    const int *gids;
+    int width;
+    int height;
+    int count;
+    bool decoded;
+};
+
+/**
+ * Compiled binary cache for tmx map.
+ * Stores decoded layer gids, blockmasks, walk layer and tileset first gids.
+ * Tile heights not stored separately. Heights layer gids cached like any
+ * other layer and heights rebuilt from them by MapReader::setTiles.
+ * File keyed by adler32 of source tmx and mapped into memory on load.
+ */
+class MapCache final
+{
+    public:
+        MapCache(const std::string &name,
+                 const unsigned long hash,
+                 const int width,
+                 const int height);
+
+        A_DELETE_COPY(MapCache)
+
+        ~MapCache();
+
+        /**
+         * Maps cache file and validates it against source hash.
+         */
+        bool load();
+
+        /**
+         * Writes collected data to cache file.
+         */
+        bool save() const;
+
+        bool isLoaded() const noexcept2 A_WARN_UNUSED
+        { return mData != nullptr; }
+
+        bool getLayer(const size_t index,
+                      MapCacheLayer &layer) const A_WARN_UNUSED;
+
+        void addLayer(const int width,
+                      const int height,
+                      const int *const gids,
+                      const int count,
+                      const bool decoded);
+
+        bool checkTilesets(const STD_VECTOR<Tileset*> &tilesets) const
+                           A_WARN_UNUSED;
+
+        void setTilesets(const STD_VECTOR<Tileset*> &tilesets);
+
+        const unsigned char *getBlockMasks() const noexcept2 A_WARN_UNUSED
+        { return mBlockMasks; }
+
+        void setBlockMasks(const MetaTile *const tiles);
+
+        const int *getWalkData() const noexcept2 A_WARN_UNUSED
+        { return mWalkData; }
+
+        void setWalkData(const WalkLayer *const walkLayer);
+
+        /**
+         * Unmaps cache file and switches to collecting new data.
+         */
+        void unload();
+
+    private:
+        std::string getFileName() const A_WARN_UNUSED;
+
+        bool parse() A_WARN_UNUSED;
+
+        std::string mName;
+        STD_VECTOR<MapCacheLayer> mLayers;
+        STD_VECTOR<int> mOutTilesets;
+        STD_VECTOR<STD_VECTOR<int> > mOutLayers;
+        STD_VECTOR<MapCacheLayer> mOutLayersInfo;
+        STD_VECTOR<unsigned char> mOutBlockMasks;
+        STD_VECTOR<int> mOutWalkData;
+        char *mData;
+        size_t mSize;
+        const int *mTilesets;
+        const unsigned char *mBlockMasks;
+        const int *mWalkData;
+        unsigned long mHash;
+        int mWidth;
+        int mHeight;
+        int mTilesetsCount;
+};
+
+#endif  // RESOURCES_MAP_MAPCACHE_H
@@ -39,6 +39,7 @@ MapItem::MapItem() :
     mImage(nullptr),
     mComment(),
     mName(),
+    mDestination(),
     mType(MapItemType::EMPTY),
     mX(-1),
     mY(-1)
@@ -50,6 +51,7 @@ MapItem::MapItem(const int type) :
     mImage(nullptr),
     mComment(),
     mName(),
+    mDestination(),
     mType(type),
     mX(-1),
     mY(-1)
@@ -62,6 +64,7 @@ MapItem::MapItem(const int type,
     mImage(nullptr),
     mComment(comment),
     mName(),
+    mDestination(),
     mType(type),
     mX(-1),
     mY(-1)
@@ -76,6 +79,7 @@ MapItem::MapItem(const int type,
     mImage(nullptr),
     mComment(comment),
     mName(),
+    mDestination(),
     mType(type),
     mX(x),
     mY(y)
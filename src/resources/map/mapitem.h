@@ -76,6 +76,12 @@ class MapItem final
         void setName(const std::string &name) noexcept2
         { mName = name; }
 
+        const std::string &getDestination() const noexcept2 A_WARN_UNUSED
+        { return mDestination; }
+
+        void setDestination(const std::string &destination) noexcept2
+        { mDestination = destination; }
+
         void draw(Graphics *const graphics,
                   const int x, const int y,
                   const int dx, const int dy) const A_NONNULL(2);
@@ -84,6 +90,7 @@ class MapItem final
         Image *mImage;
         std::string mComment;
         std::string mName;
+        std::string mDestination;
         int mType;
         int mX;
         int mY;
@@ -23,9 +23,12 @@
 #include "resources/map/maplayer.h"
 
 #include "configuration.h"
+#include "sdlshared.h"
 
 #include "being/localplayer.h"
 
+#include "const/resources/map/map.h"
+
 #include "enums/resources/map/blockmask.h"
 #include "enums/resources/map/mapitemtype.h"
 
@@ -36,14 +39,29 @@
 #endif  // USE_OPENGL
 
 #include "render/graphics.h"
+#include "render/surfacegraphics.h"
+
+#include "resources/imagehelper.h"
 
 #include "resources/image/image.h"
 
+#include "resources/map/actorbuckets.h"
 #include "resources/map/mapitem.h"
+#include "resources/map/maplayerchunks.h"
 #include "resources/map/maprowvertexes.h"
 #include "resources/map/metatile.h"
 #include "resources/map/speciallayer.h"
 
+#include "utils/delete2.h"
+#include "utils/sdlcheckutils.h"
+
+PRAGMA48(GCC diagnostic push)
+PRAGMA48(GCC diagnostic ignored "-Wshadow")
+#ifndef SDL_BIG_ENDIAN
+#include <SDL_endian.h>
+#endif  // SDL_BYTEORDER
+PRAGMA48(GCC diagnostic pop)
+
 #include "debug.h"
 
 MapLayer::MapLayer(const std::string &name,
@@ -53,7 +71,8 @@ MapLayer::MapLayer(const std::string &name,
                    const int height,
                    const bool fringeLayer,
                    const int mask,
-                   const int tileCondition) :
+                   const int tileCondition,
+                   MapTileTable *const tileTable) :
     mX(x),
     mY(y),
     mPixelX(mX * mapTileSize),
@@ -61,17 +80,28 @@ MapLayer::MapLayer(const std::string &name,
     mWidth(width),
     mHeight(height),
     mTiles(new TileInfo[mWidth * mHeight]),
+    mTileTable(tileTable != nullptr ? tileTable : new MapTileTable),
     mDrawLayerFlags(MapType::NORMAL),
     mSpecialLayer(nullptr),
     mTempLayer(nullptr),
     mName(name),
     mTempRows(),
+    mDirtyRows(),
+    mChunks(nullptr),
     mMask(mask),
     mTileCondition(tileCondition),
     mActorsFix(0),
+    mRowsStartX(0),
+    mRowsStartY(0),
+    mRowsEndX(0),
+    mRowsDx(0),
+    mRowsDy(0),
     mIsFringeLayer(fringeLayer),
     mHighlightAttackRange(config.getBoolValue("highlightAttackRange")),
-    mSpecialFlag(true)
+    mSpecialFlag(true),
+    mAnimated(false),
+    mOwnTileTable(tileTable == nullptr),
+    mHaveDirtyRows(false)
 {
 //    std::fill_n(mTiles, mWidth * mHeight, static_cast<Image*>(nullptr));
 
@@ -83,8 +113,11 @@ MapLayer::~MapLayer()
     config.removeListener("highlightAttackRange", this);
     CHECKLISTENERS
     delete []mTiles;
+    if (mOwnTileTable)
+        delete2(mTileTable)
     delete_all(mTempRows);
     mTempRows.clear();
+    delete2(mChunks)
 }
 
 void MapLayer::optionChanged(const std::string &value) restrict
@@ -104,6 +137,15 @@ void MapLayer::draw(Graphics *const graphics,
                     const int scrollX,
                     const int scrollY) const restrict
 {
+    if (mChunks != nullptr)
+    {
+        drawChunks(graphics,
+            startX, startY,
+            endX, endY,
+            scrollX, scrollY);
+        return;
+    }
+
     BLOCK_START("MapLayer::draw")
     startX -= mX;
     startY -= mY;
@@ -121,6 +163,7 @@ void MapLayer::draw(Graphics *const graphics,
 
     const int dx = mPixelX - scrollX;
     const int dy = mPixelY - scrollY;
+    Image *const *const images = mTileTable->getImages();
     for (int y = startY; y < endY; y++)
     {
         const int y32 = y * mapTileSize;
@@ -147,7 +190,7 @@ void MapLayer::draw(Graphics *const graphics,
         {
             const int x32 = x * mapTileSize;
 
-            const Image *const img = tilePtr->image;
+            const Image *const img = images[tilePtr->imageId];
             const int px = x32 + dx;
             const int py = py0 - img->mBounds.h;
             if (mSpecialFlag ||
@@ -175,6 +218,256 @@ void MapLayer::draw(Graphics *const graphics,
     BLOCK_END("MapLayer::draw")
 }
 
+void MapLayer::drawChunks(Graphics *const graphics,
+                          int startX,
+                          int startY,
+                          int endX,
+                          int endY,
+                          const int scrollX,
+                          const int scrollY) const restrict
+{
+    BLOCK_START("MapLayer::drawChunks")
+    startX -= mX;
+    startY -= mY;
+    endX -= mX;
+    endY -= mY;
+
+    if (startX < 0)
+        startX = 0;
+    if (startY < 0)
+        startY = 0;
+    if (endX > mWidth)
+        endX = mWidth;
+    if (endY > mHeight)
+        endY = mHeight;
+    if (startX >= endX || startY >= endY)
+    {
+        BLOCK_END("MapLayer::drawChunks")
+        return;
+    }
+
+    const int startChunkX = startX / mapChunkSize;
+    const int startChunkY = startY / mapChunkSize;
+    const int endChunkX = (endX + mapChunkSize - 1) / mapChunkSize;
+    const int endChunkY = (endY + mapChunkSize - 1) / mapChunkSize;
+    const int chunkPixels = mapChunkSize * mapTileSize;
+    const int dx = mPixelX - scrollX;
+    const int dy = mPixelY - mapTileSize - scrollY;
+
+    for (int y = startChunkY; y < endChunkY; y ++)
+    {
+        const int py = y * chunkPixels + dy;
+        for (int x = startChunkX; x < endChunkX; x ++)
+        {
+            const MapLayerChunk *chunk = mChunks->get(x, y);
+            if (chunk == nullptr)
+            {
+                chunk = mChunks->add(x, y, createChunk(x, y));
+                if (chunk == nullptr)
+                    continue;
+            }
+            if (chunk->image != nullptr)
+            {
+                graphics->drawImage(chunk->image,
+                    x * chunkPixels + dx,
+                    py);
+            }
+        }
+    }
+
+    // keep chunks around visible area for scrolling
+    mChunks->evict(startChunkX - 1,
+        startChunkY - 1,
+        endChunkX + 1,
+        endChunkY + 1);
+    BLOCK_END("MapLayer::drawChunks")
+}
+
+Image *MapLayer::createChunk(const int chunkX,
+                             const int chunkY) const restrict
+{
+#ifndef USE_SDL2
+    const int startX = chunkX * mapChunkSize;
+    const int startY = chunkY * mapChunkSize;
+    const int chunkPixels = mapChunkSize * mapTileSize;
+    // tiles can be bigger than map tile and go into chunk from left
+    // or bottom neighbour chunks. Chunk draws all such tiles clipped
+    // to own rectangle, so tile parts drawn once and in same order as
+    // in draw.
+    const int tilesStartX = std::max(0, startX - mChunks->getMarginX());
+    const int tilesEndX = std::min(startX + mapChunkSize, mWidth);
+    const int tilesEndY = std::min(startY + mapChunkSize +
+        mChunks->getMarginY(), mHeight);
+
+    Image *const *const images = mTileTable->getImages();
+
+    bool empty = true;
+    for (int y = startY; y < tilesEndY && empty; y ++)
+    {
+        const TileInfo *tilePtr = &mTiles[CAST_SIZE(
+            tilesStartX + y * mWidth)];
+        const int bottom = (y - startY + 1) * mapTileSize;
+        for (int x = tilesStartX; x < tilesEndX; x ++, tilePtr ++)
+        {
+            const Image *const img = images[tilePtr->imageId];
+            if (img == nullptr ||
+                tilePtr->isEnabled == false ||
+                (!mSpecialFlag && img->mBounds.h > mapTileSize))
+            {
+                continue;
+            }
+            if ((x - startX) * mapTileSize + img->mBounds.w > 0 &&
+                bottom - img->mBounds.h < chunkPixels)
+            {
+                empty = false;
+                break;
+            }
+        }
+    }
+    if (empty)
+        return nullptr;
+
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    const uint32_t rmask = 0xff000000U;
+    const uint32_t gmask = 0x00ff0000U;
+    const uint32_t bmask = 0x0000ff00U;
+    const uint32_t amask = 0x000000ffU;
+#else  // SDL_BYTEORDER == SDL_BIG_ENDIAN
+    const uint32_t rmask = 0x000000ffU;
+    const uint32_t gmask = 0x0000ff00U;
+    const uint32_t bmask = 0x00ff0000U;
+    const uint32_t amask = 0xff000000U;
+#endif  // SDL_BYTEORDER == SDL_BIG_ENDIAN
+
+    SDL_Surface *const surface = MSDL_CreateRGBSurface(SDL_HWSURFACE,
+        chunkPixels, chunkPixels, 32, rmask, gmask, bmask, amask);
+    if (surface == nullptr)
+        return nullptr;
+
+    SurfaceGraphics *graphics = new SurfaceGraphics;
+    graphics->setBlitMode(BlitMode::BLIT_GFX);
+    graphics->setTarget(surface);
+    graphics->beginDraw();
+
+    // same order and positions as in draw, blits clipped by surface
+    for (int y = startY; y < tilesEndY; y ++)
+    {
+        const TileInfo *tilePtr = &mTiles[CAST_SIZE(
+            tilesStartX + y * mWidth)];
+        const int py0 = (y - startY + 1) * mapTileSize;
+        for (int x = tilesStartX; x < tilesEndX; x ++, tilePtr ++)
+        {
+            const Image *const img = images[tilePtr->imageId];
+            if (img == nullptr ||
+                tilePtr->isEnabled == false ||
+                (!mSpecialFlag && img->mBounds.h > mapTileSize))
+            {
+                continue;
+            }
+            graphics->drawImage(img,
+                (x - startX) * mapTileSize,
+                py0 - img->mBounds.h);
+        }
+    }
+
+    delete2(graphics)
+
+    SDL_SetAlpha(surface, 0, SDL_ALPHA_OPAQUE);
+    Image *const image = imageHelper->loadSurface(surface);
+    MSDL_FreeSurface(surface);
+    return image;
+#else  // USE_SDL2
+
+    return nullptr;
+#endif  // USE_SDL2
+}
+
+void MapLayer::updateChunkMargins() restrict
+{
+    if (mChunks == nullptr)
+        return;
+    Image *const *const images = mTileTable->getImages();
+    int maxWidth = mapTileSize;
+    int maxHeight = mapTileSize;
+    const size_t sz = CAST_SIZE(mWidth) * CAST_SIZE(mHeight);
+    for (size_t f = 0; f < sz; f ++)
+    {
+        const TileInfo &tile = mTiles[f];
+        const Image *const img = images[tile.imageId];
+        if (img == nullptr ||
+            tile.isEnabled == false ||
+            (!mSpecialFlag && img->mBounds.h > mapTileSize))
+        {
+            continue;
+        }
+        maxWidth = std::max(maxWidth, CAST_S32(img->mBounds.w));
+        maxHeight = std::max(maxHeight, CAST_S32(img->mBounds.h));
+    }
+    mChunks->setMargins((maxWidth - 1) / mapTileSize,
+        (maxHeight - 1) / mapTileSize);
+}
+
+void MapLayer::setChunked(const bool chunked) restrict
+{
+#ifdef USE_SDL2
+    // SDL2 surfaces blending not give same result as direct draw
+    if (chunked)
+        return;
+#endif  // USE_SDL2
+
+    if (!chunked)
+    {
+        delete2(mChunks)
+    }
+    else if (mChunks == nullptr)
+    {
+        mChunks = new MapLayerChunks(
+            (mWidth + mapChunkSize - 1) / mapChunkSize,
+            (mHeight + mapChunkSize - 1) / mapChunkSize);
+        updateChunkMargins();
+    }
+}
+
+void MapLayer::setAnimatedTile(const int index,
+                               Image *restrict const img) restrict
+{
+    setTile(index, img);
+    if (mDirtyRows.empty())
+        return;
+    const int x = index % mWidth;
+    const int row = index / mWidth - mRowsStartY;
+    if (x >= mRowsStartX &&
+        x < mRowsEndX &&
+        row >= 0 &&
+        row < CAST_S32(mDirtyRows.size()))
+    {
+        mDirtyRows[row] = true;
+        mHaveDirtyRows = true;
+    }
+}
+
+void MapLayer::clearChunks() restrict
+{
+    if (mChunks != nullptr)
+    {
+        mChunks->clear();
+        updateChunkMargins();
+    }
+}
+
+void MapLayer::setDrawLayerFlags(const MapTypeT &restrict n) restrict
+{
+    mDrawLayerFlags = n;
+    const bool specialFlag = (mDrawLayerFlags != MapType::SPECIAL &&
+        mDrawLayerFlags != MapType::SPECIAL2 &&
+        mDrawLayerFlags != MapType::SPECIAL4);
+    if (specialFlag != mSpecialFlag)
+    {
+        mSpecialFlag = specialFlag;
+        clearChunks();
+    }
+}
+
 void MapLayer::drawSDL(Graphics *const graphics) const restrict2
 {
     BLOCK_START("MapLayer::drawSDL")
@@ -207,6 +500,7 @@ void MapLayer::updateSDL(const Graphics *const graphics,
     BLOCK_START("MapLayer::updateSDL")
     delete_all(mTempRows);
     mTempRows.clear();
+    mDirtyRows.clear();
 
     startX -= mX;
     startY -= mY;
@@ -224,6 +518,7 @@ void MapLayer::updateSDL(const Graphics *const graphics,
 
     const int dx = mPixelX - scrollX;
     const int dy = mPixelY - scrollY;
+    Image *const *const images = mTileTable->getImages();
 
     for (int y = startY; y < endY; y++)
     {
@@ -241,7 +536,7 @@ void MapLayer::updateSDL(const Graphics *const graphics,
         {
             if (!tilePtr->isEnabled)
                 continue;
-            Image *const img = (*tilePtr).image;
+            Image *const img = images[tilePtr->imageId];
             const int px = x * mapTileSize + dx;
             const int py = py0 - img->mBounds.h;
             if (mSpecialFlag ||
@@ -290,8 +585,70 @@ void MapLayer::updateOGL(Graphics *const graphics,
     const int dx = mPixelX - scrollX;
     const int dy = mPixelY - scrollY;
 
-    MapRowVertexes *const row = new MapRowVertexes;
-    mTempRows.push_back(row);
+    if (mAnimated)
+    {
+        // row per tile row for rebuild only rows with changed tiles
+        for (int y = startY; y < endY; y++)
+        {
+            MapRowVertexes *const row = new MapRowVertexes;
+            mTempRows.push_back(row);
+            fillRowVertexes(graphics, row, startX, y, endX, y + 1, dx, dy);
+        }
+        mRowsStartX = startX;
+        mRowsStartY = startY;
+        mRowsEndX = endX;
+        mRowsDx = dx;
+        mRowsDy = dy;
+        mDirtyRows.assign(mTempRows.size(), false);
+    }
+    else
+    {
+        MapRowVertexes *const row = new MapRowVertexes;
+        mTempRows.push_back(row);
+        fillRowVertexes(graphics, row, startX, startY, endX, endY, dx, dy);
+        mDirtyRows.clear();
+    }
+    mHaveDirtyRows = false;
+    BLOCK_END("MapLayer::updateOGL")
+}
+
+void MapLayer::updateOGLRows(Graphics *const graphics) restrict2
+{
+    if (!mHaveDirtyRows)
+        return;
+    BLOCK_START("MapLayer::updateOGLRows")
+    const size_t sz = mDirtyRows.size();
+    if (sz == mTempRows.size())
+    {
+        for (size_t f = 0; f < sz; f ++)
+        {
+            if (!mDirtyRows[f])
+                continue;
+            delete mTempRows[f];
+            MapRowVertexes *const row = new MapRowVertexes;
+            mTempRows[f] = row;
+            const int y = mRowsStartY + CAST_S32(f);
+            fillRowVertexes(graphics, row,
+                mRowsStartX, y,
+                mRowsEndX, y + 1,
+                mRowsDx, mRowsDy);
+            mDirtyRows[f] = false;
+        }
+    }
+    mHaveDirtyRows = false;
+    BLOCK_END("MapLayer::updateOGLRows")
+}
+
+void MapLayer::fillRowVertexes(Graphics *const graphics,
+                               MapRowVertexes *const row,
+                               const int startX,
+                               const int startY,
+                               const int endX,
+                               const int endY,
+                               const int dx,
+                               const int dy) const restrict
+{
+    Image *const *const images = mTileTable->getImages();
     Image *lastImage = nullptr;
     ImageVertexes *imgVert = nullptr;
     typedef std::map<int, ImageVertexes*> ImageVertexesMap;
@@ -306,7 +663,7 @@ void MapLayer::updateOGL(Graphics *const graphics,
         {
             if (!tilePtr->isEnabled)
                 continue;
-            Image *const img = (*tilePtr).image;
+            Image *const img = images[tilePtr->imageId];
             const int px = x * mapTileSize + dx;
             const int py = py0 - img->mBounds.h;
             const GLuint imgGlImage = img->mGLImage;
@@ -342,7 +699,6 @@ void MapLayer::updateOGL(Graphics *const graphics,
     {
         graphics->finalize(*it);
     }
-    BLOCK_END("MapLayer::updateOGL")
 }
 
 void MapLayer::drawOGL(Graphics *const graphics) const restrict2
@@ -428,7 +784,7 @@ void MapLayer::drawFringe(Graphics *const graphics,
                           int endY,
                           const int scrollX,
                           const int scrollY,
-                          const Actors &actors) const restrict
+                          const ActorBuckets &actors) const restrict
 {
     BLOCK_START("MapLayer::drawFringe")
     if ((localPlayer == nullptr) ||
@@ -453,11 +809,14 @@ void MapLayer::drawFringe(Graphics *const graphics,
     if (endY > mHeight)
         endY = mHeight;
 
-    ActorsCIter ai = actors.begin();
-    const ActorsCIter ai_end = actors.end();
+    // actors sorted and culled in Map::draw
+    const STD_VECTOR<Actor*> &actorsList = actors.getActors();
+    const size_t ai_end = actorsList.size();
+    size_t ai = 0;
 
     const int dx = mPixelX - scrollX;
     const int dy = mPixelY - scrollY;
+    Image *const *const images = mTileTable->getImages();
 
     const int specialHeight = mSpecialLayer->mHeight;
 
@@ -476,11 +835,9 @@ void MapLayer::drawFringe(Graphics *const graphics,
             BLOCK_START("MapLayer::drawFringe drawmobs")
             // If drawing the fringe layer, make sure all actors above this
             // row of tiles have been drawn
-            while (ai != ai_end && (*ai)->getSortPixelY() <= y32s)
-            {
-                (*ai)->draw(graphics, -scrollX, -scrollY);
-                ++ ai;
-            }
+            const size_t rowEnd = actors.getCountBefore(y32s);
+            for (; ai < rowEnd; ai ++)
+                actorsList[ai]->draw(graphics, -scrollX, -scrollY);
             BLOCK_END("MapLayer::drawFringe drawmobs")
 
             // remove this condition, because it always true
@@ -502,11 +859,9 @@ void MapLayer::drawFringe(Graphics *const graphics,
             BLOCK_START("MapLayer::drawFringe drawmobs")
             // If drawing the fringe layer, make sure all actors above this
             // row of tiles have been drawn
-            while (ai != ai_end && (*ai)->getSortPixelY() <= y32s)
-            {
-                (*ai)->draw(graphics, -scrollX, -scrollY);
-                ++ ai;
-            }
+            const size_t rowEnd = actors.getCountBefore(y32s);
+            for (; ai < rowEnd; ai ++)
+                actorsList[ai]->draw(graphics, -scrollX, -scrollY);
             BLOCK_END("MapLayer::drawFringe drawmobs")
         }
     }
@@ -521,12 +876,9 @@ void MapLayer::drawFringe(Graphics *const graphics,
             BLOCK_START("MapLayer::drawFringe drawmobs")
             // If drawing the fringe layer, make sure all actors above this
             // row of tiles have been drawn
-            while (ai != ai_end &&
-                   (*ai)->getSortPixelY() <= y32s)
-            {
-                (*ai)->draw(graphics, -scrollX, -scrollY);
-                ++ ai;
-            }
+            const size_t rowEnd = actors.getCountBefore(y32s);
+            for (; ai < rowEnd; ai ++)
+                actorsList[ai]->draw(graphics, -scrollX, -scrollY);
             BLOCK_END("MapLayer::drawFringe drawmobs")
 
             const int py0 = y32 + dy;
@@ -553,7 +905,7 @@ void MapLayer::drawFringe(Graphics *const graphics,
             for (int x = x0; x < endX; x++, tilePtr++)
             {
                 const int x32 = x * mapTileSize;
-                const Image *const img = tilePtr->image;
+                const Image *const img = images[tilePtr->imageId];
                 if (mSpecialFlag ||
                     img->mBounds.h <= mapTileSize)
                 {
@@ -599,11 +951,9 @@ void MapLayer::drawFringe(Graphics *const graphics,
             BLOCK_START("MapLayer::drawFringe drawmobs")
             // If drawing the fringe layer, make sure all actors above this
             // row of tiles have been drawn
-            while (ai != ai_end && (*ai)->getSortPixelY() <= y32s)
-            {
-                (*ai)->draw(graphics, -scrollX, -scrollY);
-                ++ ai;
-            }
+            const size_t rowEnd = actors.getCountBefore(y32s);
+            for (; ai < rowEnd; ai ++)
+                actorsList[ai]->draw(graphics, -scrollX, -scrollY);
             BLOCK_END("MapLayer::drawFringe drawmobs")
 
             const int py0 = y32 + dy;
@@ -622,7 +972,7 @@ void MapLayer::drawFringe(Graphics *const graphics,
             for (int x = x0; x < endX; x++, tilePtr++)
             {
                 const int x32 = x * mapTileSize;
-                const Image *const img = tilePtr->image;
+                const Image *const img = images[tilePtr->imageId];
                 const int px = x32 + dx;
                 const int py = py0 - img->mBounds.h;
                 if (mSpecialFlag ||
@@ -655,11 +1005,8 @@ void MapLayer::drawFringe(Graphics *const graphics,
         mDrawLayerFlags != MapType::SPECIAL4)
     {
         BLOCK_START("MapLayer::drawFringe drawmobs")
-        while (ai != ai_end)
-        {
-            (*ai)->draw(graphics, -scrollX, -scrollY);
-            ++ai;
-        }
+        for (; ai < ai_end; ai ++)
+            actorsList[ai]->draw(graphics, -scrollX, -scrollY);
         BLOCK_END("MapLayer::drawFringe drawmobs")
         if (mHighlightAttackRange)
         {
@@ -698,34 +1045,37 @@ void MapLayer::drawFringe(Graphics *const graphics,
 int MapLayer::getTileDrawWidth(const TileInfo *restrict tilePtr,
                                const int endX,
                                int &restrict width,
-                               int &restrict nextTile)
+                               int &restrict nextTile) const restrict
 {
     BLOCK_START("MapLayer::getTileDrawWidth")
-    const Image *const img1 = tilePtr->image;
+    const uint16_t id1 = tilePtr->imageId;
+    const int imgWidth = mTileTable->get(id1)->mBounds.w;
     int c = 0;
-    width = img1->mBounds.w;
+    width = imgWidth;
     for (int x = 1; x < endX; x++)
     {
         tilePtr ++;
-        const Image *const img = tilePtr->image;
-        if (img == nullptr ||
+        const uint16_t id = tilePtr->imageId;
+        if (id == 0 ||
             tilePtr->isEnabled == false)
         {
             break;
         }
-        if (img != img1)
+        // width stored in 16 bits, so split too long patterns
+        if (id != id1 ||
+            width + imgWidth > 65535)
         {
             nextTile = c;
             BLOCK_END("MapLayer::getTileDrawWidth")
             return c;
         }
         c ++;
-        width += img->mBounds.w;
+        width += imgWidth;
     }
     int c2 = c;
     for (int x2 = c2 + 1; x2 < endX; x2++)
     {
-        if (tilePtr->image != nullptr &&
+        if (tilePtr->imageId != 0 &&
             tilePtr->isEnabled == true)
         {
             break;
@@ -747,8 +1097,7 @@ int MapLayer::getEmptyTileDrawWidth(const TileInfo *restrict tilePtr,
     for (int x = 1; x < endX; x++)
     {
         tilePtr ++;
-        const Image *const img = tilePtr->image;
-        if (img != nullptr && tilePtr->isEnabled == true)
+        if (tilePtr->imageId != 0 && tilePtr->isEnabled == true)
             break;
         c ++;
     }
@@ -771,7 +1120,7 @@ void MapLayer::updateConditionTiles(const MetaTile *const metaTiles,
         TileInfo *tilePtr = mTiles + y * mWidth;
         for (int x = mX; x < width1; x ++, metaPtr ++, tilePtr ++)
         {
-            if (tilePtr->image != nullptr &&
+            if (tilePtr->imageId != 0 &&
                 (((metaPtr->blockmask & mTileCondition) != 0) ||
                 (metaPtr->blockmask == 0 &&
                 mTileCondition == BlockMask::GROUND)))
@@ -789,6 +1138,7 @@ void MapLayer::updateConditionTiles(const MetaTile *const metaTiles,
 void MapLayer::updateCache(const int width,
                            const int height) restrict
 {
+    clearChunks();
     const int width1 = width < mWidth ? width : mWidth;
     const int height1 = height < mHeight ? height : mHeight;
 
@@ -798,24 +1148,24 @@ void MapLayer::updateCache(const int width,
         {
             TileInfo *tilePtr = mTiles + y * mWidth + x;
             int nextTile = 0;
-            if (tilePtr->image == nullptr || tilePtr->isEnabled == false)
+            if (tilePtr->imageId == 0 || tilePtr->isEnabled == false)
             {
                 tilePtr->isEnabled = false;
-                tilePtr->count = getEmptyTileDrawWidth(tilePtr,
+                tilePtr->count = CAST_U16(getEmptyTileDrawWidth(tilePtr,
                     width1 - x,
-                    nextTile);
+                    nextTile));
                 tilePtr->width = 0;
             }
             else
             {
                 int tileWidth = 0;
-                tilePtr->count = getTileDrawWidth(tilePtr,
+                tilePtr->count = CAST_U16(getTileDrawWidth(tilePtr,
                     width1 - x,
                     tileWidth,
-                    nextTile);
-                tilePtr->width = tileWidth;
+                    nextTile));
+                tilePtr->width = CAST_U16(tileWidth);
             }
-            tilePtr->nextTile = nextTile;
+            tilePtr->nextTile = CAST_U16(nextTile);
         }
     }
 }
@@ -830,6 +1180,10 @@ int MapLayer::calcMemoryLocal() const
 int MapLayer::calcMemoryChilds(const int level) const
 {
     int sz = 0;
+    if (mChunks != nullptr)
+        sz += mChunks->calcMemory();
+    if (mOwnTileTable)
+        sz += mTileTable->calcMemory();
     if (mSpecialLayer != nullptr)
         sz += mSpecialLayer->calcMemory(level + 1);
     if (mTempLayer != nullptr)
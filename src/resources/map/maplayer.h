@@ -27,15 +27,17 @@
 
 #include "resources/memorycounter.h"
 
-#include "being/actor.h"
-
 #include "enums/resources/map/maptype.h"
 
 #include "utils/vector.h"
 
+#include "resources/map/maptiletable.h"
 #include "resources/map/tileinfo.h"
 
+class ActorBuckets;
+class Graphics;
 class Image;
+class MapLayerChunks;
 class MapRowVertexes;
 class SpecialLayer;
 
@@ -54,6 +56,7 @@ class MapLayer final : public MemoryCounter, public ConfigListener
          * Constructor, taking layer origin, size and whether this layer is the
          * fringe layer. The fringe layer is the layer that draws the actors.
          * There can be only one fringe layer per map.
+         * Tile table usually shared by map. If null, layer owns own table.
          */
         MapLayer(const std::string &name,
                  const int x,
@@ -62,7 +65,8 @@ class MapLayer final : public MemoryCounter, public ConfigListener
                  const int height,
                  const bool isFringeLayer,
                  const int mask,
-                 const int tileCondition);
+                 const int tileCondition,
+                 MapTileTable *const tileTable);
 
         A_DELETE_COPY(MapLayer)
 
@@ -74,19 +78,31 @@ class MapLayer final : public MemoryCounter, public ConfigListener
         /**
          * Set tile image, with x and y in layer coordinates.
          */
-        constexpr3 void setTile(const int x,
-                                const int y,
-                                Image *restrict const img) restrict
+        void setTile(const int x,
+                     const int y,
+                     Image *restrict const img) restrict
         {
-            mTiles[x + y * mWidth].image = img;
+            mTiles[x + y * mWidth].imageId = mTileTable->getId(img);
         }
 
         /**
          * Set tile image with x + y * width already known.
          */
-        constexpr3 void setTile(const int index,
-                                Image *restrict const img) restrict
-        { mTiles[index].image = img; }
+        void setTile(const int index,
+                     Image *restrict const img) restrict
+        { mTiles[index].imageId = mTileTable->getId(img); }
+
+        /**
+         * Set image of animated tile and mark its cached row as changed.
+         */
+        void setAnimatedTile(const int index,
+                             Image *restrict const img) restrict;
+
+        /**
+         * Get tile image with x + y * width already known.
+         */
+        Image *getTile(const int index) const restrict A_WARN_UNUSED
+        { return mTileTable->get(mTiles[index].imageId); }
 
         /**
          * Draws this layer to the given graphics context. The coordinates are
@@ -118,6 +134,12 @@ class MapLayer final : public MemoryCounter, public ConfigListener
                        int endY,
                        const int scrollX,
                        const int scrollY) restrict2 A_NONNULL(2);
+
+        /**
+         * Rebuilds only cached rows with changed animated tiles.
+         */
+        void updateOGLRows(Graphics *restrict const graphics) restrict2
+                           A_NONNULL(2);
 #endif  // USE_OPENGL
 
         void updateSDL(const Graphics *restrict const graphics,
@@ -135,7 +157,7 @@ class MapLayer final : public MemoryCounter, public ConfigListener
                         int endY,
                         const int scrollX,
                         const int scrollY,
-                        const Actors &actors) const restrict A_NONNULL(2);
+                        const ActorBuckets &actors) const restrict A_NONNULL(2);
 
         constexpr3 bool isFringeLayer() const restrict noexcept2 A_WARN_UNUSED
         { return mIsFringeLayer; }
@@ -157,14 +179,20 @@ class MapLayer final : public MemoryCounter, public ConfigListener
         void optionChanged(const std::string &restrict value)
                            restrict override final;
 
-        void setDrawLayerFlags(const MapTypeT &restrict n)
-                               restrict noexcept2
-        {
-            mDrawLayerFlags = n;
-            mSpecialFlag = (mDrawLayerFlags != MapType::SPECIAL &&
-                mDrawLayerFlags != MapType::SPECIAL2 &&
-                mDrawLayerFlags != MapType::SPECIAL4);
-        }
+        void setDrawLayerFlags(const MapTypeT &restrict n) restrict;
+
+        /**
+         * Enables drawing static layer from pre-rendered chunks.
+         */
+        void setChunked(const bool chunked) restrict;
+
+        void clearChunks() restrict;
+
+        void setAnimated() restrict noexcept2
+        { mAnimated = true; }
+
+        constexpr3 bool isAnimated() const restrict noexcept2 A_WARN_UNUSED
+        { return mAnimated; }
 
         void setActorsFix(const int y) restrict noexcept2
         { mActorsFix = y; }
@@ -191,11 +219,11 @@ class MapLayer final : public MemoryCounter, public ConfigListener
 #ifndef UNITTESTS
     protected:
 #endif  // UNITTESTS
-        static int getTileDrawWidth(const TileInfo *restrict img,
-                                    const int endX,
-                                    int &restrict width,
-                                    int &restrict nextTile)
-                                    A_WARN_UNUSED A_NONNULL(1);
+        int getTileDrawWidth(const TileInfo *restrict img,
+                             const int endX,
+                             int &restrict width,
+                             int &restrict nextTile) const restrict
+                             A_WARN_UNUSED A_NONNULL(2);
 
         static int getEmptyTileDrawWidth(const TileInfo *restrict img,
                                          const int endX,
@@ -216,7 +244,31 @@ class MapLayer final : public MemoryCounter, public ConfigListener
                               const int scrollX,
                               const int scrollY) const restrict;
 
+        void drawChunks(Graphics *restrict const graphics,
+                        const int startX,
+                        const int startY,
+                        const int endX,
+                        const int endY,
+                        const int scrollX,
+                        const int scrollY) const restrict A_NONNULL(2);
+
+        Image *createChunk(const int chunkX,
+                           const int chunkY) const restrict A_WARN_UNUSED;
+
+        void updateChunkMargins() restrict;
+
     private:
+#ifdef USE_OPENGL
+        void fillRowVertexes(Graphics *restrict const graphics,
+                             MapRowVertexes *restrict const row,
+                             const int startX,
+                             const int startY,
+                             const int endX,
+                             const int endY,
+                             const int dx,
+                             const int dy) const restrict A_NONNULL(2, 3);
+#endif  // USE_OPENGL
+
         const int mX;
         const int mY;
         const int mPixelX;
@@ -224,18 +276,29 @@ class MapLayer final : public MemoryCounter, public ConfigListener
         const int mWidth;
         const int mHeight;
         TileInfo *restrict const mTiles;
+        MapTileTable *restrict mTileTable;
         MapTypeT mDrawLayerFlags;
         const SpecialLayer *restrict mSpecialLayer;
         const SpecialLayer *restrict mTempLayer;
         const std::string mName;
         typedef STD_VECTOR<MapRowVertexes*> MapRows;
         MapRows mTempRows;
+        STD_VECTOR<bool> mDirtyRows;
+        MapLayerChunks *restrict mChunks;
         int mMask;
         int mTileCondition;
         int mActorsFix;
+        int mRowsStartX;
+        int mRowsStartY;
+        int mRowsEndX;
+        int mRowsDx;
+        int mRowsDy;
         const bool mIsFringeLayer;    /**< Whether the actors are drawn. */
         bool mHighlightAttackRange;
         bool mSpecialFlag;
+        bool mAnimated;
+        bool mOwnTileTable;
+        bool mHaveDirtyRows;
 };
 
 #endif  // RESOURCES_MAP_MAPLAYER_H
@@ -0,0 +1,125 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/maplayerchunks.h"
+
+#include "resources/image/image.h"
+
+#include "utils/cast.h"
+#include "utils/foreach.h"
+
+#include "debug.h"
+
+MapLayerChunks::MapLayerChunks(const int width,
+                               const int height) :
+    mChunks(),
+    mGrid(CAST_SIZE(width) * CAST_SIZE(height),
+        static_cast<MapLayerChunk*>(nullptr)),
+    mWidth(width),
+    mHeight(height),
+    mMarginX(0),
+    mMarginY(0)
+{
+}
+
+MapLayerChunks::~MapLayerChunks()
+{
+    clear();
+}
+
+MapLayerChunk *MapLayerChunks::get(const int x,
+                                   const int y) const
+{
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+        return nullptr;
+    return mGrid[CAST_SIZE(x + y * mWidth)];
+}
+
+MapLayerChunk *MapLayerChunks::add(const int x,
+                                   const int y,
+                                   Image *const image)
+{
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+    {
+        delete image;
+        return nullptr;
+    }
+    MapLayerChunk *&cell = mGrid[CAST_SIZE(x + y * mWidth)];
+    if (cell != nullptr)
+    {
+        delete cell->image;
+        cell->image = image;
+        return cell;
+    }
+    cell = new MapLayerChunk(x, y, image);
+    mChunks.push_back(cell);
+    return cell;
+}
+
+void MapLayerChunks::evict(const int startX,
+                           const int startY,
+                           const int endX,
+                           const int endY)
+{
+    size_t f = 0;
+    while (f < mChunks.size())
+    {
+        MapLayerChunk *const chunk = mChunks[f];
+        if (chunk->x >= startX &&
+            chunk->x < endX &&
+            chunk->y >= startY &&
+            chunk->y < endY)
+        {
+            f ++;
+            continue;
+        }
+        mGrid[CAST_SIZE(chunk->x + chunk->y * mWidth)] = nullptr;
+        delete chunk->image;
+        delete chunk;
+        mChunks[f] = mChunks.back();
+        mChunks.pop_back();
+    }
+}
+
+void MapLayerChunks::clear()
+{
+    FOR_EACH (STD_VECTOR<MapLayerChunk*>::iterator, it, mChunks)
+    {
+        MapLayerChunk *const chunk = *it;
+        mGrid[CAST_SIZE(chunk->x + chunk->y * mWidth)] = nullptr;
+        delete chunk->image;
+        delete chunk;
+    }
+    mChunks.clear();
+}
+
+int MapLayerChunks::calcMemory() const
+{
+    int sz = static_cast<int>(sizeof(MapLayerChunks) +
+        sizeof(MapLayerChunk) * mChunks.size() +
+        sizeof(MapLayerChunk*) * (mChunks.capacity() + mGrid.capacity()));
+    FOR_EACH (STD_VECTOR<MapLayerChunk*>::const_iterator, it, mChunks)
+    {
+        const Image *const image = (*it)->image;
+        if (image != nullptr)
+            sz += image->calcMemory(0);
+    }
+    return sz;
+}
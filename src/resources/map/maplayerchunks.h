@@ -0,0 +1,122 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_MAPLAYERCHUNKS_H
+#define RESOURCES_MAP_MAPLAYERCHUNKS_H
+
+#include "utils/vector.h"
+
+#include "localconsts.h"
+
+class Image;
+
+/**
+ * Pre-rendered block of mapChunkSize x mapChunkSize layer tiles.
+ */
+struct MapLayerChunk final
+{
+    MapLayerChunk(const int x0,
+                  const int y0,
+                  Image *const image0) :
+        image(image0),
+        x(x0),
+        y(y0)
+    {
+    }
+
+    A_DELETE_COPY(MapLayerChunk)
+
+    /* chunk image, or null if chunk have no visible tiles */
+    Image *image;
+    /* chunk position in chunks */
+    int x;
+    int y;
+};
+
+/**
+ * Cache of pre-rendered layer chunks indexed by chunk position.
+ */
+class MapLayerChunks final
+{
+    public:
+        /**
+         * Creates cache for layer with given size in chunks.
+         */
+        MapLayerChunks(const int width,
+                       const int height);
+
+        A_DELETE_COPY(MapLayerChunks)
+
+        ~MapLayerChunks();
+
+        /**
+         * Returns chunk at given chunk position or null.
+         */
+        MapLayerChunk *get(const int x,
+                           const int y) const A_WARN_UNUSED;
+
+        /**
+         * Adds chunk. Cache takes ownership of image.
+         */
+        MapLayerChunk *add(const int x,
+                           const int y,
+                           Image *const image);
+
+        /**
+         * Removes chunks outside of given chunks rectangle.
+         */
+        void evict(const int startX,
+                   const int startY,
+                   const int endX,
+                   const int endY);
+
+        void clear();
+
+        size_t size() const
+        { return mChunks.size(); }
+
+        /**
+         * Sets how many tiles left and below chunk can draw into chunk.
+         */
+        void setMargins(const int marginX,
+                        const int marginY)
+        {
+            mMarginX = marginX;
+            mMarginY = marginY;
+        }
+
+        int getMarginX() const noexcept2 A_WARN_UNUSED
+        { return mMarginX; }
+
+        int getMarginY() const noexcept2 A_WARN_UNUSED
+        { return mMarginY; }
+
+        int calcMemory() const A_WARN_UNUSED;
+
+    private:
+        STD_VECTOR<MapLayerChunk*> mChunks;
+        STD_VECTOR<MapLayerChunk*> mGrid;
+        int mWidth;
+        int mHeight;
+        int mMarginX;
+        int mMarginY;
+};
+
+#endif  // RESOURCES_MAP_MAPLAYERCHUNKS_H
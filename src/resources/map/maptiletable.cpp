@@ -0,0 +1,72 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/maptiletable.h"
+
+#include "utils/cast.h"
+
+#include "debug.h"
+
+MapTileTable::MapTileTable() :
+    mImages(),
+    mIds(),
+    mLastImage(nullptr),
+    mLastId(0),
+    mOverflow(false)
+{
+    mImages.push_back(nullptr);
+}
+
+uint16_t MapTileTable::getId(Image *const image)
+{
+    if (image == nullptr)
+        return 0;
+    // neighbour tiles often have same image
+    if (image == mLastImage)
+        return mLastId;
+
+    uint16_t id;
+    const ImageIdMap::const_iterator it = mIds.find(image);
+    if (it != mIds.end())
+    {
+        id = it->second;
+    }
+    else
+    {
+        if (mImages.size() >= maxImages)
+        {
+            mOverflow = true;
+            return 0;
+        }
+        id = CAST_U16(mImages.size());
+        mImages.push_back(image);
+        mIds[image] = id;
+    }
+    mLastImage = image;
+    mLastId = id;
+    return id;
+}
+
+int MapTileTable::calcMemory() const
+{
+    return static_cast<int>(sizeof(MapTileTable) +
+        sizeof(Image*) * mImages.capacity() +
+        (sizeof(const Image*) + sizeof(uint16_t)) * mIds.size());
+}
@@ -0,0 +1,82 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_MAPTILETABLE_H
+#define RESOURCES_MAP_MAPTILETABLE_H
+
+#include "utils/vector.h"
+
+#include <map>
+
+#include "localconsts.h"
+
+class Image;
+
+/**
+ * Table of tile images used by map layers.
+ * Layers store 16 bit indexes in this table instead of image pointers.
+ * Index 0 always means no image. Maps which need more images than
+ * maxImages - 1 are rejected by MapReader.
+ */
+class MapTileTable final
+{
+    public:
+        MapTileTable();
+
+        A_DELETE_COPY(MapTileTable)
+
+        /**
+         * Returns index for image, adding it to table if needed.
+         */
+        uint16_t getId(Image *const image);
+
+        Image *get(const uint16_t id) const noexcept2 A_WARN_UNUSED
+        { return mImages[id]; }
+
+        /**
+         * Direct access for draw loops. Pointer valid until new image added.
+         */
+        Image *const *getImages() const noexcept2 A_WARN_UNUSED
+        { return &mImages[0]; }
+
+        size_t size() const noexcept2 A_WARN_UNUSED
+        { return mImages.size(); }
+
+        int calcMemory() const A_WARN_UNUSED;
+
+        /**
+         * Checks if some images was not added because table full.
+         */
+        bool isOverflow() const noexcept2 A_WARN_UNUSED
+        { return mOverflow; }
+
+        static const size_t maxImages = 65536;
+
+    private:
+        typedef std::map<const Image*, uint16_t> ImageIdMap;
+
+        STD_VECTOR<Image*> mImages;
+        ImageIdMap mIds;
+        const Image *mLastImage;
+        uint16_t mLastId;
+        bool mOverflow;
+};
+
+#endif  // RESOURCES_MAP_MAPTILETABLE_H
@@ -0,0 +1,363 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/minimapcache.h"
+
+#include "settings.h"
+
+#include "fs/mkdir.h"
+
+#include "resources/map/blockmaskplanes.h"
+
+#include "enums/resources/map/blockmask.h"
+
+#include "utils/cast.h"
+#include "utils/sdlcheckutils.h"
+#include "utils/sdlhelper.h"
+#include "utils/stringutils.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <zlib.h>
+
+PRAGMA48(GCC diagnostic push)
+PRAGMA48(GCC diagnostic ignored "-Wshadow")
+#include <SDL_video.h>
+PRAGMA48(GCC diagnostic pop)
+
+#include "debug.h"
+
+namespace
+{
+    // "MPMM" in native byte order. Other byte order rejected as bad magic.
+    const int cacheMagic = 0x4d4d504d;
+    const int cacheVersion = 1;
+
+    enum
+    {
+        HEADER_MAGIC = 0,
+        HEADER_VERSION,
+        HEADER_HASH,
+        HEADER_WIDTH,
+        HEADER_HEIGHT,
+        HEADER_LEVELS,
+        HEADER_SIZE
+    };
+
+    const unsigned char minimapMask = CAST_U8(BlockMask::WALL |
+        BlockMask::AIR |
+        BlockMask::WATER |
+        BlockMask::PLAYERWALL);
+}  // namespace
+
+MinimapCache::MinimapCache(const std::string &name,
+                           const unsigned long hash,
+                           const int width,
+                           const int height,
+                           const int zoom) :
+    mFileName(pathJoin(pathJoin(settings.localDataDir, "mapcache"),
+        name + ".minimap.bin")),
+    mRows(),
+    mLevels(),
+    mMutex(),
+    mThread(nullptr),
+    mSurface(nullptr),
+    mHash(hash),
+    mWidth(width),
+    mHeight(height),
+    mStride((width + 63) / 64),
+    mZoom(zoom < 1 ? 1 : (zoom > maxZoom ? maxZoom : zoom)),
+    mCancel(false),
+    mDone(false)
+{
+}
+
+MinimapCache::~MinimapCache()
+{
+    // generation checks flag on each row, so wait is short
+    mMutex.lock();
+    mCancel = true;
+    mMutex.unlock();
+    SDL::WaitThread(mThread);
+    mThread = nullptr;
+    if (mSurface != nullptr)
+        MSDL_FreeSurface(mSurface);
+}
+
+void MinimapCache::setBlockPlanes(const BlockMaskPlanes *const planes)
+{
+    planes->combineRows(minimapMask, mRows);
+}
+
+bool MinimapCache::start()
+{
+    mThread = SDL::createThread(&cacheThread, "minimapcache", this);
+    if (mThread == nullptr)
+    {
+        cacheThread(this);
+        return false;
+    }
+    return true;
+}
+
+bool MinimapCache::isDone()
+{
+    MutexLocker lock(&mMutex);
+    return mDone;
+}
+
+bool MinimapCache::isCancelled()
+{
+    MutexLocker lock(&mMutex);
+    return mCancel;
+}
+
+int MinimapCache::cacheThread(void *ptr)
+{
+    MinimapCache *const cache = static_cast<MinimapCache*>(ptr);
+    if (cache == nullptr)
+        return 0;
+    // logger not thread safe, so no logging here
+    if (!cache->load())
+    {
+        cache->generate();
+        if (cache->mHash != 0 && !cache->isCancelled())
+            cache->save();
+    }
+    SDL_Surface *surface = nullptr;
+    if (!cache->isCancelled())
+        surface = cache->createSurface();
+    cache->mRows.clear();
+
+    MutexLocker lock(&cache->mMutex);
+    cache->mSurface = surface;
+    cache->mDone = true;
+    return 0;
+}
+
+bool MinimapCache::load()
+{
+    FILE *const file = fopen(mFileName.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    int header[HEADER_SIZE];
+    bool ok = fread(header, sizeof(header), 1, file) == 1 &&
+        header[HEADER_MAGIC] == cacheMagic &&
+        header[HEADER_VERSION] == cacheVersion &&
+        CAST_U32(header[HEADER_HASH]) == CAST_U32(mHash) &&
+        header[HEADER_WIDTH] == mWidth &&
+        header[HEADER_HEIGHT] == mHeight &&
+        header[HEADER_LEVELS] == maxZoom;
+
+    STD_VECTOR<unsigned char> buf;
+    for (int f = 0; ok && f < maxZoom; f ++)
+    {
+        int levelHeader[2];
+        const size_t sz = CAST_SIZE(mWidth) * CAST_SIZE(mHeight) *
+            CAST_SIZE((f + 1) * (f + 1));
+        ok = fread(levelHeader, sizeof(levelHeader), 1, file) == 1 &&
+            levelHeader[0] == f + 1 &&
+            levelHeader[1] > 0;
+        if (!ok)
+            break;
+        buf.resize(CAST_SIZE(levelHeader[1]));
+        ok = fread(&buf[0], 1, buf.size(), file) == buf.size();
+        if (!ok)
+            break;
+        STD_VECTOR<unsigned char> &level = mLevels[f];
+        level.resize(sz);
+        uLongf destSize = CAST_SIZE(sz);
+        ok = uncompress(&level[0], &destSize,
+            &buf[0], CAST_SIZE(buf.size())) == Z_OK &&
+            destSize == sz;
+    }
+    fclose(file);
+
+    if (!ok)
+    {
+        for (int f = 0; f < maxZoom; f ++)
+            mLevels[f].clear();
+    }
+    return ok;
+}
+
+void MinimapCache::generate()
+{
+    const size_t sz = CAST_SIZE(mWidth) * CAST_SIZE(mHeight);
+    if (mRows.size() < CAST_SIZE(mStride) * CAST_SIZE(mHeight))
+    {
+        for (int f = 0; f < maxZoom; f ++)
+            mLevels[f].clear();
+        return;
+    }
+
+    STD_VECTOR<unsigned char> &base = mLevels[0];
+    base.resize(sz);
+    unsigned char *ptr = &base[0];
+    for (int y = 0; y < mHeight; y ++)
+    {
+        if (isCancelled())
+        {
+            base.clear();
+            return;
+        }
+        const uint64_t *const row = &mRows[CAST_SIZE(y) * mStride];
+        for (int x = 0; x < mWidth; x ++)
+        {
+            *(ptr ++) = ((row[x >> 6] >> (x & 63)) & 1U) != 0U ?
+                0U : 255U;
+        }
+    }
+
+    // zoomed levels repeat each pixel and each row zoom times
+    for (int zoom = 2; zoom <= maxZoom; zoom ++)
+    {
+        const int width = mWidth * zoom;
+        STD_VECTOR<unsigned char> &level = mLevels[zoom - 1];
+        level.resize(sz * CAST_SIZE(zoom * zoom));
+        ptr = &level[0];
+        for (int y = 0; y < mHeight; y ++)
+        {
+            const unsigned char *const src = &base[CAST_SIZE(y) * mWidth];
+            unsigned char *const line = ptr;
+            for (int x = 0; x < mWidth; x ++)
+            {
+                for (int f = 0; f < zoom; f ++)
+                    *(ptr ++) = src[x];
+            }
+            for (int f = 1; f < zoom; f ++)
+            {
+                std::copy(line, line + width, ptr);
+                ptr += width;
+            }
+        }
+    }
+}
+
+bool MinimapCache::save() const
+{
+    for (int f = 0; f < maxZoom; f ++)
+    {
+        if (mLevels[f].empty())
+            return false;
+    }
+
+    const std::string dir = pathJoin(settings.localDataDir, "mapcache");
+    if (mkdir_r(dir.c_str()) != 0)
+        return false;
+
+    const std::string tempName = mFileName + ".tmp";
+    FILE *const file = fopen(tempName.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    int header[HEADER_SIZE];
+    header[HEADER_MAGIC] = cacheMagic;
+    header[HEADER_VERSION] = cacheVersion;
+    header[HEADER_HASH] = CAST_S32(CAST_U32(mHash));
+    header[HEADER_WIDTH] = mWidth;
+    header[HEADER_HEIGHT] = mHeight;
+    header[HEADER_LEVELS] = maxZoom;
+
+    bool ok = fwrite(header, sizeof(header), 1, file) == 1;
+    STD_VECTOR<unsigned char> buf;
+    for (int f = 0; ok && f < maxZoom; f ++)
+    {
+        const STD_VECTOR<unsigned char> &level = mLevels[f];
+        uLongf size = compressBound(CAST_SIZE(level.size()));
+        buf.resize(size);
+        ok = compress2(&buf[0], &size, &level[0],
+            CAST_SIZE(level.size()), Z_BEST_COMPRESSION) == Z_OK;
+        if (!ok)
+            break;
+        const int levelHeader[2] =
+        {
+            f + 1,
+            CAST_S32(size)
+        };
+        ok = fwrite(levelHeader, sizeof(levelHeader), 1, file) == 1 &&
+            fwrite(&buf[0], 1, size, file) == size;
+    }
+    if (fclose(file) != 0)
+        ok = false;
+
+    if (ok)
+    {
+#ifdef WIN32
+        ::remove(mFileName.c_str());
+#endif  // WIN32
+        ok = ::rename(tempName.c_str(), mFileName.c_str()) == 0;
+    }
+    if (!ok)
+        ::remove(tempName.c_str());
+    return ok;
+}
+
+const unsigned char *MinimapCache::getPixels(const int zoom) const
+{
+    if (zoom < 1 || zoom > maxZoom)
+        return nullptr;
+    const STD_VECTOR<unsigned char> &level = mLevels[zoom - 1];
+    if (level.empty())
+        return nullptr;
+    return &level[0];
+}
+
+SDL_Surface *MinimapCache::takeSurface()
+{
+    MutexLocker lock(&mMutex);
+    SDL_Surface *const surface = mSurface;
+    mSurface = nullptr;
+    return surface;
+}
+
+SDL_Surface *MinimapCache::createSurface() const
+{
+    const unsigned char *src = getPixels(mZoom);
+    if (src == nullptr)
+        return nullptr;
+
+    const int width = mWidth * mZoom;
+    const int height = mHeight * mZoom;
+    SDL_Surface *const surface = MSDL_CreateRGBSurface(SDL_SWSURFACE,
+        width, height, 32,
+        0x00ff0000, 0x0000ff00, 0x000000ff, 0x00000000);
+    if (surface == nullptr)
+        return nullptr;
+
+    SDL_LockSurface(surface);
+    char *const pixels = static_cast<char*>(surface->pixels);
+    if (pixels == nullptr)
+    {
+        SDL_UnlockSurface(surface);
+        MSDL_FreeSurface(surface);
+        return nullptr;
+    }
+    for (int y = 0; y < height; y ++)
+    {
+        uint32_t *data = reinterpret_cast<uint32_t*>(
+            pixels + y * surface->pitch);
+        for (int x = 0; x < width; x ++)
+            *(data ++) = *(src ++) != 0U ? 0x00ffffffU : 0x0U;
+    }
+    SDL_UnlockSurface(surface);
+    return surface;
+}
@@ -0,0 +1,120 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_MINIMAPCACHE_H
+#define RESOURCES_MAP_MINIMAPCACHE_H
+
+#include "utils/mutex.h"
+#include "utils/vector.h"
+
+#include <string>
+
+#include "localconsts.h"
+
+class BlockMaskPlanes;
+
+struct SDL_Surface;
+struct SDL_Thread;
+
+/**
+ * Minimap images generated from map blockmasks in background thread.
+ * All zoom levels generated at once and stored in mapcache directory
+ * as zlib compressed grayscale images. File keyed by adler32 of source tmx.
+ * Surface for selected zoom level also created in background thread.
+ */
+class MinimapCache final
+{
+    public:
+        MinimapCache(const std::string &name,
+                     const unsigned long hash,
+                     const int width,
+                     const int height,
+                     const int zoom);
+
+        A_DELETE_COPY(MinimapCache)
+
+        /**
+         * Cancels generation and waits for thread exit.
+         */
+        ~MinimapCache();
+
+        /**
+         * Copies blocked tiles from map. Must be called before start.
+         */
+        void setBlockPlanes(const BlockMaskPlanes *const planes);
+
+        /**
+         * Starts load or generation thread.
+         */
+        bool start();
+
+        bool isDone() A_WARN_UNUSED;
+
+        /**
+         * Reads cache file and validates it against source hash.
+         */
+        bool load();
+
+        /**
+         * Generates all zoom levels from blocked tiles.
+         */
+        void generate();
+
+        /**
+         * Writes zoom levels to cache file.
+         */
+        bool save() const;
+
+        /**
+         * Returns grayscale pixels for zoom level or nullptr.
+         */
+        const unsigned char *getPixels(const int zoom) const A_WARN_UNUSED;
+
+        /**
+         * Returns generated surface and passes ownership to caller.
+         * Surface must be freed with MSDL_FreeSurface.
+         */
+        SDL_Surface *takeSurface() A_WARN_UNUSED;
+
+        static const int maxZoom = 2;
+
+    private:
+        static int cacheThread(void *ptr);
+
+        bool isCancelled() A_WARN_UNUSED;
+
+        SDL_Surface *createSurface() const A_WARN_UNUSED;
+
+        std::string mFileName;
+        STD_VECTOR<uint64_t> mRows;
+        STD_VECTOR<unsigned char> mLevels[maxZoom];
+        Mutex mMutex;
+        SDL_Thread *mThread;
+        SDL_Surface *mSurface;
+        unsigned long mHash;
+        int mWidth;
+        int mHeight;
+        int mStride;
+        int mZoom;
+        bool mCancel;
+        bool mDone;
+};
+
+#endif  // RESOURCES_MAP_MINIMAPCACHE_H
@@ -43,6 +43,13 @@ TileAnimation::~TileAnimation()
     delete2(mAnimation)
 }
 
+int TileAnimation::getNextUpdate() const
+{
+    if (mAnimation == nullptr)
+        return -1;
+    return mAnimation->getFrameTimeLeft();
+}
+
 bool TileAnimation::update(const int ticks)
 {
     if (mAnimation == nullptr)
@@ -59,7 +66,7 @@ bool TileAnimation::update(const int ticks)
         FOR_EACH (TilePairVectorCIter, i, mAffected)
         {
             if (i->first != nullptr)
-                i->first->setTile(i->second, img);
+                i->first->setAnimatedTile(i->second, img);
         }
         mLastImage = img;
     }
@@ -51,6 +51,11 @@ class TileAnimation final
 
         bool update(const int ticks);
 
+        /**
+         * Returns ticks until next frame change or -1 if not animated.
+         */
+        int getNextUpdate() const A_WARN_UNUSED;
+
         void addAffectedTile(MapLayer *const layer, const int index)
         { mAffected.push_back(std::make_pair(layer, index)); }
 
@@ -0,0 +1,118 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/tileanimationwheel.h"
+
+#include "resources/map/tileanimation.h"
+
+#include "utils/cast.h"
+#include "utils/foreach.h"
+
+#include "debug.h"
+
+TileAnimationWheel::TileAnimationWheel() :
+    mSlots(),
+    mDue(),
+    mTime(0)
+{
+}
+
+void TileAnimationWheel::add(TileAnimation *const animation)
+{
+    if (animation != nullptr)
+        schedule(animation);
+}
+
+void TileAnimationWheel::schedule(TileAnimation *const animation)
+{
+    const int delay = animation->getNextUpdate();
+    // static frame, nothing to update
+    if (delay <= 0)
+        return;
+    const int time = mTime + delay;
+    mSlots[time & (wheelSize - 1)].push_back(
+        TileAnimationTimer(animation, time, mTime));
+}
+
+void TileAnimationWheel::remove(const TileAnimation *const animation)
+{
+    for (int f = 0; f < wheelSize; f ++)
+    {
+        Timers &slot = mSlots[f];
+        Timers::iterator it = slot.begin();
+        while (it != slot.end())
+        {
+            if ((*it).animation == animation)
+                it = slot.erase(it);
+            else
+                ++ it;
+        }
+    }
+}
+
+bool TileAnimationWheel::update(const int ticks)
+{
+    bool changed = false;
+    for (int tick = 0; tick < ticks; tick ++)
+    {
+        mTime ++;
+        Timers &slot = mSlots[mTime & (wheelSize - 1)];
+        if (slot.empty())
+            continue;
+
+        // timers with bigger delay than wheel size stay for next rounds
+        size_t kept = 0;
+        const size_t sz = slot.size();
+        for (size_t f = 0; f < sz; f ++)
+        {
+            if (slot[f].time == mTime)
+                mDue.push_back(slot[f]);
+            else
+                slot[kept++] = slot[f];
+        }
+        slot.erase(slot.begin() + kept, slot.end());
+
+        FOR_EACH (Timers::const_iterator, it, mDue)
+        {
+            TileAnimation *const animation = (*it).animation;
+            if (animation->update(mTime - (*it).lastTime))
+                changed = true;
+            schedule(animation);
+        }
+        mDue.clear();
+    }
+    return changed;
+}
+
+void TileAnimationWheel::clear()
+{
+    for (int f = 0; f < wheelSize; f ++)
+        mSlots[f].clear();
+    mDue.clear();
+    mTime = 0;
+}
+
+int TileAnimationWheel::calcMemory() const
+{
+    size_t sz = sizeof(TileAnimationWheel);
+    for (int f = 0; f < wheelSize; f ++)
+        sz += mSlots[f].capacity() * sizeof(TileAnimationTimer);
+    return CAST_S32(sz);
+}
@@ -0,0 +1,88 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_TILEANIMATIONWHEEL_H
+#define RESOURCES_MAP_TILEANIMATIONWHEEL_H
+
+#include "utils/vector.h"
+
+#include "localconsts.h"
+
+class TileAnimation;
+
+struct TileAnimationTimer final
+{
+    TileAnimationTimer(TileAnimation *const animation0,
+                       const int time0,
+                       const int lastTime0) :
+        animation(animation0),
+        time(time0),
+        lastTime(lastTime0)
+    {
+    }
+
+    A_DEFAULT_COPY(TileAnimationTimer)
+
+    TileAnimation *animation;
+    int time;
+    int lastTime;
+};
+
+/**
+ * Timer wheel for map tile animations.
+ * Animation updated only at tick when its frame should change.
+ */
+class TileAnimationWheel final
+{
+    public:
+        TileAnimationWheel();
+
+        A_DELETE_COPY(TileAnimationWheel)
+
+        void add(TileAnimation *const animation);
+
+        void remove(const TileAnimation *const animation);
+
+        /**
+         * Advances time and updates due animations.
+         * Returns true if any animation frame changed.
+         */
+        bool update(const int ticks);
+
+        void clear();
+
+        int getTime() const noexcept2 A_WARN_UNUSED
+        { return mTime; }
+
+        int calcMemory() const A_WARN_UNUSED;
+
+    private:
+        static const int wheelSize = 256;
+
+        void schedule(TileAnimation *const animation);
+
+        typedef STD_VECTOR<TileAnimationTimer> Timers;
+
+        Timers mSlots[wheelSize];
+        Timers mDue;
+        int mTime;
+};
+
+#endif  // RESOURCES_MAP_TILEANIMATIONWHEEL_H
@@ -23,12 +23,14 @@
 
 #include "localconsts.h"
 
-class Image;
-
+/**
+ * Compact layer tile. Image stored as index in map tile table.
+ * Run lengths limited to 16 bits, so layers can't be wider than 65535 tiles.
+ */
 struct TileInfo final
 {
     TileInfo() :
-        image(nullptr),
+        imageId(0),
         width(0),
         count(1),
         nextTile(1),
@@ -38,14 +40,14 @@ struct TileInfo final
 
     A_DELETE_COPY(TileInfo)
 
-    /* tile image */
-    Image *image;
+    /* tile image index in MapTileTable, 0 if no image */
+    uint16_t imageId;
     /* repeated tile width in pixels */
-    int width;
+    uint16_t width;
     /* repeated tiles count - 1 */
-    int count;
+    uint16_t count;
     /* number of tiles to get next tile */
-    int nextTile;
+    uint16_t nextTile;
     /* is tile enabled flag. if set to true, also mean image is non null */
     bool isEnabled;
 };
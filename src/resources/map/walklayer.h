@@ -37,6 +37,9 @@ class WalkLayer final : public Resource
         int *getData()
         { return mTiles; }
 
+        const int *getData() const
+        { return mTiles; }
+
         int getDataAt(const int x, const int y) const;
 
         int calcMemoryLocal() const override final;
@@ -34,13 +34,17 @@
 #include "enums/resources/map/mapitemtype.h"
 
 #include "fs/virtfs/fs.h"
+#include "fs/virtfs/rwops.h"
 
 #include "resources/map/map.h"
+#include "resources/map/mapcache.h"
 #include "resources/map/mapheights.h"
 #include "resources/map/maplayer.h"
+#include "resources/map/maptiletable.h"
 #include "resources/map/tileset.h"
 
 #include "resources/beingcommon.h"
+#include "resources/imagehelper.h"
 #include "resources/animation/animation.h"
 
 #include "resources/image/image.h"
@@ -57,13 +61,26 @@
 
 #include "resources/loaders/walklayerloader.h"
 
-#include "utils/base64.h"
+#include "resources/resourcemanager/resourcemanager.h"
+
+#include "utils/base64decoder.h"
 #include "utils/checkutils.h"
 #include "utils/delete2.h"
+#include "utils/dtor.h"
+#include "utils/foreach.h"
+#include "utils/parallel.h"
+#include "utils/sdlcheckutils.h"
+#include "utils/sdlhelper.h"
 #include "utils/stringmap.h"
 
 #include "utils/translation/podict.h"
 
+PRAGMA48(GCC diagnostic push)
+PRAGMA48(GCC diagnostic ignored "-Wshadow")
+#include <SDL_image.h>
+PRAGMA48(GCC diagnostic pop)
+
+#include <new>
 #include <zlib.h>
 
 #include "debug.h"
@@ -79,6 +96,144 @@ namespace
 {
     std::map<std::string, XmlNodePtr> mKnownLayers;
     std::set<XML::Document*> mKnownDocs;
+    MapCache *mMapCache = nullptr;
+    size_t mMapCacheLayer = 0;
+    unsigned long mMapHash = 0;
+    bool mUseMapCache = false;
+    bool mMapCacheBlockMasks = false;
+
+    struct LayerDecodeJob final
+    {
+        LayerDecodeJob(const char *const content0,
+                       const bool compressed0,
+                       const bool csv0) :
+            content(content0),
+            gids(),
+            result(Z_OK),
+            compressed(compressed0),
+            csv(csv0),
+            decoded(false)
+        {
+        }
+
+        A_DELETE_COPY(LayerDecodeJob)
+
+        const char *content;
+        STD_VECTOR<int> gids;
+        int result;
+        bool compressed;
+        bool csv;
+        bool decoded;
+    };
+
+    struct TilesetPreload final
+    {
+        explicit TilesetPreload(const std::string &path0) :
+            path(path0),
+            surface(nullptr)
+        {
+        }
+
+        A_DELETE_COPY(TilesetPreload)
+
+        std::string path;
+        SDL_Surface *surface;
+    };
+
+    struct PreloadedImageLoader final
+    {
+        A_DEFAULT_COPY(PreloadedImageLoader)
+
+        SDL_Surface *surface;
+        static Resource *load(const void *const v)
+        {
+            const PreloadedImageLoader *const rl
+                = static_cast<const PreloadedImageLoader *>(v);
+            return imageHelper->loadSurface(rl->surface);
+        }
+    };
+
+    typedef std::map<const char*, LayerDecodeJob*> LayerDecodeJobs;
+    typedef LayerDecodeJobs::const_iterator LayerDecodeJobsCIter;
+    typedef std::map<std::string, TilesetPreload*> TilesetPreloads;
+    typedef TilesetPreloads::const_iterator TilesetPreloadsCIter;
+
+    STD_VECTOR<LayerDecodeJob*> mLayerJobs;
+    LayerDecodeJobs mLayerJobsMap;
+    STD_VECTOR<TilesetPreload*> mTilesetJobs;
+    TilesetPreloads mTilesetJobsMap;
+
+    void freeTilesetJobs(STD_VECTOR<TilesetPreload*> &jobs)
+    {
+        FOR_EACH (STD_VECTOR<TilesetPreload*>::iterator, it, jobs)
+        {
+            TilesetPreload *const job = *it;
+            if (job->surface != nullptr)
+                MSDL_FreeSurface(job->surface);
+        }
+        delete_all(jobs);
+        jobs.clear();
+    }
+
+    // parsed external tileset files by path
+    typedef std::map<std::string, XML::Document*> TilesetDocs;
+    typedef TilesetDocs::iterator TilesetDocsIter;
+
+    TilesetDocs mTilesetDocs;
+
+    void freeTilesetDocs(TilesetDocs &docs)
+    {
+        FOR_EACH (TilesetDocsIter, it, docs)
+            delete (*it).second;
+        docs.clear();
+    }
+
+    // map parsed and decoded in background before map change
+    struct MapPreload final
+    {
+        MapPreload(const std::string &fileName0,
+                   const size_t memoryLimit0) :
+            fileName(fileName0),
+            doc(nullptr),
+            layerJobs(),
+            tilesetJobs(),
+            tilesetDocs(),
+            thread(nullptr),
+            hash(0),
+            memoryLimit(memoryLimit0),
+            cancel(false),
+            done(false)
+        {
+        }
+
+        A_DELETE_COPY(MapPreload)
+
+        ~MapPreload()
+        {
+            cancel = true;
+            SDL::WaitThread(thread);
+            delete_all(layerJobs);
+            freeTilesetJobs(tilesetJobs);
+            freeTilesetDocs(tilesetDocs);
+            delete doc;
+        }
+
+        std::string fileName;
+        XML::Document *doc;
+        STD_VECTOR<LayerDecodeJob*> layerJobs;
+        STD_VECTOR<TilesetPreload*> tilesetJobs;
+        TilesetDocs tilesetDocs;
+        SDL_Thread *thread;
+        unsigned long hash;
+        size_t memoryLimit;
+        volatile bool cancel;
+        volatile bool done;
+    };
+
+    MapPreload *mPreload = nullptr;
+
+    // bigger layers still decoded, but without reserving memory first
+    const size_t maxReserveTiles = 4096 * 4096;
 }  // namespace
 
 static int inflateMemory(unsigned char *restrict const in,
@@ -86,9 +241,20 @@ static int inflateMemory(unsigned char *restrict const in,
                          unsigned char *&restrict out,
                          unsigned int &restrict outLength);
 
-static int inflateMemory(unsigned char *restrict const in,
-                         const unsigned int inLength,
-                         unsigned char *&restrict out);
+static void reportInflateError(const int ret);
+
+/**
+ * Returns tiles count for reserve in layer gids or 0 for broken sizes.
+ */
+static size_t getLayerReserve(const int w, const int h)
+{
+    if (w <= 0 || h <= 0)
+        return 0;
+    const size_t size = CAST_SIZE(w) * CAST_SIZE(h);
+    if (size > maxReserveTiles)
+        return 0;
+    return size;
+}
 
 static std::string resolveRelativePath(std::string base, std::string relative)
 {
@@ -192,38 +358,201 @@ PRAGMACLANG6GCC(GCC diagnostic pop)
     return Z_OK;
 }
 
-int inflateMemory(unsigned char *restrict const in,
-                  const unsigned int inLength,
-                  unsigned char *&restrict out)
+void reportInflateError(const int ret)
+{
+    if (ret == Z_MEM_ERROR)
+    {
+        reportAlways("Error: Out of memory while decompressing map data!")
+    }
+    else if (ret == Z_VERSION_ERROR)
+    {
+        reportAlways("Error: Incompatible zlib version!")
+    }
+    else if (ret == Z_DATA_ERROR)
+    {
+        reportAlways("Error: Incorrect zlib compressed data!")
+    }
+    else
+    {
+        reportAlways("Error: Unknown error while decompressing map data!")
+    }
+}
+
+/**
+ * Decodes base64 layer data and inflates it if needed.
+ * Not reports errors and can be called from worker threads.
+ */
+static int decodeBase64Layer(const char *const xmlChars,
+                             const bool compressed,
+                             STD_VECTOR<int> &gids)
 {
-    unsigned int outLength = 0;
-    const int ret = inflateMemory(in, inLength, out, outLength);
+    // whitespace skipped by decoder
+    const size_t len = strlen(xmlChars);
+    unsigned char *binData = static_cast<unsigned char*>(
+        malloc(Base64::decodedSize(len)));
+    if (binData == nullptr)
+        return Z_MEM_ERROR;
+    int binLen = Base64::decode(xmlChars, len, binData);
+    if (binLen < 0)
+    {
+        free(binData);
+        return Z_OK;
+    }
 
-    if (ret != Z_OK || (out == nullptr))
+    if (compressed)
     {
-        if (ret == Z_MEM_ERROR)
-        {
-            reportAlways("Error: Out of memory while decompressing map data!")
-        }
-        else if (ret == Z_VERSION_ERROR)
+        // Inflate the gzipped layer data
+        unsigned char *inflated = nullptr;
+        unsigned int inflatedSize = 0;
+        const int ret = inflateMemory(binData, binLen,
+            inflated, inflatedSize);
+
+        free(binData);
+        if (ret != Z_OK || inflated == nullptr)
         {
-            reportAlways("Error: Incompatible zlib version!")
+            free(inflated);
+            return ret != Z_OK ? ret : Z_BUF_ERROR;
         }
-        else if (ret == Z_DATA_ERROR)
+        binData = inflated;
+        binLen = CAST_S32(inflatedSize);
+    }
+
+    gids.reserve(binLen / 4);
+    for (int i = 0; i < binLen - 3; i += 4)
+    {
+        const int gid = binData[i] |
+            binData[i + 1] << 8 |
+            binData[i + 2] << 16 |
+            binData[i + 3] << 24;
+        gids.push_back(gid);
+    }
+    free(binData);
+    return Z_OK;
+}
+
+static bool parseCsvLayer(const char *const data,
+                          STD_VECTOR<int> &gids)
+{
+    return parseIntTokens(gids, data, ',');
+}
+
+static unsigned long calcMapHash(const char *const buf,
+                                 const int size)
+{
+    // cache depends on map data and on client version checks
+    unsigned long hash = adler32(0L, nullptr, 0);
+    hash = adler32(hash,
+        reinterpret_cast<const Bytef*>(buf),
+        CAST_U32(size));
+    return adler32(hash,
+        reinterpret_cast<const Bytef*>(CHECK_VERSION),
+        CAST_U32(strlen(CHECK_VERSION)));
+}
+
+/**
+ * Collects base64 and csv layers for decoding.
+ * If checkLoaded is false, not uses main thread state.
+ */
+static void addLayerJobs(XmlNodeConstPtrConst node,
+                         STD_VECTOR<LayerDecodeJob*> &jobs,
+                         const bool checkLoaded)
+{
+    for_each_xml_child_node(childNode, node)
+    {
+        if (!xmlNameEqual(childNode, "layer"))
+            continue;
+        if (checkLoaded)
         {
-            reportAlways("Error: Incorrect zlib compressed data!")
+            std::string name = XML::getProperty(childNode, "name", "");
+            name = toLower(name);
+            if (mKnownLayers.find(name) != mKnownLayers.end())
+                continue;
         }
-        else
+
+        for_each_xml_child_node(dataNode, childNode)
         {
-            reportAlways("Error: Unknown error while decompressing map data!")
+            if (!xmlNameEqual(dataNode, "data") ||
+                !XmlHaveChildContent(dataNode))
+            {
+                continue;
+            }
+            const std::string encoding =
+                XML::getProperty(dataNode, "encoding", "");
+            const std::string compression =
+                XML::getProperty(dataNode, "compression", "");
+            const bool csv = encoding == "csv";
+            // unsupported data left for readLayer to report
+            if (!csv && (encoding != "base64" || (!compression.empty() &&
+                compression != "gzip" && compression != "zlib")))
+            {
+                continue;
+            }
+            const char *const content = XmlChildContent(dataNode);
+            if (content == nullptr ||
+                (checkLoaded &&
+                mLayerJobsMap.find(content) != mLayerJobsMap.end()))
+            {
+                continue;
+            }
+            LayerDecodeJob *const job = new LayerDecodeJob(content,
+                !compression.empty(),
+                csv);
+            if (csv)
+            {
+                job->gids.reserve(getLayerReserve(
+                    XML::getProperty(childNode, "width", 0),
+                    XML::getProperty(childNode, "height", 0)));
+            }
+            jobs.push_back(job);
         }
+    }
+}
 
-        free(out);
-        out = nullptr;
-        outLength = 0;
+/**
+ * Returns resolved path of first tileset image.
+ */
+static std::string getTilesetImagePath(XmlNodeConstPtrConst tilesetNode,
+                                       const std::string &pathDir)
+{
+    for_each_xml_child_node(imageNode, tilesetNode)
+    {
+        if (!xmlNameEqual(imageNode, "image"))
+            continue;
+        // readTileset uses only first <image> tag
+        const std::string source = XML::getProperty(
+            imageNode, "source", "");
+        if (source.empty())
+            return std::string();
+        return resolveRelativePath(pathDir, source);
     }
+    return std::string();
+}
 
-    return outLength;
+static void loadTilesetThread(void *const data,
+                              const size_t index)
+{
+    TilesetPreload *const job =
+        (*static_cast<STD_VECTOR<TilesetPreload*>*>(data))[index];
+    SDL_RWops *const rw = VirtFs::rwopsOpenRead(job->path);
+    if (rw == nullptr)
+        return;
+    // loadPng logs unknown formats, leave them for main thread
+    if (IMG_isPNG(rw) == 0 && IMG_isJPG(rw) == 0)
+    {
+        SDL_RWclose(rw);
+        return;
+    }
+    job->surface = ImageHelper::loadPng(rw);
+}
+
+static Image *getTilesetImage(const std::string &path)
+{
+    const TilesetPreloadsCIter it = mTilesetJobsMap.find(path);
+    if (it == mTilesetJobsMap.end() || (*it).second->surface == nullptr)
+        return Loader::getImage(path);
+    PreloadedImageLoader rl = { (*it).second->surface };
+    return static_cast<Image*>(ResourceManager::get(path,
+        PreloadedImageLoader::load, &rl));
 }
 
 void MapReader::addLayerToList(const std::string &fileName,
@@ -263,14 +592,49 @@ Map *MapReader::readMap(const std::string &restrict filename,
     BLOCK_START("MapReader::readMap str")
     logger->log("Attempting to read map %s", realFilename.c_str());
 
-    XML::Document doc(realFilename, UseVirtFs_true, SkipError_false);
-    if (!doc.isLoaded())
+    mUseMapCache = false;
+    mMapHash = 0;
+    XML::Document *doc = takePreloadedMap(realFilename);
+    if (doc != nullptr)
+    {
+        mUseMapCache = config.getBoolValue("useMapCache");
+    }
+    else
     {
+        // file loaded once and used for both hash and xml parsing
+        int fileSize = 0;
+        const char *const buf = VirtFs::loadFile(realFilename, fileSize);
+        if (buf != nullptr)
+        {
+            if (config.getBoolValue("useMapCache") ||
+                config.getBoolValue("showExtMinimaps"))
+            {
+                mMapHash = calcMapHash(buf, fileSize);
+                mUseMapCache = config.getBoolValue("useMapCache");
+            }
+            doc = new XML::Document(buf, fileSize);
+            delete [] buf;
+            if (!doc->isLoaded())
+            {
+                reportAlways("Error parsing XML file %s",
+                    realFilename.c_str())
+            }
+        }
+        else
+        {
+            reportAlways("Error loading XML file %s",
+                realFilename.c_str())
+        }
+    }
+    if (doc == nullptr || !doc->isLoaded())
+    {
+        delete doc;
+        unloadPreloaded();
         BLOCK_END("MapReader::readMap str")
         return createEmptyMap(filename, realFilename);
     }
 
-    XmlNodePtrConst node = doc.rootNode();
+    XmlNodePtrConst node = doc->rootNode();
 
     Map *map = nullptr;
     // Parse the inflated map data
@@ -287,6 +651,14 @@ Map *MapReader::readMap(const std::string &restrict filename,
             realFilename.c_str())
     }
 
+    if (map != nullptr && map->getTileTable()->isOverflow())
+    {
+        reportAlways("Error: map %s uses more than %u different tile images",
+            realFilename.c_str(),
+            CAST_U32(MapTileTable::maxImages - 1))
+        delete2(map)
+    }
+
     if (map != nullptr)
     {
         map->setProperty("_filename", realFilename);
@@ -299,6 +671,9 @@ Map *MapReader::readMap(const std::string &restrict filename,
         map->preCacheLayers();
     }
 
+    // preloaded data left if map not parsed
+    unloadPreloaded();
+    delete doc;
     BLOCK_END("MapReader::readMap str")
     return map;
 }
@@ -318,6 +693,28 @@ void MapReader::unloadTempLayers()
     mKnownDocs.clear();
 }
 
+/**
+ * Returns value of property from object properties element.
+ */
+static std::string getObjectProperty(XmlNodeConstPtrConst objectNode,
+                                     const std::string &name)
+{
+    for_each_xml_child_node(propsNode, objectNode)
+    {
+        if (!xmlNameEqual(propsNode, "properties"))
+            continue;
+        for_each_xml_child_node(propNode, propsNode)
+        {
+            if (xmlNameEqual(propNode, "property") &&
+                XML::getProperty(propNode, "name", "") == name)
+            {
+                return XML::getProperty(propNode, "value", "");
+            }
+        }
+    }
+    return std::string();
+}
+
 static void loadReplaceLayer(const LayerInfoIterator &it,
                              Map *const map) A_NONNULL(2);
 static void loadReplaceLayer(const LayerInfoIterator &it,
@@ -365,6 +762,19 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
     const std::string fileName = path.substr(path.rfind(dirSeparator) + 1);
     map->setProperty("shortName", fileName);
 
+    mMapCacheLayer = 0;
+    mMapCacheBlockMasks = false;
+    // replace layers not part of map file, so cache can't be used with them
+    if (mKnownLayers.empty())
+        map->setCacheHash(mMapHash);
+    if (mUseMapCache && mKnownLayers.empty())
+    {
+        mMapCache = new MapCache(fileName, mMapHash, w, h);
+        mMapCache->load();
+    }
+    mUseMapCache = false;
+    mMapHash = 0;
+
 #ifdef USE_OPENGL
     BLOCK_START("MapReader::readMap load atlas")
     if (graphicsManager.getUseAtlases())
@@ -385,6 +795,14 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
     BLOCK_END("MapReader::readMap load atlas")
 #endif  // USE_OPENGL
 
+    if (config.getBoolValue("parallelMapLoad"))
+    {
+        // layers from loaded map cache not need decoding
+        if (mMapCache == nullptr || !mMapCache->isLoaded())
+            decodeLayers(node);
+        preloadTilesets(node, pathDir);
+    }
+
     for_each_xml_child_node(childNode, node)
     {
         if (xmlNameEqual(childNode, "tileset"))
@@ -482,8 +900,10 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
                             map->addParticleEffect(warpPath,
                                 objX, objY, objW, objH);
                         }
-                        map->addPortal(objName, MapItemType::PORTAL,
-                                       objX, objY, objW, objH);
+                        map->addPortal(objName,
+                            getObjectProperty(objectNode, "dest_map"),
+                            MapItemType::PORTAL,
+                            objX, objY, objW, objH);
                     }
                     else if (objType == "SPAWN")
                     {
@@ -506,12 +926,33 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
         }
     }
 
+    const int *walkData = nullptr;
+    if (mMapCacheBlockMasks)
+    {
+        map->setBlockMasks(mMapCache->getBlockMasks());
+        walkData = mMapCache->getWalkData();
+    }
+
     map->initializeAmbientLayers();
     map->clearIndexedTilesets();
     map->setActorsFix(0,
         atoi(map->getProperty("actorsfix", std::string()).c_str()));
     map->reduce();
-    map->setWalkLayer(Loader::getWalkLayer(fileName, map));
+    map->setWalkLayer(Loader::getWalkLayer(fileName, map, walkData));
+    if (mMapCache != nullptr)
+    {
+        if (!mMapCache->isLoaded())
+        {
+            mMapCache->setTilesets(map->getTilesets());
+            mMapCache->setBlockMasks(map->getMetaTiles());
+            const WalkLayer *const walkLayer = map->getWalkLayer();
+            if (walkLayer != nullptr)
+                mMapCache->setWalkData(walkLayer);
+            mMapCache->save();
+        }
+        delete2(mMapCache)
+    }
+    unloadPreloaded();
     unloadTempLayers();
     map->updateDrawLayersList();
     BLOCK_END("MapReader::readMap xml")
@@ -660,14 +1101,74 @@ inline static void setTile(Map *const map,
     }
 }
 
+inline static void setTiles(Map *const map,
+                            MapLayer *const layer,
+                            const MapLayerTypeT &layerType,
+                            MapHeights *const heights,
+                            const int *const gids,
+                            const int count,
+                            int &restrict x, int &restrict y,
+                            const int w, const int h) A_NONNULL(1);
+
+inline static void setTiles(Map *const map,
+                            MapLayer *const layer,
+                            const MapLayerTypeT &layerType,
+                            MapHeights *const heights,
+                            const int *const gids,
+                            const int count,
+                            int &restrict x, int &restrict y,
+                            const int w, const int h)
+{
+    if (count <= 0 || y >= h)
+        return;
+
+    if (layerType == MapLayerType::ACTIONS)
+    {
+        // nothing to set, only move position
+        const int pos = std::min(x + y * w + count, w * h);
+        x = pos % w;
+        y = pos / w;
+        return;
+    }
+
+    const std::map<int, TileAnimation*> &tileAnimations
+        = map->getTileAnimations();
+    const bool hasAnimations = !tileAnimations.empty();
+
+    for (int f = 0; f < count; f ++)
+    {
+        const int gid = gids[f];
+        setTile(map, layer, layerType, heights, x, y, gid);
+        if (hasAnimations)
+        {
+            TileAnimationMapCIter it = tileAnimations.find(gid);
+            if (it != tileAnimations.end())
+            {
+                TileAnimation *const ani = it->second;
+                if (ani != nullptr)
+                {
+                    ani->addAffectedTile(layer, x + y * w);
+                    if (layer != nullptr)
+                        layer->setAnimated();
+                }
+            }
+        }
+
+        x++;
+        if (x == w)
+        {
+            x = 0; y++;
+
+            // When we're done, don't crash on too much data
+            if (y == h)
+                break;
+        }
+    }
+}
+
 bool MapReader::readBase64Layer(XmlNodeConstPtrConst childNode,
-                                Map *const map,
-                                MapLayer *const layer,
-                                const MapLayerTypeT &layerType,
-                                MapHeights *const heights,
                                 const std::string &compression,
-                                int &restrict x, int &restrict y,
-                                const int w, const int h)
+                                STD_VECTOR<int> &gids)
 {
     if (childNode == nullptr)
         return false;
@@ -684,199 +1185,354 @@ bool MapReader::readBase64Layer(XmlNodeConstPtrConst childNode,
     if (!XmlHaveChildContent(childNode))
         return true;
 
-    const size_t len = strlen(XmlChildContent(childNode)) + 1;
-    unsigned char *charData = new unsigned char[len + 1];
     const char *const xmlChars = XmlChildContent(childNode);
-    const char *charStart = reinterpret_cast<const char*>(xmlChars);
-    if (charStart == nullptr)
+    if (xmlChars == nullptr)
+        return false;
+
+    const int ret = decodeBase64Layer(xmlChars,
+        !compression.empty(),
+        gids);
+    if (ret != Z_OK)
     {
-        delete [] charData;
+        reportInflateError(ret);
+        reportAlways("Error: Could not decompress layer!")
         return false;
     }
+    return true;
+}
 
-    unsigned char *charIndex = charData;
+bool MapReader::readCsvLayer(XmlNodeConstPtrConst childNode,
+                             STD_VECTOR<int> &gids)
+{
+    if (childNode == nullptr)
+        return false;
 
-    while (*charStart != 0)
-    {
-        if (*charStart != ' ' &&
-            *charStart != '\t' &&
-            *charStart != '\n')
-        {
-            *charIndex = *charStart;
-            charIndex++;
-        }
-        charStart++;
-    }
-    *charIndex = '\0';
+    if (!XmlHaveChildContent(childNode))
+        return true;
 
-    int binLen;
-    unsigned char *binData = php3_base64_decode(charData,
-        CAST_S32(strlen(reinterpret_cast<char*>(
-        charData))), &binLen);
+    const char *const xmlChars = XmlChildContent(childNode);
+    const char *const data = reinterpret_cast<const char*>(xmlChars);
+    if (data == nullptr)
+        return false;
 
-    delete [] charData;
-//    XmlFree(const_cast<char*>(xmlChars));
+    return parseCsvLayer(data, gids);
+}
 
-    if (binData != nullptr)
+void MapReader::readXmlLayer(XmlNodeConstPtrConst childNode,
+                             STD_VECTOR<int> &gids)
+{
+    // Read plain XML map file
+    for_each_xml_child_node(childNode2, childNode)
     {
-        if (compression == "gzip" || compression == "zlib")
-        {
-            // Inflate the gzipped layer data
-            unsigned char *inflated = nullptr;
-            const unsigned int inflatedSize =
-                inflateMemory(binData, binLen, inflated);
+        if (!xmlNameEqual(childNode2, "tile"))
+            continue;
+        gids.push_back(XML::getProperty(childNode2, "gid", -1));
+    }
+}
 
-            free(binData);
-            binData = inflated;
-            binLen = inflatedSize;
+void MapReader::decodeLayers(XmlNodeConstPtrConst node)
+{
+    BLOCK_START("MapReader::decodeLayers")
+    STD_VECTOR<LayerDecodeJob*> jobs;
+    addLayerJobs(node, jobs, true);
+    Parallel::run(&decodeLayerThread, &jobs, jobs.size(), 0);
+    FOR_EACH (STD_VECTOR<LayerDecodeJob*>::const_iterator, it, jobs)
+    {
+        LayerDecodeJob *const job = *it;
+        mLayerJobs.push_back(job);
+        mLayerJobsMap[job->content] = job;
+    }
+    BLOCK_END("MapReader::decodeLayers")
+}
 
-            if (inflated == nullptr)
-            {
-                reportAlways("Error: Could not decompress layer!")
-                return false;
-            }
+void MapReader::decodeLayerThread(void *const data,
+                                  const size_t index)
+{
+    LayerDecodeJob *const job =
+        (*static_cast<STD_VECTOR<LayerDecodeJob*>*>(data))[index];
+    // exception in worker thread terminates program
+    try
+    {
+        if (job->csv)
+        {
+            job->decoded = parseCsvLayer(job->content, job->gids);
         }
+        else
+        {
+            job->result = decodeBase64Layer(job->content,
+                job->compressed,
+                job->gids);
+            job->decoded = true;
+        }
+    }
+    catch (const std::bad_alloc &)
+    {
+        // readLayer decodes layer again in main thread
+        STD_VECTOR<int>().swap(job->gids);
+        job->result = Z_MEM_ERROR;
+        job->decoded = false;
+    }
+}
 
-        const std::map<int, TileAnimation*> &tileAnimations
-            = map->getTileAnimations();
+void MapReader::preloadTilesets(XmlNodeConstPtrConst node,
+                                const std::string &path)
+{
+    BLOCK_START("MapReader::preloadTilesets")
+    STD_VECTOR<TilesetPreload*> jobs;
+    for_each_xml_child_node(childNode, node)
+    {
+        if (!xmlNameEqual(childNode, "tileset"))
+            continue;
 
-        const bool hasAnimations = !tileAnimations.empty();
-        if (hasAnimations)
+        XmlNodePtr tilesetNode = childNode;
+        std::string pathDir(path);
+        if (XmlHasProp(childNode, "source"))
         {
-            for (int i = 0; i < binLen - 3; i += 4)
+            std::string filename = XML::getProperty(childNode, "source", "");
+            filename = resolveRelativePath(path, filename);
+            const TilesetDocsIter it = mTilesetDocs.find(filename);
+            if (it != mTilesetDocs.end())
             {
-                const int gid = binData[i] |
-                    binData[i + 1] << 8 |
-                    binData[i + 2] << 16 |
-                    binData[i + 3] << 24;
-
-                setTile(map, layer, layerType, heights, x, y, gid);
-                TileAnimationMapCIter it = tileAnimations.find(gid);
-                if (it != tileAnimations.end())
-                {
-                    TileAnimation *const ani = it->second;
-                    if (ani != nullptr)
-                        ani->addAffectedTile(layer, x + y * w);
-                }
-
-                x++;
-                if (x == w)
+                tilesetNode = (*it).second->rootNode();
+            }
+            else
+            {
+                // readTileset reuses parsed document
+                XML::Document *const doc = new XML::Document(filename,
+                    UseVirtFs_true,
+                    SkipError_true);
+                tilesetNode = doc->rootNode();
+                if (tilesetNode == nullptr)
                 {
-                    x = 0; y++;
-
-                    // When we're done, don't crash on too much data
-                    if (y == h)
-                        break;
+                    delete doc;
+                    continue;
                 }
+                mTilesetDocs[filename] = doc;
             }
+            pathDir = filename.substr(0, filename.rfind('/') + 1);
         }
-        else
+
+        const std::string sourceResolved = getTilesetImagePath(
+            tilesetNode, pathDir);
+        if (!sourceResolved.empty() &&
+            sourceResolved.find('|') == std::string::npos &&
+            mTilesetJobsMap.find(sourceResolved) == mTilesetJobsMap.end() &&
+            !ResourceManager::isInCache(sourceResolved) &&
+            VirtFs::exists(sourceResolved))
         {
-            for (int i = 0; i < binLen - 3; i += 4)
-            {
-                const int gid = binData[i] |
-                    binData[i + 1] << 8 |
-                    binData[i + 2] << 16 |
-                    binData[i + 3] << 24;
+            TilesetPreload *const job = new TilesetPreload(sourceResolved);
+            jobs.push_back(job);
+            mTilesetJobsMap[sourceResolved] = job;
+        }
+    }
 
-                setTile(map, layer, layerType, heights, x, y, gid);
+    Parallel::run(&loadTilesetThread, &jobs, jobs.size(), 0);
+    mTilesetJobs.insert(mTilesetJobs.end(), jobs.begin(), jobs.end());
+    BLOCK_END("MapReader::preloadTilesets")
+}
 
-                x++;
-                if (x == w)
-                {
-                    x = 0; y++;
+void MapReader::unloadPreloaded()
+{
+    delete_all(mLayerJobs);
+    mLayerJobs.clear();
+    mLayerJobsMap.clear();
+    freeTilesetJobs(mTilesetJobs);
+    mTilesetJobsMap.clear();
+    freeTilesetDocs(mTilesetDocs);
+}
 
-                    // When we're done, don't crash on too much data
-                    if (y == h)
-                        break;
-                }
-            }
-        }
-        free(binData);
+void MapReader::preloadMap(const std::string &realFilename)
+{
+    if (mPreload != nullptr)
+    {
+        // one map at time, other portals checked after finish
+        if (mPreload->fileName == realFilename || !mPreload->done)
+            return;
+        delete2(mPreload)
     }
-    return true;
+    if (!config.getBoolValue("mapPreload") ||
+        !VirtFs::exists(realFilename))
+    {
+        return;
+    }
+
+    logger->log("Preloading map %s", realFilename.c_str());
+    mPreload = new MapPreload(realFilename,
+        CAST_SIZE(config.getIntValue("mapPreloadMemory")) * 1024 * 1024);
+    mPreload->thread = SDL::createThread(&preloadMapThread,
+        "mappreload",
+        mPreload);
+    if (mPreload->thread == nullptr)
+        delete2(mPreload)
 }
 
-bool MapReader::readCsvLayer(XmlNodeConstPtrConst childNode,
-                             Map *const map,
-                             MapLayer *const layer,
-                             const MapLayerTypeT &layerType,
-                             MapHeights *const heights,
-                             int &restrict x, int &restrict y,
-                             const int w, const int h)
+void MapReader::unloadPreload()
 {
-    if (childNode == nullptr)
-        return false;
-
-    if (!XmlHaveChildContent(childNode))
-        return true;
+    delete2(mPreload)
+}
 
-    const char *const xmlChars = XmlChildContent(childNode);
-    const char *const data = reinterpret_cast<const char*>(xmlChars);
-    if (data == nullptr)
-        return false;
+int MapReader::preloadMapThread(void *ptr)
+{
+    // logger and resource manager not thread safe, so not used here
+    MapPreload *const preload = static_cast<MapPreload*>(ptr);
+    int fileSize = 0;
+    const char *const buf = VirtFs::loadFile(preload->fileName, fileSize);
+    if (buf == nullptr)
+    {
+        preload->done = true;
+        return 0;
+    }
+    preload->hash = calcMapHash(buf, fileSize);
+    preload->doc = new XML::Document(buf, fileSize);
+    delete [] buf;
 
-    std::string csv(data);
-    size_t oldPos = 0;
+    XmlNodePtrConst node = preload->doc->rootNode();
+    if (node == nullptr || !xmlNameEqual(node, "map"))
+    {
+        preload->done = true;
+        return 0;
+    }
 
-    const std::map<int, TileAnimation*> &tileAnimations
-        = map->getTileAnimations();
-    const bool hasAnimations = !tileAnimations.empty();
+    // rough size of parsed document
+    size_t memory = CAST_SIZE(fileSize) * 4;
+    addLayerJobs(node, preload->layerJobs, false);
+    Parallel::run(&decodeLayerThread,
+        &preload->layerJobs,
+        preload->layerJobs.size(),
+        0);
+    FOR_EACH (STD_VECTOR<LayerDecodeJob*>::const_iterator, it,
+              preload->layerJobs)
+    {
+        memory += (*it)->gids.capacity() * sizeof(int);
+    }
 
-    if (hasAnimations)
+    const std::string &fileName = preload->fileName;
+    const std::string path = fileName.substr(0, fileName.rfind('/') + 1);
+    std::set<std::string> sources;
+    for_each_xml_child_node(childNode, node)
     {
-        while (oldPos != std::string::npos)
-        {
-            const size_t pos = csv.find_first_of(',', oldPos);
-            if (pos == std::string::npos)
-                return false;
+        if (preload->cancel || memory >= preload->memoryLimit)
+            break;
+        if (!xmlNameEqual(childNode, "tileset"))
+            continue;
 
-            const int gid = atoi(csv.substr(oldPos, pos - oldPos).c_str());
-            setTile(map, layer, layerType, heights, x, y, gid);
-            TileAnimationMapCIter it = tileAnimations.find(gid);
-            if (it != tileAnimations.end())
+        XmlNodePtr tilesetNode = childNode;
+        std::string pathDir(path);
+        if (XmlHasProp(childNode, "source"))
+        {
+            const std::string filename = resolveRelativePath(path,
+                XML::getProperty(childNode, "source", ""));
+            const TilesetDocsIter it = preload->tilesetDocs.find(filename);
+            if (it != preload->tilesetDocs.end())
             {
-                TileAnimation *const ani = it->second;
-                if (ani != nullptr)
-                    ani->addAffectedTile(layer, x + y * w);
+                tilesetNode = (*it).second->rootNode();
             }
-
-            x++;
-            if (x == w)
+            else
             {
-                x = 0; y++;
-
-                // When we're done, don't crash on too much data
-                if (y == h)
-                    return false;
+                int size = 0;
+                const char *const data = VirtFs::loadFile(filename, size);
+                if (data == nullptr)
+                    continue;
+                XML::Document *const doc = new XML::Document(data, size);
+                delete [] data;
+                tilesetNode = doc->rootNode();
+                if (tilesetNode == nullptr)
+                {
+                    delete doc;
+                    continue;
+                }
+                preload->tilesetDocs[filename] = doc;
+                memory += CAST_SIZE(size) * 4;
             }
-            oldPos = pos + 1;
+            pathDir = filename.substr(0, filename.rfind('/') + 1);
+        }
+
+        const std::string source = getTilesetImagePath(tilesetNode,
+            pathDir);
+        if (source.empty() ||
+            source.find('|') != std::string::npos ||
+            sources.find(source) != sources.end())
+        {
+            continue;
+        }
+        sources.insert(source);
+
+        TilesetPreload *const job = new TilesetPreload(source);
+        preload->tilesetJobs.push_back(job);
+        loadTilesetThread(&preload->tilesetJobs,
+            preload->tilesetJobs.size() - 1);
+        if (job->surface != nullptr)
+        {
+            memory += CAST_SIZE(job->surface->h) *
+                CAST_SIZE(job->surface->pitch);
         }
     }
-    else
+    preload->done = true;
+    return 0;
+}
+
+XML::Document *MapReader::takePreloadedMap(const std::string &realFilename)
+{
+    if (mPreload == nullptr)
+        return nullptr;
+    if (mPreload->fileName != realFilename)
     {
-        while (oldPos != std::string::npos)
-        {
-            const size_t pos = csv.find_first_of(',', oldPos);
-            if (pos == std::string::npos)
-                return false;
+        logger->log("Drop preloaded map %s", mPreload->fileName.c_str());
+        delete2(mPreload)
+        return nullptr;
+    }
 
-            const int gid = atoi(csv.substr(oldPos, pos - oldPos).c_str());
-            setTile(map, layer, layerType, heights, x, y, gid);
+    BLOCK_START("MapReader::takePreloadedMap")
+    // usually already done, because player moved to portal
+    SDL::WaitThread(mPreload->thread);
+    mPreload->thread = nullptr;
+    XML::Document *const doc = mPreload->doc;
+    if (doc == nullptr || !doc->isLoaded())
+    {
+        delete2(mPreload)
+        BLOCK_END("MapReader::takePreloadedMap")
+        return nullptr;
+    }
+    logger->log("Use preloaded map %s", realFilename.c_str());
+    mPreload->doc = nullptr;
+    mMapHash = mPreload->hash;
 
-            x++;
-            if (x == w)
-            {
-                x = 0; y++;
+    FOR_EACH (STD_VECTOR<LayerDecodeJob*>::const_iterator, it,
+              mPreload->layerJobs)
+    {
+        LayerDecodeJob *const job = *it;
+        mLayerJobs.push_back(job);
+        mLayerJobsMap[job->content] = job;
+    }
+    mPreload->layerJobs.clear();
 
-                // When we're done, don't crash on too much data
-                if (y == h)
-                    return false;
-            }
-            oldPos = pos + 1;
+    FOR_EACH (STD_VECTOR<TilesetPreload*>::const_iterator, it,
+              mPreload->tilesetJobs)
+    {
+        TilesetPreload *const job = *it;
+        // image may be loaded while preload thread worked
+        if (job->surface != nullptr &&
+            ResourceManager::isInCache(job->path))
+        {
+            MSDL_FreeSurface(job->surface);
+            job->surface = nullptr;
         }
+        mTilesetJobs.push_back(job);
+        mTilesetJobsMap[job->path] = job;
     }
-    return true;
+    mPreload->tilesetJobs.clear();
+
+    FOR_EACH (TilesetDocsIter, it, mPreload->tilesetDocs)
+    {
+        if (mTilesetDocs.find((*it).first) == mTilesetDocs.end())
+            mTilesetDocs[(*it).first] = (*it).second;
+        else
+            delete (*it).second;
+    }
+    mPreload->tilesetDocs.clear();
+    delete2(mPreload)
+    BLOCK_END("MapReader::takePreloadedMap")
+    return doc;
 }
 
 void MapReader::readLayer(XmlNodeConstPtr node, Map *const map)
@@ -981,7 +1637,8 @@ void MapReader::readLayer(XmlNodeConstPtr node, Map *const map)
                     w, h,
                     isFringeLayer,
                     mask,
-                    tileCondition);
+                    tileCondition,
+                    map->getTileTable());
                 map->addLayer(layer);
                 break;
             }
@@ -1002,63 +1659,77 @@ void MapReader::readLayer(XmlNodeConstPtr node, Map *const map)
         const std::string compression =
             XML::getProperty(childNode, "compression", "");
 
-        if (encoding == "base64")
+        STD_VECTOR<int> gidsVector;
+        const int *gids = nullptr;
+        int count = 0;
+        bool decoded = false;
+        MapCacheLayer cacheLayer;
+        if (mMapCache != nullptr &&
+            mMapCache->isLoaded() &&
+            mMapCache->getLayer(mMapCacheLayer, cacheLayer) &&
+            cacheLayer.width == w &&
+            cacheLayer.height == h)
+        {
+            gids = cacheLayer.gids;
+            count = cacheLayer.count;
+            decoded = cacheLayer.decoded;
+        }
+        else
         {
-            if (readBase64Layer(childNode, map, layer, layerType,
-                heights, compression, x, y, w, h))
+            LayerDecodeJob *job = nullptr;
+            if (XmlHaveChildContent(childNode))
             {
-                continue;
+                const LayerDecodeJobsCIter it = mLayerJobsMap.find(
+                    XmlChildContent(childNode));
+                if (it != mLayerJobsMap.end())
+                    job = (*it).second;
             }
-            else
+            // failed jobs decoded again for report errors
+            if (job != nullptr && job->result == Z_OK)
             {
-                return;
+                gidsVector.swap(job->gids);
+                decoded = job->decoded;
             }
-        }
-        else if (encoding == "csv")
-        {
-            if (readCsvLayer(childNode, map, layer, layerType,
-                heights, x, y, w, h))
+            else if (encoding == "base64")
+                decoded = readBase64Layer(childNode, compression, gidsVector);
+            else if (encoding == "csv")
             {
-                continue;
+                gidsVector.reserve(getLayerReserve(w, h));
+                decoded = readCsvLayer(childNode, gidsVector);
             }
             else
-            {
-                return;
-            }
+                readXmlLayer(childNode, gidsVector);
+            if (!gidsVector.empty())
+                gids = &gidsVector[0];
+            count = CAST_S32(gidsVector.size());
+            if (mMapCache != nullptr && !mMapCache->isLoaded())
+                mMapCache->addLayer(w, h, gids, count, decoded);
+        }
+        mMapCacheLayer ++;
+
+        if (layerType == MapLayerType::COLLISION &&
+            mMapCache != nullptr &&
+            mMapCache->isLoaded() &&
+            mMapCache->getBlockMasks() != nullptr &&
+            mMapCache->checkTilesets(map->getTilesets()))
+        {
+            // blockmasks will be copied from cache after all layers loaded
+            mMapCacheBlockMasks = true;
+            setTiles(map, layer, MapLayerType::ACTIONS, heights,
+                gids, count, x, y, w, h);
         }
         else
         {
-            const std::map<int, TileAnimation*> &tileAnimations
-                = map->getTileAnimations();
-            const bool hasAnimations = !tileAnimations.empty();
-
-            // Read plain XML map file
-            for_each_xml_child_node(childNode2, childNode)
-            {
-                if (!xmlNameEqual(childNode2, "tile"))
-                    continue;
-
-                const int gid = XML::getProperty(childNode2, "gid", -1);
-                setTile(map, layer, layerType, heights, x, y, gid);
-                if (hasAnimations)
-                {
-                    TileAnimationMapCIter it = tileAnimations.find(gid);
-                    if (it != tileAnimations.end())
-                    {
-                        TileAnimation *const ani = it->second;
-                        if (ani != nullptr)
-                            ani->addAffectedTile(layer, x + y * w);
-                    }
-                }
+            setTiles(map, layer, layerType, heights,
+                gids, count, x, y, w, h);
+        }
 
-                x++;
-                if (x == w)
-                {
-                    x = 0; y++;
-                    if (y >= h)
-                        break;
-                }
-            }
+        if (encoding == "base64" || encoding == "csv")
+        {
+            if (decoded)
+                continue;
+            else
+                return;
         }
 
         if (y < h)
@@ -1095,8 +1766,17 @@ Tileset *MapReader::readTileset(XmlNodePtr node,
         std::string filename = XML::getProperty(node, "source", "");
         filename = resolveRelativePath(path, filename);
 
-        doc = new XML::Document(filename, UseVirtFs_true, SkipError_false);
-        node = doc->rootNode();
+        // document may be already parsed by preloadTilesets
+        const TilesetDocsIter it = mTilesetDocs.find(filename);
+        if (it != mTilesetDocs.end())
+        {
+            node = (*it).second->rootNode();
+        }
+        else
+        {
+            doc = new XML::Document(filename, UseVirtFs_true, SkipError_false);
+            node = doc->rootNode();
+        }
         if (node == nullptr)
         {
             delete doc;
@@ -1127,7 +1807,7 @@ Tileset *MapReader::readTileset(XmlNodePtr node,
                 const std::string sourceResolved = resolveRelativePath(pathDir,
                     source);
 
-                Image *const tilebmp = Loader::getImage(sourceResolved);
+                Image *const tilebmp = getTilesetImage(sourceResolved);
 
                 if (tilebmp != nullptr)
                 {
@@ -1287,14 +1967,16 @@ Map *MapReader::createEmptyMap(const std::string &restrict filename,
         300, 300,
         false,
         1,
-        -1);
+        -1,
+        map->getTileTable());
     map->addLayer(layer);
     layer = new MapLayer("nolayer",
         0, 0,
         300, 300,
         true,
         1,
-        -1);
+        -1,
+        map->getTileTable());
     map->addLayer(layer);
     map->updateDrawLayersList();
     map->updateConditionLayers();
@@ -25,6 +25,7 @@
 
 #include "enums/resources/map/maplayertype.h"
 
+#include "utils/vector.h"
 #include "utils/xml.h"
 
 class Map;
@@ -66,11 +67,31 @@ class MapReader final
         static void readLayer(XmlNodeConstPtr node,
                               Map *const map) A_NONNULL(2);
 
+        /**
+         * Parses map and decodes its layers and tileset images in
+         * background thread. Used by readMap if same map loaded later.
+         */
+        static void preloadMap(const std::string &realFilename);
+
+        static void unloadPreload();
+
 #ifdef USE_OPENGL
         static void loadEmptyAtlas();
         static void unloadEmptyAtlas();
 #endif  // USE_OPENGL
 
+#ifndef UNITTESTS
+    private:
+#endif  // UNITTESTS
+        /**
+         * Waits for preload thread and moves decoded data to prepass
+         * results. Returns parsed document or nullptr.
+         */
+        static XML::Document *takePreloadedMap(const std::string
+                                               &realFilename) A_WARN_UNUSED;
+
+        static void unloadPreloaded();
+
     private:
         /**
          * Reads the properties element.
@@ -83,21 +104,32 @@ class MapReader final
                                    Properties *const props) A_NONNULL(2);
 
         static bool readBase64Layer(XmlNodeConstPtrConst childNode,
-                                    Map *const map,
-                                    MapLayer *const layer,
-                                    const MapLayerTypeT &layerType,
-                                    MapHeights *const heights,
                                     const std::string &compression,
-                                    int &restrict x, int &restrict y,
-                                    const int w, const int h) A_NONNULL(2);
+                                    STD_VECTOR<int> &gids);
 
         static bool readCsvLayer(XmlNodeConstPtrConst childNode,
-                                 Map *const map,
-                                 MapLayer *const layer,
-                                 const MapLayerTypeT &layerType,
-                                 MapHeights *const heights,
-                                 int &restrict x, int &restrict y,
-                                 const int w, const int h) A_NONNULL(2);
+                                 STD_VECTOR<int> &gids);
+
+        static void readXmlLayer(XmlNodeConstPtrConst childNode,
+                                 STD_VECTOR<int> &gids);
+
+        /**
+         * Decodes base64 and csv layers data in worker threads.
+         * Results used by readLayer instead of decoding data again.
+         */
+        static void decodeLayers(XmlNodeConstPtrConst node);
+
+        static void decodeLayerThread(void *const data,
+                                      const size_t index);
+
+        /**
+         * Loads tileset images not present in cache in worker threads.
+         * Surfaces converted to images by readTileset.
+         */
+        static void preloadTilesets(XmlNodeConstPtrConst node,
+                                    const std::string &path);
+
+        static int preloadMapThread(void *ptr);
 
         /**
          * Reads a tile set.
@@ -38,6 +38,7 @@
 #include "resources/resourcemanager/resourcemanager.h"
 
 #include "resources/sprite/animationdelayload.h"
+#include "resources/sprite/spriteactionid.h"
 
 #include "utils/delete2.h"
 #include "utils/likely.h"
@@ -165,7 +166,24 @@ bool AnimatedSprite::play(const std::string &restrict spriteAction) restrict2
         return true;
     }
 
-    const Action *const action = mSprite->getAction(spriteAction, mNumber);
+    return playAction(mSprite->getAction(spriteAction, mNumber));
+}
+
+bool AnimatedSprite::play(const int actionId) restrict2
+{
+    if (mSprite == nullptr)
+    {
+        if (mDelayLoad == nullptr)
+            return false;
+        mDelayLoad->setAction(SpriteActionId::getName(actionId));
+        return true;
+    }
+
+    return playAction(mSprite->getAction(actionId, mNumber));
+}
+
+bool AnimatedSprite::playAction(const Action *restrict const action) restrict2
+{
     if (action == nullptr)
         return false;
 
@@ -204,7 +222,7 @@ bool AnimatedSprite::update(const int time) restrict2
     if (A_UNLIKELY(!updateCurrentAnimation(dt)))
     {
         // Animation finished, reset to default
-        play(SpriteAction::STAND);
+        play(SpriteActionId::STAND);
         mTerminated = true;
     }
 
@@ -25,6 +25,7 @@
 
 #include "resources/sprite/sprite.h"
 
+class Action;
 class Animation;
 class AnimationDelayLoad;
 struct Frame;
@@ -67,6 +68,8 @@ class AnimatedSprite final : public Sprite
         bool play(const std::string &restrict spriteAction)
                   restrict2 override final;
 
+        bool play(const int actionId) restrict2 override final;
+
         bool update(const int time) restrict2 override final;
 
         void draw(Graphics *restrict const graphics,
@@ -152,6 +155,8 @@ class AnimatedSprite final : public Sprite
 #endif  // DEBUG_ANIMATIONS
 
     private:
+        bool playAction(const Action *restrict const action) restrict2;
+
         bool updateCurrentAnimation(const unsigned int dt) restrict2;
 
         void setDelayLoad(const std::string &restrict filename,
@@ -51,6 +51,13 @@ class Sprite notfinal
          */
         virtual bool play(const std::string &action) = 0;
 
+        /**
+         * Plays an action by interned action id using the current direction.
+         *
+         * @returns true if the sprite changed, false otherwise
+         */
+        virtual bool play(const int actionId) = 0;
+
         /**
          * Inform the animation of the passed time so that it can output the
          * correct animation frame.
@@ -0,0 +1,128 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/sprite/spriteactionid.h"
+
+#include "utils/cast.h"
+#include "utils/stringmap.h"
+#include "utils/vector.h"
+
+#include "debug.h"
+
+namespace
+{
+    // order must match ids in spriteactionid.h
+    const char *const predefinedNames[] =
+    {
+        "stand",
+        "sit",
+        "sittop",
+        "dead",
+        "walk",
+        "attack",
+        "spawn",
+        "cast",
+        "fly",
+        "swim",
+        "ride",
+        "standsky",
+        "standwater",
+        "standride",
+        "sitsky",
+        "sitwater",
+        "sitride",
+        "attacksky",
+        "attackwater",
+        "attackride",
+        "castsky",
+        "castwater",
+        "castride",
+        "spawnsky",
+        "spawnwater",
+        "spawnride",
+        "deadsky",
+        "deadwater",
+        "deadride"
+    };
+
+    struct ActionNames final
+    {
+        ActionNames() :
+            ids(),
+            names()
+        {
+            const size_t sz = sizeof(predefinedNames) /
+                sizeof(predefinedNames[0]);
+            for (size_t f = 0; f < sz; f ++)
+            {
+                const std::string name = predefinedNames[f];
+                ids[name] = CAST_S32(f);
+                names.push_back(name);
+            }
+        }
+
+        A_DELETE_COPY(ActionNames)
+
+        StringIntMap ids;
+        STD_VECTOR<std::string> names;
+    };
+
+    ActionNames &actionNames()
+    {
+        static ActionNames data;
+        return data;
+    }
+
+    const std::string emptyName;
+}  // namespace
+
+int SpriteActionId::get(const std::string &name)
+{
+    ActionNames &data = actionNames();
+    const StringIntMapCIter it = data.ids.find(name);
+    if (it != data.ids.end())
+        return (*it).second;
+    const int id = CAST_S32(data.names.size());
+    data.ids[name] = id;
+    data.names.push_back(name);
+    return id;
+}
+
+int SpriteActionId::find(const std::string &name)
+{
+    const ActionNames &data = actionNames();
+    const StringIntMapCIter it = data.ids.find(name);
+    if (it != data.ids.end())
+        return (*it).second;
+    return INVALID;
+}
+
+const std::string &SpriteActionId::getName(const int id)
+{
+    const ActionNames &data = actionNames();
+    if (id < 0 || id >= CAST_S32(data.names.size()))
+        return emptyName;
+    return data.names[id];
+}
+
+int SpriteActionId::size()
+{
+    return CAST_S32(actionNames().names.size());
+}
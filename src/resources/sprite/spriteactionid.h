@@ -0,0 +1,89 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_SPRITE_SPRITEACTIONID_H
+#define RESOURCES_SPRITE_SPRITEACTIONID_H
+
+#include <string>
+
+#include "localconsts.h"
+
+/*
+ * Sprite action names interned into small integer ids.
+ * Main actions from const/resources/spriteaction.h have fixed ids,
+ * other names got ids on first use.
+ */
+namespace SpriteActionId
+{
+    static const int INVALID = -1;
+    static const int STAND = 0;
+    static const int DEFAULT = STAND;
+    static const int SIT = 1;
+    static const int SITTOP = 2;
+    static const int DEAD = 3;
+    static const int MOVE = 4;
+    static const int ATTACK = 5;
+    static const int SPAWN = 6;
+    static const int CAST = 7;
+
+    static const int FLY = 8;
+    static const int SWIM = 9;
+    static const int RIDE = 10;
+    static const int STANDSKY = 11;
+    static const int STANDWATER = 12;
+    static const int STANDRIDE = 13;
+    static const int SITSKY = 14;
+    static const int SITWATER = 15;
+    static const int SITRIDE = 16;
+    static const int ATTACKSKY = 17;
+    static const int ATTACKWATER = 18;
+    static const int ATTACKRIDE = 19;
+    static const int CASTSKY = 20;
+    static const int CASTWATER = 21;
+    static const int CASTRIDE = 22;
+    static const int SPAWNSKY = 23;
+    static const int SPAWNWATER = 24;
+    static const int SPAWNRIDE = 25;
+    static const int DEADSKY = 26;
+    static const int DEADWATER = 27;
+    static const int DEADRIDE = 28;
+
+    /**
+     * Returns id for action name. Adds new id if name not known yet.
+     */
+    int get(const std::string &name) A_WARN_UNUSED;
+
+    /**
+     * Returns id for action name or INVALID if name not known.
+     */
+    int find(const std::string &name) A_WARN_UNUSED;
+
+    /**
+     * Returns action name for id or empty string for unknown id.
+     */
+    const std::string &getName(const int id) A_WARN_UNUSED;
+
+    /**
+     * Returns number of known ids.
+     */
+    int size() A_WARN_UNUSED;
+}  // namespace SpriteActionId
+
+#endif  // RESOURCES_SPRITE_SPRITEACTIONID_H
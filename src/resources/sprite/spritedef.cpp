@@ -29,6 +29,7 @@
 
 #include "const/resources/map/map.h"
 
+#include "utils/cast.h"
 #include "utils/checkutils.h"
 #include "utils/foreach.h"
 
@@ -42,6 +43,7 @@
 #include "resources/loaders/imagesetloader.h"
 #include "resources/loaders/xmlloader.h"
 
+#include "resources/sprite/spriteactionid.h"
 #include "resources/sprite/spritereference.h"
 
 #include "debug.h"
@@ -72,6 +74,29 @@ const Action *SpriteDef::getAction(const std::string &action,
     return (*it).second;
 }
 
+const Action *SpriteDef::getAction(const int actionId,
+                                   const unsigned num) const
+{
+    ActionIds::const_iterator i = mActionIds.find(num);
+    if (i == mActionIds.end() && num != 100)
+        i = mActionIds.find(100);
+
+    if (i == mActionIds.end())
+        return nullptr;
+
+    const ActionIdTable &table = (*i).second;
+    if (actionId >= 0 && actionId < CAST_S32(table.size()))
+    {
+        const Action *const action = table[actionId];
+        if (action != nullptr)
+            return action;
+    }
+
+    logger->log("Warning: no action \"%s\" defined!",
+        SpriteActionId::getName(actionId).c_str());
+    return nullptr;
+}
+
 unsigned SpriteDef::findNumber(const unsigned num) const
 {
     unsigned min = 101;
@@ -122,6 +147,7 @@ SpriteDef *SpriteDef::load(const std::string &animationFile,
     def->substituteActions();
     if (settings.fixDeadAnimation)
         def->fixDeadAction();
+    def->buildActionIds();
     if (prot)
     {
         def->incRef();
@@ -201,6 +227,25 @@ void SpriteDef::substituteActions()
     substituteAction(SpriteAction::DEADRIDE, SpriteAction::DEAD);
 }
 
+void SpriteDef::buildActionIds()
+{
+    mActionIds.clear();
+    FOR_EACH (ActionsConstIter, it, mActions)
+    {
+        const ActionMap *const actMap = (*it).second;
+        if (actMap == nullptr)
+            continue;
+        ActionIdTable &table = mActionIds[(*it).first];
+        FOR_EACHP (ActionMap::const_iterator, it2, actMap)
+        {
+            const int id = SpriteActionId::get((*it2).first);
+            if (id >= CAST_S32(table.size()))
+                table.resize(id + 1, nullptr);
+            table[id] = (*it2).second;
+        }
+    }
+}
+
 void SpriteDef::loadSprite(XmlNodeConstPtr spriteNode,
                            const int variant,
                            const std::string &palettes)
@@ -535,6 +580,7 @@ SpriteDef::~SpriteDef()
         delete *i;
 
     mActions.clear();
+    mActionIds.clear();
 
     FOR_EACH (ImageSetIterator, i, mImageSets)
     {
@@ -690,5 +736,10 @@ int SpriteDef::calcMemoryChilds(const int level) const
             sz += action->calcMemory(level + 1);
         }
     }
+    FOR_EACH (ActionIds::const_iterator, it, mActionIds)
+    {
+        sz += static_cast<int>(sizeof(unsigned) +
+            (*it).second.capacity() * sizeof(Action*));
+    }
     return sz;
 }
@@ -25,6 +25,7 @@
 
 #include "enums/resources/spritedirection.h"
 
+#include "utils/vector.h"
 #include "utils/xml.h"
 
 #include <map>
@@ -55,6 +56,12 @@ class SpriteDef final : public Resource
         const Action *getAction(const std::string &action,
                                 const unsigned num) const A_WARN_UNUSED;
 
+        /**
+         * Returns the specified action by interned action id.
+         */
+        const Action *getAction(const int actionId,
+                                const unsigned num) const A_WARN_UNUSED;
+
         unsigned findNumber(const unsigned num) const A_WARN_UNUSED;
 
         /**
@@ -89,6 +96,7 @@ class SpriteDef final : public Resource
             Resource(),
             mImageSets(),
             mActions(),
+            mActionIds(),
             mProcessedFiles()
         { }
 
@@ -149,6 +157,11 @@ class SpriteDef final : public Resource
         void substituteAction(const std::string &restrict complete,
                               const std::string &restrict with);
 
+        /**
+         * Fill actions tables indexed by action ids.
+         */
+        void buildActionIds();
+
         typedef std::map<std::string, ImageSet*> ImageSets;
         typedef ImageSets::iterator ImageSetIterator;
         typedef ImageSets::const_iterator ImageSetCIterator;
@@ -157,9 +170,12 @@ class SpriteDef final : public Resource
         typedef Actions::const_iterator ActionsConstIter;
         typedef Actions::iterator ActionsIter;
         typedef Actions::const_iterator ActionsCIter;
+        typedef STD_VECTOR<const Action*> ActionIdTable;
+        typedef std::map<unsigned, ActionIdTable> ActionIds;
 
         ImageSets mImageSets;
         Actions mActions;
+        ActionIds mActionIds;
         std::set<std::string> mProcessedFiles;
 };
 
@@ -0,0 +1,262 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "configmanager.h"
+#include "dirs.h"
+
+#include "being/compoundcache.h"
+#include "being/compoundsprite.h"
+
+#include "resources/sprite/sprite.h"
+
+#include "debug.h"
+
+namespace
+{
+    // sprite with fixed frame hash, like equipment in same frame
+    class TestSprite final : public Sprite
+    {
+        public:
+            explicit TestSprite(const void *const hash) :
+                Sprite(),
+                mHash(hash)
+            {
+            }
+
+            A_DELETE_COPY(TestSprite)
+
+            bool reset() override final
+            { return false; }
+
+            bool play(const std::string &action A_UNUSED) override final
+            { return false; }
+
+            bool play(const int actionId A_UNUSED) override final
+            { return false; }
+
+            bool update(const int time A_UNUSED) override final
+            { return false; }
+
+            void draw(Graphics *const graphics A_UNUSED,
+                      const int posX A_UNUSED,
+                      const int posY A_UNUSED) const override final
+            { }
+
+            int getWidth() const override final
+            { return 0; }
+
+            int getHeight() const override final
+            { return 0; }
+
+            const Image *getImage() const override final
+            { return nullptr; }
+
+            bool setSpriteDirection(const SpriteDirection::Type
+                                    direction A_UNUSED) override final
+            { return false; }
+
+            unsigned int getCurrentFrame() const override final
+            { return 0; }
+
+            unsigned int getFrameCount() const override final
+            { return 1; }
+
+            const void *getHash() const override final
+            { return mHash; }
+
+            bool updateNumber(const unsigned num A_UNUSED) override final
+            { return false; }
+
+        private:
+            const void *mHash;
+    };
+
+    class TestCompoundSprite final : public CompoundSprite
+    {
+        public:
+            TestCompoundSprite() :
+                CompoundSprite()
+            {
+            }
+
+            A_DELETE_COPY(TestCompoundSprite)
+
+            using CompoundSprite::getCacheKey;
+            using CompoundSprite::updateFromCache;
+            using CompoundSprite::initCurrentCacheItem;
+
+            CompoundItem *getCacheItem() const
+            { return mCacheItem; }
+    };
+
+    const int hashes[6] = { 0, 1, 2, 3, 4, 5 };
+
+    void addSprites(CompoundSprite *const sprite,
+                    const int start)
+    {
+        for (int f = 0; f < 4; f ++)
+            sprite->addSprite(new TestSprite(&hashes[start + f]));
+    }
+
+    VectorPointers makeKey(const int start)
+    {
+        VectorPointers data;
+        for (int f = 0; f < 4; f ++)
+            data.push_back(&hashes[start + f]);
+        return data;
+    }
+}  // namespace
+
+TEST_CASE("CompoundCache", "")
+{
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+    ConfigManager::initConfiguration();
+
+    CompoundCache::clear();
+    CompoundCache::setMaxSize(200);
+    REQUIRE(CompoundCache::size() == 0);
+
+    SECTION("key equality")
+    {
+        const VectorPointers key1 = makeKey(0);
+        const VectorPointers key2 = makeKey(0);
+        const VectorPointers key3 = makeKey(1);
+        REQUIRE(CompoundCache::get(key1) == nullptr);
+
+        CompoundItem *const item1 = CompoundCache::add(key1,
+            nullptr, nullptr, 1, 2);
+        REQUIRE(item1 != nullptr);
+        REQUIRE(item1->refCount == 1);
+        REQUIRE(item1->offsetX == 1);
+        REQUIRE(item1->offsetY == 2);
+
+        // equal content in other vector
+        CompoundItem *const item2 = CompoundCache::get(key2);
+        REQUIRE(item2 == item1);
+        REQUIRE(item1->refCount == 2);
+        REQUIRE(CompoundCache::get(key3) == nullptr);
+
+        // key shorter or longer is different key
+        VectorPointers key4 = key1;
+        key4.push_back(nullptr);
+        REQUIRE(CompoundCache::get(key4) == nullptr);
+        key4.resize(3);
+        REQUIRE(CompoundCache::get(key4) == nullptr);
+
+        // adding same key returns existing item
+        CompoundItem *const item3 = CompoundCache::add(key2,
+            nullptr, nullptr, 5, 6);
+        REQUIRE(item3 == item1);
+        REQUIRE(item1->refCount == 3);
+        REQUIRE(item1->offsetX == 1);
+        REQUIRE(CompoundCache::size() == 1);
+
+        CompoundCache::release(item1);
+        CompoundCache::release(item2);
+        CompoundCache::release(item3);
+        REQUIRE(item1->refCount == 0);
+        REQUIRE(CompoundCache::size() == 1);
+        CompoundCache::clear();
+        REQUIRE(CompoundCache::size() == 0);
+    }
+
+    SECTION("eviction")
+    {
+        CompoundCache::setMaxSize(2);
+        CompoundItem *const item0 = CompoundCache::add(makeKey(0),
+            nullptr, nullptr, 0, 0);
+        CompoundItem *const item1 = CompoundCache::add(makeKey(1),
+            nullptr, nullptr, 0, 0);
+        CompoundItem *const item2 = CompoundCache::add(makeKey(2),
+            nullptr, nullptr, 0, 0);
+        // used items never evicted
+        REQUIRE(CompoundCache::size() == 3);
+
+        CompoundCache::release(item1);
+        REQUIRE(CompoundCache::size() == 2);
+        REQUIRE(CompoundCache::get(makeKey(1)) == nullptr);
+
+        // least recently used unused item evicted first
+        CompoundCache::setMaxSize(3);
+        CompoundItem *const item1b = CompoundCache::add(makeKey(1),
+            nullptr, nullptr, 0, 0);
+        CompoundCache::release(item0);
+        CompoundCache::release(item2);
+        REQUIRE(CompoundCache::get(makeKey(0)) == item0);
+        CompoundCache::release(item0);
+        CompoundCache::setMaxSize(2);
+        REQUIRE(CompoundCache::size() == 2);
+        REQUIRE(CompoundCache::get(makeKey(2)) == nullptr);
+        REQUIRE(CompoundCache::get(makeKey(0)) == item0);
+        CompoundCache::release(item0);
+        CompoundCache::release(item1b);
+
+        CompoundCache::setMaxSize(0);
+        REQUIRE(CompoundCache::size() == 0);
+    }
+
+#ifndef USE_SDL2
+    SECTION("sharing between beings")
+    {
+        TestCompoundSprite *const being1 = new TestCompoundSprite;
+        TestCompoundSprite *const being2 = new TestCompoundSprite;
+        TestCompoundSprite *const being3 = new TestCompoundSprite;
+        // same equipment for first two beings
+        addSprites(being1, 0);
+        addSprites(being2, 0);
+        addSprites(being3, 1);
+
+        VectorPointers data1;
+        VectorPointers data2;
+        being1->getCacheKey(data1);
+        being2->getCacheKey(data2);
+        REQUIRE(data1 == data2);
+        REQUIRE(data1 == makeKey(0));
+
+        REQUIRE(being1->updateFromCache() == false);
+        being1->initCurrentCacheItem();
+        CompoundItem *const item = being1->getCacheItem();
+        REQUIRE(item != nullptr);
+        REQUIRE(item->refCount == 1);
+
+        REQUIRE(being2->updateFromCache() == true);
+        REQUIRE(being2->getCacheItem() == item);
+        REQUIRE(item->refCount == 2);
+
+        REQUIRE(being3->updateFromCache() == false);
+        REQUIRE(being3->getCacheItem() == nullptr);
+        REQUIRE(CompoundCache::size() == 1);
+
+        delete being1;
+        REQUIRE(item->refCount == 1);
+        delete being2;
+        REQUIRE(item->refCount == 0);
+        delete being3;
+        CompoundCache::clear();
+        REQUIRE(CompoundCache::size() == 0);
+    }
+#endif  // USE_SDL2
+
+    CompoundCache::clear();
+    CompoundCache::setMaxSize(200);
+}
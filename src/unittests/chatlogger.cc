@@ -0,0 +1,106 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "chatlogger.h"
+#include "dirs.h"
+#include "settings.h"
+
+#include "fs/mkdir.h"
+
+#include "utils/delete2.h"
+#include "utils/stringutils.h"
+
+#include <cstdio>
+
+#include "debug.h"
+
+TEST_CASE("ChatLogger", "")
+{
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+
+    ChatLogger *logger1 = new ChatLogger;
+    logger1->setBaseLogDir(pathJoin(settings.localDataDir, "unittestlogs"));
+    logger1->setServerName("server");
+    const std::string fileName = pathJoin(logger1->getDir(), "chan.log");
+    ::remove(fileName.c_str());
+
+    SECTION("empty")
+    {
+        std::list<std::string> list;
+        logger1->loadLast("chan", list, 5);
+        REQUIRE(list.empty());
+    }
+
+    SECTION("tail")
+    {
+        for (int f = 0; f < 1000; f ++)
+            logger1->log("chan", strprintf("line %d", f));
+        logger1->log("other", "other line");
+
+        std::list<std::string> list;
+        logger1->loadLast("chan", list, 3);
+        REQUIRE(list.size() == 3);
+        REQUIRE(list.front() == "line 997");
+        REQUIRE(list.back() == "line 999");
+
+        list.clear();
+        list.push_back("old");
+        logger1->loadLast("chan", list, 2000);
+        REQUIRE(list.size() == 1001);
+        REQUIRE(list.front() == "old");
+        REQUIRE(list.back() == "line 999");
+    }
+
+    SECTION("crlf")
+    {
+        REQUIRE(mkdir_r(logger1->getDir().c_str()) == 0);
+        FILE *const file = fopen(fileName.c_str(), "wb");
+        REQUIRE(file != nullptr);
+        fputs("line 1\r\nline 2\r\n", file);
+        fclose(file);
+
+        std::list<std::string> list;
+        logger1->loadLast("chan", list, 5);
+        REQUIRE(list.size() == 2);
+        REQUIRE(list.front() == "line 1");
+        REQUIRE(list.back() == "line 2");
+    }
+
+    SECTION("log after load")
+    {
+        logger1->log("chan", "line 1");
+        std::list<std::string> list;
+        logger1->loadLast("chan", list, 5);
+        REQUIRE(list.size() == 1);
+
+        // writer thread keeps running after load
+        logger1->log("chan", "line 2");
+        list.clear();
+        logger1->loadLast("chan", list, 5);
+        REQUIRE(list.size() == 2);
+        REQUIRE(list.back() == "line 2");
+    }
+
+    delete2(logger1)
+    ::remove(fileName.c_str());
+}
@@ -0,0 +1,156 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "dirs.h"
+#include "settings.h"
+
+#include "fs/hashcache.h"
+#include "fs/mkdir.h"
+
+#include "utils/cast.h"
+#include "utils/stringutils.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "debug.h"
+
+namespace
+{
+    void writeFile(const std::string &fileName,
+                   const std::string &str)
+    {
+        FILE *const file = fopen(fileName.c_str(), "wb");
+        REQUIRE(file != nullptr);
+        fwrite(str.c_str(), 1, str.size(), file);
+        fclose(file);
+    }
+
+    // writes cache with one entry for fileName with changed fields
+    void writeCache(const std::string &fileName,
+                    const unsigned long adler,
+                    const int64_t sizeDelta,
+                    const int64_t mtimeDelta)
+    {
+        struct stat statbuf;
+        REQUIRE(stat(fileName.c_str(), &statbuf) == 0);
+        std::ofstream file;
+        file.open(pathJoin(settings.localDataDir, "hashcache.txt").c_str(),
+            std::ios::out);
+        REQUIRE(file.is_open());
+        file << std::hex << adler << std::dec
+            << " " << static_cast<int64_t>(statbuf.st_size) + sizeDelta
+            << " " << static_cast<int64_t>(statbuf.st_mtime) + mtimeDelta
+            << " " << static_cast<uint64_t>(statbuf.st_ino)
+            << " " << fileName << "\n";
+    }
+}  // namespace
+
+TEST_CASE("HashCache", "")
+{
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+    REQUIRE(mkdir_r(settings.localDataDir.c_str()) == 0);
+
+    const std::string cacheName = pathJoin(settings.localDataDir,
+        "hashcache.txt");
+    const std::string fileName = pathJoin(settings.localDataDir,
+        "hashcache.test");
+    const std::string content = "hash cache test file content";
+    writeFile(fileName, content);
+    const unsigned long adler = adler32(adler32(0L, nullptr, 0),
+        reinterpret_cast<const Bytef*>(content.c_str()),
+        CAST_U32(content.size()));
+    ::remove(cacheName.c_str());
+    HashCache::clear();
+
+    SECTION("calculate and save")
+    {
+        REQUIRE(HashCache::getAdler32(fileName) == adler);
+        HashCache::save();
+        HashCache::clear();
+        std::ifstream file(cacheName.c_str(), std::ios::in);
+        REQUIRE(file.is_open());
+        std::string line;
+        REQUIRE(std::getline(file, line));
+        REQUIRE(line.find(fileName) != std::string::npos);
+        REQUIRE(HashCache::getAdler32(fileName) == adler);
+    }
+
+    SECTION("hit")
+    {
+        // fake checksum returned only if cache used
+        writeCache(fileName, 0x12345, 0, 0);
+        REQUIRE(HashCache::getAdler32(fileName) == 0x12345);
+        StringVect paths;
+        paths.push_back(fileName);
+        HashCache::calcAdler32(paths);
+        REQUIRE(HashCache::getAdler32(fileName) == 0x12345);
+    }
+
+    SECTION("miss on size change")
+    {
+        writeCache(fileName, 0x12345, 1, 0);
+        REQUIRE(HashCache::getAdler32(fileName) == adler);
+    }
+
+    SECTION("miss on mtime change")
+    {
+        writeCache(fileName, 0x12345, 0, 1);
+        REQUIRE(HashCache::getAdler32(fileName) == adler);
+    }
+
+    SECTION("calcAdler32 miss")
+    {
+        writeCache(fileName, 0x12345, 0, -1);
+        StringVect paths;
+        paths.push_back(fileName);
+        HashCache::calcAdler32(paths);
+        REQUIRE(HashCache::getAdler32(fileName) == adler);
+    }
+
+    SECTION("corrupt file")
+    {
+        writeFile(cacheName, "zz broken\n12 abc\n");
+        REQUIRE(HashCache::getAdler32(fileName) == adler);
+        HashCache::save();
+        HashCache::clear();
+        REQUIRE(HashCache::getAdler32(fileName) == adler);
+    }
+
+    SECTION("truncated file")
+    {
+        writeCache(fileName, 0x12345, 0, 0);
+        std::ifstream file(cacheName.c_str(), std::ios::in);
+        std::string line;
+        REQUIRE(std::getline(file, line));
+        file.close();
+        writeFile(cacheName, line.substr(0, line.size() / 2));
+        REQUIRE(HashCache::getAdler32(fileName) == adler);
+    }
+
+    HashCache::clear();
+    ::remove(cacheName.c_str());
+    ::remove(fileName.c_str());
+}
@@ -0,0 +1,128 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "configmanager.h"
+#include "dirs.h"
+#include "settings.h"
+
+#include "fs/mkdir.h"
+
+#include "gui/theme.h"
+
+#include "utils/cast.h"
+#include "utils/stringutils.h"
+
+#include <cstdio>
+
+#include "debug.h"
+
+TEST_CASE("Theme atlas list", "")
+{
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+    ConfigManager::initConfiguration();
+
+    const std::string dir = pathJoin(settings.localDataDir,
+        "unittesttheme");
+    REQUIRE(mkdir_r(dir.c_str()) == 0);
+    const std::string fileName = pathJoin(dir, "list.bin");
+    ::remove(fileName.c_str());
+
+    std::set<std::string> images;
+    images.insert("graphics/gui/button.png");
+    images.insert("graphics/gui/window.png");
+    images.insert("themes/test/graphics/gui/tab.png");
+    StringVect list;
+
+    SECTION("round trip")
+    {
+        REQUIRE(Theme::writeAtlasList(fileName, images));
+        REQUIRE(Theme::readAtlasList(fileName, list));
+        REQUIRE(list.size() == 3);
+        REQUIRE(std::set<std::string>(list.begin(), list.end()) == images);
+
+        std::set<std::string> images2;
+        REQUIRE(Theme::writeAtlasList(fileName, images2));
+        REQUIRE(Theme::readAtlasList(fileName, list));
+        REQUIRE(list.empty());
+    }
+
+    SECTION("missing file")
+    {
+        list.push_back("test");
+        REQUIRE(Theme::readAtlasList(fileName, list) == false);
+        REQUIRE(list.empty());
+    }
+
+    SECTION("broken files")
+    {
+        REQUIRE(Theme::writeAtlasList(fileName, images));
+        FILE *file = fopen(fileName.c_str(), "rb");
+        REQUIRE(file != nullptr);
+        std::string data;
+        int chr;
+        while ((chr = fgetc(file)) != EOF)
+            data.push_back(CAST_8(chr));
+        fclose(file);
+
+        std::string broken;
+        SECTION("truncated")
+        {
+            broken = data.substr(0, data.size() - 3);
+        }
+        SECTION("truncated header")
+        {
+            broken = data.substr(0, 5);
+        }
+        SECTION("bad magic")
+        {
+            broken = data;
+            broken[0] = CAST_8(broken[0] + 1);
+        }
+        SECTION("bad version")
+        {
+            broken = data;
+            broken[4] = CAST_8(broken[4] + 1);
+        }
+        SECTION("bad path size")
+        {
+            broken = data;
+            broken[12] = CAST_8(0xff);
+            broken[13] = CAST_8(0xff);
+        }
+        SECTION("extra data")
+        {
+            broken = data + "x";
+        }
+
+        file = fopen(fileName.c_str(), "wb");
+        REQUIRE(file != nullptr);
+        fwrite(broken.c_str(), 1, broken.size(), file);
+        fclose(file);
+
+        list.push_back("test");
+        REQUIRE(Theme::readAtlasList(fileName, list) == false);
+        REQUIRE(list.empty());
+    }
+
+    ::remove(fileName.c_str());
+}
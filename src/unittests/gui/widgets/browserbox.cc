@@ -38,6 +38,7 @@
 
 #include "utils/delete2.h"
 #include "utils/env.h"
+#include "utils/stringutils.h"
 
 #include "render/sdlgraphics.h"
 
@@ -45,6 +46,40 @@
 
 #include "debug.h"
 
+namespace
+{
+    // compare row and link positions relative to first row
+    void compareLayouts(const BrowserBox *const box1,
+                        const BrowserBox *const box2)
+    {
+        const BrowserBox::RowLayouts &rows1 = box1->getRowLayouts();
+        const BrowserBox::RowLayouts &rows2 = box2->getRowLayouts();
+        const int top1 = box1->getRowsTop();
+        const int top2 = box2->getRowsTop();
+        REQUIRE(rows1.size() == rows2.size());
+        for (size_t f = 0; f < rows1.size(); f ++)
+        {
+            REQUIRE(rows1[f].y - top1 == rows2[f].y - top2);
+            REQUIRE(rows1[f].height == rows2[f].height);
+            REQUIRE(rows1[f].linksCount == rows2[f].linksCount);
+            REQUIRE(rows1[f].parts.size() == rows2[f].parts.size());
+        }
+
+        const BrowserBox::Links &links1 = box1->getLinks();
+        const BrowserBox::Links &links2 = box2->getLinks();
+        REQUIRE(links1.size() == links2.size());
+        for (size_t f = 0; f < links1.size(); f ++)
+        {
+            REQUIRE(links1[f].link == links2[f].link);
+            REQUIRE(links1[f].x1 == links2[f].x1);
+            REQUIRE(links1[f].x2 == links2[f].x2);
+            REQUIRE(links1[f].y1 - top1 == links2[f].y1 - top2);
+            REQUIRE(links1[f].y2 - top1 == links2[f].y2 - top2);
+        }
+        REQUIRE(box1->getHeight() == box2->getHeight());
+    }
+}  // namespace
+
 TEST_CASE("BrowserBox tests", "browserbox")
 {
     setEnv("SDL_VIDEODRIVER", "dummy");
@@ -182,6 +217,86 @@ TEST_CASE("BrowserBox tests", "browserbox")
     row = "##1%%2";
     box->addRow(row, false);
 
+    // incremental layout must match full layout
+    box->clearRows();
+    box->setMaxRow(5);
+    for (int f = 0; f < 20; f ++)
+    {
+        box->addRow(strprintf("##%d@@link%d|row %d@@ long text for wrap",
+            f % 10, f, f), false);
+    }
+    REQUIRE(box->getRows().size() == 5);
+    REQUIRE(box->getRows().front().find("row 15") != std::string::npos);
+    const int height = box->getHeight();
+
+    // same rows without removed rows
+    BrowserBox *const box2 = new BrowserBox(nullptr,
+        Opaque_true,
+        "");
+    box2->setWidth(100);
+    box2->setMaxRow(5);
+    for (int f = 15; f < 20; f ++)
+    {
+        box2->addRow(strprintf("##%d@@link%d|row %d@@ long text for wrap",
+            f % 10, f, f), false);
+    }
+    compareLayouts(box, box2);
+
+    box->updateSize(true);
+    REQUIRE(box->getHeight() == height);
+    compareLayouts(box, box2);
+    box2->updateSize(true);
+    compareLayouts(box, box2);
+    delete box2;
+
+    // rows appended after full layout
+    for (int f = 20; f < 23; f ++)
+    {
+        box->addRow(strprintf("##%d@@link%d|row %d@@ long text for wrap",
+            f % 10, f, f), false);
+    }
+    BrowserBox *const box3 = new BrowserBox(nullptr,
+        Opaque_true,
+        "");
+    box3->setWidth(100);
+    box3->setMaxRow(5);
+    for (int f = 18; f < 23; f ++)
+    {
+        box3->addRow(strprintf("##%d@@link%d|row %d@@ long text for wrap",
+            f % 10, f, f), false);
+    }
+    compareLayouts(box, box3);
+    delete box3;
+
+    // row search by virtual y position
+    const BrowserBox::RowLayouts &rows = box->getRowLayouts();
+    REQUIRE(rows.size() == 5);
+    REQUIRE(box->getRowIndex(-1000) == 0);
+    for (size_t f = 0; f < rows.size(); f ++)
+    {
+        REQUIRE(rows[f].height > 0);
+        REQUIRE(box->getRowIndex(rows[f].y) == f);
+        REQUIRE(box->getRowIndex(rows[f].y + rows[f].height - 1) == f);
+        REQUIRE(box->getRowIndex(rows[f].y + rows[f].height) == f + 1);
+    }
+    REQUIRE(box->getRowIndex(rows.back().y + rows.back().height + 1000) ==
+        rows.size());
+
+    // link search by widget position
+    const BrowserBox::Links &links = box->getLinks();
+    REQUIRE(links.size() == 5);
+    const int top = box->getRowsTop();
+    for (size_t f = 0; f < links.size(); f ++)
+    {
+        const BrowserLink &link = links[f];
+        REQUIRE(box->findLink((link.x1 + link.x2) / 2,
+            (link.y1 + link.y2) / 2 - top) == CAST_S32(f));
+        REQUIRE(box->findLink(link.x2 + 1000,
+            (link.y1 + link.y2) / 2 - top) == -1);
+    }
+    REQUIRE(box->findLink(10, -1000) == -1);
+    REQUIRE(box->findLink(10, box->getHeight() + 1000) == -1);
+
     delete Widget::getGloablFont();
     Widget::setGlobalFont(nullptr);
     delete box;
@@ -0,0 +1,390 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "client.h"
+#include "configuration.h"
+#include "configmanager.h"
+#include "dirs.h"
+#include "graphicsmanager.h"
+
+#include "being/actorsprite.h"
+
+#include "fs/virtfs/fs.h"
+
+#include "gui/gui.h"
+#include "gui/theme.h"
+
+#include "gui/fonts/font.h"
+
+#include "gui/models/extendedlistmodel.h"
+
+#include "gui/widgets/container.h"
+#include "gui/widgets/extendedlistbox.h"
+
+#include "unittests/render/mockgraphics.h"
+
+#include "utils/cast.h"
+#include "utils/delete2.h"
+#include "utils/env.h"
+#include "utils/stringutils.h"
+
+#include "render/sdlgraphics.h"
+
+#include "resources/sdlimagehelper.h"
+
+#include <algorithm>
+
+#include "debug.h"
+
+namespace
+{
+    class TestListModel final : public ExtendedListModel
+    {
+        public:
+            explicit TestListModel(const int size) :
+                ExtendedListModel(),
+                rows(),
+                reads(size, 0)
+            {
+                for (int f = 0; f < size; f ++)
+                    rows.push_back(strprintf("row %d", f));
+            }
+
+            A_DELETE_COPY(TestListModel)
+
+            int getNumberOfElements() override final
+            { return CAST_S32(rows.size()); }
+
+            std::string getElementAt(int i) override final
+            {
+                reads[i] ++;
+                return rows[i];
+            }
+
+            const Image *getImageAt(int i A_UNUSED) override final
+            { return nullptr; }
+
+            int countReads(const int start, const int end) const
+            {
+                int cnt = 0;
+                for (int f = start; f < end; f ++)
+                    cnt += reads[f];
+                return cnt;
+            }
+
+            void resetReads()
+            { std::fill(reads.begin(), reads.end(), 0); }
+
+            STD_VECTOR<std::string> rows;
+            STD_VECTOR<int> reads;
+    };
+
+    class TestListBox final : public ListBox
+    {
+        public:
+            explicit TestListBox(ListModel *const model) :
+                ListBox(nullptr, model, "")
+            {
+            }
+
+            A_DELETE_COPY(TestListBox)
+
+            using ListBox::getVisibleRows;
+    };
+
+    class TestContainer final : public Container
+    {
+        public:
+            TestContainer() :
+                Container(nullptr),
+                mChanges(0)
+            {
+            }
+
+            A_DELETE_COPY(TestContainer)
+
+            void contentChanged() override
+            {
+                mChanges ++;
+                Container::contentChanged();
+            }
+
+            int mChanges;
+    };
+
+    // list scrolled by offset inside 100 pixels high viewport
+    void pushScrollClip(Graphics &graphics,
+                        const int offset)
+    {
+        graphics.pushClipArea(Rect(0, 0, 200, 100));
+        graphics.pushClipArea(Rect(0, -offset, 200, 10000));
+    }
+
+    void popScrollClip(Graphics &graphics)
+    {
+        graphics.popClipArea();
+        graphics.popClipArea();
+    }
+}  // namespace
+
+TEST_CASE("ExtendedListBox", "")
+{
+    setEnv("SDL_VIDEODRIVER", "dummy");
+
+    client = new Client;
+    VirtFs::mountDirSilent("data", Append_false);
+    VirtFs::mountDirSilent("../data", Append_false);
+
+    mainGraphics = new SDLGraphics;
+    imageHelper = new SDLImageHelper;
+
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+
+    ConfigManager::initConfiguration();
+    setConfigDefaults2(config);
+    setBrandingDefaults(branding);
+
+#ifdef USE_SDL2
+    SDLImageHelper::setRenderer(graphicsManager.createRenderer(
+        GraphicsManager::createWindow(640, 480, 0,
+        SDL_WINDOW_SHOWN | SDL_SWSURFACE), SDL_RENDERER_SOFTWARE));
+#else  // USE_SDL2
+
+    GraphicsManager::createWindow(640, 480, 0, SDL_ANYFORMAT | SDL_SWSURFACE);
+#endif  // USE_SDL2
+
+    theme = new Theme;
+    Theme::selectSkin();
+
+    ActorSprite::load();
+    gui = new Gui();
+    gui->postInit(mainGraphics);
+
+    Widget::setGlobalFont(new Font(
+        "fonts/dejavusans.ttf",
+        18,
+        TTF_STYLE_NORMAL));
+
+    MockGraphics *const graphics = new MockGraphics;
+
+    SECTION("getVisibleRows")
+    {
+        TestListModel *const model = new TestListModel(100);
+        TestListBox *const box = new TestListBox(model);
+        int start = -1;
+        int end = -1;
+
+        graphics->pushClipArea(Rect(0, 0, 200, 100));
+        box->getVisibleRows(graphics, 0, 20, start, end);
+        REQUIRE(start == 0);
+        REQUIRE(end == 5);
+        // partially visible row included
+        box->getVisibleRows(graphics, 0, 30, start, end);
+        REQUIRE(start == 0);
+        REQUIRE(end == 4);
+        // rows start after top padding
+        box->getVisibleRows(graphics, 10, 20, start, end);
+        REQUIRE(start == 0);
+        REQUIRE(end == 5);
+        // no row height means all rows
+        box->getVisibleRows(graphics, 0, 0, start, end);
+        REQUIRE(start == 0);
+        REQUIRE(end == 100);
+        graphics->popClipArea();
+
+        pushScrollClip(*graphics, 410);
+        box->getVisibleRows(graphics, 0, 20, start, end);
+        REQUIRE(start == 20);
+        REQUIRE(end == 26);
+        box->getVisibleRows(graphics, 10, 20, start, end);
+        REQUIRE(start == 20);
+        REQUIRE(end == 25);
+        popScrollClip(*graphics);
+
+        // clip after last row
+        pushScrollClip(*graphics, 1990);
+        box->getVisibleRows(graphics, 0, 20, start, end);
+        REQUIRE(start == 99);
+        REQUIRE(end == 100);
+        popScrollClip(*graphics);
+        pushScrollClip(*graphics, 5000);
+        box->getVisibleRows(graphics, 0, 20, start, end);
+        REQUIRE(start == 100);
+        REQUIRE(end == 100);
+        popScrollClip(*graphics);
+
+        delete box;
+        delete model;
+    }
+
+    SECTION("logic changes")
+    {
+        TestListModel *const model = new TestListModel(100);
+        TestContainer *const parent = new TestContainer;
+        TestListBox *const box = new TestListBox(model);
+        parent->setSize(200, 100);
+        parent->add(box);
+        box->setRowHeight(20);
+        box->setWidth(200);
+        box->setPosition(0, -410);
+        box->logic();
+
+        // nothing changed
+        parent->mChanges = 0;
+        box->logic();
+        box->logic();
+        REQUIRE(parent->mChanges == 0);
+
+        // visible row changed
+        model->rows[22] = "changed row";
+        box->logic();
+        REQUIRE(parent->mChanges == 1);
+        box->logic();
+        REQUIRE(parent->mChanges == 1);
+
+        // row outside of parent not drawn
+        model->rows[60] = "changed row";
+        box->logic();
+        REQUIRE(parent->mChanges == 1);
+
+        // rows added
+        model->rows.push_back("row 100");
+        model->reads.push_back(0);
+        box->logic();
+        REQUIRE(parent->mChanges >= 2);
+        parent->mChanges = 0;
+        box->logic();
+        REQUIRE(parent->mChanges == 0);
+
+        // selection changed
+        box->setSelected(21);
+        const int changes = parent->mChanges;
+        REQUIRE(changes > 0);
+        box->logic();
+        box->logic();
+        REQUIRE(parent->mChanges == changes + 1);
+
+        delete parent;
+        delete model;
+    }
+
+    SECTION("ExtendedListBox rows")
+    {
+        TestListModel *const model = new TestListModel(100);
+        ExtendedListBox *const box = new ExtendedListBox(nullptr,
+            model,
+            "",
+            20);
+        box->setWidth(200);
+
+        // first update measures all rows
+        pushScrollClip(*graphics, 410);
+        box->draw(graphics);
+        REQUIRE(model->countReads(0, 100) == 100);
+        const STD_VECTOR<int> &rowsY = box->getRowsY();
+        REQUIRE(rowsY.size() == 100);
+        for (int f = 0; f < 100; f ++)
+            REQUIRE(rowsY[f] == f * 20);
+        REQUIRE(box->getLayoutHeight() == 101 * 20);
+
+        // next frames read rows only up to visible range
+        model->resetReads();
+        box->draw(graphics);
+        REQUIRE(model->countReads(0, 26) == 26);
+        REQUIRE(model->countReads(26, 100) == 0);
+
+        // changed row below clip area not read while draw
+        model->rows[50] = "changed row";
+        model->resetReads();
+        box->draw(graphics);
+        REQUIRE(model->countReads(50, 51) == 0);
+
+        // adjustSize from logic not read rows while layout valid
+        model->resetReads();
+        box->adjustSize();
+        box->adjustSize();
+        REQUIRE(model->countReads(0, 100) == 0);
+
+        // wrapped visible row moves all rows after it
+        std::string longRow;
+        for (int f = 0; f < 20; f ++)
+            longRow.append("long text ");
+        model->rows[5] = longRow;
+        model->resetReads();
+        box->draw(graphics);
+        REQUIRE(model->countReads(0, 100) == 100);
+        for (int f = 0; f < 6; f ++)
+            REQUIRE(rowsY[f] == f * 20);
+        for (int f = 6; f < 100; f ++)
+            REQUIRE(rowsY[f] == (f + 1) * 20);
+        REQUIRE(box->getLayoutHeight() == 102 * 20);
+
+        // added rows laid out at once
+        model->rows.push_back("row 100");
+        model->reads.push_back(0);
+        model->resetReads();
+        box->draw(graphics);
+        REQUIRE(model->countReads(0, 101) == 101);
+        REQUIRE(rowsY.size() == 101);
+        REQUIRE(rowsY[100] == 101 * 20);
+
+        // font change invalidates cache
+        box->setFont(Widget::getGloablFont());
+        model->resetReads();
+        box->draw(graphics);
+        REQUIRE(model->countReads(0, 101) == 101);
+        popScrollClip(*graphics);
+
+        // adjustSize measures all rows once after font change
+        model->resetReads();
+        box->adjustSize();
+        REQUIRE(model->countReads(0, 101) == 101);
+        model->resetReads();
+        box->adjustSize();
+        REQUIRE(model->countReads(0, 101) == 0);
+
+        // and after width or row count change
+        box->setWidth(300);
+        box->adjustSize();
+        REQUIRE(model->countReads(0, 101) == 101);
+        model->rows.pop_back();
+        model->resetReads();
+        box->adjustSize();
+        REQUIRE(model->countReads(0, 100) == 100);
+        REQUIRE(rowsY.size() == 100);
+
+        // selection by mouse use same row positions
+        REQUIRE(box->getSelectionByMouse(rowsY[7] + 12) == 7);
+        REQUIRE(box->getSelectionByMouse(rowsY[5] + 30) == 5);
+
+        delete box;
+        delete model;
+    }
+
+    delete graphics;
+    delete Widget::getGloablFont();
+    Widget::setGlobalFont(nullptr);
+    delete2(client)
+    VirtFs::unmountDirSilent("data");
+    VirtFs::unmountDirSilent("../data");
+}
@@ -0,0 +1,248 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "client.h"
+#include "configuration.h"
+#include "configmanager.h"
+#include "dirs.h"
+#include "graphicsmanager.h"
+
+#include "being/actorsprite.h"
+
+#include "fs/virtfs/fs.h"
+
+#include "gui/gui.h"
+#include "gui/theme.h"
+
+#include "gui/widgets/itemcontainer.h"
+
+#include "render/sdlgraphics.h"
+
+#include "resources/iteminfo.h"
+#include "resources/sdlimagehelper.h"
+
+#include "resources/db/itemdb.h"
+
+#include "resources/inventory/inventory.h"
+
+#include "resources/item/item.h"
+
+#include "utils/env.h"
+
+#include "debug.h"
+
+namespace
+{
+    const int firstId = 900001;
+    const char *const names[] =
+    {
+        "pear",
+        "apple",
+        "melon",
+        "apricot",
+        "cherry",
+        "banana",
+        "grape",
+        "orange"
+    };
+
+    void addItemInfos()
+    {
+        ItemDB::ItemInfos &infos = ItemDB::getItemInfosTest();
+        for (int f = 0; f < 8; f ++)
+        {
+            ItemInfo *const info = new ItemInfo;
+            info->setId(firstId + f);
+            info->setName(names[f]);
+            info->setWeight((f % 3) * 10);
+            info->setType(f % 2 == 0 ?
+                ItemDbType::USABLE : ItemDbType::UNUSABLE);
+            info->addTag(0);
+            infos[firstId + f] = info;
+        }
+    }
+
+    void setItem(Inventory *const inventory,
+                 const int index,
+                 const int id,
+                 const int amount)
+    {
+        inventory->setItem(index,
+            id,
+            ItemType::Etc,
+            amount,
+            0,
+            ItemColor_one,
+            Identified_true,
+            Damaged_false,
+            Favorite_false,
+            Equipm_false,
+            Equipped_false);
+    }
+
+    // compare incremental sorted slots with full rebuild
+    void checkSlots(Inventory *const inventory,
+                    ItemContainer *const container,
+                    const ShowEmptyRows showEmpty,
+                    const int sortType,
+                    const std::string &name)
+    {
+        container->updateMatrix();
+        ItemContainer *const fresh = new ItemContainer(nullptr,
+            inventory,
+            100000,
+            showEmpty,
+            ForceQuantity_false);
+        fresh->setName(name);
+        fresh->setSortType(sortType);
+        REQUIRE(container->getSortedSlots() == fresh->getSortedSlots());
+        delete fresh;
+    }
+}  // namespace
+
+TEST_CASE("ItemContainer sorted slots", "")
+{
+    setEnv("SDL_VIDEODRIVER", "dummy");
+
+    client = new Client;
+    VirtFs::mountDirSilent("data", Append_false);
+    VirtFs::mountDirSilent("../data", Append_false);
+    VirtFs::mountDirSilent("data/test", Append_false);
+    VirtFs::mountDirSilent("../data/test", Append_false);
+
+    mainGraphics = new SDLGraphics;
+    imageHelper = new SDLImageHelper;
+
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+
+    ConfigManager::initConfiguration();
+    setConfigDefaults2(config);
+    setBrandingDefaults(branding);
+    setPathsDefaults(paths);
+    paths.setValue("itemIcons", "");
+
+#ifdef USE_SDL2
+    SDLImageHelper::setRenderer(graphicsManager.createRenderer(
+        GraphicsManager::createWindow(640, 480, 0,
+        SDL_WINDOW_SHOWN | SDL_SWSURFACE), SDL_RENDERER_SOFTWARE));
+#else  // USE_SDL2
+
+    GraphicsManager::createWindow(640, 480, 0, SDL_ANYFORMAT | SDL_SWSURFACE);
+#endif  // USE_SDL2
+
+    theme = new Theme;
+    Theme::selectSkin();
+
+    ActorSprite::load();
+    gui = new Gui();
+    gui->postInit(mainGraphics);
+
+    ItemDB::load();
+    addItemInfos();
+
+    Inventory *const inventory = new Inventory(InventoryType::Inventory, 20);
+    for (int f = 0; f < 10; f ++)
+        setItem(inventory, f, firstId + (f * 3) % 8, 10 - f);
+
+    SECTION("incremental")
+    {
+        for (int empty = 0; empty < 2; empty ++)
+        {
+            const ShowEmptyRows showEmpty = fromBool(empty != 0,
+                ShowEmptyRows);
+            for (int sortType = 0; sortType <= 5; sortType ++)
+            {
+                ItemContainer *const container = new ItemContainer(nullptr,
+                    inventory,
+                    100000,
+                    showEmpty,
+                    ForceQuantity_false);
+                container->setSortType(sortType);
+                checkSlots(inventory, container, showEmpty, sortType, "");
+
+                // amount changes
+                inventory->getItem(2)->setQuantity(50);
+                checkSlots(inventory, container, showEmpty, sortType, "");
+                inventory->getItem(7)->setQuantity(1);
+                inventory->getItem(0)->setQuantity(3);
+                checkSlots(inventory, container, showEmpty, sortType, "");
+
+                // slot moves
+                inventory->moveItem(1, 15);
+                checkSlots(inventory, container, showEmpty, sortType, "");
+                inventory->moveItem(3, 4);
+                checkSlots(inventory, container, showEmpty, sortType, "");
+
+                // removed and added items
+                inventory->removeItemAt(5);
+                checkSlots(inventory, container, showEmpty, sortType, "");
+                setItem(inventory, 5, firstId + 6, 4);
+                checkSlots(inventory, container, showEmpty, sortType, "");
+
+                // filter edits
+                container->setName("ap");
+                checkSlots(inventory, container, showEmpty, sortType, "ap");
+                container->setName("apr");
+                checkSlots(inventory, container, showEmpty, sortType, "apr");
+                container->setName("a");
+                checkSlots(inventory, container, showEmpty, sortType, "a");
+                inventory->getItem(4)->setQuantity(7);
+                checkSlots(inventory, container, showEmpty, sortType, "a");
+                container->setName("");
+                checkSlots(inventory, container, showEmpty, sortType, "");
+
+                delete container;
+            }
+        }
+    }
+
+    SECTION("empty slots last")
+    {
+        inventory->moveItem(0, 12);
+        inventory->moveItem(3, 18);
+        for (int sortType = 1; sortType <= 5; sortType ++)
+        {
+            ItemContainer *const container = new ItemContainer(nullptr,
+                inventory,
+                100000,
+                ShowEmptyRows_true,
+                ForceQuantity_false);
+            container->setSortType(sortType);
+            const STD_VECTOR<int> &slots = container->getSortedSlots();
+            REQUIRE(slots.size() == 20);
+            for (size_t f = 0; f < 10; f ++)
+                REQUIRE(inventory->getItem(slots[f]) != nullptr);
+            for (size_t f = 10; f < 20; f ++)
+                REQUIRE(inventory->getItem(slots[f]) == nullptr);
+
+            inventory->getItem(2)->setQuantity(99);
+            container->updateMatrix();
+            for (size_t f = 10; f < 20; f ++)
+                REQUIRE(inventory->getItem(slots[f]) == nullptr);
+            delete container;
+        }
+    }
+
+    delete inventory;
+    ItemDB::unload();
+}
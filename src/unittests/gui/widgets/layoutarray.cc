@@ -0,0 +1,245 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "enums/gui/layouttype.h"
+
+#include "gui/widgets/layoutarray.h"
+#include "gui/widgets/layoutcell.h"
+#include "gui/widgets/widget.h"
+
+#include "listeners/widgetlistener.h"
+
+#include "utils/delete2.h"
+
+#include "debug.h"
+
+namespace
+{
+    class TestWidget final : public Widget
+    {
+        public:
+            TestWidget(const int width,
+                       const int height) :
+                Widget(nullptr)
+            {
+                setWidth(width);
+                setHeight(height);
+            }
+
+            A_DELETE_COPY(TestWidget)
+
+            void draw(Graphics *const graphics A_UNUSED) override
+            { }
+
+            void safeDraw(Graphics *const graphics A_UNUSED) override
+            { }
+    };
+
+    // changes layout while it reflowed
+    class ResizeListener final : public WidgetListener
+    {
+        public:
+            explicit ResizeListener(LayoutArray *const array0) :
+                WidgetListener(),
+                array(array0),
+                calls(0)
+            {
+            }
+
+            A_DELETE_COPY(ResizeListener)
+
+            void widgetResized(const Event &event A_UNUSED) override final
+            {
+                calls ++;
+                // like window reflowed from resize event
+                array->setColWidth(4, 10 * calls);
+                if (calls == 1)
+                    array->reflow(0, 0, 100, 50);
+            }
+
+            LayoutArray *array;
+            int calls;
+    };
+
+    const int widgetsCount = 5;
+
+    // applies first steps of layout changes
+    void buildLayout(LayoutArray &array,
+                     Widget **const widgets,
+                     const int step)
+    {
+        switch (step)
+        {
+            case 0:
+                array.place(widgets[0], 0, 0, 1, 1);
+                break;
+            case 1:
+                array.place(widgets[1], 1, 0, 1, 1).setPadding(3);
+                break;
+            case 2:
+                array.place(widgets[2], 0, 1, 2, 1);
+                break;
+            case 3:
+                array.place(widgets[3], 2, 0, 1, 1);
+                break;
+            case 4:
+                array.extend(2, 0, 1, 2);
+                break;
+            case 5:
+                array.setColWidth(0, 80);
+                break;
+            case 6:
+                array.setRowHeight(1, 40);
+                break;
+            case 7:
+                array.matchColWidth(0, 1);
+                break;
+            case 8:
+                array.setColWidth(1, LayoutType::SET);
+                break;
+            case 9:
+                array.place(widgets[4], 0, 3, 3, 1);
+                break;
+            case 10:
+                array.setColWidth(0, LayoutType::DEF);
+                break;
+            default:
+                break;
+        }
+    }
+
+    const int stepsCount = 11;
+
+    void compareWidgets(Widget **const widgets1,
+                        Widget **const widgets2)
+    {
+        for (int f = 0; f < widgetsCount; f ++)
+        {
+            const Rect &rect1 = widgets1[f]->getDimension();
+            const Rect &rect2 = widgets2[f]->getDimension();
+            REQUIRE(rect1.x == rect2.x);
+            REQUIRE(rect1.y == rect2.y);
+            REQUIRE(rect1.width == rect2.width);
+            REQUIRE(rect1.height == rect2.height);
+        }
+    }
+
+    void createWidgets(Widget **const widgets)
+    {
+        for (int f = 0; f < widgetsCount; f ++)
+            widgets[f] = new TestWidget(20 + f * 7, 10 + f * 3);
+    }
+
+    void deleteWidgets(Widget **const widgets)
+    {
+        for (int f = 0; f < widgetsCount; f ++)
+            delete2(widgets[f])
+    }
+}  // namespace
+
+TEST_CASE("LayoutArray", "")
+{
+    SECTION("cached and fresh layouts")
+    {
+        Widget *widgets1[widgetsCount];
+        Widget *widgets2[widgetsCount];
+        createWidgets(widgets1);
+
+        // one array changed step by step and reflowed after each change
+        LayoutArray *const cached = new LayoutArray;
+        for (int step = 0; step < stepsCount; step ++)
+        {
+            buildLayout(*cached, widgets1, step);
+            cached->reflow(0, 0, 300, 200);
+            // same size again uses cached sizes
+            cached->reflow(0, 0, 300, 200);
+
+            // place use widget sizes, so fresh array needs new widgets
+            createWidgets(widgets2);
+            LayoutArray *const fresh = new LayoutArray;
+            for (int f = 0; f <= step; f ++)
+                buildLayout(*fresh, widgets2, f);
+            fresh->reflow(0, 0, 300, 200);
+            compareWidgets(widgets1, widgets2);
+
+            // other target size
+            cached->reflow(5, 7, 400, 250);
+            fresh->reflow(5, 7, 400, 250);
+            compareWidgets(widgets1, widgets2);
+            cached->reflow(0, 0, 300, 200);
+            fresh->reflow(0, 0, 300, 200);
+            compareWidgets(widgets1, widgets2);
+            delete fresh;
+            deleteWidgets(widgets2);
+        }
+        delete cached;
+        deleteWidgets(widgets1);
+    }
+
+    SECTION("fill sizes")
+    {
+        Widget *widgets[widgetsCount];
+        createWidgets(widgets);
+        LayoutArray *const array = new LayoutArray;
+        array->place(widgets[0], 0, 0, 1, 1);
+        array->place(widgets[1], 1, 0, 1, 1);
+        array->setColWidth(1, LayoutType::SET);
+        array->reflow(0, 0, 200, 100);
+        // free space given to column with SET width
+        REQUIRE(widgets[0]->getX() == 0);
+        REQUIRE(widgets[0]->getWidth() == 20);
+        REQUIRE(widgets[0]->getHeight() == 13);
+        REQUIRE(widgets[1]->getX() == 24);
+        REQUIRE(widgets[1]->getWidth() == 176);
+
+        array->setColWidth(0, 50);
+        array->reflow(0, 0, 200, 100);
+        REQUIRE(widgets[0]->getWidth() == 50);
+        REQUIRE(widgets[1]->getX() == 54);
+        REQUIRE(widgets[1]->getWidth() == 146);
+        delete array;
+        deleteWidgets(widgets);
+    }
+
+    SECTION("layout changed while reflow")
+    {
+        Widget *widgets[widgetsCount];
+        createWidgets(widgets);
+        LayoutArray *const array = new LayoutArray;
+        array->place(widgets[0], 0, 0, 1, 1);
+        array->place(widgets[1], 1, 1, 1, 1);
+        // reflow will resize first widget and call listener
+        widgets[0]->setWidth(5);
+        ResizeListener listener(array);
+        widgets[0]->addWidgetListener(&listener);
+        array->reflow(0, 0, 200, 100);
+        REQUIRE(listener.calls == 1);
+        REQUIRE(widgets[0]->getWidth() == 20);
+        REQUIRE(widgets[1]->getX() == 24);
+        REQUIRE(widgets[1]->getY() == 14);
+        REQUIRE(widgets[1]->getWidth() == 27);
+        REQUIRE(widgets[1]->getHeight() == 13);
+        widgets[0]->removeWidgetListener(&listener);
+        delete array;
+        deleteWidgets(widgets);
+    }
+}
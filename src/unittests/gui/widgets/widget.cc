@@ -0,0 +1,294 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "logger.h"
+
+#include "gui/widgets/container.h"
+
+#include "utils/cast.h"
+#include "utils/delete2.h"
+#include "utils/foreach.h"
+
+#include <ctime>
+
+#include "debug.h"
+
+namespace
+{
+    class TestWidget final : public Widget
+    {
+        public:
+            TestWidget() :
+                Widget(nullptr)
+            {
+            }
+
+            A_DELETE_COPY(TestWidget)
+
+            void draw(Graphics *const graphics A_UNUSED) override
+            { }
+
+            void safeDraw(Graphics *const graphics A_UNUSED) override
+            { }
+    };
+
+    class TestContainer final : public Container
+    {
+        public:
+            TestContainer() :
+                Container(nullptr),
+                mChanges(0)
+            {
+            }
+
+            A_DELETE_COPY(TestContainer)
+
+            void contentChanged() override
+            {
+                mChanges ++;
+                Container::contentChanged();
+            }
+
+            int mChanges;
+    };
+}  // namespace
+
+TEST_CASE("Widget registry", "")
+{
+    SECTION("handles")
+    {
+        Widget *widget1 = new TestWidget;
+        const WidgetHandle handle1 = widget1->getHandle();
+        REQUIRE(Widget::widgetExists(widget1));
+        REQUIRE(Widget::widgetExists(handle1));
+
+        delete2(widget1)
+        REQUIRE(Widget::widgetExists(handle1) == false);
+
+        // new widget reuses slot but not handle
+        Widget *widget2 = new TestWidget;
+        const WidgetHandle handle2 = widget2->getHandle();
+        REQUIRE(handle2.slot == handle1.slot);
+        REQUIRE(Widget::widgetExists(handle1) == false);
+        REQUIRE(Widget::widgetExists(handle2));
+        delete2(widget2)
+        REQUIRE(Widget::widgetExists(handle2) == false);
+    }
+
+    SECTION("default handle")
+    {
+        Widget *widget1 = new TestWidget;
+        REQUIRE(widget1->getHandle().generation != 0U);
+        REQUIRE(Widget::widgetExists(WidgetHandle()) == false);
+        delete2(widget1)
+        REQUIRE(Widget::widgetExists(WidgetHandle()) == false);
+    }
+
+    SECTION("tree")
+    {
+        Container *const top = new Container(nullptr);
+        STD_VECTOR<WidgetHandle> handles;
+        for (int f = 0; f < 10; f ++)
+        {
+            Container *const container = new Container(nullptr);
+            top->add(container);
+            handles.push_back(container->getHandle());
+            for (int i = 0; i < 10; i ++)
+            {
+                Widget *const widget = new TestWidget;
+                container->add(widget);
+                handles.push_back(widget->getHandle());
+            }
+        }
+        FOR_EACH (STD_VECTOR<WidgetHandle>::const_iterator, it, handles)
+            REQUIRE(Widget::widgetExists(*it));
+        delete top;
+        FOR_EACH (STD_VECTOR<WidgetHandle>::const_iterator, it, handles)
+            REQUIRE(Widget::widgetExists(*it) == false);
+    }
+}
+
+TEST_CASE("Widget contentChanged", "")
+{
+    TestContainer *const top = new TestContainer;
+    Container *const container = new Container(nullptr);
+    top->add(container);
+    Widget *const widget = new TestWidget;
+    container->add(widget);
+    widget->setSize(10, 10);
+
+    SECTION("dimension")
+    {
+        top->mChanges = 0;
+        widget->setSize(10, 10);
+        widget->setPosition(0, 0);
+        REQUIRE(top->mChanges == 0);
+        widget->setSize(20, 10);
+        REQUIRE(top->mChanges == 1);
+        widget->setPosition(5, 0);
+        REQUIRE(top->mChanges == 2);
+    }
+
+    SECTION("state")
+    {
+        top->mChanges = 0;
+        widget->setVisible(Visible_true);
+        widget->setEnabled(true);
+        REQUIRE(top->mChanges == 0);
+        widget->setVisible(Visible_false);
+        REQUIRE(top->mChanges == 1);
+        widget->setEnabled(false);
+        REQUIRE(top->mChanges == 2);
+    }
+
+    SECTION("look")
+    {
+        top->mChanges = 0;
+        widget->setForegroundColor(Color(1, 2, 3, 255));
+        REQUIRE(top->mChanges == 1);
+        widget->setBackgroundColor(Color(1, 2, 3, 255));
+        REQUIRE(top->mChanges == 2);
+        widget->setBaseColor(Color(1, 2, 3, 255));
+        REQUIRE(top->mChanges == 3);
+        widget->setFrameSize(2);
+        REQUIRE(top->mChanges == 4);
+    }
+
+    SECTION("explicit")
+    {
+        top->mChanges = 0;
+        widget->contentChanged();
+        container->contentChanged();
+        REQUIRE(top->mChanges == 2);
+    }
+    delete top;
+}
+
+namespace
+{
+    Widget *findWidgetAt(const STD_VECTOR<Widget*> &widgets,
+                         const int x,
+                         const int y)
+    {
+        for (size_t f = widgets.size(); f > 0; f --)
+        {
+            Widget *const widget = widgets[f - 1];
+            if (widget->isVisible() &&
+                widget->getDimension().isPointInRect(x, y))
+            {
+                return widget;
+            }
+        }
+        return nullptr;
+    }
+}  // namespace
+
+TEST_CASE("Container getWidgetAt", "")
+{
+    Container *const container = new Container(nullptr);
+    container->setSize(400, 400);
+    STD_VECTOR<Widget*> widgets;
+    for (int f = 0; f < 100; f ++)
+    {
+        Widget *const widget = new TestWidget;
+        widget->setPosition((f % 10) * 36, (f / 10) * 36);
+        widget->setSize(32, 32);
+        container->add(widget);
+        widgets.push_back(widget);
+    }
+    // overlapped widgets
+    Widget *const big = new TestWidget;
+    big->setPosition(50, 120);
+    big->setSize(100, 200);
+    container->add(big);
+    widgets.push_back(big);
+
+    SECTION("grid")
+    {
+        for (int y = -5; y < 405; y += 3)
+        {
+            for (int x = -5; x < 405; x += 3)
+            {
+                REQUIRE(container->getWidgetAt(x, y) ==
+                    findWidgetAt(widgets, x, y));
+            }
+        }
+    }
+
+    SECTION("changes")
+    {
+        widgets[5]->setPosition(300, 360);
+        widgets[17]->setVisible(Visible_false);
+        Widget *const top = widgets[44];
+        container->moveToTop(top);
+        widgets.erase(widgets.begin() + 44);
+        widgets.push_back(top);
+        big->setSize(100, 20);
+        for (int y = -5; y < 405; y += 3)
+        {
+            for (int x = -5; x < 405; x += 3)
+            {
+                REQUIRE(container->getWidgetAt(x, y) ==
+                    findWidgetAt(widgets, x, y));
+            }
+        }
+    }
+    delete container;
+}
+
+TEST_CASE("Widget registry benchmark", "[.]")
+{
+    const int count = 50000;
+    const int runs = 5;
+    STD_VECTOR<Widget*> widgets;
+    widgets.reserve(count);
+
+    clock_t start = clock();
+    for (int f = 0; f < runs; f ++)
+    {
+        for (int i = 0; i < count; i ++)
+            widgets.push_back(new TestWidget);
+        FOR_EACH (STD_VECTOR<Widget*>::const_iterator, it, widgets)
+            delete *it;
+        widgets.clear();
+    }
+    const clock_t flat = clock() - start;
+
+    start = clock();
+    for (int f = 0; f < runs; f ++)
+    {
+        Container *const top = new Container(nullptr);
+        for (int i = 0; i < count / 100; i ++)
+        {
+            Container *const container = new Container(nullptr);
+            top->add(container);
+            for (int k = 0; k < 99; k ++)
+                container->add(new TestWidget);
+        }
+        delete top;
+    }
+    const clock_t tree = clock() - start;
+
+    logger->log("widgets flat: %d ms, tree: %d ms",
+        CAST_S32(flat * 1000 / CLOCKS_PER_SEC),
+        CAST_S32(tree * 1000 / CLOCKS_PER_SEC));
+}
@@ -0,0 +1,123 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "dirs.h"
+#include "logger.h"
+#include "settings.h"
+
+#include "utils/delete2.h"
+#include "utils/stringutils.h"
+
+#include <cstdio>
+
+#include "debug.h"
+
+TEST_CASE("Logger", "")
+{
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+
+    const std::string fileName = pathJoin(settings.localDataDir,
+        "unittestlogger.txt");
+    Logger *logger1 = new Logger;
+    logger1->setLogFile(fileName);
+
+    SECTION("flush")
+    {
+        for (int f = 0; f < 500; f ++)
+            logger1->log("line %d", f);
+        logger1->log1("last line");
+        logger1->flush();
+
+        FILE *const file = fopen(fileName.c_str(), "r");
+        REQUIRE(file != nullptr);
+        char buf[1100];
+        int cnt = 0;
+        std::string lastLine;
+        while (fgets(buf, sizeof(buf), file) != nullptr)
+        {
+            lastLine = buf;
+            cnt ++;
+        }
+        fclose(file);
+        REQUIRE(cnt == 501);
+        REQUIRE(lastLine.find("] last line\n") != std::string::npos);
+    }
+
+    SECTION("long line")
+    {
+        logger1->log("%s", std::string(2000, 'a').c_str());
+        logger1->flush();
+
+        FILE *const file = fopen(fileName.c_str(), "r");
+        REQUIRE(file != nullptr);
+        char buf[3000];
+        REQUIRE(fgets(buf, sizeof(buf), file) != nullptr);
+        fclose(file);
+        const std::string line = buf;
+        REQUIRE(line.find("] " + std::string(2000, 'a') + "\n") !=
+            std::string::npos);
+    }
+
+    SECTION("long line1")
+    {
+        logger1->log1(std::string(5000, 'b').c_str());
+        logger1->flush();
+
+        FILE *const file = fopen(fileName.c_str(), "r");
+        REQUIRE(file != nullptr);
+        char buf[6000];
+        REQUIRE(fgets(buf, sizeof(buf), file) != nullptr);
+        fclose(file);
+        const std::string line = buf;
+        REQUIRE(line.find("] " + std::string(5000, 'b') + "\n") !=
+            std::string::npos);
+    }
+
+    SECTION("raw queue")
+    {
+        for (int f = 0; f < 100; f ++)
+            logger1->log("line %d", f);
+        logger1->flush();
+
+        // written lines already removed from queue
+        const std::string rawName = fileName + ".raw";
+        FILE *const rawFile = fopen(rawName.c_str(), "w");
+        REQUIRE(rawFile != nullptr);
+        logger1->writeQueueRaw(fileno(rawFile));
+        REQUIRE(ftell(rawFile) == 0);
+        fclose(rawFile);
+        ::remove(rawName.c_str());
+
+        FILE *const file = fopen(fileName.c_str(), "r");
+        REQUIRE(file != nullptr);
+        char buf[100];
+        int cnt = 0;
+        while (fgets(buf, sizeof(buf), file) != nullptr)
+            cnt ++;
+        fclose(file);
+        REQUIRE(cnt == 100);
+    }
+
+    delete2(logger1)
+    ::remove(fileName.c_str());
+}
@@ -0,0 +1,360 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WIN32
+
+#include "unittests/unittests.h"
+
+#include "configmanager.h"
+#include "configuration.h"
+#include "dirs.h"
+#include "settings.h"
+
+#include "fs/files.h"
+#include "fs/mkdir.h"
+
+#include "net/downloadscheduler.h"
+
+#include "utils/cast.h"
+#include "utils/sdlhelper.h"
+#include "utils/stringutils.h"
+
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "debug.h"
+
+namespace
+{
+    // minimal http server what serves generated files and range requests
+    struct TestServer final
+    {
+        TestServer() :
+            thread(nullptr),
+            sock(-1),
+            port(0),
+            requests(0),
+            rangeRequests(0),
+            stop(false)
+        {
+        }
+
+        A_DELETE_COPY(TestServer)
+
+        SDL_Thread *thread;
+        int sock;
+        int port;
+        volatile int requests;
+        volatile int rangeRequests;
+        volatile bool stop;
+    };
+
+    struct TestState final
+    {
+        TestState() :
+            status(DownloadStatus::Idle),
+            finished(false)
+        {
+        }
+
+        A_DELETE_COPY(TestState)
+
+        volatile DownloadStatusT status;
+        volatile bool finished;
+    };
+
+    std::string getContent(const std::string &name)
+    {
+        std::string str;
+        for (int f = 0; f < 5000; f ++)
+            str.append(strprintf("%s line %d\n", name.c_str(), f));
+        return str;
+    }
+
+    int64_t getAdler(const std::string &str)
+    {
+        return CAST_S64(adler32(adler32(0L, nullptr, 0),
+            reinterpret_cast<const Bytef*>(str.c_str()),
+            CAST_U32(str.size())));
+    }
+
+    std::string readFile(const std::string &fileName)
+    {
+        std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+        std::string str;
+        char buf[4096];
+        while (file.read(buf, sizeof(buf)) || file.gcount() > 0)
+            str.append(buf, CAST_SIZE(file.gcount()));
+        return str;
+    }
+
+    void serveClient(TestServer *const server,
+                     const int client)
+    {
+        std::string request;
+        char buf[1024];
+        while (request.find("\r\n\r\n") == std::string::npos)
+        {
+            const ssize_t sz = recv(client, buf, sizeof(buf), 0);
+            if (sz <= 0)
+                return;
+            request.append(buf, CAST_SIZE(sz));
+        }
+        server->requests = server->requests + 1;
+
+        const size_t nameStart = request.find('/');
+        const size_t nameEnd = request.find(' ', nameStart);
+        if (nameStart == std::string::npos || nameEnd == std::string::npos)
+            return;
+        const std::string content = getContent(
+            request.substr(nameStart + 1, nameEnd - nameStart - 1));
+
+        size_t from = 0;
+        const size_t range = request.find("Range: bytes=");
+        if (range != std::string::npos)
+        {
+            server->rangeRequests = server->rangeRequests + 1;
+            from = CAST_SIZE(atoi(request.c_str() + range + 13));
+        }
+
+        std::string response;
+        if (from > 0 && from < content.size())
+        {
+            response = strprintf("HTTP/1.1 206 Partial Content\r\n"
+                "Content-Range: bytes %u-%u/%u\r\n",
+                CAST_U32(from),
+                CAST_U32(content.size() - 1),
+                CAST_U32(content.size()));
+        }
+        else
+        {
+            from = 0;
+            response = "HTTP/1.1 200 OK\r\n";
+        }
+        response.append(strprintf("Content-Length: %u\r\n"
+            "Connection: close\r\n\r\n",
+            CAST_U32(content.size() - from)));
+        response.append(content.substr(from));
+
+        size_t sent = 0;
+        while (sent < response.size())
+        {
+            const ssize_t sz = send(client,
+                response.c_str() + sent,
+                response.size() - sent,
+                0);
+            if (sz <= 0)
+                return;
+            sent += CAST_SIZE(sz);
+        }
+    }
+
+    int serverThread(void *ptr)
+    {
+        TestServer *const server = static_cast<TestServer*>(ptr);
+        while (!server->stop)
+        {
+            fd_set fds;
+            FD_ZERO(&fds);
+            FD_SET(server->sock, &fds);
+            timeval tv;
+            tv.tv_sec = 0;
+            tv.tv_usec = 50000;
+            if (select(server->sock + 1, &fds, nullptr, nullptr, &tv) <= 0)
+                continue;
+            const int client = accept(server->sock, nullptr, nullptr);
+            if (client < 0)
+                continue;
+            serveClient(server, client);
+            close(client);
+        }
+        return 0;
+    }
+
+    bool startServer(TestServer &server)
+    {
+        server.sock = socket(AF_INET, SOCK_STREAM, 0);
+        if (server.sock < 0)
+            return false;
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t len = sizeof(addr);
+        if (bind(server.sock, reinterpret_cast<sockaddr*>(&addr),
+            sizeof(addr)) != 0 ||
+            listen(server.sock, 16) != 0 ||
+            getsockname(server.sock, reinterpret_cast<sockaddr*>(&addr),
+            &len) != 0)
+        {
+            close(server.sock);
+            return false;
+        }
+        server.port = ntohs(addr.sin_port);
+        server.thread = SDL::createThread(&serverThread,
+            "testhttpserver", &server);
+        return server.thread != nullptr;
+    }
+
+    void stopServer(TestServer &server)
+    {
+        server.stop = true;
+        SDL::WaitThread(server.thread);
+        close(server.sock);
+    }
+
+    int updateFunction(void *ptr,
+                       const DownloadStatusT status,
+                       size_t total A_UNUSED,
+                       const size_t remaining A_UNUSED)
+    {
+        TestState *const state = static_cast<TestState*>(ptr);
+        if (status == DownloadStatus::Complete ||
+            status == DownloadStatus::Error ||
+            status == DownloadStatus::Cancelled ||
+            status == DownloadStatus::ThreadError)
+        {
+            state->status = status;
+            state->finished = true;
+        }
+        return 0;
+    }
+
+    void waitFinish(const TestState &state)
+    {
+        for (int f = 0; f < 1000 && !state.finished; f ++)
+            SDL_Delay(10);
+    }
+}  // namespace
+
+TEST_CASE("DownloadScheduler", "")
+{
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+    ConfigManager::initConfiguration();
+
+    TestServer server;
+    REQUIRE(startServer(server));
+    const std::string url = strprintf("http://127.0.0.1:%d/", server.port);
+    const std::string dir = pathJoin(settings.localDataDir,
+        "unittestdownloads");
+    REQUIRE(mkdir_r(dir.c_str()) == 0);
+
+    SECTION("parallel")
+    {
+        TestState state;
+        Net::DownloadScheduler *const scheduler =
+            new Net::DownloadScheduler(&state, &updateFunction, 3);
+        for (int f = 0; f < 7; f ++)
+        {
+            const std::string name = strprintf("file%d", f);
+            const std::string fileName = pathJoin(dir, name);
+            ::remove(fileName.c_str());
+            ::remove((fileName + ".part").c_str());
+            STD_VECTOR<std::string> urls;
+            urls.push_back(url + name);
+            scheduler->addFile(fileName, getAdler(getContent(name)), urls);
+        }
+        REQUIRE(scheduler->getFilesCount() == 7);
+        REQUIRE(scheduler->start());
+        waitFinish(state);
+        REQUIRE(state.finished);
+        REQUIRE(state.status == DownloadStatus::Complete);
+        REQUIRE(scheduler->getCompletedCount() == 7);
+        delete scheduler;
+
+        REQUIRE(server.requests == 7);
+        REQUIRE(server.rangeRequests == 0);
+        for (int f = 0; f < 7; f ++)
+        {
+            const std::string name = strprintf("file%d", f);
+            const std::string fileName = pathJoin(dir, name);
+            REQUIRE(readFile(fileName) == getContent(name));
+            REQUIRE(Files::existsLocal(fileName + ".part") == false);
+            ::remove(fileName.c_str());
+        }
+    }
+
+    SECTION("resume")
+    {
+        const std::string name = "resume";
+        const std::string content = getContent(name);
+        const std::string fileName = pathJoin(dir, name);
+        ::remove(fileName.c_str());
+        FILE *const file = fopen((fileName + ".part").c_str(), "wb");
+        REQUIRE(file != nullptr);
+        fwrite(content.c_str(), 1, content.size() / 3, file);
+        fclose(file);
+
+        TestState state;
+        Net::DownloadScheduler *const scheduler =
+            new Net::DownloadScheduler(&state, &updateFunction, 2);
+        STD_VECTOR<std::string> urls;
+        urls.push_back(url + name);
+        scheduler->addFile(fileName, getAdler(content), urls);
+        REQUIRE(scheduler->start());
+        waitFinish(state);
+        REQUIRE(state.status == DownloadStatus::Complete);
+        REQUIRE(scheduler->getCompletedCount() == 1);
+        delete scheduler;
+
+        REQUIRE(server.requests == 1);
+        REQUIRE(server.rangeRequests == 1);
+        REQUIRE(readFile(fileName) == content);
+        ::remove(fileName.c_str());
+    }
+
+    SECTION("bad checksum")
+    {
+        const std::string name = "bad";
+        const std::string fileName = pathJoin(dir, name);
+        ::remove(fileName.c_str());
+        ::remove((fileName + ".part").c_str());
+
+        TestState state;
+        Net::DownloadScheduler *const scheduler =
+            new Net::DownloadScheduler(&state, &updateFunction, 2);
+        STD_VECTOR<std::string> urls;
+        urls.push_back(url + name);
+        scheduler->addFile(fileName, 12345, urls);
+        REQUIRE(scheduler->start());
+        waitFinish(state);
+        REQUIRE(state.status == DownloadStatus::Error);
+        REQUIRE(scheduler->getCompletedCount() == 0);
+        delete scheduler;
+
+        // each url tried three times
+        REQUIRE(server.requests == 3);
+        REQUIRE(Files::existsLocal(fileName) == false);
+        REQUIRE(Files::existsLocal(fileName + ".part") == false);
+    }
+
+    stopServer(server);
+}
+
+#endif  // WIN32
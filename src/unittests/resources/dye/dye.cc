@@ -1910,6 +1910,76 @@ TEST_CASE("Dye normalDye 2", "")
     REQUIRE(data[0] == buildHex(0x14, 0x1e, 0x28, 0x60));
 }
 
+TEST_CASE("Dye normalDye 3", "")
+{
+    Dye dye("R:#203040,506070;W:#203040,506070");
+    NormalDyeTable table;
+    dye.fillNormalTable(table, 0xffU, 24U, 16U, 8U);
+    uint32_t data[11];
+    data[0] = buildHex(0x50, 0x00, 0x00, 0x55);
+    data[1] = buildHex(0x50, 0x00, 0x00, 0x00);
+    data[2] = buildHex(0x50, 0x01, 0x00, 0x55);
+    data[3] = buildHex(0x50, 0x50, 0x50, 0x20);
+    data[4] = buildHex(0x00, 0x00, 0x00, 0x55);
+    data[5] = buildHex(0x00, 0x50, 0x00, 0x60);
+    data[6] = buildHex(0x50, 0x00, 0x00, 0x55);
+    data[7] = buildHex(0x10, 0x20, 0x30, 0x40);
+    data[8] = buildHex(0x50, 0x50, 0x50, 0xff);
+    data[9] = buildHex(0x50, 0x00, 0x00, 0x55);
+    data[10] = buildHex(0x80, 0x00, 0x00, 0x01);
+    uint32_t data2[11];
+    uint32_t data3[11];
+    for (int f = 0; f < 11; f ++)
+    {
+        data2[f] = data[f];
+        data3[f] = data[f];
+    }
+    Dye::normalDyeDefault(&data[0], 11, table);
+    REQUIRE(data[0] == buildHex(0x14, 0x1e, 0x28, 0x55));
+    REQUIRE(data[1] == buildHex(0x50, 0x00, 0x00, 0x00));
+    REQUIRE(data[2] == buildHex(0x50, 0x01, 0x00, 0x55));
+    REQUIRE(data[3] == buildHex(0x14, 0x1e, 0x28, 0x20));
+    REQUIRE(data[4] == buildHex(0x00, 0x00, 0x00, 0x55));
+    REQUIRE(data[5] == buildHex(0x00, 0x50, 0x00, 0x60));
+    REQUIRE(data[6] == buildHex(0x14, 0x1e, 0x28, 0x55));
+    REQUIRE(data[7] == buildHex(0x10, 0x20, 0x30, 0x40));
+    REQUIRE(data[8] == buildHex(0x14, 0x1e, 0x28, 0xff));
+    REQUIRE(data[9] == buildHex(0x14, 0x1e, 0x28, 0x55));
+#ifdef SIMD_SUPPORTED
+    Dye::normalDyeSse2(&data2[0], 11, table);
+    Dye::normalDyeAvx2(&data3[0], 11, table);
+    for (int f = 0; f < 11; f ++)
+    {
+        REQUIRE(data2[f] == data[f]);
+        REQUIRE(data3[f] == data[f]);
+    }
+#endif  // SIMD_SUPPORTED
+}
+
+TEST_CASE("Dye normalDye threads", "")
+{
+    Dye dye("R:#203040,506070;G:#706050,302010");
+    NormalDyeTable table;
+    dye.fillNormalTable(table, 0xffU, 24U, 16U, 8U);
+    const int sz = 300000;
+    STD_VECTOR<uint32_t> data;
+    data.resize(sz);
+    for (int f = 0; f < sz; f ++)
+    {
+        const uint32_t val = f & 0xff;
+        if ((f % 3) == 0)
+            data[f] = buildHex(val, 0x00, 0x00, 0x80);
+        else if ((f % 3) == 1)
+            data[f] = buildHex(0x00, val, 0x00, 0x80);
+        else
+            data[f] = buildHex(val, val, 0x10, 0x80);
+    }
+    STD_VECTOR<uint32_t> data2 = data;
+    dye.normalDye(&data[0], sz);
+    Dye::normalDyeDefault(&data2[0], sz, table);
+    REQUIRE(data == data2);
+}
+
 
 #ifdef USE_OPENGL
 TEST_CASE("Dye normalOGLDye 1", "")
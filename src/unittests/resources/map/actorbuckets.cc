@@ -0,0 +1,172 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "resources/map/actorbuckets.h"
+
+#include "utils/foreach.h"
+
+#include "debug.h"
+
+namespace
+{
+    class TestActor final : public Actor
+    {
+        public:
+            TestActor(const int x,
+                      const int y,
+                      const int width) :
+                Actor(),
+                mWidth(width)
+            {
+                mPos = Vector(static_cast<float>(x),
+                    static_cast<float>(y),
+                    0.0F);
+            }
+
+            A_DELETE_COPY(TestActor)
+
+            void draw(Graphics *const graphics A_UNUSED,
+                      const int offsetX A_UNUSED,
+                      const int offsetY A_UNUSED) const override final
+            {
+            }
+
+            int getWidth() const override final
+            { return mWidth; }
+
+            int getHeight() const override final
+            { return mWidth; }
+
+            float getAlpha() const override final
+            { return 1.0F; }
+
+            void setAlpha(float alpha A_UNUSED) override final
+            { }
+
+        private:
+            int mWidth;
+    };
+}  // namespace
+
+TEST_CASE("ActorBuckets", "")
+{
+    TestActor actor1(100, 70, 0);
+    TestActor actor2(200, 10, 0);
+    TestActor actor3(300, 270, 32);
+    TestActor actor4(400, 700, 32);
+    TestActor actor5(5000, 40, 32);
+    Actors actors;
+    actors.push_back(&actor1);
+    actors.push_back(&actor2);
+    actors.push_back(&actor3);
+    actors.push_back(&actor4);
+    actors.push_back(&actor5);
+
+    ActorBuckets buckets;
+    buckets.setView(0, 0, 640, 480);
+
+    SECTION("sort")
+    {
+        buckets.build(actors, 0, 320);
+        const STD_VECTOR<Actor*> &sorted = buckets.getActors();
+        REQUIRE(sorted.size() == 3);
+        REQUIRE(sorted[0] == &actor2);
+        REQUIRE(sorted[1] == &actor1);
+        REQUIRE(sorted[2] == &actor3);
+        REQUIRE(buckets.getCountBefore(-1) == 0);
+        REQUIRE(buckets.getCountBefore(9) == 0);
+        REQUIRE(buckets.getCountBefore(10) == 1);
+        REQUIRE(buckets.getCountBefore(69) == 1);
+        REQUIRE(buckets.getCountBefore(70) == 2);
+        REQUIRE(buckets.getCountBefore(270) == 3);
+        REQUIRE(buckets.getCountBefore(1000) == 3);
+        REQUIRE(buckets.isHidden(&actor5) == true);
+    }
+
+    SECTION("clamp")
+    {
+        buckets.setView(0, 0, 6400, 4800);
+        buckets.build(actors, 32, 64);
+        const STD_VECTOR<Actor*> &sorted = buckets.getActors();
+        REQUIRE(sorted.size() == 5);
+        REQUIRE(sorted[0] == &actor2);
+        REQUIRE(sorted[1] == &actor5);
+        REQUIRE(sorted[4] == &actor4);
+        REQUIRE(buckets.getCountBefore(32) == 1);
+        REQUIRE(buckets.getCountBefore(63) == 2);
+        REQUIRE(buckets.getCountBefore(64) == 5);
+    }
+
+    SECTION("clamp order")
+    {
+        TestActor actor6(600, 5, 0);
+        Actors actors2;
+        actors2.push_back(&actor4);
+        actors2.push_back(&actor3);
+        actors2.push_back(&actor2);
+        actors2.push_back(&actor6);
+        actors2.push_back(&actor5);
+        actors2.push_back(&actor1);
+        buckets.setView(0, 0, 6400, 4800);
+        buckets.build(actors2, 32, 64);
+        const STD_VECTOR<Actor*> &sorted = buckets.getActors();
+        REQUIRE(sorted.size() == 6);
+        REQUIRE(sorted[0] == &actor6);
+        REQUIRE(sorted[1] == &actor2);
+        REQUIRE(sorted[2] == &actor5);
+        REQUIRE(sorted[3] == &actor1);
+        REQUIRE(sorted[4] == &actor3);
+        REQUIRE(sorted[5] == &actor4);
+        REQUIRE(buckets.getCountBefore(32) == 2);
+        REQUIRE(buckets.getCountBefore(63) == 3);
+        REQUIRE(buckets.getCountBefore(64) == 6);
+
+        // all actors in one bucket
+        buckets.build(actors2, 50, 50);
+        REQUIRE(sorted.size() == 6);
+        REQUIRE(sorted[0] == &actor6);
+        REQUIRE(sorted[1] == &actor2);
+        REQUIRE(sorted[2] == &actor5);
+        REQUIRE(sorted[3] == &actor1);
+        REQUIRE(sorted[4] == &actor3);
+        REQUIRE(sorted[5] == &actor4);
+    }
+
+    SECTION("occlusion")
+    {
+        // all tiles opaque except column 15
+        STD_VECTOR<uint64_t> rows(20, ~static_cast<uint64_t>(0U));
+        FOR_EACH (STD_VECTOR<uint64_t>::iterator, it, rows)
+            *it &= ~(static_cast<uint64_t>(1U) << 15);
+        buckets.setOccluders(&rows[0], 1, 64, 20);
+        REQUIRE(buckets.isHidden(&actor1) == false);
+        REQUIRE(buckets.isHidden(&actor3) == true);
+        REQUIRE(buckets.isHidden(&actor4) == true);
+        buckets.build(actors, 0, 320);
+        REQUIRE(buckets.getActors().size() == 2);
+
+        TestActor actor6(480, 200, 32);
+        REQUIRE(buckets.isHidden(&actor6) == false);
+        buckets.setOccluders(nullptr, 0, 0, 0);
+        REQUIRE(buckets.isHidden(&actor3) == false);
+    }
+}
@@ -0,0 +1,192 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "enums/resources/map/blockmask.h"
+
+#include "resources/map/blockmaskplanes.h"
+
+#include "utils/cpu.h"
+
+#include "debug.h"
+
+TEST_CASE("BlockMaskPlanes", "")
+{
+    BlockMaskPlanes planes(130, 5);
+    const unsigned char walkMask = BlockMask::WALL | BlockMask::WATER;
+    REQUIRE(planes.getStride() == 3);
+
+    SECTION("masks")
+    {
+        planes.addMask(64, 2, BlockMask::WALL);
+        planes.addMask(64, 2, BlockMask::AIR);
+        REQUIRE(planes.isBlocked(64, 2, BlockMask::WALL) == true);
+        REQUIRE(planes.isBlocked(64, 2, BlockMask::AIR) == true);
+        REQUIRE(planes.isBlocked(64, 2, BlockMask::WATER) == false);
+        REQUIRE(planes.isBlocked(63, 2, walkMask) == false);
+        REQUIRE(planes.isBlocked(-1, 2, 0) == true);
+        REQUIRE(planes.isBlocked(130, 2, 0) == true);
+
+        planes.setMask(64, 2, BlockMask::WATER);
+        REQUIRE(planes.isBlocked(64, 2, BlockMask::WALL) == false);
+        REQUIRE(planes.isBlocked(64, 2, BlockMask::AIR) == false);
+        REQUIRE(planes.isBlocked(64, 2, BlockMask::WATER) == true);
+        REQUIRE(planes.getRow(BlockMask::WATER, 2)[1] == 1U);
+
+        unsigned char masks[130 * 5] = { 0 };
+        masks[129 + 130 * 4] = BlockMask::GROUND;
+        planes.setMasks(masks);
+        REQUIRE(planes.isBlocked(64, 2, BlockMask::WATER) == false);
+        REQUIRE(planes.isBlocked(129, 4, BlockMask::GROUND) == true);
+    }
+
+    SECTION("anyBlocked")
+    {
+        REQUIRE(planes.anyBlocked(0, 0, 129, 4, walkMask) == false);
+        REQUIRE(planes.anyBlocked(0, 0, 130, 4, walkMask) == true);
+        planes.addMask(100, 3, BlockMask::WATER);
+        planes.addMask(5, 1, BlockMask::AIR);
+        REQUIRE(planes.anyBlocked(0, 0, 129, 4, walkMask) == true);
+        REQUIRE(planes.anyBlocked(0, 0, 129, 2, walkMask) == false);
+        REQUIRE(planes.anyBlocked(101, 0, 129, 4, walkMask) == false);
+        REQUIRE(planes.anyBlocked(100, 3, 100, 3, walkMask) == true);
+        REQUIRE(planes.anyBlocked(129, 4, 0, 3, walkMask) == true);
+        REQUIRE(planes.anyBlocked(0, 0, 10, 4, BlockMask::AIR) == true);
+    }
+
+    SECTION("lineOfSight")
+    {
+        planes.addMask(70, 2, BlockMask::WALL);
+        REQUIRE(planes.lineOfSight(60, 2, 80, 2, walkMask) == false);
+        REQUIRE(planes.lineOfSight(60, 2, 70, 2, walkMask) == true);
+        REQUIRE(planes.lineOfSight(60, 1, 80, 1, walkMask) == true);
+        REQUIRE(planes.lineOfSight(70, 0, 70, 4, walkMask) == false);
+        REQUIRE(planes.lineOfSight(68, 0, 72, 4, walkMask) == false);
+        REQUIRE(planes.lineOfSight(68, 4, 72, 3, walkMask) == true);
+        REQUIRE(planes.lineOfSight(68, 0, 72, 4, BlockMask::AIR) == true);
+        REQUIRE(planes.lineOfSight(0, 0, 130, 0, walkMask) == false);
+    }
+
+    SECTION("lineOfSight corners")
+    {
+        planes.addMask(11, 1, BlockMask::WALL);
+        REQUIRE(planes.lineOfSight(10, 1, 11, 2, walkMask) == false);
+        REQUIRE(planes.lineOfSight(10, 2, 11, 1, walkMask) == true);
+        REQUIRE(planes.lineOfSight(10, 0, 12, 2, walkMask) == false);
+        REQUIRE(planes.lineOfSight(12, 0, 10, 2, walkMask) == false);
+        REQUIRE(planes.lineOfSight(10, 0, 13, 1, walkMask) == false);
+        REQUIRE(planes.lineOfSight(10, 2, 13, 3, walkMask) == true);
+        REQUIRE(planes.lineOfSight(10, 1, 11, 2, BlockMask::AIR) == true);
+    }
+
+    SECTION("combineRows")
+    {
+        planes.addMask(1, 0, BlockMask::WALL);
+        planes.addMask(65, 1, BlockMask::WATER);
+        planes.addMask(2, 0, BlockMask::AIR);
+        STD_VECTOR<uint64_t> rows;
+        planes.combineRows(walkMask, rows);
+        REQUIRE(rows.size() == 15);
+        REQUIRE(rows[0] == 2U);
+        REQUIRE(rows[4] == 2U);
+        REQUIRE(rows[2] == ~static_cast<uint64_t>(3U));
+        REQUIRE(BlockMaskPlanes::findBit(&rows[0], 0, 130, true) == 1);
+        REQUIRE(BlockMaskPlanes::findBit(&rows[0], 2, 130, true) == 130);
+        REQUIRE(BlockMaskPlanes::findBit(&rows[0], 2, 300, true) == 130);
+        REQUIRE(BlockMaskPlanes::findBit(&rows[0], 1, 130, false) == 2);
+        REQUIRE(BlockMaskPlanes::findBit(&rows[3], 0, 130, false) == 0);
+        REQUIRE(BlockMaskPlanes::findBit(&rows[3], 64, 130, false) == 64);
+        REQUIRE(BlockMaskPlanes::findBit(&rows[3], 65, 130, false) == 66);
+        REQUIRE(BlockMaskPlanes::findBitBack(&rows[0], 129, true) == 1);
+        REQUIRE(BlockMaskPlanes::findBitBack(&rows[0], 0, true) == -1);
+        REQUIRE(BlockMaskPlanes::findBitBack(&rows[3], 100, true) == 65);
+        REQUIRE(BlockMaskPlanes::findBitBack(&rows[3], 65, false) == 64);
+    }
+}
+
+TEST_CASE("BlockMaskPlanes fillAreas", "")
+{
+    BlockMaskPlanes planes(70, 3);
+    for (int y = 0; y < 3; y ++)
+    {
+        planes.addMask(10, y, BlockMask::WALL);
+        planes.addMask(60, y, BlockMask::WALL);
+        planes.addMask(61, y, BlockMask::WATER);
+        planes.addMask(62, y, BlockMask::WALL);
+    }
+    planes.addMask(30, 1, BlockMask::WALL);
+    planes.addMask(40, 1, BlockMask::AIR);
+
+    STD_VECTOR<uint64_t> rows;
+    planes.combineRows(BlockMask::WALL | BlockMask::WATER, rows);
+    STD_VECTOR<int> data(70 * 3, 0);
+    BlockMaskPlanes::fillAreas(&rows[0], 70, 3, &data[0]);
+
+    for (int y = 0; y < 3; y ++)
+    {
+        const int *const row = &data[y * 70];
+        REQUIRE(row[0] == 1);
+        REQUIRE(row[9] == 1);
+        REQUIRE(row[10] == -1);
+        REQUIRE(row[11] == 2);
+        REQUIRE(row[40] == 2);
+        REQUIRE(row[59] == 2);
+        REQUIRE(row[60] == -2);
+        REQUIRE(row[61] == 0);
+        REQUIRE(row[62] == -3);
+        REQUIRE(row[63] == 3);
+        REQUIRE(row[69] == 3);
+    }
+    REQUIRE(data[70 + 30] == -2);
+    REQUIRE(data[70 + 31] == 2);
+}
+
+TEST_CASE("BlockMaskPlanes anyWords", "")
+{
+    uint64_t words[11] = { 0U };
+    for (size_t count = 0; count <= 11; count ++)
+        REQUIRE(BlockMaskPlanes::anyWordsDefault(words, count) == false);
+    for (size_t pos = 0; pos < 11; pos ++)
+    {
+        words[pos] = static_cast<uint64_t>(1U) << 63;
+        REQUIRE(BlockMaskPlanes::anyWordsDefault(words, pos) == false);
+        REQUIRE(BlockMaskPlanes::anyWordsDefault(words, pos + 1) == true);
+        REQUIRE(BlockMaskPlanes::anyWordsDefault(words, 11) == true);
+        words[pos] = 0U;
+    }
+
+#ifdef SIMD_SUPPORTED
+    Cpu::detect();
+    if ((Cpu::getFlags() & Cpu::FEATURE_AVX2) != 0U)
+    {
+        for (size_t count = 0; count <= 11; count ++)
+            REQUIRE(BlockMaskPlanes::anyWordsAvx2(words, count) == false);
+        for (size_t pos = 0; pos < 11; pos ++)
+        {
+            words[pos] = static_cast<uint64_t>(1U) << 63;
+            REQUIRE(BlockMaskPlanes::anyWordsAvx2(words, pos) == false);
+            REQUIRE(BlockMaskPlanes::anyWordsAvx2(words, pos + 1) == true);
+            REQUIRE(BlockMaskPlanes::anyWordsAvx2(words, 11) == true);
+            words[pos] = 0U;
+        }
+    }
+#endif  // SIMD_SUPPORTED
+}
@@ -0,0 +1,122 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "dirs.h"
+#include "settings.h"
+
+#include "resources/map/mapcache.h"
+#include "resources/map/metatile.h"
+#include "resources/map/walklayer.h"
+
+#include "utils/cast.h"
+#include "utils/delete2.h"
+#include "utils/stringutils.h"
+
+#include <cstdio>
+
+#include "debug.h"
+
+TEST_CASE("MapCache", "")
+{
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+
+    const std::string fileName = pathJoin(pathJoin(settings.localDataDir,
+        "mapcache"), "unittest.tmx.bin");
+    ::remove(fileName.c_str());
+
+    const int gids1[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+    const int gids2[] = { 20, 21, 22 };
+    MetaTile tiles[12];
+    for (int f = 0; f < 12; f ++)
+        tiles[f].blockmask = CAST_U8(f * 3);
+    WalkLayer *walkLayer = new WalkLayer(4, 3);
+    for (int f = 0; f < 12; f ++)
+        walkLayer->getData()[f] = f - 6;
+    STD_VECTOR<Tileset*> tilesets;
+
+    MapCache *cache = new MapCache("unittest.tmx", 12345, 4, 3);
+    REQUIRE(cache->load() == false);
+    REQUIRE(cache->isLoaded() == false);
+    cache->addLayer(4, 3, gids1, 12, true);
+    cache->addLayer(4, 3, gids2, 3, false);
+    cache->addLayer(4, 3, nullptr, 0, true);
+    cache->setTilesets(tilesets);
+    cache->setBlockMasks(tiles);
+    cache->setWalkData(walkLayer);
+    REQUIRE(cache->save() == true);
+    delete2(cache)
+    delete2(walkLayer)
+
+    SECTION("load")
+    {
+        cache = new MapCache("unittest.tmx", 12345, 4, 3);
+        REQUIRE(cache->load() == true);
+        REQUIRE(cache->isLoaded() == true);
+        REQUIRE(cache->checkTilesets(tilesets) == true);
+
+        MapCacheLayer layer;
+        REQUIRE(cache->getLayer(0, layer) == true);
+        REQUIRE(layer.width == 4);
+        REQUIRE(layer.height == 3);
+        REQUIRE(layer.count == 12);
+        REQUIRE(layer.decoded == true);
+        for (int f = 0; f < 12; f ++)
+            REQUIRE(layer.gids[f] == gids1[f]);
+
+        REQUIRE(cache->getLayer(1, layer) == true);
+        REQUIRE(layer.count == 3);
+        REQUIRE(layer.decoded == false);
+        for (int f = 0; f < 3; f ++)
+            REQUIRE(layer.gids[f] == gids2[f]);
+
+        REQUIRE(cache->getLayer(2, layer) == true);
+        REQUIRE(layer.count == 0);
+        REQUIRE(layer.decoded == true);
+        REQUIRE(cache->getLayer(3, layer) == false);
+
+        const unsigned char *const masks = cache->getBlockMasks();
+        REQUIRE(masks != nullptr);
+        for (int f = 0; f < 12; f ++)
+            REQUIRE(masks[f] == f * 3);
+
+        const int *const walk = cache->getWalkData();
+        REQUIRE(walk != nullptr);
+        for (int f = 0; f < 12; f ++)
+            REQUIRE(walk[f] == f - 6);
+        delete2(cache)
+    }
+
+    SECTION("outdated")
+    {
+        cache = new MapCache("unittest.tmx", 12346, 4, 3);
+        REQUIRE(cache->load() == false);
+        REQUIRE(cache->getBlockMasks() == nullptr);
+        delete2(cache)
+
+        cache = new MapCache("unittest.tmx", 12345, 3, 4);
+        REQUIRE(cache->load() == false);
+        delete2(cache)
+    }
+
+    ::remove(fileName.c_str());
+}
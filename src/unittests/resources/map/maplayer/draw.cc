@@ -56,7 +56,8 @@ TEST_CASE("MapLayer draw", "")
             1, 1,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         map->addLayer(layer);
         layer->updateCache(1, 1);
@@ -104,7 +105,8 @@ TEST_CASE("MapLayer draw", "")
             2, 1,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         map->addLayer(layer);
         layer->updateCache(2, 1);
@@ -153,7 +155,8 @@ TEST_CASE("MapLayer draw", "")
             2, 1,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img2);
         map->addLayer(layer);
@@ -199,7 +202,8 @@ TEST_CASE("MapLayer draw", "")
             2, 1,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         map->addLayer(layer);
@@ -241,7 +245,8 @@ TEST_CASE("MapLayer draw", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         layer->setTile(2, 0, img1);
         map->addLayer(layer);
@@ -287,7 +292,8 @@ TEST_CASE("MapLayer draw", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         map->addLayer(layer);
@@ -329,7 +335,8 @@ TEST_CASE("MapLayer draw", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         layer->setTile(2, 0, img2);
@@ -380,7 +387,8 @@ TEST_CASE("MapLayer draw", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         layer->setTile(2, 0, img2);
@@ -431,7 +439,8 @@ TEST_CASE("MapLayer draw", "")
             maxX, maxY,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(1, 10, img1);
         layer->setTile(2, 10, img1);
         layer->setTile(3, 10, img1);
@@ -538,7 +547,8 @@ TEST_CASE("MapLayer draw", "")
             maxX, maxY,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         TileInfo *const tiles = layer->getTiles();
         map->addLayer(layer);
         for (int x = 0; x < maxX; x ++)
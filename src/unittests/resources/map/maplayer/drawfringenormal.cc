@@ -44,6 +44,7 @@
 
 #include "resources/image/image.h"
 
+#include "resources/map/actorbuckets.h"
 #include "resources/map/map.h"
 #include "resources/map/maplayer.h"
 #include "resources/map/speciallayer.h"
@@ -86,7 +87,7 @@ TEST_CASE("MapLayer drawFringe normal", "")
     Map *map = nullptr;
     MapLayer *layer = nullptr;
     MockGraphics *const mock = new MockGraphics;
-    const Actors actors;
+    const ActorBuckets actors;
 
     SECTION("normal 1")
     {
@@ -100,7 +101,8 @@ TEST_CASE("MapLayer drawFringe normal", "")
             maxX, maxY,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(1, 10, img1);
         layer->setTile(2, 10, img1);
         layer->setTile(3, 10, img1);
@@ -211,7 +213,8 @@ TEST_CASE("MapLayer drawFringe normal", "")
             maxX, maxY,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         TileInfo *const tiles = layer->getTiles();
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
@@ -261,7 +264,8 @@ TEST_CASE("MapLayer drawFringe normal", "")
             maxX, maxY,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(1, 10, img1);
         layer->setTile(2, 10, img1);
         layer->setTile(3, 10, img1);
@@ -393,7 +397,8 @@ TEST_CASE("MapLayer drawFringe normal", "")
             maxX, maxY,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(1, 10, img1);
         layer->setTile(2, 10, img1);
         layer->setTile(3, 10, img1);
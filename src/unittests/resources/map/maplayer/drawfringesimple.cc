@@ -42,6 +42,7 @@
 
 #include "resources/image/image.h"
 
+#include "resources/map/actorbuckets.h"
 #include "resources/map/map.h"
 #include "resources/map/maplayer.h"
 
@@ -83,7 +84,7 @@ TEST_CASE("MapLayer drawFringe simple", "")
     Map *map = nullptr;
     MapLayer *layer = nullptr;
     MockGraphics *const mock = new MockGraphics;
-    const Actors actors;
+    const ActorBuckets actors;
 
     SECTION("simple 1")
     {
@@ -95,7 +96,8 @@ TEST_CASE("MapLayer drawFringe simple", "")
             1, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
@@ -148,7 +150,8 @@ TEST_CASE("MapLayer drawFringe simple", "")
             2, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
@@ -202,7 +205,8 @@ TEST_CASE("MapLayer drawFringe simple", "")
             2, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img2);
         map->addLayer(layer);
@@ -252,7 +256,8 @@ TEST_CASE("MapLayer drawFringe simple", "")
             2, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         map->addLayer(layer);
@@ -298,7 +303,8 @@ TEST_CASE("MapLayer drawFringe simple", "")
             3, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         layer->setTile(2, 0, img1);
         map->addLayer(layer);
@@ -348,7 +354,8 @@ TEST_CASE("MapLayer drawFringe simple", "")
             3, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         map->addLayer(layer);
@@ -394,7 +401,8 @@ TEST_CASE("MapLayer drawFringe simple", "")
             3, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         layer->setTile(2, 0, img2);
@@ -449,7 +457,8 @@ TEST_CASE("MapLayer drawFringe simple", "")
             3, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         layer->setTile(2, 0, img2);
@@ -83,7 +83,8 @@ TEST_CASE("MapLayer drawSpecialLayer (specialLayer)", "")
             1, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -113,7 +114,8 @@ TEST_CASE("MapLayer drawSpecialLayer (specialLayer)", "")
             1, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -141,7 +143,8 @@ TEST_CASE("MapLayer drawSpecialLayer (specialLayer)", "")
             2, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -169,7 +172,8 @@ TEST_CASE("MapLayer drawSpecialLayer (specialLayer)", "")
             2, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -197,7 +201,8 @@ TEST_CASE("MapLayer drawSpecialLayer (specialLayer)", "")
             2, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -229,7 +234,8 @@ TEST_CASE("MapLayer drawSpecialLayer (specialLayer)", "")
             3, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -261,7 +267,8 @@ TEST_CASE("MapLayer drawSpecialLayer (specialLayer)", "")
             3, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -293,7 +300,8 @@ TEST_CASE("MapLayer drawSpecialLayer (specialLayer)", "")
             3, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -331,7 +339,8 @@ TEST_CASE("MapLayer drawSpecialLayer (specialLayer)", "")
             maxX, maxY,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -83,7 +83,8 @@ TEST_CASE("MapLayer drawSpecialLayer (tempLayer)", "")
             1, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -113,7 +114,8 @@ TEST_CASE("MapLayer drawSpecialLayer (tempLayer)", "")
             1, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -141,7 +143,8 @@ TEST_CASE("MapLayer drawSpecialLayer (tempLayer)", "")
             2, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -169,7 +172,8 @@ TEST_CASE("MapLayer drawSpecialLayer (tempLayer)", "")
             2, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -203,7 +207,8 @@ TEST_CASE("MapLayer drawSpecialLayer (tempLayer)", "")
             2, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -235,7 +240,8 @@ TEST_CASE("MapLayer drawSpecialLayer (tempLayer)", "")
             3, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -267,7 +273,8 @@ TEST_CASE("MapLayer drawSpecialLayer (tempLayer)", "")
             3, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -299,7 +306,8 @@ TEST_CASE("MapLayer drawSpecialLayer (tempLayer)", "")
             3, 1,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -337,7 +345,8 @@ TEST_CASE("MapLayer drawSpecialLayer (tempLayer)", "")
             maxX, maxY,
             true,
             0,
-            0);
+            0,
+            map->getTileTable());
         map->addLayer(layer);
         layer->setSpecialLayer(map->getSpecialLayer());
         layer->setTempLayer(map->getTempLayer());
@@ -49,7 +49,8 @@ TEST_CASE("MapLayer getEmptyTileDrawWidth", "")
             2, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         TileInfo *const tiles = layer->getTiles();
         REQUIRE(layer->getEmptyTileDrawWidth(tiles + 1,
@@ -65,7 +66,8 @@ TEST_CASE("MapLayer getEmptyTileDrawWidth", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(2, 0, img1);
         TileInfo *const tiles = layer->getTiles();
@@ -82,7 +84,8 @@ TEST_CASE("MapLayer getEmptyTileDrawWidth", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         TileInfo *const tiles = layer->getTiles();
@@ -99,7 +102,8 @@ TEST_CASE("MapLayer getEmptyTileDrawWidth", "")
             100, 100,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(1, 10, img1);
         layer->setTile(2, 10, img1);
         layer->setTile(3, 10, img1);
@@ -50,7 +50,8 @@ TEST_CASE("MapLayer getTileDrawWidth", "")
             1, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         TileInfo *const tiles = layer->getTiles();
         REQUIRE(layer->getTileDrawWidth(tiles,
@@ -68,7 +69,8 @@ TEST_CASE("MapLayer getTileDrawWidth", "")
             2, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         TileInfo *const tiles = layer->getTiles();
         REQUIRE(layer->getTileDrawWidth(tiles,
@@ -86,7 +88,8 @@ TEST_CASE("MapLayer getTileDrawWidth", "")
             2, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img2);
         TileInfo *const tiles = layer->getTiles();
@@ -112,7 +115,8 @@ TEST_CASE("MapLayer getTileDrawWidth", "")
             2, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         TileInfo *const tiles = layer->getTiles();
@@ -138,7 +142,8 @@ TEST_CASE("MapLayer getTileDrawWidth", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(2, 0, img1);
         TileInfo *const tiles = layer->getTiles();
@@ -164,7 +169,8 @@ TEST_CASE("MapLayer getTileDrawWidth", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         TileInfo *const tiles = layer->getTiles();
@@ -190,7 +196,8 @@ TEST_CASE("MapLayer getTileDrawWidth", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         layer->setTile(2, 0, img2);
@@ -224,7 +231,8 @@ TEST_CASE("MapLayer getTileDrawWidth", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         layer->setTile(2, 0, img2);
@@ -259,7 +267,8 @@ TEST_CASE("MapLayer getTileDrawWidth", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         layer->setTile(2, 0, img2);
@@ -294,7 +303,8 @@ TEST_CASE("MapLayer getTileDrawWidth", "")
             100, 100,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(1, 10, img1);
         layer->setTile(2, 10, img1);
         layer->setTile(3, 10, img1);
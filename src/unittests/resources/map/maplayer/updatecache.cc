@@ -48,7 +48,8 @@ TEST_CASE("MapLayer updateCache", "")
             1, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         TileInfo *const tiles = layer->getTiles();
         layer->updateCache(1, 1);
@@ -65,7 +66,8 @@ TEST_CASE("MapLayer updateCache", "")
             2, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         TileInfo *const tiles = layer->getTiles();
         layer->updateCache(2, 1);
@@ -86,7 +88,8 @@ TEST_CASE("MapLayer updateCache", "")
             2, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img2);
         TileInfo *const tiles = layer->getTiles();
@@ -108,7 +111,8 @@ TEST_CASE("MapLayer updateCache", "")
             2, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         TileInfo *const tiles = layer->getTiles();
@@ -130,7 +134,8 @@ TEST_CASE("MapLayer updateCache", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(2, 0, img1);
         TileInfo *const tiles = layer->getTiles();
@@ -156,7 +161,8 @@ TEST_CASE("MapLayer updateCache", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         TileInfo *const tiles = layer->getTiles();
@@ -182,7 +188,8 @@ TEST_CASE("MapLayer updateCache", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         layer->setTile(2, 0, img2);
@@ -209,7 +216,8 @@ TEST_CASE("MapLayer updateCache", "")
             3, 1,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(0, 0, img1);
         layer->setTile(1, 0, img1);
         layer->setTile(2, 0, img2);
@@ -237,7 +245,8 @@ TEST_CASE("MapLayer updateCache", "")
             100, 100,
             false,
             0,
-            0);
+            0,
+            nullptr);
         layer->setTile(1, 10, img1);
         layer->setTile(2, 10, img1);
         layer->setTile(3, 10, img1);
@@ -368,7 +377,8 @@ TEST_CASE("MapLayer updateCache", "")
             maxX, maxY,
             false,
             0,
-            0);
+            0,
+            nullptr);
         TileInfo *const tiles = layer->getTiles();
         for (int x = 0; x < maxX; x ++)
         {
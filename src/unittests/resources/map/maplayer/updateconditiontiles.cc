@@ -53,7 +53,8 @@ TEST_CASE("MapLayer updateConditionTiles", "")
             1, 1,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(0, 0, img1);
         map->addLayer(layer);
         layer->setTileCondition(BlockMask::WATER);
@@ -80,7 +81,8 @@ TEST_CASE("MapLayer updateConditionTiles", "")
             100, 200,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(10, 10, img1);
         layer->setTile(10, 20, img1);
         layer->setTile(10, 30, img1);
@@ -112,7 +114,8 @@ TEST_CASE("MapLayer updateConditionTiles", "")
             100, 200,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(10, 10, img1);
         layer->setTile(10, 20, img1);
         layer->setTile(10, 30, img1);
@@ -151,7 +154,8 @@ TEST_CASE("MapLayer updateConditionTiles", "")
             100, 200,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         for (int x = 0; x < 100; x ++)
         {
             for (int y = 0; y < 200; y ++)
@@ -193,7 +197,8 @@ TEST_CASE("MapLayer updateConditionTiles", "")
             100, 200,
             false,
             0,
-            0);
+            0,
+            map->getTileTable());
         layer->setTile(10, 10, img1);
         layer->setTile(10, 20, img1);
         map->addLayer(layer);
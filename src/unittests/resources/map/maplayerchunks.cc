@@ -0,0 +1,85 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "resources/map/maplayerchunks.h"
+
+#include "debug.h"
+
+TEST_CASE("MapLayerChunks", "")
+{
+    MapLayerChunks chunks(4, 3);
+
+    SECTION("get")
+    {
+        REQUIRE(chunks.get(0, 0) == nullptr);
+        MapLayerChunk *const chunk = chunks.add(1, 2, nullptr);
+        REQUIRE(chunk != nullptr);
+        REQUIRE(chunk->x == 1);
+        REQUIRE(chunk->y == 2);
+        REQUIRE(chunk->image == nullptr);
+        REQUIRE(chunks.get(1, 2) == chunk);
+        REQUIRE(chunks.get(2, 1) == nullptr);
+        REQUIRE(chunks.size() == 1);
+        REQUIRE(chunks.add(1, 2, nullptr) == chunk);
+        REQUIRE(chunks.size() == 1);
+    }
+
+    SECTION("outside")
+    {
+        REQUIRE(chunks.add(4, 0, nullptr) == nullptr);
+        REQUIRE(chunks.add(0, 3, nullptr) == nullptr);
+        REQUIRE(chunks.add(-1, 0, nullptr) == nullptr);
+        REQUIRE(chunks.get(4, 0) == nullptr);
+        REQUIRE(chunks.get(0, -1) == nullptr);
+        REQUIRE(chunks.size() == 0);
+    }
+
+    SECTION("evict")
+    {
+        chunks.add(0, 0, nullptr);
+        chunks.add(1, 0, nullptr);
+        chunks.add(2, 0, nullptr);
+        chunks.add(3, 2, nullptr);
+        chunks.evict(0, 0, 4, 3);
+        REQUIRE(chunks.size() == 4);
+        chunks.evict(1, 0, 4, 1);
+        REQUIRE(chunks.size() == 2);
+        REQUIRE(chunks.get(0, 0) == nullptr);
+        REQUIRE(chunks.get(1, 0) != nullptr);
+        REQUIRE(chunks.get(2, 0) != nullptr);
+        REQUIRE(chunks.get(3, 2) == nullptr);
+        chunks.add(0, 0, nullptr);
+        REQUIRE(chunks.get(0, 0) != nullptr);
+        chunks.clear();
+        REQUIRE(chunks.size() == 0);
+        REQUIRE(chunks.get(1, 0) == nullptr);
+    }
+
+    SECTION("margins")
+    {
+        REQUIRE(chunks.getMarginX() == 0);
+        REQUIRE(chunks.getMarginY() == 0);
+        chunks.setMargins(1, 3);
+        REQUIRE(chunks.getMarginX() == 1);
+        REQUIRE(chunks.getMarginY() == 3);
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "resources/map/maptiletable.h"
+
+#include "debug.h"
+
+TEST_CASE("MapTileTable", "")
+{
+    MapTileTable table;
+    char buf[3];
+    Image *const img1 = reinterpret_cast<Image*>(&buf[0]);
+    Image *const img2 = reinterpret_cast<Image*>(&buf[1]);
+    Image *const img3 = reinterpret_cast<Image*>(&buf[2]);
+
+    REQUIRE(table.size() == 1);
+    REQUIRE(table.getId(nullptr) == 0);
+    REQUIRE(table.get(0) == nullptr);
+
+    const uint16_t id1 = table.getId(img1);
+    const uint16_t id2 = table.getId(img2);
+    REQUIRE(id1 == 1);
+    REQUIRE(id2 == 2);
+    REQUIRE(table.getId(img1) == id1);
+    REQUIRE(table.getId(img2) == id2);
+    REQUIRE(table.getId(img3) == 3);
+    REQUIRE(table.size() == 4);
+
+    REQUIRE(table.get(id1) == img1);
+    REQUIRE(table.get(id2) == img2);
+    Image *const *const images = table.getImages();
+    REQUIRE(images[0] == nullptr);
+    REQUIRE(images[3] == img3);
+    REQUIRE(table.isOverflow() == false);
+}
+
+TEST_CASE("MapTileTable overflow", "")
+{
+    MapTileTable table;
+    char *const buf = new char[MapTileTable::maxImages + 1];
+
+    for (size_t f = 1; f < MapTileTable::maxImages; f ++)
+        table.getId(reinterpret_cast<Image*>(&buf[f]));
+    REQUIRE(table.size() == MapTileTable::maxImages);
+    REQUIRE(table.isOverflow() == false);
+
+    Image *const last = reinterpret_cast<Image*>(
+        &buf[MapTileTable::maxImages]);
+    REQUIRE(table.getId(last) == 0);
+    REQUIRE(table.isOverflow() == true);
+    REQUIRE(table.getId(reinterpret_cast<Image*>(&buf[1])) == 1);
+    delete [] buf;
+}
@@ -0,0 +1,218 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "dirs.h"
+#include "settings.h"
+
+#include "enums/resources/map/blockmask.h"
+
+#include "resources/map/blockmaskplanes.h"
+#include "resources/map/minimapcache.h"
+
+#include "utils/delete2.h"
+#include "utils/stringutils.h"
+
+#include <cstdio>
+
+PRAGMA48(GCC diagnostic push)
+PRAGMA48(GCC diagnostic ignored "-Wshadow")
+#include <SDL_timer.h>
+#include <SDL_video.h>
+PRAGMA48(GCC diagnostic pop)
+
+#include "debug.h"
+
+namespace
+{
+    uint32_t getPixel(const SDL_Surface *const surface,
+                      const int x,
+                      const int y)
+    {
+        return reinterpret_cast<const uint32_t*>(
+            static_cast<const char*>(surface->pixels) +
+            y * surface->pitch)[x];
+    }
+
+    SDL_Surface *waitSurface(MinimapCache *const cache)
+    {
+        cache->start();
+        while (!cache->isDone())
+            SDL_Delay(1);
+        return cache->takeSurface();
+    }
+}  // namespace
+
+TEST_CASE("MinimapCache", "")
+{
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+
+    const std::string fileName = pathJoin(pathJoin(settings.localDataDir,
+        "mapcache"), "unittest.minimap.bin");
+    ::remove(fileName.c_str());
+
+    BlockMaskPlanes *planes = new BlockMaskPlanes(70, 3);
+    planes->setMask(0, 0, BlockMask::WALL);
+    planes->setMask(69, 1, BlockMask::WATER);
+    planes->setMask(5, 2, BlockMask::MONSTERWALL);
+
+    MinimapCache *cache = new MinimapCache("unittest", 12345, 70, 3, 1);
+    REQUIRE(cache->load() == false);
+    REQUIRE(cache->getPixels(1) == nullptr);
+    cache->generate();
+    REQUIRE(cache->getPixels(1) == nullptr);
+    cache->setBlockPlanes(planes);
+    cache->generate();
+
+    SECTION("generate")
+    {
+        REQUIRE(cache->getPixels(0) == nullptr);
+        REQUIRE(cache->getPixels(3) == nullptr);
+        const unsigned char *pixels = cache->getPixels(1);
+        REQUIRE(pixels != nullptr);
+        for (int f = 0; f < 210; f ++)
+        {
+            REQUIRE(pixels[f] == (f == 0 || f == 70 + 69 ? 0 : 255));
+        }
+
+        pixels = cache->getPixels(2);
+        REQUIRE(pixels != nullptr);
+        REQUIRE(pixels[0] == 0);
+        REQUIRE(pixels[1] == 0);
+        REQUIRE(pixels[140] == 0);
+        REQUIRE(pixels[141] == 0);
+        REQUIRE(pixels[2] == 255);
+        REQUIRE(pixels[280 + 138] == 0);
+        REQUIRE(pixels[420 + 139] == 0);
+        REQUIRE(pixels[420 + 137] == 255);
+        delete2(cache)
+    }
+
+    SECTION("load")
+    {
+        REQUIRE(cache->save() == true);
+        delete2(cache)
+
+        cache = new MinimapCache("unittest", 12345, 70, 3, 1);
+        REQUIRE(cache->load() == true);
+        const unsigned char *pixels = cache->getPixels(1);
+        REQUIRE(pixels != nullptr);
+        for (int f = 0; f < 210; f ++)
+        {
+            REQUIRE(pixels[f] == (f == 0 || f == 139 ? 0 : 255));
+        }
+        pixels = cache->getPixels(2);
+        REQUIRE(pixels != nullptr);
+        REQUIRE(pixels[421] == 255);
+        REQUIRE(pixels[420 + 139] == 0);
+        delete2(cache)
+    }
+
+    SECTION("outdated")
+    {
+        REQUIRE(cache->save() == true);
+        delete2(cache)
+
+        cache = new MinimapCache("unittest", 12346, 70, 3, 1);
+        REQUIRE(cache->load() == false);
+        REQUIRE(cache->getPixels(1) == nullptr);
+        delete2(cache)
+
+        cache = new MinimapCache("unittest", 12345, 3, 70, 1);
+        REQUIRE(cache->load() == false);
+        delete2(cache)
+    }
+
+    SECTION("zoom 1")
+    {
+        delete2(cache)
+        cache = new MinimapCache("unittest", 12345, 70, 3, 1);
+        cache->setBlockPlanes(planes);
+        SDL_Surface *const surface = waitSurface(cache);
+        REQUIRE(surface != nullptr);
+        REQUIRE(cache->takeSurface() == nullptr);
+        delete2(cache)
+        REQUIRE(surface->w == 70);
+        REQUIRE(surface->h == 3);
+        REQUIRE(getPixel(surface, 0, 0) == 0U);
+        REQUIRE(getPixel(surface, 1, 0) == 0x00ffffffU);
+        REQUIRE(getPixel(surface, 69, 1) == 0U);
+        REQUIRE(getPixel(surface, 5, 2) == 0x00ffffffU);
+        MSDL_FreeSurface(surface);
+
+        // thread saved file for same map
+        cache = new MinimapCache("unittest", 12345, 70, 3, 1);
+        REQUIRE(cache->load() == true);
+        delete2(cache)
+    }
+
+    SECTION("zoom 2")
+    {
+        delete2(cache)
+        cache = new MinimapCache("unittest", 12345, 70, 3, 5);
+        cache->setBlockPlanes(planes);
+        SDL_Surface *const surface = waitSurface(cache);
+        delete2(cache)
+        REQUIRE(surface != nullptr);
+        REQUIRE(surface->w == 140);
+        REQUIRE(surface->h == 6);
+        for (int y = 0; y < 6; y ++)
+        {
+            for (int x = 0; x < 140; x ++)
+            {
+                const bool blocked = (x < 2 && y < 2) ||
+                    (x >= 138 && y >= 2 && y < 4);
+                REQUIRE(getPixel(surface, x, y) ==
+                    (blocked ? 0U : 0x00ffffffU));
+            }
+        }
+        MSDL_FreeSurface(surface);
+    }
+
+    SECTION("thread load")
+    {
+        REQUIRE(cache->save() == true);
+        delete2(cache)
+
+        // no block planes, so image can come only from file
+        cache = new MinimapCache("unittest", 12345, 70, 3, 2);
+        SDL_Surface *const surface = waitSurface(cache);
+        delete2(cache)
+        REQUIRE(surface != nullptr);
+        REQUIRE(surface->w == 140);
+        REQUIRE(getPixel(surface, 1, 1) == 0U);
+        REQUIRE(getPixel(surface, 2, 1) == 0x00ffffffU);
+        MSDL_FreeSurface(surface);
+    }
+
+    SECTION("cancel")
+    {
+        delete2(cache)
+        cache = new MinimapCache("unittest", 0, 70, 3, 1);
+        cache->setBlockPlanes(planes);
+        cache->start();
+        delete2(cache)
+    }
+
+    delete2(planes)
+    ::remove(fileName.c_str());
+}
@@ -0,0 +1,82 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "unittests/unittests.h"
+
+#include "resources/animation/animation.h"
+
+#include "resources/map/tileanimation.h"
+#include "resources/map/tileanimationwheel.h"
+
+#include "utils/delete2.h"
+
+#include "debug.h"
+
+namespace
+{
+    Animation *createAnimation()
+    {
+        Animation *const ani = new Animation("test");
+        ani->addFrame(nullptr, 3, 0, 0, 100);
+        ani->addFrame(nullptr, 5, 0, 0, 100);
+        ani->addFrame(nullptr, 300, 0, 0, 100);
+        ani->addFrame(nullptr, 1, 0, 0, 100);
+        return ani;
+    }
+}  // namespace
+
+TEST_CASE("TileAnimationWheel", "")
+{
+    TileAnimation *wheelAni = new TileAnimation(createAnimation());
+    TileAnimation *tickAni = new TileAnimation(createAnimation());
+    TileAnimationWheel wheel;
+
+    SECTION("same frames as per tick update")
+    {
+        wheel.add(wheelAni);
+        for (int f = 0; f < 1000; f ++)
+        {
+            const bool changed = tickAni->update(1);
+            REQUIRE(wheel.update(1) == changed);
+            REQUIRE(wheel.getTime() == f + 1);
+        }
+    }
+
+    SECTION("remove")
+    {
+        wheel.add(wheelAni);
+        wheel.remove(wheelAni);
+        for (int f = 0; f < 400; f ++)
+            REQUIRE(wheel.update(1) == false);
+    }
+
+    SECTION("clear")
+    {
+        wheel.add(wheelAni);
+        REQUIRE(wheel.update(2) == false);
+        wheel.clear();
+        REQUIRE(wheel.getTime() == 0);
+        REQUIRE(wheel.update(10) == false);
+    }
+
+    delete2(wheelAni)
+    delete2(tickAni)
+}
@@ -0,0 +1,217 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "client.h"
+#include "configmanager.h"
+#include "configuration.h"
+#include "dirs.h"
+#include "graphicsmanager.h"
+
+#include "fs/virtfs/fs.h"
+
+#include "render/sdlgraphics.h"
+
+#include "resources/mapreader.h"
+#include "resources/sdlimagehelper.h"
+
+#include "resources/map/map.h"
+#include "resources/map/maplayer.h"
+#include "resources/map/tileset.h"
+
+#include "utils/cast.h"
+#include "utils/delete2.h"
+#include "utils/env.h"
+#include "utils/foreach.h"
+#include "utils/stringutils.h"
+
+#include "debug.h"
+
+namespace
+{
+    int getTileGid(const Map *const map,
+                   const Image *const image)
+    {
+        if (image == nullptr)
+            return 0;
+        const Tilesets &tilesets = map->getTilesets();
+        FOR_EACH (Tilesets::const_iterator, it, tilesets)
+        {
+            const Tileset *const set = *it;
+            for (size_t f = 0; f < set->size(); f ++)
+            {
+                if (set->get(f) == image)
+                    return set->getFirstGid() + CAST_S32(f);
+            }
+        }
+        return -1;
+    }
+
+    // layer names and tile gids
+    STD_VECTOR<std::string> getLayersData(const Map *const map)
+    {
+        STD_VECTOR<std::string> data;
+        const Layers &layers = map->getLayers();
+        FOR_EACH (LayersCIter, it, layers)
+        {
+            const MapLayer *const layer = *it;
+            std::string str = layer->getCounterName();
+            const int size = layer->getWidth() * layer->getHeight();
+            for (int f = 0; f < size; f ++)
+            {
+                str.append(strprintf(",%d", getTileGid(map,
+                    layer->getTile(f))));
+            }
+            data.push_back(str);
+        }
+        return data;
+    }
+}  // namespace
+
+TEST_CASE("MapReader takePreloadedMap", "")
+{
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+    ConfigManager::initConfiguration();
+
+    VirtFs::mountDirSilent("data/test", Append_false);
+    VirtFs::mountDirSilent("../data/test", Append_false);
+    config.setValue("mapPreload", true);
+
+    SECTION("nothing preloaded")
+    {
+        REQUIRE(MapReader::takePreloadedMap("test.tmx") == nullptr);
+    }
+
+    SECTION("same map")
+    {
+        MapReader::preloadMap("test.tmx");
+        XML::Document *doc = MapReader::takePreloadedMap("test.tmx");
+        REQUIRE(doc != nullptr);
+        REQUIRE(doc->isLoaded());
+        REQUIRE(doc->rootNode() != nullptr);
+        REQUIRE(xmlNameEqual(doc->rootNode(), "map"));
+        delete2(doc)
+        // preload can be used only once
+        REQUIRE(MapReader::takePreloadedMap("test.tmx") == nullptr);
+        MapReader::unloadPreloaded();
+    }
+
+    SECTION("other map")
+    {
+        MapReader::preloadMap("test.tmx");
+        REQUIRE(MapReader::takePreloadedMap("test2.tmx") == nullptr);
+        // preload dropped on mismatch
+        REQUIRE(MapReader::takePreloadedMap("test.tmx") == nullptr);
+    }
+
+    SECTION("missing map")
+    {
+        MapReader::preloadMap("missing.tmx");
+        REQUIRE(MapReader::takePreloadedMap("missing.tmx") == nullptr);
+    }
+
+    SECTION("preload disabled")
+    {
+        config.setValue("mapPreload", false);
+        MapReader::preloadMap("test.tmx");
+        REQUIRE(MapReader::takePreloadedMap("test.tmx") == nullptr);
+        config.setValue("mapPreload", true);
+    }
+
+    MapReader::unloadPreload();
+    VirtFs::unmountDirSilent("data/test");
+    VirtFs::unmountDirSilent("../data/test");
+}
+
+TEST_CASE("MapReader parallel load", "")
+{
+    setEnv("SDL_VIDEODRIVER", "dummy");
+
+    client = new Client;
+    VirtFs::mountDirSilent("data", Append_false);
+    VirtFs::mountDirSilent("../data", Append_false);
+    VirtFs::mountDirSilent("data/test", Append_false);
+    VirtFs::mountDirSilent("../data/test", Append_false);
+
+    mainGraphics = new SDLGraphics;
+    imageHelper = new SDLImageHelper;
+
+    Dirs::initRootDir();
+    Dirs::initHomeDir();
+
+    ConfigManager::initConfiguration();
+    setConfigDefaults2(config);
+    setPathsDefaults(paths);
+    config.setValue("useMapCache", false);
+    // keep all tiles for compare
+    config.setValue("enableMapReduce", false);
+
+#ifdef USE_SDL2
+    SDLImageHelper::setRenderer(graphicsManager.createRenderer(
+        GraphicsManager::createWindow(640, 480, 0,
+        SDL_WINDOW_SHOWN | SDL_SWSURFACE), SDL_RENDERER_SOFTWARE));
+#else  // USE_SDL2
+
+    GraphicsManager::createWindow(640, 480, 0, SDL_ANYFORMAT | SDL_SWSURFACE);
+#endif  // USE_SDL2
+
+    config.setValue("parallelMapLoad", false);
+    config.setValue("mapPreload", false);
+    Map *const map1 = MapReader::readMap("test.tmx", "test.tmx");
+    REQUIRE(map1 != nullptr);
+    REQUIRE(map1->getTilesets().size() == 2);
+    const STD_VECTOR<std::string> data1 = getLayersData(map1);
+    REQUIRE(data1.size() == 3);
+    REQUIRE(data1[0] == "ground,1,0,2,0,0,3,0,4,5,1,0,0");
+
+    SECTION("parallel load")
+    {
+        config.setValue("parallelMapLoad", true);
+        Map *const map2 = MapReader::readMap("test.tmx", "test.tmx");
+        REQUIRE(map2 != nullptr);
+        REQUIRE(map2->getTilesets().size() == 2);
+        REQUIRE(getLayersData(map2) == data1);
+        delete map2;
+    }
+
+    SECTION("preloaded parallel load")
+    {
+        config.setValue("parallelMapLoad", true);
+        config.setValue("mapPreload", true);
+        MapReader::preloadMap("test.tmx");
+        Map *const map2 = MapReader::readMap("test.tmx", "test.tmx");
+        REQUIRE(map2 != nullptr);
+        REQUIRE(map2->getTilesets().size() == 2);
+        REQUIRE(getLayersData(map2) == data1);
+        delete map2;
+    }
+
+    delete map1;
+    config.setValue("parallelMapLoad", true);
+    config.setValue("mapPreload", true);
+    config.setValue("useMapCache", true);
+    delete2(client)
+    VirtFs::unmountDirSilent("data/test");
+    VirtFs::unmountDirSilent("../data/test");
+    VirtFs::unmountDirSilent("data");
+    VirtFs::unmountDirSilent("../data");
+}
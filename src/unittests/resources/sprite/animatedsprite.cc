@@ -42,6 +42,7 @@
 #include "resources/animation/animation.h"
 
 #include "resources/sprite/animatedsprite.h"
+#include "resources/sprite/spriteactionid.h"
 
 #include "utils/env.h"
 #include "utils/delete2.h"
@@ -192,6 +193,48 @@ TEST_CASE("AnimatedSprite tests", "animatedsprite")
         delete sprite2;
     }
 
+    SECTION("action ids")
+    {
+        REQUIRE(SpriteActionId::find(SpriteAction::STAND) ==
+            SpriteActionId::STAND);
+        REQUIRE(SpriteActionId::find(SpriteAction::DEFAULT) ==
+            SpriteActionId::DEFAULT);
+        REQUIRE(SpriteActionId::find(SpriteAction::SITTOP) ==
+            SpriteActionId::SITTOP);
+        REQUIRE(SpriteActionId::find(SpriteAction::MOVE) ==
+            SpriteActionId::MOVE);
+        REQUIRE(SpriteActionId::find(SpriteAction::CASTRIDE) ==
+            SpriteActionId::CASTRIDE);
+        REQUIRE(SpriteActionId::find(SpriteAction::DEADRIDE) ==
+            SpriteActionId::DEADRIDE);
+        REQUIRE(SpriteActionId::getName(SpriteActionId::SIT) ==
+            SpriteAction::SIT);
+        REQUIRE(SpriteActionId::getName(SpriteActionId::INVALID).empty());
+
+        const int id = SpriteActionId::get("test action id");
+        REQUIRE(id > SpriteActionId::DEADRIDE);
+        REQUIRE(SpriteActionId::get("test action id") == id);
+        REQUIRE(SpriteActionId::find("test action id") == id);
+        REQUIRE(SpriteActionId::getName(id) == "test action id");
+    }
+
+    SECTION("play by id")
+    {
+        AnimatedSprite *sprite = AnimatedSprite::load(
+            "graphics/sprites/test.xml", 0);
+        AnimatedSprite *sprite2 = AnimatedSprite::load(
+            "graphics/sprites/test.xml", 0);
+        sprite->play(SpriteAction::SIT);
+        sprite2->play(SpriteActionId::SIT);
+        REQUIRE(sprite->getAnimation() == sprite2->getAnimation());
+        REQUIRE(sprite->getFrame() == sprite2->getFrame());
+
+        REQUIRE(false == sprite2->play(SpriteActionId::get("unknown")));
+        REQUIRE(sprite->getAnimation() == sprite2->getAnimation());
+        delete sprite;
+        delete sprite2;
+    }
+
     delete2(client)
     VirtFs::unmountDirSilent("data");
     VirtFs::unmountDirSilent("../data");
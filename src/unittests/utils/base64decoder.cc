@@ -0,0 +1,179 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "unittests/unittests.h"
+
+#include "logger.h"
+
+#include "utils/base64.h"
+#include "utils/base64decoder.h"
+#include "utils/cast.h"
+#include "utils/foreach.h"
+#include "utils/stringutils.h"
+
+#include <ctime>
+
+#include "debug.h"
+
+namespace
+{
+    std::string decodeString(const std::string &str)
+    {
+        STD_VECTOR<unsigned char> buf(Base64::decodedSize(str.size()));
+        const int len = Base64::decode(str.c_str(), str.size(), &buf[0]);
+        if (len < 0)
+            return "error";
+        return std::string(reinterpret_cast<char*>(&buf[0]), len);
+    }
+
+    std::string encodeLayer(const STD_VECTOR<int> &gids)
+    {
+        std::string data;
+        FOR_EACH (STD_VECTOR<int>::const_iterator, it, gids)
+        {
+            const int gid = *it;
+            data.push_back(CAST_8(gid & 0xff));
+            data.push_back(CAST_8((gid >> 8) & 0xff));
+            data.push_back(CAST_8((gid >> 16) & 0xff));
+            data.push_back(CAST_8((gid >> 24) & 0xff));
+        }
+        const std::string encoded = encodeBase64String(data);
+        // split to lines like map editors do
+        std::string str("\n");
+        for (size_t f = 0; f < encoded.size(); f += 76)
+            str.append("   ").append(encoded.substr(f, 76)).append("\n");
+        return str;
+    }
+}  // namespace
+
+TEST_CASE("Base64 decode", "")
+{
+    REQUIRE(decodeString("") == "");
+    REQUIRE(decodeString("dGVzdA==") == "test");
+    REQUIRE(decodeString("dGVzdDE=") == "test1");
+    REQUIRE(decodeString("dGVzdDEy") == "test12");
+    REQUIRE(decodeString(" dG\nVz\tdA ==") == "test");
+    REQUIRE(decodeString("dGVzdA") == "test");
+    REQUIRE(decodeString("dGVz=") == "error");
+    REQUIRE(decodeString("dGVzd=") == "error");
+
+    std::string data;
+    for (int f = 0; f < 1000; f ++)
+        data.push_back(CAST_8(f * 7 + f / 13));
+    const std::string encoded = encodeBase64String(data);
+    REQUIRE(decodeString(encoded) == data);
+    REQUIRE(decodeBase64String(encoded) == data);
+
+    // whitespace inside and outside of simd blocks
+    std::string spaced;
+    for (size_t f = 0; f < encoded.size(); f ++)
+    {
+        if (f % 37 == 0 || f % 100 == 5)
+            spaced.append("\r\n ");
+        spaced.push_back(encoded[f]);
+    }
+    REQUIRE(decodeString(spaced) == data);
+
+    // not base64 chars after simd block
+    REQUIRE(decodeString(encoded.substr(0, 32) + "!" +
+        encoded.substr(32, 4)) == data.substr(0, 27));
+}
+
+TEST_CASE("Base64 layer benchmark", "[.]")
+{
+    const int layerSize = 500 * 500;
+    const int runs = 20;
+    STD_VECTOR<int> gids;
+    gids.reserve(layerSize);
+    for (int f = 0; f < layerSize; f ++)
+        gids.push_back(f % 7 == 0 ? 0 : 1 + (f * 31 % 700));
+
+    const std::string base64 = encodeLayer(gids);
+    std::string csv("\n");
+    for (int f = 0; f < layerSize; f ++)
+    {
+        csv.append(toString(gids[f])).append(",");
+        if (f % 500 == 499)
+            csv.append("\n");
+    }
+
+    STD_VECTOR<unsigned char> buf(Base64::decodedSize(base64.size()));
+    clock_t start = clock();
+    for (int f = 0; f < runs; f ++)
+    {
+        // old map reader path
+        std::string stripped;
+        FOR_EACH (std::string::const_iterator, it, base64)
+        {
+            if (*it != ' ' && *it != '\t' && *it != '\n')
+                stripped.push_back(*it);
+        }
+        int len = 0;
+        unsigned char *const data = php3_base64_decode(
+            reinterpret_cast<const unsigned char*>(stripped.c_str()),
+            CAST_S32(stripped.size()), &len);
+        REQUIRE(len == layerSize * 4);
+        free(data);
+    }
+    const clock_t oldBase64 = clock() - start;
+
+    start = clock();
+    for (int f = 0; f < runs; f ++)
+    {
+        REQUIRE(Base64::decode(base64.c_str(), base64.size(), &buf[0]) ==
+            layerSize * 4);
+    }
+    const clock_t newBase64 = clock() - start;
+
+    start = clock();
+    for (int f = 0; f < runs; f ++)
+    {
+        STD_VECTOR<int> tokens;
+        size_t oldPos = 0;
+        while (oldPos != std::string::npos)
+        {
+            const size_t pos = csv.find_first_of(',', oldPos);
+            if (pos == std::string::npos)
+                break;
+            tokens.push_back(atoi(csv.substr(oldPos, pos - oldPos).c_str()));
+            oldPos = pos + 1;
+        }
+        REQUIRE(tokens == gids);
+    }
+    const clock_t oldCsv = clock() - start;
+
+    start = clock();
+    for (int f = 0; f < runs; f ++)
+    {
+        STD_VECTOR<int> tokens;
+        tokens.reserve(layerSize);
+        parseIntTokens(tokens, csv.c_str(), ',');
+        REQUIRE(tokens == gids);
+    }
+    const clock_t newCsv = clock() - start;
+
+    logger->log("base64 layer decode: old %ld, new %ld clocks",
+        static_cast<long>(oldBase64),
+        static_cast<long>(newBase64));
+    logger->log("csv layer decode: old %ld, new %ld clocks",
+        static_cast<long>(oldCsv),
+        static_cast<long>(newCsv));
+}
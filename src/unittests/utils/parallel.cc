@@ -0,0 +1,77 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unittests/unittests.h"
+
+#include "utils/parallel.h"
+#include "utils/vector.h"
+
+#include "debug.h"
+
+namespace
+{
+    void countIndex(void *const data,
+                    const size_t index)
+    {
+        STD_VECTOR<int> &counts = *static_cast<STD_VECTOR<int>*>(data);
+        counts[index] ++;
+    }
+
+    void neverCalled(void *const data A_UNUSED,
+                     const size_t index A_UNUSED)
+    {
+        REQUIRE(false);
+    }
+}  // namespace
+
+TEST_CASE("Parallel run", "")
+{
+    SECTION("no items")
+    {
+        Parallel::run(&neverCalled, nullptr, 0, 0);
+        Parallel::run(&neverCalled, nullptr, 0, 4);
+    }
+
+    SECTION("one item")
+    {
+        STD_VECTOR<int> counts(1, 0);
+        Parallel::run(&countIndex, &counts, counts.size(), 0);
+        REQUIRE(counts[0] == 1);
+        Parallel::run(&countIndex, &counts, counts.size(), 4);
+        REQUIRE(counts[0] == 2);
+    }
+
+    SECTION("each index once")
+    {
+        STD_VECTOR<int> counts(1000, 0);
+        Parallel::run(&countIndex, &counts, counts.size(), 0);
+        for (size_t f = 0; f < counts.size(); f ++)
+            REQUIRE(counts[f] == 1);
+    }
+
+    SECTION("limited threads")
+    {
+        STD_VECTOR<int> counts(37, 0);
+        Parallel::run(&countIndex, &counts, counts.size(), 1);
+        Parallel::run(&countIndex, &counts, counts.size(), 3);
+        for (size_t f = 0; f < counts.size(); f ++)
+            REQUIRE(counts[f] == 2);
+    }
+}
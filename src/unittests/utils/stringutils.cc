@@ -845,6 +845,41 @@ TEST_CASE("stringuntils splitToIntVector 1", "")
     REQUIRE(tokens[2] == 30);
 }
 
+TEST_CASE("stringuntils parseIntTokens 1", "")
+{
+    STD_VECTOR<int> tokens;
+    REQUIRE(parseIntTokens(tokens, "", ',') == true);
+    REQUIRE(tokens.empty() == true);
+
+    tokens.clear();
+    REQUIRE(parseIntTokens(tokens, "10,2,30,", ',') == true);
+    REQUIRE(tokens.size() == 3);
+    REQUIRE(tokens[0] == 10);
+    REQUIRE(tokens[1] == 2);
+    REQUIRE(tokens[2] == 30);
+
+    tokens.clear();
+    REQUIRE(parseIntTokens(tokens, "10,2,30", ',') == false);
+    REQUIRE(tokens.size() == 2);
+    REQUIRE(tokens[0] == 10);
+    REQUIRE(tokens[1] == 2);
+
+    tokens.clear();
+    REQUIRE(parseIntTokens(tokens, "\n 10,\n-2a,,z30,+7,\n", ',') == false);
+    REQUIRE(tokens.size() == 5);
+    REQUIRE(tokens[0] == 10);
+    REQUIRE(tokens[1] == -2);
+    REQUIRE(tokens[2] == 0);
+    REQUIRE(tokens[3] == 0);
+    REQUIRE(tokens[4] == 7);
+
+    tokens.clear();
+    REQUIRE(parseIntTokens(tokens, "10;20;", ';') == true);
+    REQUIRE(tokens.size() == 2);
+    REQUIRE(tokens[0] == 10);
+    REQUIRE(tokens[1] == 20);
+}
+
 TEST_CASE("stringuntils splitToStringVector 1", "")
 {
     STD_VECTOR<std::string> tokens;
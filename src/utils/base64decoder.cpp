@@ -0,0 +1,261 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/base64decoder.h"
+
+#include "utils/cast.h"
+#include "utils/cpu.h"
+
+#ifdef SIMD_SUPPORTED
+// avx2
+#include <immintrin.h>
+#endif  // SIMD_SUPPORTED
+
+#include <cstring>
+
+#include "debug.h"
+
+namespace
+{
+    const signed char decodeTable[256] =
+    {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+        52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+        -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+        15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+        -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+        41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+    };
+
+    // returns mask of not base64 chars in 32 chars block or 0 if decoded
+    typedef unsigned int (*DecodeBlockFunctionPtr)
+        (const char *restrict const src,
+         unsigned char *restrict const dst);
+
+    DecodeBlockFunctionPtr funcDecodeBlock = nullptr;
+
+#ifdef SIMD_SUPPORTED
+    __attribute__ ((target ("ssse3")))
+    unsigned int decodeBlock16Ssse3(const char *restrict const src,
+                                    unsigned char *restrict const dst)
+    {
+        const __m128i in = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(src));
+        const __m128i upper = _mm_and_si128(
+            _mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)),
+            _mm_cmplt_epi8(in, _mm_set1_epi8('Z' + 1)));
+        const __m128i lower = _mm_and_si128(
+            _mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)),
+            _mm_cmplt_epi8(in, _mm_set1_epi8('z' + 1)));
+        const __m128i digit = _mm_and_si128(
+            _mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)),
+            _mm_cmplt_epi8(in, _mm_set1_epi8('9' + 1)));
+        const __m128i plus = _mm_cmpeq_epi8(in, _mm_set1_epi8('+'));
+        const __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+        const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+            _mm_or_si128(digit, _mm_or_si128(plus, slash)));
+        const unsigned int invalid =
+            CAST_U32(_mm_movemask_epi8(valid)) ^ 0xffffU;
+        if (invalid != 0U)
+            return invalid;
+
+        // char to 6 bit value
+        const __m128i shift = _mm_or_si128(
+            _mm_or_si128(
+            _mm_and_si128(upper, _mm_set1_epi8(-65)),
+            _mm_and_si128(lower, _mm_set1_epi8(-71))),
+            _mm_or_si128(
+            _mm_and_si128(digit, _mm_set1_epi8(4)),
+            _mm_or_si128(
+            _mm_and_si128(plus, _mm_set1_epi8(19)),
+            _mm_and_si128(slash, _mm_set1_epi8(16)))));
+        const __m128i values = _mm_add_epi8(in, shift);
+
+        // four 6 bit values to 24 bits in each dword
+        const __m128i merged = _mm_madd_epi16(
+            _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)),
+            _mm_set1_epi32(0x00011000));
+        const __m128i packed = _mm_shuffle_epi8(merged, _mm_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        unsigned char buf[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buf), packed);
+        memcpy(dst, buf, 12);
+        return 0U;
+    }
+
+    __attribute__ ((target ("ssse3")))
+    unsigned int decodeBlockSsse3(const char *restrict const src,
+                                  unsigned char *restrict const dst)
+    {
+        const unsigned int invalid = decodeBlock16Ssse3(src, dst);
+        if (invalid != 0U)
+            return invalid;
+        return decodeBlock16Ssse3(src + 16, dst + 12) << 16;
+    }
+
+    __attribute__ ((target ("avx2")))
+    unsigned int decodeBlockAvx2(const char *restrict const src,
+                                 unsigned char *restrict const dst)
+    {
+        const __m256i in = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(src));
+        const __m256i upper = _mm256_andnot_si256(
+            _mm256_cmpgt_epi8(in, _mm256_set1_epi8('Z')),
+            _mm256_cmpgt_epi8(in, _mm256_set1_epi8('A' - 1)));
+        const __m256i lower = _mm256_andnot_si256(
+            _mm256_cmpgt_epi8(in, _mm256_set1_epi8('z')),
+            _mm256_cmpgt_epi8(in, _mm256_set1_epi8('a' - 1)));
+        const __m256i digit = _mm256_andnot_si256(
+            _mm256_cmpgt_epi8(in, _mm256_set1_epi8('9')),
+            _mm256_cmpgt_epi8(in, _mm256_set1_epi8('0' - 1)));
+        const __m256i plus = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('+'));
+        const __m256i slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+        const __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower),
+            _mm256_or_si256(digit, _mm256_or_si256(plus, slash)));
+        const unsigned int invalid = ~CAST_U32(_mm256_movemask_epi8(valid));
+        if (invalid != 0U)
+            return invalid;
+
+        // char to 6 bit value
+        const __m256i shift = _mm256_or_si256(
+            _mm256_or_si256(
+            _mm256_and_si256(upper, _mm256_set1_epi8(-65)),
+            _mm256_and_si256(lower, _mm256_set1_epi8(-71))),
+            _mm256_or_si256(
+            _mm256_and_si256(digit, _mm256_set1_epi8(4)),
+            _mm256_or_si256(
+            _mm256_and_si256(plus, _mm256_set1_epi8(19)),
+            _mm256_and_si256(slash, _mm256_set1_epi8(16)))));
+        const __m256i values = _mm256_add_epi8(in, shift);
+
+        // four 6 bit values to 24 bits in each dword
+        const __m256i merged = _mm256_madd_epi16(
+            _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140)),
+            _mm256_set1_epi32(0x00011000));
+        const __m256i shuffled = _mm256_shuffle_epi8(merged,
+            _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        const __m256i packed = _mm256_permutevar8x32_epi32(shuffled,
+            _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        unsigned char buf[32];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(buf), packed);
+        memcpy(dst, buf, 24);
+        return 0U;
+    }
+#endif  // SIMD_SUPPORTED
+}  // namespace
+
+void Base64::initFunctions()
+{
+#ifdef SIMD_SUPPORTED
+    const uint32_t flags = Cpu::getFlags();
+    if ((flags & Cpu::FEATURE_AVX2) != 0U)
+        funcDecodeBlock = &decodeBlockAvx2;
+    else if ((flags & Cpu::FEATURE_SSSE3) != 0U)
+        funcDecodeBlock = &decodeBlockSsse3;
+    else
+#endif  // SIMD_SUPPORTED
+        funcDecodeBlock = nullptr;
+}
+
+int Base64::decode(const char *restrict const src,
+                   const size_t length,
+                   unsigned char *restrict const dst)
+{
+    const DecodeBlockFunctionPtr decodeBlock = funcDecodeBlock;
+    size_t pos = 0;
+    int j = 0;
+    unsigned int acc = 0;
+    int quad = 0;
+    bool pad = false;
+
+    while (pos < length && !pad)
+    {
+        size_t end = length;
+        if (decodeBlock != nullptr)
+        {
+            if (quad == 0 && length - pos >= 32)
+            {
+                const unsigned int invalid = decodeBlock(src + pos, dst + j);
+                if (invalid == 0U)
+                {
+                    pos += 32;
+                    j += 24;
+                    continue;
+                }
+                // decode without simd up to first not base64 char
+                end = pos + CAST_SIZE(__builtin_ctz(invalid)) + 1;
+            }
+            else
+            {
+                end = pos + 1;
+            }
+        }
+
+        for (; pos < end; pos ++)
+        {
+            const unsigned char ch = CAST_U8(src[pos]);
+            if (ch == '=' || ch == 0)
+            {
+                pad = ch == '=';
+                pos = length;
+                break;
+            }
+            const int val = decodeTable[ch];
+            if (val < 0)
+                continue;
+            acc = (acc << 6) | CAST_U32(val);
+            quad ++;
+            if (quad == 4)
+            {
+                dst[j] = CAST_U8(acc >> 16);
+                dst[j + 1] = CAST_U8(acc >> 8);
+                dst[j + 2] = CAST_U8(acc);
+                j += 3;
+                acc = 0;
+                quad = 0;
+            }
+        }
+    }
+
+    if (pad && quad < 2)
+        return -1;
+    if (quad == 2)
+    {
+        dst[j++] = CAST_U8(acc >> 4);
+    }
+    else if (quad == 3)
+    {
+        dst[j++] = CAST_U8(acc >> 10);
+        dst[j++] = CAST_U8(acc >> 2);
+    }
+    return j;
+}
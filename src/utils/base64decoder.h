@@ -0,0 +1,51 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_BASE64DECODER_H
+#define UTILS_BASE64DECODER_H
+
+#include "localconsts.h"
+
+namespace Base64
+{
+    /**
+     * Selects simd decoder for current cpu.
+     */
+    void initFunctions();
+
+    /**
+     * Returns enough output buffer size for decode length chars.
+     */
+    inline size_t decodedSize(const size_t length)
+    {
+        return length / 4 * 3 + 3;
+    }
+
+    /**
+     * Decodes base64 data. Chars outside of base64 alphabet skipped,
+     * decoding stops at padding or zero char.
+     * Returns number of decoded bytes or -1 for padding in wrong place.
+     */
+    int decode(const char *restrict const src,
+               const size_t length,
+               unsigned char *restrict const dst);
+}  // namespace Base64
+
+#endif  // UTILS_BASE64DECODER_H
@@ -22,6 +22,8 @@
 
 #include "logger.h"
 
+#include "utils/cast.h"
+
 #if (defined(__amd64__) || defined(__i386__)) && defined(__GNUC__) \
     && (GCC_VERSION >= 40800) && !defined(ANDROID)
 // nothing
@@ -33,6 +35,8 @@
 
 #ifdef USE_SDL2
 #include <SDL_cpuinfo.h>
+#elif !defined(WIN32)
+#include <unistd.h>
 #endif  // USE_SDL2
 
 #include "debug.h"
@@ -176,3 +180,16 @@ uint32_t Cpu::getFlags()
 {
     return mCpuFlags;
 }
+
+int Cpu::getCount()
+{
+#ifdef USE_SDL2
+    const int count = SDL_GetCPUCount();
+#elif defined(_SC_NPROCESSORS_ONLN)
+    const int count = CAST_S32(sysconf(_SC_NPROCESSORS_ONLN));
+#else  // USE_SDL2
+    const int count = 1;
+#endif  // USE_SDL2
+
+    return count > 0 ? count : 1;
+}
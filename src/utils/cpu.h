@@ -43,6 +43,8 @@ namespace Cpu
     void printFlags();
 
     uint32_t getFlags();
+
+    int getCount();
 }  // namespace Cpu
 
 #endif  // UTILS_CPU_H
@@ -0,0 +1,122 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/parallel.h"
+
+#include "utils/cast.h"
+#include "utils/cpu.h"
+#include "utils/foreach.h"
+#include "utils/mutex.h"
+#include "utils/sdlhelper.h"
+#include "utils/vector.h"
+
+#include "debug.h"
+
+namespace
+{
+    struct ParallelTask final
+    {
+        ParallelTask(const ParallelFunction func0,
+                     void *const data0,
+                     const size_t count0) :
+            mutex(),
+            func(func0),
+            data(data0),
+            count(count0),
+            next(0)
+        {
+        }
+
+        A_DELETE_COPY(ParallelTask)
+
+        Mutex mutex;
+        ParallelFunction func;
+        void *data;
+        size_t count;
+        size_t next;
+    };
+
+    int parallelThread(void *ptr)
+    {
+        ParallelTask *const task = static_cast<ParallelTask*>(ptr);
+        while (true)
+        {
+            size_t index;
+            {
+                MutexLocker lock(&task->mutex);
+                index = task->next;
+                task->next ++;
+            }
+            if (index >= task->count)
+                break;
+            task->func(task->data, index);
+        }
+        return 0;
+    }
+}  // namespace
+
+void Parallel::run(const ParallelFunction func,
+                   void *const data,
+                   const size_t count,
+                   const int maxThreads)
+{
+    if (count == 0)
+        return;
+
+    size_t threads = CAST_SIZE(Cpu::getCount());
+    if (maxThreads > 0 && threads > CAST_SIZE(maxThreads))
+        threads = CAST_SIZE(maxThreads);
+    if (threads > count)
+        threads = count;
+    if (threads <= 1)
+    {
+        for (size_t f = 0; f < count; f ++)
+            func(data, f);
+        return;
+    }
+
+    ParallelTask task(func, data, count);
+    STD_VECTOR<SDL_Thread*> workers;
+    for (size_t f = 1; f < threads; f ++)
+    {
+        SDL_Thread *const thread = SDL::createThread(&parallelThread,
+            "parallel",
+            &task);
+        if (thread != nullptr)
+            workers.push_back(thread);
+    }
+    try
+    {
+        parallelThread(&task);
+    }
+    catch (...)
+    {
+        // workers use task from this stack frame
+        {
+            MutexLocker lock(&task.mutex);
+            task.next = count;
+        }
+        FOR_EACH (STD_VECTOR<SDL_Thread*>::iterator, it, workers)
+            SDL::WaitThread(*it);
+        throw;
+    }
+    FOR_EACH (STD_VECTOR<SDL_Thread*>::iterator, it, workers)
+        SDL::WaitThread(*it);
+}
@@ -0,0 +1,44 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2011-2019  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include "localconsts.h"
+
+typedef void (*ParallelFunction)(void *const data,
+                                 const size_t index);
+
+namespace Parallel
+{
+    /**
+     * Calls func for each index in range [0, count) using worker threads.
+     * Calling thread also process indexes. Returns after all calls done.
+     * Func must not throw, because exception in worker thread terminates
+     * program.
+     * @param maxThreads limit of threads or 0 for cpu count
+     */
+    void run(const ParallelFunction func,
+             void *const data,
+             const size_t count,
+             const int maxThreads);
+}  // namespace Parallel
+
+#endif  // UTILS_PARALLEL_H
@@ -523,6 +523,37 @@ void splitToIntVector(STD_VECTOR<int> &tokens,
     }
 }
 
+bool parseIntTokens(STD_VECTOR<int> &tokens,
+                    const char *const text,
+                    const char separator)
+{
+    const char *ptr = text;
+    while (*ptr != 0)
+    {
+        const char *const end = strchr(ptr, separator);
+        if (end == nullptr)
+            return false;
+
+        while (ptr != end && (*ptr == ' ' || (*ptr >= '\t' && *ptr <= '\r')))
+            ptr ++;
+        bool negative = false;
+        if (ptr != end && (*ptr == '-' || *ptr == '+'))
+        {
+            negative = *ptr == '-';
+            ptr ++;
+        }
+        unsigned int value = 0;
+        while (ptr != end && *ptr >= '0' && *ptr <= '9')
+        {
+            value = value * 10 + CAST_U32(*ptr - '0');
+            ptr ++;
+        }
+        tokens.push_back(negative ? -CAST_S32(value) : CAST_S32(value));
+        ptr = end + 1;
+    }
+    return true;
+}
+
 std::string combineDye(std::string file,
                        const std::string &dye)
 {
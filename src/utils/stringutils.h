@@ -212,6 +212,14 @@ void splitToStringSet(std::set<std::string> &tokens,
 void splitToIntVector(STD_VECTOR<int> &tokens,
                       const std::string &text, const char separator);
 
+/**
+ * Parses each token ended with separator like atoi without allocations.
+ * Returns false if text have data after last separator.
+ */
+bool parseIntTokens(STD_VECTOR<int> &tokens,
+                    const char *const text,
+                    const char separator);
+
 std::string combineDye(std::string file, const std::string &dye) A_WARN_UNUSED;
 
 std::string combineDye2(std::string file,